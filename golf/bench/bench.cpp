@@ -0,0 +1,372 @@
+#include "cgp/cgp.hpp"
+#include "../src/terrain.hpp"
+#include "third_party/src/tinyobj/tiny_obj_loader.hpp"
+
+#include <iostream>
+
+using namespace cgp;
+
+// Microbenchmarks of the hot paths of the library and of the terrain generation (built with: make bench)
+//  ./golf_bench [--output bench.json] [--filter name] [--repetitions 15] [--warmup 2] [--min-time 0.01] [--list]
+//  Compare two runs (exit code 1 if a benchmark is slower): ./golf_bench --compare before.json after.json [--threshold 0.05]
+//  The assets are searched from the directory of the executable, as for the golf executable.
+
+struct bench_case {
+	std::string name;
+	std::function<void()> setup; // Called once before the benchmark, not measured
+	std::function<void()> function;
+};
+
+// Access patterns that depend on the memory layout of the grids (large grids: not in the cache)
+template <typename LAYOUT>
+static void add_grid_layout_cases(std::vector<bench_case>& cases, std::string const& layout_name)
+{
+	// Bilinear sampling of a 4096^2 grid along a rotated direction (as a rotated texture lookup)
+	auto const grids = std::make_shared<std::vector<grid_2D<float, LAYOUT>>>();
+	auto const setup_grids = [grids]() {
+		rand_initialize_generator(0);
+		grids->assign(2, grid_2D<float, LAYOUT>(4096, 4096));
+		for (float& v : (*grids)[0])
+			v = rand_uniform();
+	};
+	cases.push_back({ "grid_2D bilinear rotated " + layout_name, setup_grids, [grids]() {
+		grid_2D<float, LAYOUT> const& g = (*grids)[0];
+		int const M = 1024;
+		float const L = 2900.0f; // Side of the rotated square of samples, inside the grid
+		vec2 const u = { std::cos(1.0f), std::sin(1.0f) };
+		vec2 const v = { -u.y, u.x };
+		vec2 const origin = { 2048.0f - 0.5f * L * (u.x + v.x), 2048.0f - 0.5f * L * (u.y + v.y) };
+		float s = 0.0f;
+		for (int kv = 0; kv < M; ++kv)
+			for (int ku = 0; ku < M; ++ku) {
+				vec2 const p = origin + (L * ku / M) * u + (L * kv / M) * v;
+				s += interpolation_bilinear(g, p.x, p.y);
+			}
+		benchmark_keep(s);
+	} });
+
+	// 5-point stencil on a 4096^2 grid, in the memory order of the result
+	cases.push_back({ "grid_2D stencil 4096 " + layout_name, setup_grids, [grids]() {
+		grid_2D<float, LAYOUT> const& g = (*grids)[0];
+		grid_2D<float, LAYOUT>& r = (*grids)[1];
+		int const N = g.dimension.x;
+		grid_for_each(r, [&](int kx, int ky, float& value) {
+			if (kx > 0 && ky > 0 && kx < N - 1 && ky < N - 1)
+				value = 0.2f * (g(kx, ky) + g(kx - 1, ky) + g(kx + 1, ky) + g(kx, ky - 1) + g(kx, ky + 1));
+		});
+		benchmark_keep(r);
+	} });
+
+	// 7-point stencil on a 256^3 grid
+	auto const grids_3D = std::make_shared<std::vector<grid_3D<float, LAYOUT>>>();
+	cases.push_back({ "grid_3D stencil 256 " + layout_name, [grids_3D]() {
+		rand_initialize_generator(0);
+		grids_3D->assign(2, grid_3D<float, LAYOUT>(256, 256, 256));
+		for (float& v : (*grids_3D)[0])
+			v = rand_uniform();
+	}, [grids_3D]() {
+		grid_3D<float, LAYOUT> const& g = (*grids_3D)[0];
+		grid_3D<float, LAYOUT>& r = (*grids_3D)[1];
+		int const N = g.dimension.x;
+		grid_for_each(r, [&](int kx, int ky, int kz, float& value) {
+			if (kx > 0 && ky > 0 && kz > 0 && kx < N - 1 && ky < N - 1 && kz < N - 1)
+				value = (g(kx, ky, kz) + g(kx - 1, ky, kz) + g(kx + 1, ky, kz) + g(kx, ky - 1, kz) + g(kx, ky + 1, kz) + g(kx, ky, kz - 1) + g(kx, ky, kz + 1)) / 7.0f;
+		});
+		benchmark_keep(r);
+	} });
+}
+
+static std::vector<bench_case> bench_cases(std::string const& path)
+{
+	std::vector<bench_case> cases;
+
+	cases.push_back({ "noise_perlin", {}, []() {
+		// Same parameters as the terrain
+		float s = 0.0f;
+		for (int k = 0; k < 1024; ++k)
+			s += noise_perlin({ k * 0.037f, k * 0.011f }, 4, 0.20f, 1.5f);
+		benchmark_keep(s);
+	} });
+
+	cases.push_back({ "evaluate_terrain_height", {}, []() {
+		float s = 0.0f;
+		for (int ku = 0; ku < 32; ++ku)
+			for (int kv = 0; kv < 32; ++kv)
+				s += evaluate_terrain_height(-40.0f + 80.0f * ku / 31.0f, -15.0f + 30.0f * kv / 31.0f);
+		benchmark_keep(s);
+	} });
+
+	cases.push_back({ "create_terrain_mesh", {}, []() {
+		mesh const terrain = create_terrain_mesh(100, 80, 30);
+		benchmark_keep(terrain);
+	} });
+
+	// The meshes are shared with the setup functions (kept alive by the lambdas)
+	auto const terrain = std::make_shared<mesh>();
+	cases.push_back({ "normal_per_vertex", [terrain]() { *terrain = create_terrain_mesh(100, 80, 30); }, [terrain]() {
+		numarray<vec3> const normal = normal_per_vertex(terrain->position, terrain->connectivity);
+		benchmark_keep(normal);
+	} });
+
+	cases.push_back({ "mesh_load_file_obj", {}, [path]() {
+		mesh const trunk = mesh_load_file_obj(path + "assets/trunk.obj");
+		benchmark_keep(trunk);
+	} });
+	// References for the OBJ loader: stream based loader of the library, and tinyobjloader (parsing only, no mesh built)
+	cases.push_back({ "obj_load_reference", {}, [path]() {
+		numarray<numarray<int>> correspondance;
+		mesh const trunk = loader::obj_load_reference(path + "assets/trunk.obj", correspondance);
+		benchmark_keep(trunk);
+	} });
+	cases.push_back({ "tinyobj ParseFromFile", {}, [path]() {
+		tinyobj::ObjReader reader;
+		reader.ParseFromFile(path + "assets/trunk.obj");
+		benchmark_keep(reader);
+	} });
+
+	auto const field = std::make_shared<grid_3D<float>>();
+	auto const domain = std::make_shared<spatial_domain_grid_3D>();
+	cases.push_back({ "marching_cube", [field, domain]() {
+		// Noisy sphere sampled on 64^3 voxels
+		int const N = 64;
+		*domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { N,N,N });
+		field->resize(N, N, N);
+		for (int kx = 0; kx < N; ++kx)
+			for (int ky = 0; ky < N; ++ky)
+				for (int kz = 0; kz < N; ++kz) {
+					vec3 const p = domain->position({ kx,ky,kz });
+					(*field)(kx, ky, kz) = norm(p) + 0.2f * noise_perlin(2.0f * p, 3);
+				}
+	}, [field, domain]() {
+		mesh const surface = marching_cube(*field, *domain, 0.8f);
+		benchmark_keep(surface);
+	} });
+
+	cases.push_back({ "image_load_file jpg", {}, [path]() {
+		image_structure const image = image_load_file(path + "assets/texture_grass.jpg");
+		benchmark_keep(image);
+	} });
+	cases.push_back({ "image_load_file png", {}, [path]() {
+		image_structure const image = image_load_file(path + "assets/ball.png");
+		benchmark_keep(image);
+	} });
+
+	auto const matrices = std::make_shared<std::vector<mat4>>();
+	auto const setup_matrices = [matrices]() {
+		rand_initialize_generator(0);
+		matrices->resize(1024);
+		for (mat4& M : *matrices)
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 4; ++j)
+					M(i, j) = (i == j ? 4.0f : 0.0f) + rand_uniform(-1, 1); // Diagonally dominant: invertible
+	};
+	cases.push_back({ "mat4 multiply", setup_matrices, [matrices]() {
+		mat4 M = mat4::build_identity();
+		for (mat4 const& A : *matrices)
+			M = A * M;
+		benchmark_keep(M);
+	} });
+	cases.push_back({ "mat4 inverse", setup_matrices, [matrices]() {
+		mat4 M;
+		for (mat4 const& A : *matrices)
+			M += inverse(A);
+		benchmark_keep(M);
+	} });
+	cases.push_back({ "mat4 transpose", setup_matrices, [matrices]() {
+		mat4 M;
+		for (mat4 const& A : *matrices)
+			M += transpose(A);
+		benchmark_keep(M);
+	} });
+	cases.push_back({ "mat4 transform_position", setup_matrices, [matrices]() {
+		vec3 p = { 0.1f, 0.2f, 0.3f };
+		for (mat4 const& A : *matrices)
+			p = A.transform_position(p) * 0.25f;
+		benchmark_keep(p);
+	} });
+
+	// Model matrices as built by mesh_drawable for each draw call
+	auto const transforms = std::make_shared<std::vector<affine_rts>>();
+	cases.push_back({ "affine_rts matrix", [transforms]() {
+		rand_initialize_generator(0);
+		transforms->resize(1024);
+		for (affine_rts& T : *transforms) {
+			T.rotation = rotation_transform::from_axis_angle(normalize(vec3(rand_uniform(-1, 1), rand_uniform(-1, 1), 1.0f)), rand_uniform(0, 3.14f));
+			T.translation = { rand_uniform(-10, 10), rand_uniform(-10, 10), rand_uniform(-10, 10) };
+			T.scaling = rand_uniform(0.5f, 2.0f);
+		}
+	}, [transforms]() {
+		mat4 M;
+		for (affine_rts const& T : *transforms)
+			M += T.matrix();
+		benchmark_keep(M);
+	} });
+
+	// Arithmetic on large numarrays (a + b*c allocates a temporary per operator without fusion)
+	auto const arrays = std::make_shared<std::vector<numarray<vec3>>>();
+	cases.push_back({ "numarray a+b*c", [arrays]() {
+		rand_initialize_generator(0);
+		arrays->assign(4, numarray<vec3>(65536));
+		for (numarray<vec3>& a : *arrays)
+			for (vec3& p : a)
+				p = { rand_uniform(), rand_uniform(), rand_uniform() };
+	}, [arrays]() {
+		numarray<vec3> const& a = (*arrays)[0];
+		numarray<vec3> const& b = (*arrays)[1];
+		numarray<vec3> const& c = (*arrays)[2];
+		numarray<vec3>& r = (*arrays)[3];
+		r = a + b * c;
+		r += 0.5f * a - c / 2.0f;
+		benchmark_keep(r);
+	} });
+
+	// Indexed element access in a 5-point stencil (cost of the bound checks, see CGP_BOUND_CHECK)
+	auto const grids = std::make_shared<std::vector<grid_2D<float>>>();
+	cases.push_back({ "grid_2D stencil", [grids]() {
+		rand_initialize_generator(0);
+		grids->assign(2, grid_2D<float>(256, 256));
+		for (float& v : (*grids)[0])
+			v = rand_uniform();
+	}, [grids]() {
+		grid_2D<float> const& g = (*grids)[0];
+		grid_2D<float>& r = (*grids)[1];
+		int const N = g.dimension.x;
+		for (int kx = 1; kx < N - 1; ++kx)
+			for (int ky = 1; ky < N - 1; ++ky)
+				r(kx, ky) = 0.2f * (g(kx, ky) + g(kx - 1, ky) + g(kx + 1, ky) + g(kx, ky - 1) + g(kx, ky + 1));
+		benchmark_keep(r);
+	} });
+
+	add_grid_layout_cases<grid_layout_row_major>(cases, "row_major");
+	add_grid_layout_cases<grid_layout_tiled<8>>(cases, "tiled");
+	add_grid_layout_cases<grid_layout_morton<16>>(cases, "morton");
+
+	// Sampling of a heightfield at 65536 random positions: one interpolation_bilinear per query, and the batched grid_sampler_2D
+	auto const heightfield = std::make_shared<grid_2D<float>>();
+	auto const queries = std::make_shared<numarray<vec2>>();
+	auto const setup_heightfield = [heightfield, queries]() {
+		rand_initialize_generator(0);
+		heightfield->resize(1024, 1024);
+		grid_for_each(*heightfield, [](int kx, int ky, float& h) { h = evaluate_terrain_height(-40.0f + 80.0f * kx / 1023.0f, -15.0f + 30.0f * ky / 1023.0f); });
+		queries->resize(65536);
+		for (vec2& q : *queries)
+			q = { rand_uniform(-40.0f, 40.0f), rand_uniform(-15.0f, 15.0f) };
+	};
+	cases.push_back({ "interpolation_bilinear 64k", setup_heightfield, [heightfield, queries]() {
+		float s = 0.0f;
+		for (vec2 const& q : *queries)
+			s += interpolation_bilinear(*heightfield, std::min((q.x + 40.0f) * 1023.0f / 80.0f, 1022.99f), std::min((q.y + 15.0f) * 1023.0f / 30.0f, 1022.99f));
+		benchmark_keep(s);
+	} });
+	auto const samples = std::make_shared<numarray<float>>();
+	auto const samples_gradient = std::make_shared<numarray<grid_sample<float>>>();
+	cases.push_back({ "grid_sampler bilinear 64k", setup_heightfield, [heightfield, queries, samples]() {
+		grid_sampler_2D<float> const sampler(*heightfield, { -40.0f, -15.0f }, { 40.0f, 15.0f });
+		sampler.sample(*queries, *samples);
+		benchmark_keep(*samples);
+	} });
+	cases.push_back({ "grid_sampler bicubic 64k", setup_heightfield, [heightfield, queries, samples]() {
+		grid_sampler_2D<float> const sampler(*heightfield, { -40.0f, -15.0f }, { 40.0f, 15.0f }, grid_sampler_filter::bicubic);
+		sampler.sample(*queries, *samples);
+		benchmark_keep(*samples);
+	} });
+	cases.push_back({ "grid_sampler bicubic gradient 64k", setup_heightfield, [heightfield, queries, samples_gradient]() {
+		grid_sampler_2D<float> const sampler(*heightfield, { -40.0f, -15.0f }, { 40.0f, 15.0f }, grid_sampler_filter::bicubic);
+		sampler.sample_with_gradient(*queries, *samples_gradient);
+		benchmark_keep(*samples_gradient);
+	} });
+
+	cases.push_back({ "generate_positions_on_terrain", {}, []() {
+		// Same parameters as the grass of the vegetation (the seed is reset to draw the same positions at every call)
+		rand_initialize_generator(0);
+		std::vector<vec3> const position = generate_positions_on_terrain(8000, 70, 30);
+		benchmark_keep(position);
+	} });
+
+	// Cost of an empty zone (recorded in the ring buffer of the thread)
+	cases.push_back({ "profiler zone 1k", []() { profiler::active = true; }, []() {
+		for (int k = 0; k < 1000; ++k) {
+			profile_zone_cgp("bench_zone");
+		}
+	} });
+
+	return cases;
+}
+
+static int bench_compare(std::string const& before_filename, std::string const& after_filename, double threshold)
+{
+	std::vector<benchmark_result> const before = benchmark_load_json(before_filename);
+	std::vector<benchmark_result> const after = benchmark_load_json(after_filename);
+	if (before.empty() || after.empty())
+		return 2;
+
+	int regressions = 0;
+	for (benchmark_comparison const& c : benchmark_compare(before, after, threshold)) {
+		std::cout << str(c) << std::endl;
+		if (c.change == benchmark_change::regression)
+			regressions++;
+	}
+	std::cout << regressions << " regression(s) (threshold " << 100 * threshold << "%)" << std::endl;
+	return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+	std::string output = "bench.json";
+	std::string filter;
+	std::string compare_before, compare_after;
+	double threshold = 0.05;
+	bool list = false;
+	benchmark_parameters parameters;
+	for (int k = 1; k < argc; ++k) {
+		std::string const arg = argv[k];
+		bool const has_value = k + 1 < argc;
+		if (arg == "--list")
+			list = true;
+		else if (arg == "--compare" && k + 2 < argc) {
+			compare_before = argv[++k];
+			compare_after = argv[++k];
+		}
+		else if (arg == "--output" && has_value)
+			output = argv[++k];
+		else if (arg == "--filter" && has_value)
+			filter = argv[++k];
+		else if (arg == "--repetitions" && has_value)
+			parameters.repetitions = std::stoi(argv[++k]);
+		else if (arg == "--warmup" && has_value)
+			parameters.warmup = std::stoi(argv[++k]);
+		else if (arg == "--min-time" && has_value)
+			parameters.min_sample_time = std::stod(argv[++k]);
+		else if (arg == "--threshold" && has_value)
+			threshold = std::stod(argv[++k]);
+		else {
+			std::cerr << "Unknown argument " << arg << std::endl;
+			return 2;
+		}
+	}
+
+	if (!compare_before.empty())
+		return bench_compare(compare_before, compare_after, threshold);
+
+	std::string const path = project_path_find(argv[0], "shaders/");
+	std::vector<benchmark_result> results;
+	for (bench_case const& c : bench_cases(path)) {
+		if (!filter.empty() && c.name.find(filter) == std::string::npos)
+			continue;
+		if (list) {
+			std::cout << c.name << std::endl;
+			continue;
+		}
+		if (c.setup)
+			c.setup();
+		results.push_back(benchmark_run(c.name, c.function, parameters));
+		std::cout << str(results.back()) << std::endl;
+	}
+	if (list)
+		return 0;
+
+	if (!benchmark_save_json(output, results))
+		return 2;
+	std::cout << "Results written in " << output << std::endl;
+	return 0;
+}
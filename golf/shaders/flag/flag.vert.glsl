@@ -19,6 +19,7 @@ out struct fragment_data
 
 // Uniform variables expected to receive from the C++ program
 uniform mat4 model; // Model affine transform matrix associated to the current shape
+uniform mat4 modelNormal; // Normal matrix transpose(inverse(model)), computed on the CPU
 uniform mat4 view;  // View matrix (rigid transform) of the camera
 uniform mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
 uniform float time;
@@ -35,7 +36,6 @@ void main()
     pos.x += sin(vertex_uv.x * 10.0 + time * 2.0) * wave_intensity * 0.3;
 
     vec4 position = model * vec4(pos, 1.0);
-    mat4 modelNormal = transpose(inverse(model));
     vec4 normal = modelNormal * vec4(vertex_normal, 0.0);
 
 	fragment.position = position.xyz;
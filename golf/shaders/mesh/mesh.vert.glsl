@@ -19,6 +19,7 @@ out struct fragment_data
 
 // Uniform variables expected to receive from the C++ program
 uniform mat4 model; // Model affine transform matrix associated to the current shape
+uniform mat4 modelNormal; // Normal matrix transpose(inverse(model)), computed on the CPU
 uniform mat4 view;  // View matrix (rigid transform) of the camera
 uniform mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
 
@@ -30,7 +31,6 @@ void main()
 	vec4 position = model * vec4(vertex_position, 1.0);
 
 	// The normal of the vertex in the world space
-	mat4 modelNormal = transpose(inverse(model));
 	vec4 normal = modelNormal * vec4(vertex_normal, 0.0);
 
 	// The projected position of the vertex in the normalized device coordinates:
@@ -10,6 +10,10 @@ bool project::fps_limiting = true;
 float project::fps_max=60.0f;
 // Automatic synchronization of GLFW with the vertical-monitor refresh
 bool project::vsync=true;     
+// Run the simulation of the ball on a separate thread
+bool project::simulation_thread=true;
+// Recompile the shaders when their files are modified (a thread polls the files)
+bool project::shader_hot_reload=true;
 // Initial dimension of the OpenGL window (ratio if in [0,1], and absolute pixel size if > 1)
 float project::initial_window_size_width  = 0.5f; 
 float project::initial_window_size_height = 0.5f;
@@ -55,6 +55,12 @@ struct project {
 	static float fps_max; // Maximal default FPS (used only of fps_max is true)
 	static bool vsync; // Automatic synchronization of GLFW with the vertical-monitor refresh
 
+	// Run the simulation of the ball on a separate thread (computed on the render thread otherwise)
+	static bool simulation_thread;
+
+	// Recompile the shaders when their files are modified
+	static bool shader_hot_reload;
+
 	// Initial window size: expressed as ratio of screen in [0,1], or absolute pixel value if > 1
 	static float initial_window_size_width;
 	static float initial_window_size_height;
@@ -12,70 +12,159 @@ void scene_structure::initialize_camera()
 	camera_control.look_at(cam_init, ball_position);
 }
 
+// The assets are loaded asynchronously with load_asset(name, load):
+//  load() is run on a worker thread (file decoding, mesh generation) and returns the upload function, called later on the main thread (OpenGL calls).
+//  The data passed from one to the other is held by shared pointers captured in the upload function.
+
 void scene_structure::initialize_skybox()
 {
-	image_structure image_skybox_template = image_load_file(project::path + "assets/skybox_02.jpg");
-	std::vector<image_structure> image_grid = image_split_grid(image_skybox_template, 4, 3);
-	skybox.initialize_data_on_gpu();
-	skybox.texture.initialize_cubemap_on_gpu(image_grid[1], image_grid[7], image_grid[5], image_grid[3], image_grid[10], image_grid[4]);
-	skybox.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+	load_asset("skybox", [this]() {
+		// The cubemap faces are split from the 4x3 atlas only once, then read from the baked cache
+		std::string const filename = project::path + "assets/skybox_02.jpg";
+		auto cubemap = std::make_shared<image_baked>();
+		if (image_baked_cache_is_valid(filename))
+			*cubemap = image_baked_load(image_baked_cache_filename(filename));
+		if (cubemap->face_count != 6) {
+			// The faces are read in place in the atlas (views): no copy of the 12 sub-images
+			image_structure image_skybox_template = image_load_file(filename);
+			std::vector<image_view> grid = image_split_grid_view(image_skybox_template, 4, 3);
+			*cubemap = image_bake_cubemap(grid[1], grid[7], grid[5], grid[3], grid[10], grid[4]);
+			if (image_baked_cache::active)
+				image_baked_save(image_baked_cache_filename(filename), *cubemap);
+		}
+		return std::function<void()>([this, cubemap]() {
+			skybox.initialize_data_on_gpu();
+			skybox.texture.initialize_cubemap_on_gpu(*cubemap);
+			skybox.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+		});
+	});
 }
 
 void scene_structure::initialize_terrain()
 {
-	int N_terrain_samples = 100;
-	float terrain_length_x = 80;
-	float terrain_length_y = 30;
-	mesh const terrain_mesh = create_terrain_mesh(N_terrain_samples, terrain_length_x, terrain_length_y);
-	terrain.initialize_data_on_gpu(terrain_mesh);
-	terrain.material.color = {1.0f, 1.0f, 1.0f};
-	terrain.material.phong.specular = 0.0f;
-	terrain.texture.load_and_initialize_texture_2d_on_gpu("assets/texture_grass.jpg", GL_REPEAT, GL_REPEAT);
+	load_asset("terrain", [this]() {
+		int N_terrain_samples = 100;
+		float terrain_length_x = 80;
+		float terrain_length_y = 30;
+		auto terrain_mesh = memory_tracked_mesh(create_terrain_mesh(N_terrain_samples, terrain_length_x, terrain_length_y));
+		mesh_optimization_report const report = mesh_optimize(*terrain_mesh);
+		if (mesh_optimization::verbose)
+			std::cout << "[mesh_optimize] terrain " << str(report) << std::endl;
+		auto image = std::make_shared<image_baked>(image_load_file_baked("assets/texture_grass.jpg"));
+		return std::function<void()>([this, terrain_mesh, image]() {
+			terrain.initialize_data_on_gpu(*terrain_mesh);
+			terrain.material.color = {1.0f, 1.0f, 1.0f};
+			terrain.material.phong.specular = 0.0f;
+			terrain.texture.initialize_texture_2d_on_gpu(*image, GL_REPEAT, GL_REPEAT);
+		});
+	});
 }
 
 void scene_structure::initialize_water()
 {
-	float sea_w = 25.0f;
-	float sea_z = -0.5f;
-	int N_sea_samples = 100;
-	water.initialize_data_on_gpu(create_sea_mesh(N_sea_samples, sea_w, sea_w));
-	water.texture.load_and_initialize_texture_2d_on_gpu("assets/sea2.jpg");
-	water.model.translation = {-12.5, -2.5, sea_z};
-	water.material.alpha = 0.8f;
-	water.material.phong = {0.4f, 0.6f, 0.5f};
+	load_asset("water", [this]() {
+		float sea_w = 25.0f;
+		int N_sea_samples = 100;
+		auto sea_mesh = memory_tracked_mesh(create_sea_mesh(N_sea_samples, sea_w, sea_w));
+		auto image = std::make_shared<image_baked>(image_load_file_baked("assets/sea2.jpg"));
+		return std::function<void()>([this, sea_mesh, image]() {
+			float sea_z = -0.5f;
+			water.initialize_data_on_gpu(*sea_mesh);
+			water.texture.initialize_texture_2d_on_gpu(*image);
+			water.model.translation = {-12.5, -2.5, sea_z};
+			water.material.alpha = 0.8f;
+			water.material.phong = {0.4f, 0.6f, 0.5f};
+		});
+	});
 }
 
 void scene_structure::initialize_circle()
 {
-	mesh circle_mesh = mesh_primitive_disc(4.0f, vec3{-15.0f, 5.0f, 0.02f}, vec3{0.0f, 0.0f, 1.0f}, 60);
-	circle.initialize_data_on_gpu(circle_mesh);
-	circle.texture.load_and_initialize_texture_2d_on_gpu("assets/green.jpg", GL_REPEAT, GL_REPEAT);
-	circle.material.color = {1.0f, 1.0f, 1.0f};
-	circle.material.phong = {0.3f, 0.6f, 0.2f};
+	load_asset("circle", [this]() {
+		auto circle_mesh = memory_tracked_mesh(mesh_primitive_disc(4.0f, vec3{-15.0f, 5.0f, 0.02f}, vec3{0.0f, 0.0f, 1.0f}, 60));
+		auto image = std::make_shared<image_baked>(image_load_file_baked("assets/green.jpg"));
+		return std::function<void()>([this, circle_mesh, image]() {
+			circle.initialize_data_on_gpu(*circle_mesh);
+			circle.texture.initialize_texture_2d_on_gpu(*image, GL_REPEAT, GL_REPEAT);
+			circle.material.color = {1.0f, 1.0f, 1.0f};
+			circle.material.phong = {0.3f, 0.6f, 0.2f};
+		});
+	});
+}
+
+void scene_structure::initialize_vegetation()
+{
+	// The vegetation species share a texture array (one layer per species) and are drawn with a single instanced draw call
+	//  Each instance is a vec4 (position, layer) sent as a per-instance attribute
+	// Note: generate_positions_on_terrain uses the global random generator, no other job should use it concurrently
+	load_asset("vegetation", [this]() {
+		auto images = std::make_shared<std::vector<image_baked>>();
+		images->push_back(image_load_file_baked("assets/grass.png"));      // layer 0
+		images->push_back(image_load_file_baked("assets/redflowers.png")); // layer 1
+
+		// Same grass as before the texture array (8000 candidate positions), and the flowers are added on top
+		std::vector<vec3> const grass_position = generate_positions_on_terrain(8000, 70, 30);
+		std::vector<vec3> const flower_position = generate_positions_on_terrain(1000, 70, 30);
+		auto instance = std::make_shared<numarray<vec4>>();
+		instance->reserve(int(grass_position.size() + flower_position.size()));
+		vec3 const offset = {0, 0, 0.02f};
+		for (vec3 const& p : grass_position)
+			instance->push_back(vec4(p - offset, 0.0f));
+		for (vec3 const& p : flower_position)
+			instance->push_back(vec4(p - offset, 1.0f));
+
+		return std::function<void()>([this, images, instance]() {
+			vegetation_texture.initialize_array_on_gpu(*images);
+			vegetation.initialize_data_on_gpu(mesh_primitive_quadrangle({-0.5f, 0, 0}, {0.5f, 0, 0}, {0.5f, 0, 1}, {-0.5f, 0, 1}));
+			vegetation.texture = vegetation_texture.texture;
+			vegetation.shader.load(project::path + "shaders/vegetation/vegetation.vert.glsl", project::path + "shaders/mesh_texture_array/mesh_texture_array.frag.glsl");
+			vegetation.initialize_supplementary_data_on_gpu(*instance, 4, 1);
+			vegetation.material.phong = {0.4f, 0.6f, 0, 1};
+			vegetation.model.scaling = 0.6f;
+			vegetation_instance_count = int(instance->size());
+		});
+	});
 }
 
-void scene_structure::initialize_grass()
+// Load an OBJ file with its levels of details (run on a worker thread)
+//  The OBJ is parsed and decimated only if its binary cache is missing or outdated, otherwise the cache is mapped in memory
+static std::shared_ptr<mesh_binary> load_tree_part(std::string const& filename)
 {
-	grass.initialize_data_on_gpu(mesh_primitive_quadrangle({-0.5f, 0, 0}, {0.5f, 0, 0}, {0.5f, 0, 1}, {-0.5f, 0, 1}));
-	grass.texture.load_and_initialize_texture_2d_on_gpu("assets/grass.png");
-	grass.material.phong = {0.4f, 0.6f, 0, 1};
-	grass.model.scaling = 0.6f;
-	grass_position = generate_positions_on_terrain(8000, 70, 30);
+	return std::make_shared<mesh_binary>(mesh_load_file_obj_binary(filename, 4));
 }
 
 void scene_structure::initialize_trees()
 {
-	trunk.initialize_data_on_gpu(mesh_load_file_obj(project::path + "assets/trunk.obj"));
-	trunk.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/trunk.png");
-	branches.initialize_data_on_gpu(mesh_load_file_obj(project::path + "assets/branches.obj"));
-	branches.material.color = {0.45f, 0.41f, 0.34f};
-	foliage.initialize_data_on_gpu(mesh_load_file_obj(project::path + "assets/foliage.obj"));
-	foliage.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/pine.png");
-	foliage.shader.load(project::path + "shaders/mesh_transparency/mesh_transparency.vert.glsl", project::path + "shaders/mesh_transparency/mesh_transparency.frag.glsl");
-	foliage.material.phong = {0.4f, 0.6f, 0, 1};
-	trunk.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
-	branches.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
-	foliage.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+	// Each part of the tree is parsed and decimated in its own job
+	load_asset("tree trunk", [this]() {
+		auto part = load_tree_part(project::path + "assets/trunk.obj");
+		auto image = std::make_shared<image_baked>(image_load_file_baked(project::path + "assets/trunk.png"));
+		return std::function<void()>([this, part, image]() {
+			trunk.initialize_data_on_gpu(*part);
+			trunk.texture.initialize_texture_2d_on_gpu(*image);
+			trunk.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+		});
+	});
+	load_asset("tree branches", [this]() {
+		auto part = load_tree_part(project::path + "assets/branches.obj");
+		return std::function<void()>([this, part]() {
+			branches.initialize_data_on_gpu(*part);
+			branches.material.color = {0.45f, 0.41f, 0.34f};
+			branches.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+		});
+	});
+	load_asset("tree foliage", [this]() {
+		auto part = load_tree_part(project::path + "assets/foliage.obj");
+		auto image = std::make_shared<image_baked>(image_load_file_baked(project::path + "assets/pine.png"));
+		return std::function<void()>([this, part, image]() {
+			foliage.initialize_data_on_gpu(*part);
+			foliage.texture.initialize_texture_2d_on_gpu(*image);
+			foliage.shader.load(project::path + "shaders/mesh_transparency/mesh_transparency.vert.glsl", project::path + "shaders/mesh_transparency/mesh_transparency.frag.glsl");
+			foliage.material.phong = {0.4f, 0.6f, 0, 1};
+			foliage.model.rotation = rotation_transform::from_axis_angle({1, 0, 0}, 1.5709);
+		});
+	});
+
 	tree_position = {
 		{18.0f, 9.0f, evaluate_terrain_height(18.0f, 9.0f)},
 		{11.0f, 7.0f, evaluate_terrain_height(11.0f, 7.0f)},
@@ -93,13 +182,18 @@ void scene_structure::initialize_trees()
 
 void scene_structure::initialize_flag()
 {
-	mesh flag_pole_mesh = mesh_primitive_cylinder(0.02f, {-17.0f, 6.0f, 0.0f}, {-17.0f, 6.0f, 2.0f}, 20, 5, true);
-	mesh flag_mesh = mesh_primitive_quadrangle({-17.0f, 6.0f, 1.5f}, {-17.0f, 6.7f, 1.5f}, {-17.0f, 6.7f, 2.0f}, {-17.0f, 6.0f, 2.0f});
-	flag_pole.initialize_data_on_gpu(flag_pole_mesh);
-	flag.initialize_data_on_gpu(flag_mesh);
-	flag.shader.load("shaders/flag/flag.vert.glsl", "shaders/flag/flag.frag.glsl");
-	flag_pole.material.color = {0.7f, 0.7f, 0.7f};
-	flag.texture.load_and_initialize_texture_2d_on_gpu("assets/epfl.png");
+	load_asset("flag", [this]() {
+		auto image = std::make_shared<image_baked>(image_load_file_baked("assets/epfl.png"));
+		return std::function<void()>([this, image]() {
+			mesh flag_pole_mesh = mesh_primitive_cylinder(0.02f, {-17.0f, 6.0f, 0.0f}, {-17.0f, 6.0f, 2.0f}, 20, 5, true);
+			mesh flag_mesh = mesh_primitive_quadrangle({-17.0f, 6.0f, 1.5f}, {-17.0f, 6.7f, 1.5f}, {-17.0f, 6.7f, 2.0f}, {-17.0f, 6.0f, 2.0f});
+			flag_pole.initialize_data_on_gpu(flag_pole_mesh);
+			flag.initialize_data_on_gpu(flag_mesh);
+			flag.shader.load("shaders/flag/flag.vert.glsl", "shaders/flag/flag.frag.glsl");
+			flag_pole.material.color = {0.7f, 0.7f, 0.7f};
+			flag.texture.initialize_texture_2d_on_gpu(*image);
+		});
+	});
 }
 
 void scene_structure::initialize_hole()
@@ -111,8 +205,13 @@ void scene_structure::initialize_hole()
 
 void scene_structure::initialize_ball()
 {
-	ball_position = {31.0f, 0.0f, 1.0f};
-	ball_velocity = {0.0f, 0.0f, 0.0f};
+	simulation_state initial_state;
+	initial_state.ball_position = {31.0f, 0.0f, 1.0f};
+	initial_state.ball_velocity = {0.0f, 0.0f, 0.0f};
+	simulation.parameters.ball_radius = ball_radius;
+	simulation.initialize(initial_state);
+
+	ball_position = initial_state.ball_position;
 	mesh ball_mesh = mesh_primitive_sphere(ball_radius);
 	ball.initialize_data_on_gpu(ball_mesh);
 	ball.material.color = {0.90f, 0.90f, 0.90f};
@@ -4,11 +4,16 @@
 #include "environment.hpp" // The general scene environment + project variable
 #include <iostream> 
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
 // Custom scene of this code
 #include "scene.hpp"
+#include "replay.hpp"
 
 
 
@@ -29,78 +34,216 @@ window_structure standard_window_initialization();
 void initialize_default_shaders();
 void animation_loop();
 void display_gui_default();
+void display_loading_screen();
+void wait_loading();
+int render_camera_path(replay_script const& script, std::string const& directory, int width, int height);
+int run_benchmark(replay_script const& script, std::string const& output_filename, int width, int height, std::string const& capture_format_name, std::string const& capture_directory);
+void toggle_recording();
 
 timer_fps fps_record;
+frame_pacer frame_pacing;
 
-int main(int, char* argv[])
+// Average frame time (ms) measured with each OpenGL error reporting mode, to compare their cost
+float frame_time_per_error_mode[4] = { 0,0,0,0 };
+
+// Measure of the time to first frame (from the start of the program to the first displayed frame of the scene)
+std::chrono::steady_clock::time_point const program_start = std::chrono::steady_clock::now();
+bool first_frame_displayed = false;
+
+// Screenshots (shift+P) and recording (shift+R) of the scene, written in capture/
+frame_capture capture;
+frame_capture_format capture_format = frame_capture_format::raw;
+bool screenshot_requested = false;
+int screenshot_count = 0;
+
+// Headless modes (capture of a camera path, benchmark): OpenGL context without window
+offscreen_context offscreen;
+
+// Recording of the camera and keyboard of an interactive session, to be replayed by the headless modes (--record-script)
+replay_script input_recording;
+std::string input_recording_filename;
+std::chrono::steady_clock::time_point input_recording_start;
+bool input_recording_started = false;
+float input_recording_time();
+
+int main(int argc, char* argv[])
 {
 	std::cout << "Run " << argv[0] << std::endl;
-
-	
+	profile_thread_name_cgp("main");
+
+	// Headless modes: replay a script offscreen, then exit
+	//  Render the camera path and save every frame:
+	//    ./golf --capture-path assets/camera_path.txt --capture-dir capture/
+	//  Benchmark (per-frame CPU/GPU times and image checksums):
+	//    ./golf --benchmark assets/benchmark_replay.txt --benchmark-output benchmark.csv
+	//    Record the frames during the benchmark, as the interactive recording (frames dropped if the encoders are busy): --benchmark-capture raw|png|jpg (in --capture-dir)
+	//  Options: --backend automatic|egl_surfaceless|egl_pbuffer|glfw_hidden_window, --size 1280x720
+	//  Record a script from an interactive session: ./golf --record-script my_replay.txt
+	//  Export the profiler zones at exit (Chrome trace format): ./golf --trace profile.json
+	//  Export the GPU time of the render passes at exit (CSV, one row per frame): ./golf --gpu-passes gpu_passes.csv
+	//  Memory budgets in MB (GPU, CPU meshes, upload per frame; 0 for no budget): ./golf --memory-budget 256,64,16
+	//    Exceeding a budget is a warning in the interactive mode, and an error in the headless modes.
+	std::string capture_path_filename;
+	std::string capture_directory = "capture/";
+	std::string benchmark_filename;
+	std::string benchmark_output = "benchmark.csv";
+	std::string benchmark_capture;
+	offscreen_backend backend = offscreen_backend::automatic;
+	int headless_width = 1280;
+	int headless_height = 720;
+	std::string trace_filename;
+	std::string gpu_passes_filename;
+	float budget_mb[3] = { 0, 0, 0 };
+	for (int k = 1; k + 1 < argc; ++k) {
+		std::string const arg = argv[k];
+		if (arg == "--capture-path")
+			capture_path_filename = argv[k + 1];
+		if (arg == "--capture-dir")
+			capture_directory = argv[k + 1];
+		if (arg == "--benchmark")
+			benchmark_filename = argv[k + 1];
+		if (arg == "--benchmark-output")
+			benchmark_output = argv[k + 1];
+		if (arg == "--benchmark-capture")
+			benchmark_capture = argv[k + 1];
+		if (arg == "--backend")
+			backend = offscreen_backend_from_string(argv[k + 1]);
+		if (arg == "--size")
+			std::sscanf(argv[k + 1], "%dx%d", &headless_width, &headless_height);
+		if (arg == "--record-script")
+			input_recording_filename = argv[k + 1];
+		if (arg == "--trace")
+			trace_filename = argv[k + 1];
+		if (arg == "--gpu-passes")
+			gpu_passes_filename = argv[k + 1];
+		if (arg == "--memory-budget")
+			std::sscanf(argv[k + 1], "%f,%f,%f", &budget_mb[0], &budget_mb[1], &budget_mb[2]);
+	}
+	bool const headless = !capture_path_filename.empty() || !benchmark_filename.empty();
+	memory_registry::budget_gpu = size_t(budget_mb[0] * 1024 * 1024);
+	memory_registry::budget_cpu = size_t(budget_mb[1] * 1024 * 1024);
+	memory_registry::budget_upload = size_t(budget_mb[2] * 1024 * 1024);
+	memory_registry::budget_strict = headless;
+
+	replay_script script;
+	if (headless) {
+		std::string const script_filename = benchmark_filename.empty() ? capture_path_filename : benchmark_filename;
+		if (!script.load(script_filename)) {
+			std::cerr << "Cannot read the replay script " << script_filename << std::endl;
+			return 1;
+		}
+	}
 
 	// ************************ //
 	//     INITIALISATION
 	// ************************ //
 	
-	// Standard Initialization of an OpenGL ready window
-	scene.window = standard_window_initialization();
+	// Standard Initialization of an OpenGL ready window (or of an offscreen context in the headless modes)
+	if (headless) {
+		if (!offscreen.initialize(backend, CGP_OPENGL_VERSION_MAJOR, CGP_OPENGL_VERSION_MINOR))
+			return 1;
+		std::cout << "Offscreen context: " << offscreen.description() << std::endl;
+		scene.window.width = headless_width;
+		scene.window.height = headless_height;
+	}
+	else
+		scene.window = standard_window_initialization();
 
 	// Initialize default path for assets
 	project::path = cgp::project_path_find(argv[0], "shaders/");
 
 	// Initialize default shaders
 	initialize_default_shaders();
+#ifndef __EMSCRIPTEN__
+	if (project::shader_hot_reload && !headless)
+		opengl_shader_hot_reload_start();
+#endif
 
 
-	// Custom scene initialization
+	// Custom scene initialization (the assets continue to load during the first frames)
 	std::cout << "Initialize data of the scene ..." << std::endl;
 	scene.initialize();
-	std::cout << "Initialization finished\n" << std::endl;
 
 
 	// ************************ //
 	//     Animation Loop
 	// ************************ //
-	std::cout << "Start animation loop ..." << std::endl;
-	fps_record.start();
-
-
-	// Call the main display loop in the function animation_loop
-	//  The following part is simply a loop that call the function "animation_loop"
-	//  (This call is different when we compile in standard mode with GLFW, than when we compile with emscripten to output the result in a webpage.)
+	int exit_code = 0;
+	if (!benchmark_filename.empty())
+		exit_code = run_benchmark(script, benchmark_output, headless_width, headless_height, benchmark_capture, capture_directory);
+	else if (headless)
+		exit_code = render_camera_path(script, capture_directory, headless_width, headless_height);
+	else {
+		std::cout << "Start animation loop ..." << std::endl;
+		fps_record.start();
+
+
+		// Call the main display loop in the function animation_loop
+		//  The following part is simply a loop that call the function "animation_loop"
+		//  (This call is different when we compile in standard mode with GLFW, than when we compile with emscripten to output the result in a webpage.)
 #ifndef __EMSCRIPTEN__
-    double lasttime = glfwGetTime();
-	// Default mode to run the animation/display loop with GLFW in C++
-	while (!glfwWindowShouldClose(scene.window.glfw_window)) {
-		// The real animation loop
-		animation_loop();
-
-		// FPS limitation
-		if(project::fps_limiting){
-			while (glfwGetTime() < lasttime + 1.0 / project::fps_max) {	}
-        	lasttime = glfwGetTime();
+		GLFWvidmode const* video_mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+		frame_pacing.refresh_rate = video_mode!=nullptr? float(video_mode->refreshRate) : 0.0f;
+		frame_pacing.reset();
+		// Default mode to run the animation/display loop with GLFW in C++
+		while (!glfwWindowShouldClose(scene.window.glfw_window)) {
+			// The real animation loop
+			animation_loop();
+
+			// FPS limitation (sleep until the next frame deadline)
+			frame_pacing.fps_target = project::fps_limiting? project::fps_max : 0.0f;
+			frame_pacing.vsync = project::vsync;
+			frame_pacing.wait();
 		}
-	}
 #else
-	// Specific loop if compiled for EMScripten
-	emscripten_set_main_loop(animation_loop, 0, 1);
+		// Specific loop if compiled for EMScripten
+		emscripten_set_main_loop(animation_loop, 0, 1);
 #endif
 
-	std::cout << "\nAnimation loop stopped" << std::endl;
+		std::cout << "\nAnimation loop stopped" << std::endl;
+	}
 
 	// Cleanup
-	cgp::imgui_cleanup();
-	glfwDestroyWindow(scene.window.glfw_window);
-	glfwTerminate();
+	opengl_shader_hot_reload_stop();
+	capture.stop_recording();
+	capture.finish();
+	scene.simulation.stop_thread();
+	if (!trace_filename.empty() && profiler_export_chrome_trace(trace_filename))
+		std::cout << "Profiler trace saved in " << trace_filename << std::endl;
+	gpu_profiler_finish();
+	if (!gpu_passes_filename.empty() && gpu_profiler_export_csv(gpu_passes_filename))
+		std::cout << "GPU passes saved in " << gpu_passes_filename << std::endl;
+	gpu_profiler_cleanup();
+	memory_report_leaks();
+	if (!input_recording_filename.empty() && !input_recording.empty()) {
+		input_recording.save(input_recording_filename);
+		std::cout << "Replay script saved in " << input_recording_filename << std::endl;
+	}
+	if (headless)
+		offscreen.cleanup();
+	else {
+		cgp::imgui_cleanup();
+		glfwDestroyWindow(scene.window.glfw_window);
+		glfwTerminate();
+	}
 
-	return 0;
+	return exit_code;
 }
 
 void animation_loop()
 {
+	profile_frame_mark_cgp();
+	profile_zone_cgp("animation_loop");
+	gpu_profiler_frame_begin();
+	memory_frame_begin();
+	allocation_frame_begin();
+	memory_arena_frame_begin();
 
 	emscripten_update_window_size(scene.window.width, scene.window.height); // update window size in case of use of emscripten (not used by default)
 
+	// Swap the programs of the modified shaders before drawing the frame
+	opengl_shader_hot_reload_update();
+
 	scene.camera_projection.aspect_ratio = scene.window.aspect_ratio();
 	scene.environment.camera_projection = scene.camera_projection.matrix();
 	glViewport(0, 0, scene.window.width, scene.window.height);
@@ -111,7 +254,17 @@ void animation_loop()
 	glClear(GL_DEPTH_BUFFER_BIT);
 	glEnable(GL_DEPTH_TEST);
 
+	// Display a progress screen while the assets are loading
+	if (!scene.is_loaded()) {
+		display_loading_screen();
+		return;
+	}
+
 	float const time_interval = fps_record.update();
+	{
+		float& frame_time = frame_time_per_error_mode[int(opengl_error_reporting::mode)];
+		frame_time = frame_time == 0 ? 1000 * time_interval : 0.95f * frame_time + 0.05f * 1000 * time_interval;
+	}
 	if (fps_record.event) {
 		std::string const title = "CGP Display - " + str(fps_record.fps) + " fps";
 		glfwSetWindowTitle(scene.window.glfw_window, title.c_str());
@@ -130,14 +283,61 @@ void animation_loop()
 
 	// Handle camera behavior in standard frame
 	scene.idle_frame();
+	if (!input_recording_filename.empty())
+		input_recording.record_camera(input_recording_time(), scene.camera_control.camera_model.position(), scene.camera_control.camera_model.center_of_rotation);
 
 	// Call the display of the scene
 	scene.display_frame();
 
+	// Capture the scene before the GUI is drawn on top of it (the pixels are written a few frames later)
+	if (screenshot_requested) {
+		capture.screenshot(project::path + "capture/screenshot_" + str(screenshot_count++) + ".png", scene.window.width, scene.window.height);
+		screenshot_requested = false;
+	}
+	capture.record_frame(scene.window.width, scene.window.height);
+	capture.update();
+
 
 	// End of ImGui display and handle GLFW events
 	ImGui::End();
+	{
+		profile_zone_cgp("imgui");
+		profile_gpu_zone_cgp("gui");
+		imgui_render_frame(scene.window.glfw_window);
+	}
+	opengl_error_frame_check();
+	{
+		profile_zone_cgp("swap buffers");
+		glfwSwapBuffers(scene.window.glfw_window);
+	}
+	scene.frame_presented();
+	glfwPollEvents();
+
+	if (!first_frame_displayed) {
+		first_frame_displayed = true;
+		scene.display_loading_report(std::chrono::duration<float>(std::chrono::steady_clock::now() - program_start).count());
+		std::cout << "[shaders] " << opengl_shader_binary_cache_statistics() << "\n" << std::endl;
+	}
+}
+
+void display_loading_screen()
+{
+	// OpenGL uploads of the assets that are ready, within the frame budget
+	scene.update_loading();
+	if (scene.is_loaded())
+		std::cout << "Initialization finished\n" << std::endl;
+
+	imgui_create_frame();
+	ImGui::GetIO().FontGlobalScale = project::gui_scale;
+	ImGui::SetNextWindowPos(ImVec2(0.5f * scene.window.width, 0.5f * scene.window.height), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+	ImGui::Begin("Loading", NULL, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings);
+	ImGui::Text("Loading assets ...");
+	std::string const progress = str(int(scene.asset_report.size())) + "/" + str(scene.asset_count);
+	ImGui::ProgressBar(scene.loading_progress(), ImVec2(300, 0), progress.c_str());
+	ImGui::End();
 	imgui_render_frame(scene.window.glfw_window);
+
+	opengl_error_frame_check();
 	glfwSwapBuffers(scene.window.glfw_window);
 	glfwPollEvents();
 }
@@ -265,6 +465,8 @@ void keyboard_callback(GLFWwindow* window, int key, int scancode, int action, in
 	if(!imgui_capture_keyboard){
 		scene.inputs.keyboard.update_from_glfw_key(key, action);
 		scene.keyboard_event();
+		if (!input_recording_filename.empty() && scene.is_loaded())
+			input_recording.record_key(input_recording_time(), key, action);
 
 		// Press 'F' for full screen mode
 		if (key == GLFW_KEY_F && action == GLFW_PRESS && scene.inputs.keyboard.shift) {
@@ -274,6 +476,11 @@ void keyboard_callback(GLFWwindow* window, int key, int scancode, int action, in
 			else
 				scene.window.set_windowed_screen();
 		}
+		// Press 'P' for a screenshot, 'R' to start/stop the recording
+		if (key == GLFW_KEY_P && action == GLFW_PRESS && scene.inputs.keyboard.shift)
+			screenshot_requested = true;
+		if (key == GLFW_KEY_R && action == GLFW_PRESS && scene.inputs.keyboard.shift)
+			toggle_recording();
 		// Press 'V' for camera frame/view matrix debug
 		if (key == GLFW_KEY_V && action == GLFW_PRESS && scene.inputs.keyboard.shift) {
 			auto const camera_model = scene.camera_control.camera_model;
@@ -318,6 +525,8 @@ void display_gui_default()
 		if(project::fps_limiting){
 			ImGui::SliderFloat("FPS limit",&project::fps_max, 10, 250);
 		}
+		std::string const pacing = "Frame time: "+str(frame_pacing.statistics());
+		ImGui::Text( pacing.c_str(), "%s" );
 #endif
 		// vsync is the default synchronization of frame refresh with the screen frequency
 		//   vsync may or may not be enforced by your GPU driver and OS (on top of the GLFW request).
@@ -334,4 +543,324 @@ void display_gui_default()
 
 		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
 	}
-}
\ No newline at end of file
+#ifndef __EMSCRIPTEN__
+	if(ImGui::CollapsingHeader("Shaders")) {
+		ImGui::Indent();
+		if(ImGui::Checkbox("Hot reload", &project::shader_hot_reload))
+			project::shader_hot_reload ? opengl_shader_hot_reload_start() : opengl_shader_hot_reload_stop();
+		std::string const cache = opengl_shader_binary_cache_statistics();
+		ImGui::TextWrapped("%s", cache.c_str());
+		if(opengl_shader_hot_reload::reload_count > 0) {
+			std::string const reload = str(opengl_shader_hot_reload::reload_count)+" reloads, last: "+str(int(1000*opengl_shader_hot_reload::last_reload_time))+"ms";
+			ImGui::Text(reload.c_str(), "%s");
+		}
+		ImGui::Unindent();
+		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
+	}
+#endif
+	if(ImGui::CollapsingHeader("Capture")) {
+		ImGui::Indent();
+		// raw is the only format fast enough for a 60 fps recording: the frames are encoded afterward with ffmpeg
+		int format = int(capture_format);
+		char const* format_names[] = { "png", "jpg", "raw (ffmpeg)" };
+		if(!capture.is_recording() && ImGui::Combo("Format", &format, format_names, 3))
+			capture_format = frame_capture_format(format);
+		if(ImGui::Button(capture.is_recording()? "Stop recording (shift+R)" : "Start recording (shift+R)"))
+			toggle_recording();
+		if(ImGui::Button("Screenshot (shift+P)"))
+			screenshot_requested = true;
+		if(capture.is_recording()) {
+			std::string const stats = str(capture.frame_count())+" frames, "+str(capture.dropped_count())+" dropped, "+str(capture.stall_count())+" stalls";
+			ImGui::Text(stats.c_str(), "%s");
+		}
+		ImGui::Unindent();
+		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
+	}
+	if(ImGui::CollapsingHeader("Profiler")) {
+		ImGui::Indent();
+		profiler_display_imgui(project::path + "capture/profile.json");
+		ImGui::Spacing();
+		gpu_profiler_display_imgui(project::path + "capture/gpu_passes.csv");
+		ImGui::Unindent();
+		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
+	}
+	if(ImGui::CollapsingHeader("Memory")) {
+		ImGui::Indent();
+		memory_display_imgui();
+		ImGui::Unindent();
+		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
+	}
+	if(ImGui::CollapsingHeader("OpenGL errors")) {
+		ImGui::Indent();
+		// Strict mode calls glGetError after each OpenGL call: use it to locate an error, not for performance
+		int mode = int(opengl_error_reporting::mode);
+		char const* mode_names[] = { "disabled", "debug callback", "sampled", "strict" };
+		if(ImGui::Combo("Mode", &mode, mode_names, 4))
+			opengl_error_set_mode(opengl_error_mode(mode));
+		if(opengl_error_reporting::mode==opengl_error_mode::sampled)
+			ImGui::SliderInt("Sample period (frames)", &opengl_error_reporting::sample_period, 1, 240);
+		if(!opengl_error_reporting::debug_callback_available)
+			ImGui::Text("GL_KHR_debug not available");
+
+		std::string const errors = "Errors detected: "+str(opengl_error_reporting::error_count);
+		ImGui::Text(errors.c_str(), "%s");
+		for(int k=0; k<4; ++k) {
+			if(frame_time_per_error_mode[k]>0) {
+				std::string const txt = std::string(mode_names[k])+": "+str(frame_time_per_error_mode[k])+" ms/frame";
+				ImGui::Text(txt.c_str(), "%s");
+			}
+		}
+		ImGui::Unindent();
+		ImGui::Spacing();ImGui::Separator();ImGui::Spacing();
+	}
+}
+
+
+void toggle_recording()
+{
+	if (capture.is_recording()) {
+		capture.stop_recording();
+		return;
+	}
+	std::string const directory = project::path + "capture/";
+	if (!check_path_exist(directory)) {
+		std::cout << "Cannot record: the directory " << directory << " does not exist" << std::endl;
+		return;
+	}
+	capture.framerate = project::fps_limiting ? project::fps_max : frame_pacing.refresh_rate;
+	capture.start_recording(directory, capture_format);
+}
+
+float input_recording_time()
+{
+	// The recorded times start at the first frame of the loaded scene, as in the replay
+	if (!input_recording_started) {
+		input_recording_start = std::chrono::steady_clock::now();
+		input_recording_started = true;
+	}
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - input_recording_start).count();
+}
+
+// Upload all the assets before replaying a script (headless modes)
+void wait_loading()
+{
+	while (!scene.is_loaded()) {
+		scene.update_loading();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// Frame k of a replay: apply the key events and the simulation time, update the scene, and set the camera of the script
+//  The simulation runs inline on a manual clock: the frames only depend on the script and on the fixed time step.
+void replay_frame(replay_script const& script, int k_frame, float fps, int width, int height)
+{
+	float const t = k_frame / fps;
+	float const t_previous = k_frame == 0 ? -1.0f : (k_frame - 1) / fps;
+	for (replay_key_event const& event : script.keys_between(t_previous, t)) {
+		scene.inputs.keyboard.update_from_glfw_key(event.key, event.action);
+		scene.keyboard_event();
+	}
+
+	scene.simulation.set_manual_time(t);
+	scene.inputs.time_interval = 1.0f / fps;
+	scene.idle_frame();
+
+	vec3 eye, center;
+	if (script.camera_at(t, eye, center)) {
+		scene.camera_control.look_at(eye, center);
+		scene.environment.camera_view = scene.camera_control.camera_model.matrix_view();
+	}
+	scene.camera_projection.aspect_ratio = width / float(height);
+	scene.environment.camera_projection = scene.camera_projection.matrix();
+}
+
+void render_frame_offscreen(opengl_fbo_structure const& fbo, int width, int height)
+{
+	fbo.bind();
+	glViewport(0, 0, width, height);
+	vec3 const& background_color = scene.environment.background_color;
+	glClearColor(background_color.x, background_color.y, background_color.z, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_DEPTH_TEST);
+	scene.display_frame();
+	fbo.unbind();
+}
+
+// Headless mode: render the scene along a camera path in an offscreen framebuffer, and save every frame (lossless: no frame is dropped)
+//  The frames are rendered at a fixed time step (see replay.hpp for the format of the script).
+int render_camera_path(replay_script const& script, std::string const& directory, int width, int height)
+{
+	if (!check_path_exist(directory)) {
+		std::cerr << "The capture directory " << directory << " does not exist" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Render the camera path in " << directory << " ..." << std::endl;
+	wait_loading();
+	project::simulation_thread = false;
+	scene.simulation.stop_thread();
+
+	float const fps = 60.0f;
+	opengl_fbo_structure fbo;
+	fbo.initialize();
+	fbo.update_screen_size(width, height);
+
+	capture.lossless = true;
+	capture.framerate = fps;
+	capture.start_recording(directory, frame_capture_format::png);
+
+	int const N_frame = int(script.duration() * fps) + 1;
+	for (int k_frame = 0; k_frame < N_frame; ++k_frame) {
+		profile_frame_mark_cgp();
+		gpu_profiler_frame_begin();
+		memory_frame_begin();
+		allocation_frame_begin();
+		memory_arena_frame_begin();
+		replay_frame(script, k_frame, fps, width, height);
+		render_frame_offscreen(fbo, width, height);
+		scene.frame_presented();
+
+		capture.record_frame(fbo);
+		capture.update();
+		opengl_error_frame_check();
+	}
+	capture.stop_recording();
+	return 0;
+}
+
+static float percentile(std::vector<float> values, float p)
+{
+	if (values.empty())
+		return 0.0f;
+	std::sort(values.begin(), values.end());
+	return values[std::min(values.size() - 1, size_t(p * (values.size() - 1) + 0.5f))];
+}
+
+// Benchmark mode: replay a script offscreen, and write for each frame the CPU time (idle_frame + draw calls submission),
+//  the GPU time (GL_TIMESTAMP queries around the rendering), the heap allocations during the CPU time (all the threads),
+//  and a checksum of the image (FNV-1a of the RGBA pixels).
+//  With the same driver (ex. LIBGL_ALWAYS_SOFTWARE=1 on Mesa llvmpipe), the checksums are identical between two runs: a different
+//  checksum indicates a visual change.
+//  If capture_format_name is png, jpg or raw, the frames are recorded in capture_directory during the benchmark, with the settings of the
+//  interactive recording: the CPU time of each frame includes the capture (read back request and retrieval of the previous frames).
+int run_benchmark(replay_script const& script, std::string const& output_filename, int width, int height, std::string const& capture_format_name, std::string const& capture_directory)
+{
+	std::cout << "Benchmark " << width << "x" << height << " ..." << std::endl;
+	bool const capture_frames = !capture_format_name.empty();
+	if (capture_frames) {
+		char const* format_names[] = { "png", "jpg", "raw" };
+		int const format = int(std::find(format_names, format_names + 3, capture_format_name) - format_names);
+		if (format == 3) {
+			std::cerr << "Unknown capture format " << capture_format_name << " (expected png, jpg or raw)" << std::endl;
+			return 1;
+		}
+		if (!check_path_exist(capture_directory)) {
+			std::cerr << "The capture directory " << capture_directory << " does not exist" << std::endl;
+			return 1;
+		}
+		capture_format = frame_capture_format(format);
+	}
+	wait_loading();
+	project::simulation_thread = false;
+	scene.simulation.stop_thread();
+	allocation_statistics const initialization = allocation_totals();
+
+	float const fps = 60.0f;
+	int const N_frame = int(script.duration() * fps) + 1;
+	opengl_fbo_structure fbo;
+	fbo.initialize();
+	fbo.update_screen_size(width, height);
+
+	// Two timestamps per frame (GL_TIME_ELAPSED queries are not reliable on all the software drivers)
+	std::vector<GLuint> queries(2 * N_frame);
+	glGenQueries(2 * N_frame, queries.data());
+	std::vector<float> cpu_time(N_frame);
+	std::vector<float> allocations(N_frame);
+	std::vector<unsigned long long> checksum(N_frame);
+	std::vector<unsigned char> pixels(size_t(width) * height * 4);
+
+	// Keep the GPU time of the passes of all the frames
+	gpu_profiler::history_size = std::max(gpu_profiler::history_size, N_frame);
+	gpu_profiler_clear();
+
+	if (capture_frames) {
+		capture.framerate = fps;
+		capture.start_recording(capture_directory, capture_format);
+	}
+
+	for (int k_frame = 0; k_frame < N_frame; ++k_frame) {
+		profile_frame_mark_cgp();
+		gpu_profiler_frame_begin();
+		memory_frame_begin();
+		allocation_frame_begin();
+		memory_arena_frame_begin();
+		auto const cpu_start = std::chrono::steady_clock::now();
+		allocation_statistics const allocation_start = allocation_totals();
+		replay_frame(script, k_frame, fps, width, height);
+		glQueryCounter(queries[2 * k_frame], GL_TIMESTAMP);
+		render_frame_offscreen(fbo, width, height);
+		glQueryCounter(queries[2 * k_frame + 1], GL_TIMESTAMP);
+		if (capture_frames) {
+			capture.record_frame(fbo);
+			capture.update();
+		}
+		allocations[k_frame] = float((allocation_totals() - allocation_start).count);
+		cpu_time[k_frame] = 1000 * std::chrono::duration<float>(std::chrono::steady_clock::now() - cpu_start).count();
+		scene.frame_presented();
+
+		// Synchronous read back (outside of the measured times)
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.id);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		unsigned long long hash = 14695981039346656037ull;
+		for (unsigned char c : pixels)
+			hash = (hash ^ c) * 1099511628211ull;
+		checksum[k_frame] = hash;
+		opengl_error_frame_check();
+	}
+
+	std::vector<float> gpu_time(N_frame);
+	for (int k_frame = 0; k_frame < N_frame; ++k_frame) {
+		GLuint64 start = 0, end = 0;
+		glGetQueryObjectui64v(queries[2 * k_frame], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(queries[2 * k_frame + 1], GL_QUERY_RESULT, &end);
+		gpu_time[k_frame] = float(end - start) / 1e6f;
+	}
+	glDeleteQueries(2 * N_frame, queries.data());
+	gpu_profiler_finish();
+
+	if (capture_frames)
+		capture.stop_recording();
+
+	std::ofstream stream(output_filename);
+	unsigned long long run_checksum = 14695981039346656037ull;
+	char hex[17];
+	stream << "frame,time,cpu_ms,gpu_ms,allocations,checksum\n";
+	for (int k_frame = 0; k_frame < N_frame; ++k_frame) {
+		std::snprintf(hex, sizeof(hex), "%016llx", checksum[k_frame]);
+		stream << k_frame << "," << k_frame / fps << "," << cpu_time[k_frame] << "," << gpu_time[k_frame] << "," << allocations[k_frame] << "," << hex << "\n";
+		run_checksum = (run_checksum ^ checksum[k_frame]) * 1099511628211ull;
+	}
+	if (!stream.good()) {
+		std::cerr << "Cannot write the benchmark results in " << output_filename << std::endl;
+		return 1;
+	}
+
+	std::snprintf(hex, sizeof(hex), "%016llx", run_checksum);
+	std::cout << "Frames: " << N_frame << " (" << offscreen.description() << ")" << std::endl;
+	std::cout << "CPU (ms): median " << percentile(cpu_time, 0.5f) << " - p95 " << percentile(cpu_time, 0.95f) << std::endl;
+	if (capture_frames)
+		std::cout << "Capture (" << capture_format_name << "): " << capture.frame_count() << " frames, " << capture.dropped_count() << " dropped, " << capture.stall_count() << " stalls" << std::endl;
+	std::cout << "GPU (ms): median " << percentile(gpu_time, 0.5f) << " - p95 " << percentile(gpu_time, 0.95f) << std::endl;
+	for (gpu_pass_statistics const& pass : gpu_profiler_statistics())
+		std::cout << "  " << std::string(2 * pass.depth, ' ') << pass.name << " (ms): average " << pass.average << " - p95 " << pass.p95 << std::endl;
+	memory_totals const memory = memory_total();
+	if (allocation_counter_active())
+		std::cout << "Allocations: initialization " << initialization.count << " (" << memory_size_str(size_t(initialization.bytes)) << ") - per frame median " << percentile(allocations, 0.5f) << " - p95 " << percentile(allocations, 0.95f) << std::endl;
+	else
+		std::cout << "Allocations: not counted (build with CGP_ALLOCATION_COUNTER)" << std::endl;
+	std::cout << "Memory: GPU " << memory_size_str(memory.gpu()) << ", CPU meshes " << memory_size_str(memory.cpu()) << ", upload peak " << memory_size_str(memory_upload().peak_frame) << " per frame" << std::endl;
+	std::cout << "Checksum: " << hex << std::endl;
+	std::cout << "Results written in " << output_filename << std::endl;
+	return 0;
+}
@@ -0,0 +1,172 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace cgp;
+
+
+bool replay_script::load(std::string const& filename)
+{
+	clear();
+	std::ifstream stream(filename);
+	if (!stream.is_open())
+		return false;
+
+	std::string line;
+	int line_number = 0;
+	while (std::getline(stream, line)) {
+		line_number++;
+		std::istringstream line_stream(line);
+		std::string first, type;
+		if (!(line_stream >> first) || first[0] == '#')
+			continue;
+
+		float const t = float(std::atof(first.c_str()));
+		std::streampos const after_time = line_stream.tellg();
+		line_stream >> type;
+
+		if (type == "key_press" || type == "key_release") {
+			std::string name;
+			line_stream >> name;
+			int const key = replay_key_from_name(name);
+			if (key < 0) {
+				warning_cgp("Unknown key [" + name + "] in replay script", filename + ":" + str(line_number));
+				continue;
+			}
+			keys.push_back({ t, key, type == "key_press" ? GLFW_PRESS : GLFW_RELEASE });
+			continue;
+		}
+
+		// Camera keyframe, with or without the "camera" keyword
+		if (type != "camera") {
+			line_stream.clear();
+			line_stream.seekg(after_time);
+		}
+		replay_camera_keyframe keyframe;
+		keyframe.time = t;
+		if (line_stream >> keyframe.eye.x >> keyframe.eye.y >> keyframe.eye.z >> keyframe.center.x >> keyframe.center.y >> keyframe.center.z)
+			camera.push_back(keyframe);
+		else
+			warning_cgp("Cannot read the line [" + line + "] of the replay script", filename + ":" + str(line_number));
+	}
+
+	auto const by_time = [](auto const& a, auto const& b) { return a.time < b.time; };
+	std::stable_sort(camera.begin(), camera.end(), by_time);
+	std::stable_sort(keys.begin(), keys.end(), by_time);
+	return !empty();
+}
+
+bool replay_script::save(std::string const& filename) const
+{
+	std::ofstream stream(filename);
+	if (!stream.is_open())
+		return false;
+
+	stream << "# Replay script: t camera eye_x eye_y eye_z center_x center_y center_z | t key_press/key_release KEY\n";
+	size_t k_camera = 0, k_key = 0;
+	while (k_camera < camera.size() || k_key < keys.size()) {
+		if (k_key == keys.size() || (k_camera < camera.size() && camera[k_camera].time <= keys[k_key].time)) {
+			replay_camera_keyframe const& c = camera[k_camera++];
+			stream << c.time << " camera " << c.eye.x << " " << c.eye.y << " " << c.eye.z << "  " << c.center.x << " " << c.center.y << " " << c.center.z << "\n";
+		}
+		else {
+			replay_key_event const& e = keys[k_key++];
+			stream << e.time << (e.action == GLFW_RELEASE ? " key_release " : " key_press ") << replay_key_name(e.key) << "\n";
+		}
+	}
+	return true;
+}
+
+void replay_script::clear()
+{
+	camera.clear();
+	keys.clear();
+}
+
+bool replay_script::empty() const
+{
+	return camera.empty() && keys.empty();
+}
+
+float replay_script::duration() const
+{
+	float d = 0.0f;
+	if (!camera.empty())
+		d = std::max(d, camera.back().time);
+	if (!keys.empty())
+		d = std::max(d, keys.back().time);
+	return d;
+}
+
+bool replay_script::camera_at(float t, vec3& eye, vec3& center) const
+{
+	if (camera.empty())
+		return false;
+
+	size_t k = 0;
+	while (k + 2 < camera.size() && camera[k + 1].time < t)
+		k++;
+	size_t const k_next = std::min(k + 1, camera.size() - 1);
+	float alpha = 0.0f;
+	if (camera[k_next].time > camera[k].time)
+		alpha = clamp((t - camera[k].time) / (camera[k_next].time - camera[k].time), 0.0f, 1.0f);
+
+	eye = (1 - alpha) * camera[k].eye + alpha * camera[k_next].eye;
+	center = (1 - alpha) * camera[k].center + alpha * camera[k_next].center;
+	return true;
+}
+
+std::vector<replay_key_event> replay_script::keys_between(float t0, float t1) const
+{
+	std::vector<replay_key_event> events;
+	for (replay_key_event const& e : keys)
+		if (e.time > t0 && e.time <= t1)
+			events.push_back(e);
+	return events;
+}
+
+void replay_script::record_camera(float t, vec3 const& eye, vec3 const& center)
+{
+	camera.push_back({ t, eye, center });
+}
+
+void replay_script::record_key(float t, int key, int action)
+{
+	if (action == GLFW_PRESS || action == GLFW_RELEASE)
+		keys.push_back({ t, key, action });
+}
+
+
+static std::vector<std::pair<std::string, int>> const replay_named_keys = {
+	{ "SPACE", GLFW_KEY_SPACE }, { "UP", GLFW_KEY_UP }, { "DOWN", GLFW_KEY_DOWN }, { "LEFT", GLFW_KEY_LEFT }, { "RIGHT", GLFW_KEY_RIGHT },
+	{ "LEFT_SHIFT", GLFW_KEY_LEFT_SHIFT }, { "RIGHT_SHIFT", GLFW_KEY_RIGHT_SHIFT }, { "LEFT_CONTROL", GLFW_KEY_LEFT_CONTROL }, { "RIGHT_CONTROL", GLFW_KEY_RIGHT_CONTROL }
+};
+
+std::string replay_key_name(int key)
+{
+	if ((key >= GLFW_KEY_A && key <= GLFW_KEY_Z) || (key >= GLFW_KEY_0 && key <= GLFW_KEY_9))
+		return std::string(1, char(key));
+	for (auto const& named : replay_named_keys)
+		if (named.second == key)
+			return named.first;
+	return str(key);
+}
+
+int replay_key_from_name(std::string const& name)
+{
+	if (name.size() == 1) {
+		char const c = char(std::toupper(name[0]));
+		if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+			return int(c);
+	}
+	for (auto const& named : replay_named_keys)
+		if (named.first == name)
+			return named.second;
+	if (!name.empty() && std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+		return std::atoi(name.c_str());
+	return -1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "cgp/cgp.hpp"
+
+#include <string>
+#include <vector>
+
+
+// Camera and keyboard script replayed by the headless modes (capture of a camera path, benchmark)
+//  Text file with one event per line (times in seconds, lines starting with # are ignored):
+//    t camera eye_x eye_y eye_z center_x center_y center_z
+//    t key_press KEY
+//    t key_release KEY
+//    t eye_x eye_y eye_z center_x center_y center_z     (short form of a camera keyframe)
+//  KEY is a letter/digit, SPACE, UP, DOWN, LEFT, RIGHT, LEFT_SHIFT, or a GLFW key code.
+//  The camera is linearly interpolated between the keyframes.
+struct replay_camera_keyframe {
+	float time;
+	cgp::vec3 eye;
+	cgp::vec3 center;
+};
+struct replay_key_event {
+	float time;
+	int key;    // GLFW key code
+	int action; // GLFW_PRESS or GLFW_RELEASE
+};
+
+struct replay_script {
+	std::vector<replay_camera_keyframe> camera;
+	std::vector<replay_key_event> keys;
+
+	bool load(std::string const& filename);
+	bool save(std::string const& filename) const;
+	void clear();
+
+	bool empty() const;
+	float duration() const;
+
+	// Interpolated camera at time t (returns false if there is no camera keyframe)
+	bool camera_at(float t, cgp::vec3& eye, cgp::vec3& center) const;
+	// Key events in the interval ]t0, t1]
+	std::vector<replay_key_event> keys_between(float t0, float t1) const;
+
+	// Recording from the interactive application (events must be added in chronological order)
+	void record_camera(float t, cgp::vec3 const& eye, cgp::vec3 const& center);
+	void record_key(float t, int key, int action);
+};
+
+std::string replay_key_name(int key);
+int replay_key_from_name(std::string const& name); // -1 if the name is unknown
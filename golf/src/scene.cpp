@@ -13,62 +13,134 @@ void scene_structure::initialize()
 	display_info();
 	initialize_camera();
 	global_frame.initialize_data_on_gpu(mesh_primitive_frame());
+
+	// Assets loaded asynchronously (see update_loading)
 	initialize_skybox();
 	initialize_terrain();
 	initialize_water();
 	initialize_circle();
-	initialize_grass();
+	initialize_vegetation();
 	initialize_trees();
 	initialize_flag();
+
 	initialize_hole();
 	initialize_ball();
 	initialize_arrow();
 }
 
 
+void scene_structure::load_asset(std::string const& name, std::function<std::function<void()>()> const& load)
+{
+	asset_count++;
+	loading_jobs.submit([this, name, load]() {
+		auto const start = std::chrono::steady_clock::now();
+		std::function<void()> upload;
+		{
+			memory_owner_cgp(name);
+			upload = load();
+		}
+		float const load_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+		loading_uploads.push([this, name, upload, load_time]() {
+			auto const start_upload = std::chrono::steady_clock::now();
+			{
+				memory_owner_cgp(name);
+				upload();
+			}
+			float const upload_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start_upload).count();
+			asset_report.push_back({ name, load_time, upload_time });
+		});
+	});
+}
+
+void scene_structure::update_loading()
+{
+	profile_zone_cgp("update_loading");
+	loading_jobs.rethrow_error();
+	loading_uploads.run(loading_upload_budget);
+}
+
+bool scene_structure::is_loaded() const
+{
+	return int(asset_report.size()) == asset_count;
+}
+
+float scene_structure::loading_progress() const
+{
+	return asset_count == 0 ? 1.0f : float(asset_report.size()) / asset_count;
+}
+
+void scene_structure::display_loading_report(float time_to_first_frame) const
+{
+	std::cout << "\n[assets] Loading report (" << loading_jobs.size() << " worker threads)" << std::endl;
+	float load_total = 0.0f, upload_total = 0.0f;
+	for (asset_load_record const& record : asset_report) {
+		std::cout << "  " << record.name << ": load " << 1000 * record.load_time << "ms, upload " << 1000 * record.upload_time << "ms" << std::endl;
+		load_total += record.load_time;
+		upload_total += record.upload_time;
+	}
+	std::cout << "  Total: load " << 1000 * load_total << "ms (worker threads), upload " << 1000 * upload_total << "ms (main thread)" << std::endl;
+	std::cout << "  Time to first frame: " << 1000 * time_to_first_frame << "ms\n" << std::endl;
+}
+
+
 
 void scene_structure::display_frame()
 {
-	environment.uniform_generic.uniform_float["time"] = timer.t;
+	profile_zone_cgp("display_frame");
+	environment.uniform_generic.uniform_float["time"] = simulation_time;
 	// Set the light to the current position of the camera
 	environment.light = camera_control.camera_model.position();
 
 	if (gui.display_frame)
 		draw(global_frame, environment);
 
-	glDepthMask(GL_FALSE);
-	draw(skybox, environment);
-	glDepthMask(GL_TRUE);
+	{
+		profile_gpu_zone_cgp("skybox");
+		glDepthMask(GL_FALSE);
+		draw(skybox, environment);
+		glDepthMask(GL_TRUE);
+	}
 
-	draw(terrain, environment);
-	if (gui.display_wireframe)
-		draw_wireframe(terrain, environment);
+	{
+		profile_gpu_zone_cgp("terrain");
+		draw(terrain, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(terrain, environment);
+	}
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	draw(water, environment);
-	glDisable(GL_BLEND);
-	if (gui.display_wireframe)
-		draw_wireframe(water, environment);
+	{
+		profile_gpu_zone_cgp("water");
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		draw(water, environment);
+		glDisable(GL_BLEND);
+		if (gui.display_wireframe)
+			draw_wireframe(water, environment);
+	}
 	
-	draw(hole, environment);
-	if (gui.display_wireframe) 
-		draw_wireframe(hole, environment);
-	draw(circle, environment); 
-	if (gui.display_wireframe) 
-		draw_wireframe(circle, environment);
-	draw(flag_pole, environment);
-	if (gui.display_wireframe) 
-		draw_wireframe(flag_pole, environment);
-	draw(flag, environment);
-	if (gui.display_wireframe) 
-		draw_wireframe(flag, environment);
-	draw(ball, environment);
-	if (gui.display_wireframe) 
-		draw_wireframe(ball, environment);
+	{
+		profile_gpu_zone_cgp("course");
+		draw(hole, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(hole, environment);
+		draw(circle, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(circle, environment);
+		draw(flag_pole, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(flag_pole, environment);
+		draw(flag, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(flag, environment);
+		ball.model.translation = ball_position;
+		draw(ball, environment);
+		if (gui.display_wireframe)
+			draw_wireframe(ball, environment);
+	}
 
 	display_trees();
-	display_grass();
+	display_vegetation();
 
 	// Affichage de la flèche en cas de balle arrêtée
 	if (ball_is_stopped) {
@@ -92,40 +164,39 @@ void scene_structure::display_frame()
 
 void scene_structure::display_trees()
 {
+	profile_zone_cgp("display_trees");
+	profile_gpu_zone_cgp("trees");
 	vec3 const offset = { 0,0,0.05f };
+	vec3 const camera_position = camera_control.camera_model.position();
 	for (size_t k = 0; k < tree_position.size(); ++k) {
 		trunk.model.translation = tree_position[k] - offset;
 		branches.model.translation = tree_position[k] - offset;
 		foliage.model.translation = tree_position[k] - offset;
-		draw(trunk, environment);
-		draw(branches, environment);
-		draw(foliage, environment);
+		draw(trunk, camera_position, environment);
+		draw(branches, camera_position, environment);
+		draw(foliage, camera_position, environment);
 	}
 }
 
 
-void scene_structure::display_grass()
+void scene_structure::display_vegetation()
 {
+	profile_zone_cgp("display_vegetation");
+	profile_gpu_zone_cgp("vegetation");
+	if (vegetation_instance_count == 0)
+		return;
+
 	auto const& camera = camera_control.camera_model;
 	vec3 const right = camera.right();
-	rotation_transform R = rotation_transform::from_frame_transform({ 1,0,0 }, { 0,0,1 }, right, { 0,0,1 });
-	grass.model.rotation = R;
+	vegetation.model.rotation = rotation_transform::from_frame_transform({ 1,0,0 }, { 0,0,1 }, right, { 0,0,1 });
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	vec3 const offset = { 0,0,0.02f };
-	for (vec3 position : grass_position) {
-		grass.model.translation = position - offset;
-		draw(grass, environment);
-	}
-
+	draw(vegetation, environment, vegetation_instance_count);
 	glDisable(GL_BLEND);
-	if (gui.display_wireframe) {
-		for (vec3 position : grass_position) {
-			grass.model.translation = position - offset;
-			draw_wireframe(grass, environment);
-		}
-	}
+
+	if (gui.display_wireframe)
+		draw_wireframe(vegetation, environment, { 0,0,1 }, vegetation_instance_count);
 }
 
 void scene_structure::display_gui()
@@ -146,6 +217,8 @@ void scene_structure::display_gui()
 	ImGui::Text("y = %.2f", ball_position.y);
 	ImGui::Text("z = %.2f", ball_position.z);
 	ImGui::Text("Shoot number : %d", shoot_number);
+	ImGui::Checkbox("Simulation thread", &project::simulation_thread);
+	ImGui::Text("Shoot latency: inline %.1f ms, threaded %.1f ms", shoot_latency[0], shoot_latency[1]);
 	if (show_goal_message) {
 		ImGui::SetNextWindowPos(ImVec2(300, 50), ImGuiCond_Always);
 		ImGui::SetNextWindowBgAlpha(0.7f); // transparence
@@ -175,92 +248,26 @@ void scene_structure::keyboard_event()
 	camera_control.action_keyboard(environment.camera_view);
 }
 
-void scene_structure::update_ball(float dt)
-{
-    if (ball_is_stopped)
-        return;
-
-    // Mouvement de la balle
-    ball_velocity += g * dt;
-    ball_position += ball_velocity * dt;
-
-    // Infos du terrain
-    float terrain_height = evaluate_terrain_height(ball_position.x, ball_position.y);
-    vec3 p_ground = { ball_position.x, ball_position.y, terrain_height };
-    vec3 terrain_normal = evaluate_terrain_normal(ball_position.x, ball_position.y);
-
-    vec3 delta_p = ball_position - p_ground;
-    float distance_along_normal = dot(delta_p, terrain_normal);
-    bool on_ground = (distance_along_normal < ball_radius + 0.001f);
-
-	// Cas ou la balle 'touche' le sol
-    if (on_ground)
-    {
-        float penetration = ball_radius - distance_along_normal;
-        ball_position += penetration * terrain_normal;
-
-        // Rebond vertical
-        float v_n = dot(ball_velocity, terrain_normal);
-        if (v_n < 0)
-            ball_velocity -= (1.0f + restitution) * v_n * terrain_normal;
-
-        // Frottement tangent
-        vec3 v_normal_component = dot(ball_velocity, terrain_normal) * terrain_normal;
-        vec3 v_tangent = ball_velocity - v_normal_component;
-        float ground_friction = 0.8f;
-		// Frottements diminués si la balle est sur le green
-		if (is_on_green(ball_position.xy())) ground_friction = 0.97f;
-        v_tangent *= ground_friction;
-        ball_velocity = v_normal_component + v_tangent;
-
-        // Test d'arrêt
-        float total_speed = norm(ball_velocity);
-        float tangent_speed = norm(v_tangent);
-        if (total_speed < 0.15f && tangent_speed < 0.15f && std::abs(v_n) < 0.15f)
-        {
-            ball_velocity = {0, 0, 0};
-            ball_is_stopped = true;
-        }
-    }
-	// Cas où la balle est dans l'air
-    else
-    {
-        // Frottement dans l'air
-        ball_velocity *= 0.995f;
-    }
-
-    // Hors limites
-	if (ball_position.z < -0.6f || std::abs(ball_position.x) > 40.0f || std::abs(ball_position.y) > 15.0f) {
-		ball_position = {34.0f, 0.0f, 1.0f};
-		ball_velocity = {0.0f, 0.0f, 0.0f};
-	}
-
-	// Infos sur le trou
-	vec2 hole_position = {-17.0f, 6.0f};
-	float hole_radius = 0.1f;
-	float dist_to_hole = norm(vec2{ball_position.x, ball_position.y} - hole_position);
-	float speed = norm(ball_velocity);
-
-	// Cas où la balle rentre dans le trou
-	if (dist_to_hole < hole_radius && speed < 1.0f) {
-		std::cout << "Ball in the hole! Respawning..." << std::endl;
-		ball_position = {34.0f, 0.0f, 1.0f}; // position de spawn
-		ball_velocity = {0.0f, 0.0f, 0.0f};
-		shoot_number = 0;
-		show_goal_message = true;
-		goal_message_timer = 2.0f;
-	}
-
-	ball.model.translation = ball_position;
-}
-	
-
 void scene_structure::idle_frame()
 {
+	profile_zone_cgp("idle_frame");
 	camera_control.idle_frame(environment.camera_view);
-	float dt = timer.update();
 
-	update_ball(dt);
+	// Start/stop the simulation thread if the mode changed
+	if (project::simulation_thread != simulation.is_threaded())
+		project::simulation_thread ? simulation.start_thread() : simulation.stop_thread();
+	if (!simulation.is_threaded())
+		simulation.update_inline();
+
+	// State to display in this frame
+	simulation_snapshot const& snapshot = simulation.update_snapshot();
+	simulation_state const state = simulation.interpolated_state(simulation.time());
+	ball_position = state.ball_position;
+	ball_is_stopped = state.ball_is_stopped;
+	shoot_number = state.shoot_number;
+	show_goal_message = state.goal_message_timer > 0.0f;
+	simulation_time = state.time;
+	displayed_command = snapshot.last_command;
 
 	// Binds
 	if (inputs.keyboard.is_pressed(GLFW_KEY_D))  shoot_phi -= delta_angle;
@@ -299,29 +306,32 @@ void scene_structure::idle_frame()
 	shoot_phi = fmod(shoot_phi + 2 * Pi, 2 * Pi);
 
 	// Tir
-	if (inputs.keyboard.is_pressed(GLFW_KEY_SPACE) && ball_is_stopped){
+	if (inputs.keyboard.is_pressed(GLFW_KEY_SPACE) && ball_is_stopped && shoot_command == 0){
 		vec3 dir = {
 			shoot_speed * std::sin(shoot_theta) * std::cos(shoot_phi),
 			shoot_speed * std::sin(shoot_theta) * std::sin(shoot_phi),
 			shoot_speed * std::cos(shoot_theta)
 		};
-		ball_velocity = dir;
-		ball_is_stopped = false;
-		shoot_number++;
+		shoot_input_time = simulation.time();
+		shoot_position = ball_position;
+		shoot_command = simulation.shoot(dir);
 	}
 
 	// Suivi de la balle
 	if (inputs.keyboard.is_pressed(GLFW_KEY_C)) follow_ball_orbit = !follow_ball_orbit;
 	if (follow_ball_orbit) camera_control.camera_model.center_of_rotation = ball_position;
-	
-	// Balle dans le trou
-	if (show_goal_message) {
-		goal_message_timer -= dt;
-		if (goal_message_timer <= 0.0f) {
-			show_goal_message = false;
-		}
-	}
+}
 
+void scene_structure::frame_presented()
+{
+	// The shoot is visible once a swapped frame shows the ball moving. Receiving the snapshot that processed the command is not enough:
+	//  the interpolated state lags one tick behind it (up to 1/tick_rate), and this delay is part of the measured latency.
+	if (shoot_command != 0 && displayed_command >= shoot_command && norm(ball_position - shoot_position) > 0.0f) {
+		float const latency = 1000.0f * float(simulation.time() - shoot_input_time);
+		float& average = shoot_latency[simulation.is_threaded() ? 1 : 0];
+		average = average == 0 ? latency : 0.8f * average + 0.2f * latency;
+		shoot_command = 0;
+	}
 }
 
 void scene_structure::display_info()
@@ -3,6 +3,7 @@
 
 #include "cgp/cgp.hpp"
 #include "environment.hpp"
+#include "simulation.hpp"
 
 
 // This definitions allow to use the structures: mesh, mesh_drawable, etc. without mentionning explicitly cgp::
@@ -39,8 +40,6 @@ struct scene_structure : cgp::scene_inputs_generic {
 	// Elements and shapes of the scene
 	// ****************************** //
 
-	timer_basic timer;
-
 	cgp::skybox_drawable skybox;
 
 	cgp::mesh_drawable terrain;
@@ -53,14 +52,16 @@ struct scene_structure : cgp::scene_inputs_generic {
 	void display_trees();
 
 
-	cgp::mesh_drawable grass;
-	std::vector<cgp::vec3> grass_position;
-	void display_grass();
+	// Grass and flowers: one instance per tuft, species selected by the layer of the texture array
+	cgp::mesh_drawable vegetation;
+	cgp::opengl_texture_atlas vegetation_texture;
+	int vegetation_instance_count = 0;
+	void display_vegetation();
 
 
-	cgp::mesh_drawable trunk;
-	cgp::mesh_drawable branches;
-	cgp::mesh_drawable foliage;
+	cgp::mesh_drawable_lod trunk;
+	cgp::mesh_drawable_lod branches;
+	cgp::mesh_drawable_lod foliage;
 
 	cgp::mesh_drawable flag_pole;
 	cgp::mesh_drawable flag;
@@ -70,14 +71,22 @@ struct scene_structure : cgp::scene_inputs_generic {
 
 	
 
+	// Physics of the ball, computed at a fixed tick rate (on its own thread if project::simulation_thread)
+	simulation_structure simulation;
+
+	// State displayed in the current frame (interpolated from the simulation snapshots)
 	vec3 ball_position;
-	vec3 ball_velocity;
-	vec3 g = {0.0f, 0.0f, -9.81f};
 	float ball_radius = 0.05f;
-	float restitution = 0.5f;
-	float air_friction = 0.995f;
-	float ground_friction;
 	bool ball_is_stopped = false;
+	float simulation_time = 0.0f;
+	unsigned int displayed_command = 0;
+
+	// Measure of the latency between the shoot input and the first frame where the displayed (interpolated) ball has moved
+	//  It includes the interpolation delay of one tick (8.3 ms at 120 Hz) in addition to the processing of the command.
+	unsigned int shoot_command = 0;     // Sequence number of the shoot waiting to be displayed (0 if none)
+	double shoot_input_time = 0.0;
+	vec3 shoot_position;                // Displayed ball position when the shoot was sent
+	float shoot_latency[2] = { 0,0 };   // Average latency (ms) in inline [0] and threaded [1] mode
 
 
 	bool follow_ball_orbit = true;
@@ -98,20 +107,45 @@ struct scene_structure : cgp::scene_inputs_generic {
 
 	int shoot_number = 0;
 	bool show_goal_message = false;
-	float goal_message_timer = 0.0f;
+
+
+	// ****************************** //
+	// Asynchronous loading of the assets
+	// ****************************** //
+
+	cgp::task_queue loading_uploads;    // OpenGL uploads, executed on the main thread within a time budget per frame
+	float loading_upload_budget = 0.008f;
+
+	struct asset_load_record {
+		std::string name;
+		float load_time;   // Time spent on the worker thread (s)
+		float upload_time; // Time spent on the main thread (s)
+	};
+	std::vector<asset_load_record> asset_report;
+
+	// Declared after the members used by the jobs: it is destroyed first, and its destructor finishes the pending jobs (which push to loading_uploads)
+	cgp::job_system loading_jobs;       // Decoding and parsing of the assets on worker threads
+	int asset_count = 0;
+
+	// Run load() on a worker thread. It returns the function uploading the result to the GPU, called later by update_loading()
+	void load_asset(std::string const& name, std::function<std::function<void()>()> const& load);
+	void update_loading();   // To be called once per frame while the scene is not loaded
+	bool is_loaded() const;
+	float loading_progress() const;
+	void display_loading_report(float time_to_first_frame) const;
 
 
 	// ****************************** //
 	// Functions
 	// ****************************** //
 
-	void initialize();    // Standard initialization to be called before the animation loop
+	void initialize();    // Standard initialization to be called before the animation loop (starts the loading of the assets)
 	void initialize_camera();
 	void initialize_skybox();
 	void initialize_terrain();
 	void initialize_water();
 	void initialize_circle();
-	void initialize_grass();
+	void initialize_vegetation();
 	void initialize_trees();
 	void initialize_flag();
 	void initialize_hole();
@@ -127,7 +161,7 @@ struct scene_structure : cgp::scene_inputs_generic {
 	void mouse_click_event();
 	void keyboard_event();
 	void idle_frame();
-	void update_ball(float dt);
+	void frame_presented(); // To be called after the buffers swap
 
 	void display_info();
 };
@@ -0,0 +1,277 @@
+#include "simulation.hpp"
+#include "terrain.hpp"
+
+using namespace cgp;
+
+
+simulation_structure::simulation_structure()
+	:running(false)
+{}
+
+simulation_structure::~simulation_structure()
+{
+	stop_thread();
+}
+
+void simulation_structure::initialize(simulation_state const& initial_state)
+{
+	assert_cgp(!is_threaded(), "The simulation cannot be initialized while its thread is running");
+	state = initial_state;
+	state_previous = initial_state;
+	tick_count = 0;
+	start_time = clock::now();
+	publish();
+}
+
+simulation_structure::clock::time_point simulation_structure::tick_deadline(long tick) const
+{
+	return start_time + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(tick / double(tick_rate)));
+}
+
+double simulation_structure::time() const
+{
+	if (manual_time >= 0)
+		return manual_time;
+	return std::chrono::duration<double>(clock::now() - start_time).count();
+}
+
+
+void simulation_structure::start_thread()
+{
+	if (is_threaded())
+		return;
+	running = true;
+	thread = std::thread(&simulation_structure::thread_loop, this);
+}
+
+void simulation_structure::stop_thread()
+{
+	if (!is_threaded())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		running = false;
+	}
+	command_signal.notify_one();
+	thread.join();
+}
+
+bool simulation_structure::is_threaded() const
+{
+	return thread.joinable();
+}
+
+
+unsigned int simulation_structure::shoot(vec3 const& velocity)
+{
+	unsigned int sequence;
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		sequence = ++command_counter;
+		commands.push_back({ velocity, sequence });
+	}
+	command_signal.notify_one();
+	return sequence;
+}
+
+void simulation_structure::process_commands()
+{
+	std::vector<shoot_command> pending;
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		pending.swap(commands);
+	}
+	for (shoot_command const& command : pending) {
+		if (state.ball_is_stopped) {
+			state.ball_velocity = command.velocity;
+			state.ball_is_stopped = false;
+			state.shoot_number++;
+		}
+		last_command = command.sequence;
+	}
+}
+
+
+void simulation_structure::thread_loop()
+{
+	profile_thread_name_cgp("simulation");
+	while (running)
+	{
+		clock::time_point const deadline = tick_deadline(tick_count + 1);
+		{
+			// Sleep until the next tick, or until a command is received
+			std::unique_lock<std::mutex> lock(command_mutex);
+			command_signal.wait_until(lock, deadline, [this]() { return !commands.empty() || !running; });
+		}
+		if (!running)
+			break;
+
+		// Commands are applied and published immediately to avoid adding latency to the inputs
+		unsigned int const command_before = last_command;
+		process_commands();
+		bool updated = (last_command != command_before);
+
+		// Catch up with the ticks that are due (skip the ticks if the simulation is too late, ex. after a breakpoint)
+		clock::time_point const now = clock::now();
+		if (now - tick_deadline(tick_count) > std::chrono::milliseconds(250))
+			tick_count = long(time() * tick_rate);
+		while (tick_deadline(tick_count + 1) <= now) {
+			step(1.0f / tick_rate);
+			tick_count++;
+			updated = true;
+		}
+
+		if (updated)
+			publish();
+	}
+}
+
+void simulation_structure::set_manual_time(double t)
+{
+	assert_cgp(t < 0 || !is_threaded(), "The manual clock is only available in inline mode");
+	manual_time = t;
+}
+
+void simulation_structure::update_inline()
+{
+	assert_cgp(!is_threaded(), "update_inline should not be called when the simulation thread is running");
+
+	process_commands();
+
+	clock::time_point const now = manual_time >= 0 ? start_time + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(manual_time)) : clock::now();
+	if (now - tick_deadline(tick_count) > std::chrono::milliseconds(250))
+		tick_count = long(time() * tick_rate);
+	while (tick_deadline(tick_count + 1) <= now) {
+		step(1.0f / tick_rate);
+		tick_count++;
+	}
+	publish();
+}
+
+
+void simulation_structure::publish()
+{
+	simulation_snapshot& snapshot = snapshots.write_buffer();
+	snapshot.previous = state_previous;
+	snapshot.current = state;
+	snapshot.tick_time = tick_count / double(tick_rate);
+	snapshot.tick_period = 1.0f / tick_rate;
+	snapshot.last_command = last_command;
+	snapshots.publish();
+}
+
+simulation_snapshot const& simulation_structure::update_snapshot()
+{
+	snapshots.update();
+	return snapshots.read_buffer();
+}
+
+simulation_state simulation_structure::interpolated_state(double t) const
+{
+	simulation_snapshot const& snapshot = snapshots.read_buffer();
+
+	// The displayed state is one tick behind the simulation: it is always between the two last computed ticks
+	float const alpha = clamp(float((t - snapshot.tick_time) / snapshot.tick_period), 0.0f, 1.0f);
+
+	simulation_state s = snapshot.current;
+	s.ball_position = (1 - alpha) * snapshot.previous.ball_position + alpha * snapshot.current.ball_position;
+	s.time = (1 - alpha) * snapshot.previous.time + alpha * snapshot.current.time;
+	return s;
+}
+
+
+void simulation_structure::step(float dt)
+{
+	profile_zone_cgp("simulation step");
+	state_previous = state;
+	state.time += dt;
+
+	if (state.goal_message_timer > 0.0f)
+		state.goal_message_timer = std::max(state.goal_message_timer - dt, 0.0f);
+
+	if (state.ball_is_stopped)
+		return;
+
+	vec3& ball_position = state.ball_position;
+	vec3& ball_velocity = state.ball_velocity;
+	float const ball_radius = parameters.ball_radius;
+	float const friction_exponent = 60.0f * dt; // Friction factors are given for 1/60s
+
+	// Mouvement de la balle
+	ball_velocity += parameters.g * dt;
+	ball_position += ball_velocity * dt;
+
+	// Infos du terrain
+	float terrain_height = evaluate_terrain_height(ball_position.x, ball_position.y);
+	vec3 p_ground = { ball_position.x, ball_position.y, terrain_height };
+	vec3 terrain_normal = evaluate_terrain_normal(ball_position.x, ball_position.y);
+
+	vec3 delta_p = ball_position - p_ground;
+	float distance_along_normal = dot(delta_p, terrain_normal);
+	bool on_ground = (distance_along_normal < ball_radius + 0.001f);
+
+	// Cas ou la balle 'touche' le sol
+	if (on_ground)
+	{
+		float penetration = ball_radius - distance_along_normal;
+		ball_position += penetration * terrain_normal;
+
+		// Rebond vertical
+		float v_n = dot(ball_velocity, terrain_normal);
+		if (v_n < 0)
+			ball_velocity -= (1.0f + parameters.restitution) * v_n * terrain_normal;
+
+		// Frottement tangent
+		vec3 v_normal_component = dot(ball_velocity, terrain_normal) * terrain_normal;
+		vec3 v_tangent = ball_velocity - v_normal_component;
+		float ground_friction = parameters.ground_friction;
+		// Frottements diminués si la balle est sur le green
+		if (is_on_green(ball_position.xy())) ground_friction = parameters.green_friction;
+		v_tangent *= std::pow(ground_friction, friction_exponent);
+		ball_velocity = v_normal_component + v_tangent;
+
+		// Test d'arrêt
+		float total_speed = norm(ball_velocity);
+		float tangent_speed = norm(v_tangent);
+		if (total_speed < 0.15f && tangent_speed < 0.15f && std::abs(v_n) < 0.15f)
+		{
+			ball_velocity = { 0, 0, 0 };
+			state.ball_is_stopped = true;
+		}
+	}
+	// Cas où la balle est dans l'air
+	else
+	{
+		// Frottement dans l'air
+		ball_velocity *= std::pow(parameters.air_friction, friction_exponent);
+	}
+
+	bool teleported = false;
+
+	// Hors limites
+	if (ball_position.z < -0.6f || std::abs(ball_position.x) > 40.0f || std::abs(ball_position.y) > 15.0f) {
+		ball_position = { 34.0f, 0.0f, 1.0f };
+		ball_velocity = { 0.0f, 0.0f, 0.0f };
+		teleported = true;
+	}
+
+	// Infos sur le trou
+	vec2 hole_position = { -17.0f, 6.0f };
+	float hole_radius = 0.1f;
+	float dist_to_hole = norm(vec2{ ball_position.x, ball_position.y } - hole_position);
+	float speed = norm(ball_velocity);
+
+	// Cas où la balle rentre dans le trou
+	if (dist_to_hole < hole_radius && speed < 1.0f) {
+		std::cout << "Ball in the hole! Respawning..." << std::endl;
+		ball_position = { 34.0f, 0.0f, 1.0f }; // position de spawn
+		ball_velocity = { 0.0f, 0.0f, 0.0f };
+		state.shoot_number = 0;
+		state.goal_message_timer = 2.0f;
+		teleported = true;
+	}
+
+	// No interpolation across a respawn
+	if (teleported)
+		state_previous.ball_position = ball_position;
+}
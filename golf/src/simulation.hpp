@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cgp/cgp.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// State of the animated elements of the scene at a given simulation tick
+struct simulation_state {
+	cgp::vec3 ball_position = { 31.0f, 0.0f, 1.0f };
+	cgp::vec3 ball_velocity = { 0.0f, 0.0f, 0.0f };
+	bool ball_is_stopped = false;
+	int shoot_number = 0;
+	float goal_message_timer = 0.0f;
+	float time = 0.0f; // Simulation time (s) - used by the animated shaders (water, flag)
+};
+
+// Immutable snapshot published after each tick (and after each command)
+//  Contains the two last ticks so that the render thread can interpolate between them.
+struct simulation_snapshot {
+	simulation_state previous;
+	simulation_state current;
+	double tick_time = 0.0;         // Time (s, from simulation_structure::time()) at which the current state is reached
+	float tick_period = 1.0f / 120;
+	unsigned int last_command = 0;  // Sequence number of the last processed command
+};
+
+// Physical parameters of the ball
+//  The friction factors are expressed for a duration of 1/60s, and are adapted to the tick period.
+struct simulation_parameters {
+	cgp::vec3 g = { 0.0f, 0.0f, -9.81f };
+	float ball_radius = 0.05f;
+	float restitution = 0.5f;
+	float air_friction = 0.995f;
+	float ground_friction = 0.8f;
+	float green_friction = 0.97f;
+};
+
+
+// Simulation of the ball at a fixed tick rate.
+//  - Threaded mode: the ticks run on a dedicated thread that publishes snapshots through a lock-free triple buffer.
+//  - Inline mode: the ticks are computed on the render thread by update_inline() (same results, used for comparison).
+//  The render thread never accesses the state directly: it sends commands (shoot) and reads snapshots.
+struct simulation_structure {
+
+	simulation_parameters parameters;
+	float tick_rate = 120.0f;
+
+	simulation_structure();
+	~simulation_structure();
+
+	void initialize(simulation_state const& initial_state);
+
+	void start_thread();
+	void stop_thread();
+	bool is_threaded() const;
+
+	// Compute all the ticks up to the current time on the calling thread (to be called once per frame when the thread is not running)
+	void update_inline();
+
+	// Ask to shoot the ball with the given velocity (ignored if the ball is not stopped). Returns the sequence number of the command.
+	unsigned int shoot(cgp::vec3 const& velocity);
+
+	// Render side: acquire the latest snapshot and interpolate its state at the given time
+	simulation_snapshot const& update_snapshot();
+	simulation_state interpolated_state(double time) const;
+
+	// Time elapsed since the initialization (s)
+	double time() const;
+
+	// Manual clock (inline mode only): time() returns the given value instead of the real elapsed time, so that replays are deterministic
+	//  A negative value goes back to the real clock.
+	void set_manual_time(double t);
+	double manual_time = -1.0;
+
+private:
+	using clock = std::chrono::steady_clock;
+
+	void thread_loop();
+	void process_commands();
+	void step(float dt);
+	void publish();
+	clock::time_point tick_deadline(long tick) const;
+
+	// Owned by the thread running the simulation
+	simulation_state state;
+	simulation_state state_previous;
+	long tick_count = 0;
+	unsigned int last_command = 0;
+
+	clock::time_point start_time;
+	cgp::triple_buffer<simulation_snapshot> snapshots;
+
+	// Commands sent by the render thread (rare events: protected by a mutex, and wake up the simulation thread)
+	struct shoot_command {
+		cgp::vec3 velocity;
+		unsigned int sequence;
+	};
+	std::mutex command_mutex;
+	std::condition_variable command_signal;
+	std::vector<shoot_command> commands;
+	unsigned int command_counter = 0;
+
+	std::thread thread;
+	std::atomic<bool> running;
+};
@@ -6,6 +6,17 @@ using namespace cgp;
 
 // Evaluate 3D position of the terrain for any (x,y)
 
+// Gaussian hills of the terrain: center, height and width
+//  The tables are built at compile time instead of on every call of evaluate_terrain_height
+namespace
+{
+    constexpr std::array<vec2, 13> terrain_hill_center = {vec2{20.0f, 10.0f},vec2{16.0f, 8.0f},vec2{13.2f, 7.6f},vec2{8.4f, 8.8f},vec2{3.6f, 6.0f},vec2{-0.8f, 7.6f},
+            vec2{-6.0f, 7.6f},vec2{-10.8f, 8.8f},vec2{18.0f, -8.8f},vec2{12.8f, -7.6f},vec2{8.4f, -8.4f},vec2{6.0f, -8.8f},vec2{-16.0f, -10.0f}
+            };
+    constexpr float terrain_hill_height[13] = {1.6f, 0.8f, 1.2f, 0.8f, 1.6f, 0.8f, 1.6f, 0.6f, 1.2f, 0.8f, 1.2f, 0.8f, -3.0f};
+    constexpr float terrain_hill_sigma[13] = {4.4f, 2.4f, 2.0f, 2.8f, 3.2f, 1.6f, 2.4f, 2.0f,2.8f, 2.0f, 2.4f, 1.6f, 8.0f};
+}
+
 float smoothstep(float edge0, float edge1, float x) {
     x = clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
     return x * x * (3.0f - 2.0f * x);
@@ -15,20 +26,16 @@ float evaluate_terrain_height(float x, float y)
 {
 
       
-    //vec2 p_i[4] = { {-10,-10}, {5,5}, {-3,4}, {6,4} };
-    std::array<vec2, 13> p_i = {vec2{20.0f, 10.0f},vec2{16.0f, 8.0f},vec2{13.2f, 7.6f},vec2{8.4f, 8.8f},vec2{3.6f, 6.0f},vec2{-0.8f, 7.6f},
-            vec2{-6.0f, 7.6f},vec2{-10.8f, 8.8f},vec2{18.0f, -8.8f},vec2{12.8f, -7.6f},vec2{8.4f, -8.4f},vec2{6.0f, -8.8f},vec2{-16.0f, -10.0f}
-            };
-    float h_i[13] = {1.6f, 0.8f, 1.2f, 0.8f, 1.6f, 0.8f, 1.6f, 0.6f, 1.2f, 0.8f, 1.2f, 0.8f, -3.0f};
-    float sigma_i[13] = {4.4f, 2.4f, 2.0f, 2.8f, 3.2f, 1.6f, 2.4f, 2.0f,2.8f, 2.0f, 2.4f, 1.6f, 8.0f};
+    // The noise term does not depend on the hill: computed once, but still added at each iteration to keep the same height
+    float fade = 0.5f * (1.0f + std::cos(Pi * clamp(std::abs(y) / 10.0f, 0.0f, 1.0f)));
+    float const noise_term = 0.2f * noise_perlin({ x/10.0f, y/10.0f }, 4, 0.20f, 1.5f) * (1-fade);
 
     float z = 0.0f;
     for (int k = 0; k < 13; ++k)
     {
-        float d = norm(vec2(x, y) - p_i[k]) / sigma_i[k];
-        z += h_i[k] * std::exp(-(d * d));
-        float fade = 0.5f * (1.0f + std::cos(Pi * clamp(std::abs(y) / 10.0f, 0.0f, 1.0f)));
-        z += 0.2f * noise_perlin({ x/10.0f, y/10.0f }, 4, 0.20f, 1.5f) * (1-fade);
+        float d = norm(vec2(x, y) - terrain_hill_center[k]) / terrain_hill_sigma[k];
+        z += terrain_hill_height[k] * std::exp(-(d * d));
+        z += noise_term;
     }
 
     const float circle_radius = 4.0f;
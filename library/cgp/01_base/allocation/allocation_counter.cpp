@@ -0,0 +1,120 @@
+#include "allocation_counter.hpp"
+
+#include "cgp/cgp_parameters.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace cgp
+{
+	namespace
+	{
+		// Constant initialization: the counters can be used by the allocations done before the dynamic initialization of the statics
+		std::atomic<long long> total_count{ 0 };
+		std::atomic<long long> total_bytes{ 0 };
+		std::atomic<long long> total_free{ 0 };
+		thread_local long long thread_count = 0;
+		thread_local long long thread_bytes = 0;
+		thread_local long long thread_free = 0;
+
+		allocation_statistics frame_start;
+		allocation_statistics last_frame;
+	}
+
+	allocation_statistics operator-(allocation_statistics const& a, allocation_statistics const& b)
+	{
+		allocation_statistics d;
+		d.count = a.count - b.count;
+		d.bytes = a.bytes - b.bytes;
+		d.free_count = a.free_count - b.free_count;
+		return d;
+	}
+
+	allocation_statistics allocation_totals()
+	{
+		allocation_statistics s;
+		s.count = total_count.load(std::memory_order_relaxed);
+		s.bytes = total_bytes.load(std::memory_order_relaxed);
+		s.free_count = total_free.load(std::memory_order_relaxed);
+		return s;
+	}
+
+	allocation_statistics allocation_thread_totals()
+	{
+		allocation_statistics s;
+		s.count = thread_count;
+		s.bytes = thread_bytes;
+		s.free_count = thread_free;
+		return s;
+	}
+
+	void allocation_frame_begin()
+	{
+		allocation_statistics const now = allocation_totals();
+		last_frame = now - frame_start;
+		frame_start = now;
+	}
+
+	allocation_statistics allocation_last_frame()
+	{
+		return last_frame;
+	}
+
+#ifdef CGP_ALLOCATION_COUNTER
+	bool allocation_counter_active() { return true; }
+
+	namespace
+	{
+		void* counted_allocate(size_t bytes)
+		{
+			if (bytes == 0)
+				bytes = 1;
+			void* p = std::malloc(bytes);
+			if (p != nullptr) {
+				total_count.fetch_add(1, std::memory_order_relaxed);
+				total_bytes.fetch_add((long long)bytes, std::memory_order_relaxed);
+				thread_count++;
+				thread_bytes += (long long)bytes;
+			}
+			return p;
+		}
+		void* counted_allocate_or_throw(size_t bytes)
+		{
+			while (true) {
+				void* p = counted_allocate(bytes);
+				if (p != nullptr)
+					return p;
+				std::new_handler handler = std::get_new_handler();
+				if (handler == nullptr)
+					throw std::bad_alloc();
+				handler();
+			}
+		}
+		void counted_free(void* p)
+		{
+			if (p == nullptr)
+				return;
+			total_free.fetch_add(1, std::memory_order_relaxed);
+			thread_free++;
+			std::free(p);
+		}
+	}
+#else
+	bool allocation_counter_active() { return false; }
+#endif
+}
+
+#ifdef CGP_ALLOCATION_COUNTER
+// Replacement of the global operators (the aligned versions of C++17 are not replaced: they are not used by the library)
+void* operator new(size_t bytes) { return cgp::counted_allocate_or_throw(bytes); }
+void* operator new[](size_t bytes) { return cgp::counted_allocate_or_throw(bytes); }
+void* operator new(size_t bytes, std::nothrow_t const&) noexcept { return cgp::counted_allocate(bytes); }
+void* operator new[](size_t bytes, std::nothrow_t const&) noexcept { return cgp::counted_allocate(bytes); }
+void operator delete(void* p) noexcept { cgp::counted_free(p); }
+void operator delete[](void* p) noexcept { cgp::counted_free(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { cgp::counted_free(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { cgp::counted_free(p); }
+void operator delete(void* p, size_t) noexcept { cgp::counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { cgp::counted_free(p); }
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// Counters of the heap allocations
+//  Defining CGP_ALLOCATION_COUNTER replaces the global operator new/delete (allocation_counter.cpp) to count every allocation of the program, on all the threads.
+//  Otherwise the default operators are kept and all the counters stay at 0 (the replacement would clash with sanitizers and custom allocators).
+//  allocation_frame_begin() must be called once per frame: it stores the allocations of the previous frame (allocation_last_frame()).
+
+namespace cgp
+{
+	struct allocation_statistics {
+		long long count = 0;      // Number of allocations (operator new)
+		long long bytes = 0;      // Bytes requested by these allocations
+		long long free_count = 0; // Number of deallocations (operator delete)
+	};
+	allocation_statistics operator-(allocation_statistics const& a, allocation_statistics const& b);
+
+	// Allocations since the start of the program, on all the threads
+	allocation_statistics allocation_totals();
+	// Allocations of the calling thread
+	allocation_statistics allocation_thread_totals();
+
+	// Close the counter of the previous frame (all the threads)
+	void allocation_frame_begin();
+	allocation_statistics allocation_last_frame();
+
+	// True when the global operators are replaced (CGP_ALLOCATION_COUNTER is defined)
+	bool allocation_counter_active();
+}
@@ -0,0 +1,99 @@
+#include "memory_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cgp
+{
+	memory_arena::memory_arena(std::string const& name, size_t block_size_arg)
+		:arena_name(name), block_size(block_size_arg)
+	{}
+
+	void* memory_arena::allocate(size_t bytes, size_t alignment)
+	{
+		allocations++;
+		while (true) {
+			if (current < int(blocks.size())) {
+				block const& b = blocks[current];
+				std::uintptr_t const base = reinterpret_cast<std::uintptr_t>(b.data.get());
+				size_t const aligned = size_t((base + offset + alignment - 1) / alignment * alignment - base);
+				if (aligned + bytes <= b.size) {
+					offset = aligned + bytes;
+					used_peak = std::max(used_peak, used());
+					return b.data.get() + aligned;
+				}
+				if (offset == 0 && bytes + alignment > b.size) {
+					// Empty block too small for this allocation (kept for the next ones): a larger block is inserted before it
+					blocks.insert(blocks.begin() + current, block());
+				}
+				else {
+					used_full += b.size;
+					current++;
+					offset = 0;
+					continue;
+				}
+			}
+			else
+				blocks.push_back(block());
+
+			block& b = blocks[current];
+			b.size = std::max(block_size, bytes + alignment);
+			b.data.reset(new unsigned char[b.size]);
+		}
+	}
+
+	memory_arena_marker memory_arena::marker() const
+	{
+		return { current, offset };
+	}
+
+	void memory_arena::rewind(memory_arena_marker const& m)
+	{
+		current = m.block;
+		offset = m.offset;
+		used_full = 0;
+		for (int k = 0; k < current && k < int(blocks.size()); ++k)
+			used_full += blocks[k].size;
+	}
+
+	void memory_arena::reset()
+	{
+		rewind(memory_arena_marker());
+	}
+
+	void memory_arena::release_memory()
+	{
+		reset();
+		blocks.clear();
+	}
+
+	size_t memory_arena::used() const
+	{
+		return used_full + offset;
+	}
+
+	size_t memory_arena::capacity() const
+	{
+		size_t s = 0;
+		for (block const& b : blocks)
+			s += b.size;
+		return s;
+	}
+
+	memory_arena& frame_arena()
+	{
+		static memory_arena arena("frame");
+		return arena;
+	}
+
+	void memory_arena_frame_begin()
+	{
+		frame_arena().reset();
+	}
+
+	memory_arena& scratch_arena()
+	{
+		thread_local memory_arena arena("scratch");
+		return arena;
+	}
+}
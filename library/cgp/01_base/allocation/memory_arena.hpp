@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Arenas for the temporary allocations
+//  A memory_arena is a linear (bump) allocator: an allocation only moves an offset in a block, a deallocation does nothing,
+//  and all the allocations are released at once with reset() or rewind(marker). The blocks are kept for the next allocations.
+//  - frame_arena(): temporary data of the current frame, released by memory_arena_frame_begin() (to be called once per frame on the main thread)
+//  - scratch_arena(): temporary data of a function (one per thread), released at the end of a memory_arena_scope
+//      { memory_arena_scope scope(scratch_arena()); mesh m(scratch_arena()); ... }
+//  The containers of the library (numarray, mesh) accept an arena through arena_allocator (see numarray(memory_arena&)).
+//  The data in an arena must not be used after the reset/rewind: a copy of a numarray is always allocated on the heap.
+
+namespace cgp
+{
+	// Position in an arena (see memory_arena::marker())
+	struct memory_arena_marker {
+		int block = 0;
+		size_t offset = 0;
+	};
+
+	class memory_arena
+	{
+	public:
+		explicit memory_arena(std::string const& name = "arena", size_t block_size = 1 << 20);
+		memory_arena(memory_arena const&) = delete;
+		memory_arena& operator=(memory_arena const&) = delete;
+
+		// Allocate bytes in the current block (a new block is used if it doesn't fit). Never returns nullptr.
+		void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		// Release all the allocations done after the marker
+		memory_arena_marker marker() const;
+		void rewind(memory_arena_marker const& marker);
+		// Release all the allocations (the blocks are kept)
+		void reset();
+		// Free the blocks
+		void release_memory();
+
+		std::string const& name() const { return arena_name; }
+		size_t used() const;     // Bytes currently allocated (including the alignment padding)
+		size_t capacity() const; // Bytes of all the blocks
+		size_t peak() const { return used_peak; }
+		int block_count() const { return int(blocks.size()); }
+		long long allocation_count() const { return allocations; } // Number of calls to allocate since the creation
+
+	private:
+		struct block {
+			std::unique_ptr<unsigned char[]> data;
+			size_t size = 0;
+		};
+		std::string arena_name;
+		size_t block_size;
+		std::vector<block> blocks;
+		int current = 0;      // Index of the block used for the next allocation
+		size_t offset = 0;    // Offset in the current block
+		size_t used_full = 0; // Bytes of the blocks before the current one (the unused end of a block counts as used)
+		size_t used_peak = 0;
+		long long allocations = 0;
+	};
+
+	// Temporary data of the current frame (main thread only)
+	memory_arena& frame_arena();
+	// Release the frame arena: to be called at the beginning of each frame
+	void memory_arena_frame_begin();
+	// Temporary data of the calling thread, to be used with memory_arena_scope
+	memory_arena& scratch_arena();
+
+	// Rewind an arena at the end of the scope
+	class memory_arena_scope
+	{
+	public:
+		explicit memory_arena_scope(memory_arena& arena_arg) : arena(arena_arg), start(arena_arg.marker()) {}
+		~memory_arena_scope() { arena.rewind(start); }
+		memory_arena_scope(memory_arena_scope const&) = delete;
+		memory_arena_scope& operator=(memory_arena_scope const&) = delete;
+	private:
+		memory_arena& arena;
+		memory_arena_marker start;
+	};
+
+
+	// Allocator of the containers: allocations in an arena, or on the heap when the arena is nullptr (default)
+	//  A copy of a container is allocated on the heap (select_on_container_copy_construction), and a move assignment between
+	//  containers using different arenas copies the elements: only the containers created with an arena use it.
+	template <typename T>
+	struct arena_allocator
+	{
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::false_type;
+		using propagate_on_container_swap = std::false_type;
+
+		memory_arena* arena = nullptr;
+
+		arena_allocator() = default;
+		explicit arena_allocator(memory_arena* arena_arg) : arena(arena_arg) {}
+		template <typename U> arena_allocator(arena_allocator<U> const& other) : arena(other.arena) {}
+
+		T* allocate(size_t n)
+		{
+			if (arena == nullptr)
+				return static_cast<T*>(::operator new(n * sizeof(T)));
+			return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* p, size_t)
+		{
+			if (arena == nullptr)
+				::operator delete(p);
+		}
+		arena_allocator select_on_container_copy_construction() const { return arena_allocator(); }
+	};
+	template <typename T, typename U> bool operator==(arena_allocator<T> const& a, arena_allocator<U> const& b) { return a.arena == b.arena; }
+	template <typename T, typename U> bool operator!=(arena_allocator<T> const& a, arena_allocator<U> const& b) { return a.arena != b.arena; }
+}
@@ -0,0 +1,85 @@
+#include "cgp/01_base/base.hpp"
+#include "cgp/02_numarray/numarray/numarray.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+#include "../memory_arena.hpp"
+#include "../allocation_counter.hpp"
+
+#include <cstdint>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_memory_arena()
+	{
+		using namespace cgp;
+
+		// Alignment, rewind and reuse of the blocks
+		{
+			memory_arena arena("test", 256);
+			void* a = arena.allocate(3, 1);
+			void* b = arena.allocate(16, 16);
+			assert_cgp_no_msg(reinterpret_cast<std::uintptr_t>(b) % 16 == 0);
+			assert_cgp_no_msg(static_cast<char*>(b) >= static_cast<char*>(a) + 3);
+
+			memory_arena_marker const m = arena.marker();
+			void* c = arena.allocate(64);
+			arena.rewind(m);
+			assert_cgp_no_msg(arena.allocate(64) == c);
+
+			// Larger than a block: a dedicated block, the allocations continue after it
+			void* d = arena.allocate(1000);
+			assert_cgp_no_msg(arena.block_count() == 2);
+			assert_cgp_no_msg(arena.capacity() >= 256 + 1000);
+
+			arena.reset();
+			assert_cgp_no_msg(arena.used() == 0);
+			assert_cgp_no_msg(arena.allocate(3, 1) == a); // The blocks are kept
+			assert_cgp_no_msg(arena.peak() >= 1000);
+		}
+
+		// Containers in an arena: no heap allocation once the blocks exist, and the copies go back to the heap
+		{
+			memory_arena arena("test");
+			arena.allocate(1);
+			arena.reset();
+			allocation_statistics const start = allocation_thread_totals();
+			{
+				memory_arena_scope scope(arena);
+				numarray<vec3> a(100, arena);
+				for (int k = 0; k < 100; ++k)
+					a[k] = { float(k), 0.0f, 0.0f };
+				a.push_back(vec3{ 1.0f, 2.0f, 3.0f });
+				mesh m(arena);
+				m.reserve(4, 2);
+				m.position.push_back(vec3{ 0,0,0 }).push_back(vec3{ 1,0,0 }).push_back(vec3{ 1,1,0 }).push_back(vec3{ 0,1,0 });
+				m.connectivity.push_back(uint3{ 0,1,2 }).push_back(uint3{ 0,2,3 });
+				m.fill_empty_field();
+				assert_cgp_no_msg(m.normal.size() == 4 && m.color.size() == 4);
+				assert_cgp_no_msg(arena.used() > 0);
+			}
+			allocation_statistics const used = allocation_thread_totals() - start;
+			if (allocation_counter_active())
+				assert_cgp_no_msg(used.count == 0);
+			assert_cgp_no_msg(arena.used() == 0);
+
+			numarray<float> b(arena);
+			b.push_back(1.0f);
+			numarray<float> const c = b;
+			assert_cgp_no_msg(c.data.get_allocator().arena == nullptr);
+			assert_cgp_no_msg(c[0] == 1.0f);
+		}
+
+		// The counter records the heap allocations
+		if (allocation_counter_active()) {
+			allocation_statistics const start = allocation_thread_totals();
+			numarray<float> heap(1000);
+			allocation_statistics const used = allocation_thread_totals() - start;
+			assert_cgp_no_msg(used.count == 1);
+			assert_cgp_no_msg(used.bytes >= 1000 * (long long)sizeof(float));
+		}
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace cgp_test
+{
+	void test_memory_arena();
+}
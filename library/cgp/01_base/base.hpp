@@ -6,4 +6,6 @@
 #include "stl/stl.hpp"
 #include "types/types.hpp"
 #include "string/string.hpp"
+#include "allocation/memory_arena.hpp"
+#include "allocation/allocation_counter.hpp"
 
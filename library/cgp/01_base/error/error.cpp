@@ -47,6 +47,15 @@ void call_error(std::string const& assert_arg, std::string const& message, std::
 
 }
 
+void call_error_index(int index, int size, char const* container)
+{
+    std::string msg = "\n";
+    msg += "\t> Try to access " + std::string(container) + "[" + std::to_string(index) + "] with a size (or linear offset bound) = " + std::to_string(size) + "\n";
+    msg += "\t> The index should be in [0, " + std::to_string(size) + "[\n";
+    msg += "\t  Only the cheap bound check is active (CGP_BOUND_CHECK=1): use CGP_BOUND_CHECK=2 for a detailed message.\n";
+    call_error("", msg, __FILE__, __func__, __LINE__);
+}
+
 void call_warning(std::string const& message_id, std::string const& extra, std::string const& filename, std::string const& function_name, int line)
 {
 
@@ -54,6 +54,17 @@ struct cgp_warning {
 	#define warning_cgp(MESSAGE_ID, EXTRA) {}
 #endif
 
+// Cheap bound check used by the containers when CGP_BOUND_CHECK is 1 (see cgp_parameters.hpp)
+//  A single unsigned comparison (a negative index wraps to a large value): the error message is only built, out of line, when the check fails.
+namespace cgp{
+	[[noreturn]] void call_error_index(int index, int size, char const* container);
+	inline void check_index_bounds_cheap(int index, int size, char const* container)
+	{
+		if (static_cast<unsigned int>(index) >= static_cast<unsigned int>(size))
+			call_error_index(index, size, container);
+	}
+}
+
 namespace cgp{
 	template <typename T> void currently_unused(T const&) {}
 }
\ No newline at end of file
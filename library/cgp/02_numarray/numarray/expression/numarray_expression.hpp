@@ -0,0 +1,188 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+
+#include <type_traits>
+
+// Expression templates of the numarray operators
+//  The operators +, -, *, / between numarrays (and with a float for * and /) return a lightweight expression instead of a new numarray.
+//  The expression is evaluated element by element in a single loop when it is assigned to a numarray, or used with +=, -=, *=, /=:
+//    numarray<vec3> p = a + b * c;   // single loop, no intermediate numarray for b*c
+//  An expression only holds references on its numarray operands: assign it to a numarray instead of storing it with auto.
+//  Functions deducing the type of a numarray argument (ex. sum(numarray<T> const&)) expect an evaluated numarray: use numarray<T>(expression).
+
+namespace cgp
+{
+	template <typename T> struct numarray;
+
+	// Base of the expressions (static polymorphism: E is the actual expression type)
+	template <typename E>
+	struct numarray_expression
+	{
+		E const& derived() const { return static_cast<E const&>(*this); }
+	};
+
+	// Numarray operand of an expression
+	template <typename T>
+	struct numarray_expression_leaf : numarray_expression< numarray_expression_leaf<T> >
+	{
+		using value_type = T;
+		numarray<T> const& a;
+
+		explicit numarray_expression_leaf(numarray<T> const& a_arg) : a(a_arg) {}
+		int size() const { return a.size(); }
+		T const& operator[](int k) const { return a.at(k); } // Sizes are checked when the expression is built
+	};
+
+	// Element-wise operation between two expressions of the same size
+	template <typename A, typename B, typename OP>
+	struct numarray_expression_binary : numarray_expression< numarray_expression_binary<A, B, OP> >
+	{
+		using value_type = typename A::value_type;
+		A a;
+		B b;
+
+		numarray_expression_binary(A const& a_arg, B const& b_arg)
+			: a(a_arg), b(b_arg)
+		{
+			assert_cgp(a.size() > 0 && b.size() > 0, "Size must be >0");
+			assert_cgp(a.size() == b.size(), "Size do not agree");
+		}
+		int size() const { return a.size(); }
+		value_type operator[](int k) const { return OP::apply(a[k], b[k]); }
+	};
+
+	// Operation between every element of an expression and a scalar
+	template <typename A, typename OP>
+	struct numarray_expression_scalar : numarray_expression< numarray_expression_scalar<A, OP> >
+	{
+		using value_type = typename A::value_type;
+		A a;
+		float s;
+
+		numarray_expression_scalar(A const& a_arg, float s_arg) : a(a_arg), s(s_arg) {}
+		int size() const { return a.size(); }
+		value_type operator[](int k) const { return OP::apply(a[k], s); }
+	};
+
+	template <typename A>
+	struct numarray_expression_negate : numarray_expression< numarray_expression_negate<A> >
+	{
+		using value_type = typename A::value_type;
+		A a;
+
+		explicit numarray_expression_negate(A const& a_arg) : a(a_arg) {}
+		int size() const { return a.size(); }
+		value_type operator[](int k) const { return -a[k]; }
+	};
+
+
+	namespace detail
+	{
+		struct numarray_op_add { template <typename U, typename V> static auto apply(U const& u, V const& v) -> decltype(u + v) { return u + v; } };
+		struct numarray_op_sub { template <typename U, typename V> static auto apply(U const& u, V const& v) -> decltype(u - v) { return u - v; } };
+		struct numarray_op_mul { template <typename U, typename V> static auto apply(U const& u, V const& v) -> decltype(u * v) { return u * v; } };
+		struct numarray_op_div { template <typename U, typename V> static auto apply(U const& u, V const& v) -> decltype(u / v) { return u / v; } };
+		// Scalar on the left side: s*u
+		struct numarray_op_mul_left { template <typename U> static auto apply(U const& u, float s) -> decltype(s * u) { return s * u; } };
+
+		// Type of the expression used for an operand: numarrays are wrapped in a leaf, expressions are kept as they are.
+		//  Other types have no member "type", which removes the operators below from the overload resolution.
+		template <typename X, typename Enable = void>
+		struct numarray_operand {};
+		template <typename T>
+		struct numarray_operand< numarray<T> > {
+			using type = numarray_expression_leaf<T>;
+			static type wrap(numarray<T> const& x) { return type(x); }
+		};
+		template <typename E>
+		struct numarray_operand<E, typename std::enable_if< std::is_base_of<numarray_expression<E>, E>::value >::type> {
+			using type = E;
+			static E const& wrap(E const& x) { return x; }
+		};
+
+		// Binary expression between A and B, defined only when both are numarray operands with the same element type
+		template <typename A, typename B, typename OP>
+		using numarray_binary_t = typename std::enable_if<
+			std::is_same<typename numarray_operand<A>::type::value_type, typename numarray_operand<B>::type::value_type>::value,
+			numarray_expression_binary<typename numarray_operand<A>::type, typename numarray_operand<B>::type, OP> >::type;
+
+		template <typename A, typename OP>
+		using numarray_scalar_t = numarray_expression_scalar<typename numarray_operand<A>::type, OP>;
+	}
+
+
+	template <typename A, typename B> detail::numarray_binary_t<A, B, detail::numarray_op_add> operator+(A const& a, B const& b)
+	{
+		return { detail::numarray_operand<A>::wrap(a), detail::numarray_operand<B>::wrap(b) };
+	}
+	template <typename A, typename B> detail::numarray_binary_t<A, B, detail::numarray_op_sub> operator-(A const& a, B const& b)
+	{
+		return { detail::numarray_operand<A>::wrap(a), detail::numarray_operand<B>::wrap(b) };
+	}
+	template <typename A, typename B> detail::numarray_binary_t<A, B, detail::numarray_op_mul> operator*(A const& a, B const& b)
+	{
+		return { detail::numarray_operand<A>::wrap(a), detail::numarray_operand<B>::wrap(b) };
+	}
+	template <typename A, typename B> detail::numarray_binary_t<A, B, detail::numarray_op_div> operator/(A const& a, B const& b)
+	{
+		return { detail::numarray_operand<A>::wrap(a), detail::numarray_operand<B>::wrap(b) };
+	}
+
+	template <typename A> detail::numarray_scalar_t<A, detail::numarray_op_mul> operator*(A const& a, float s)
+	{
+		return { detail::numarray_operand<A>::wrap(a), s };
+	}
+	template <typename A> detail::numarray_scalar_t<A, detail::numarray_op_mul_left> operator*(float s, A const& a)
+	{
+		return { detail::numarray_operand<A>::wrap(a), s };
+	}
+	template <typename A> detail::numarray_scalar_t<A, detail::numarray_op_div> operator/(A const& a, float s)
+	{
+		return { detail::numarray_operand<A>::wrap(a), s };
+	}
+	template <typename A> numarray_expression_negate<typename detail::numarray_operand<A>::type> operator-(A const& a)
+	{
+		return numarray_expression_negate<typename detail::numarray_operand<A>::type>(detail::numarray_operand<A>::wrap(a));
+	}
+
+
+	// Compound assignment with an expression: a single loop writing directly in the numarray
+	//  The numarray can also be an operand of the expression (ex. a += a*b) as each element only depends on the same index.
+	template <typename T, typename E> numarray<T>& operator+=(numarray<T>& a, numarray_expression<E> const& e)
+	{
+		E const& x = e.derived();
+		assert_cgp(a.size() == x.size(), "Size do not agree");
+		int const N = a.size();
+		for (int k = 0; k < N; ++k)
+			a.at(k) += x[k];
+		return a;
+	}
+	template <typename T, typename E> numarray<T>& operator-=(numarray<T>& a, numarray_expression<E> const& e)
+	{
+		E const& x = e.derived();
+		assert_cgp(a.size() == x.size(), "Size do not agree");
+		int const N = a.size();
+		for (int k = 0; k < N; ++k)
+			a.at(k) -= x[k];
+		return a;
+	}
+	template <typename T, typename E> numarray<T>& operator*=(numarray<T>& a, numarray_expression<E> const& e)
+	{
+		E const& x = e.derived();
+		assert_cgp(a.size() == x.size(), "Size do not agree");
+		int const N = a.size();
+		for (int k = 0; k < N; ++k)
+			a.at(k) *= x[k];
+		return a;
+	}
+	template <typename T, typename E> numarray<T>& operator/=(numarray<T>& a, numarray_expression<E> const& e)
+	{
+		E const& x = e.derived();
+		assert_cgp(a.size() == x.size(), "Size do not agree");
+		int const N = a.size();
+		for (int k = 0; k < N; ++k)
+			a.at(k) /= x[k];
+		return a;
+	}
+}
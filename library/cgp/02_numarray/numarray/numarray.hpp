@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cgp/01_base/base.hpp"
+#include "expression/numarray_expression.hpp"
 
 #include <vector>
 #include <iostream>
@@ -16,23 +17,35 @@ namespace cgp
  *
  * The numarray structure is a wrapper around an std::vector with additional convenient functionalities
  * - Overloaded operators + - * / as well as common outputs
- * - Strict bound checking with operator [] and () (unless cgp_NO_DEBUG is defined)
+ *   (the operators + - * / return expression templates evaluated in a single loop - see numarray_expression.hpp)
+ * - Strict bound checking with operator [] and () (level set by CGP_BOUND_CHECK, see cgp_parameters.hpp)
  *
  * Numarray follows the main syntax than std::vector
  * Elements in a numarray are stored contiguously in memory (use std::vector internally)
+ * The elements are allocated on the heap, or in a memory_arena for temporary data (see memory_arena.hpp)
  *
  **/
 template <typename T>
 struct numarray
 {
-    /** Internal data stored as std::vector */
-    std::vector<T> data;
+    using container_type = std::vector<T, arena_allocator<T> >;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    /** Internal data stored as std::vector (using the heap, or an arena) */
+    container_type data;
 
     // Constructors
     numarray();                             // Empty numarray - no elements 
     numarray(int size);                     // numarray with a given size 
     numarray(std::initializer_list<T> arg); // Inline initialization using { } 
     numarray(std::vector<T> const& arg);    // Direct initialization from std::vector 
+    explicit numarray(memory_arena& arena);           // Empty numarray allocating its elements in the arena
+    numarray(int size, memory_arena& arena);          // numarray with a given size allocated in the arena
+    template <typename E> numarray(numarray_expression<E> const& e); // Evaluation of an expression (ex. a+b*c)
+
+    /** Evaluation of an expression in a single loop (the numarray is resized to the size of the expression) */
+    template <typename E> numarray<T>& operator=(numarray_expression<E> const& e);
 
     /** Similar to matlab linespace 
     * Linear interpolation between p1 and p2 along N variable */
@@ -42,6 +55,8 @@ struct numarray
     int size() const;
     /** Resize container to a new size (similar to vector.resize()) */
     numarray<T>& resize(int size);
+    /** Reserve memory for at least capacity elements (similar to vector.reserve()) */
+    numarray<T>& reserve(int capacity);
     /** Resize container to a new size, and clear it initialy to delete previous values */
     numarray<T>& resize_clear(int size);
     /** Add an element at the end of the container (similar to vector.push_back()) */
@@ -56,7 +71,7 @@ struct numarray
 
     /** Element access
      * Allows numarray[i], numarray(i), and numarray.at(i)
-     * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+     * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
     T const& operator[](int index) const;
     T& operator[](int index);
     T const& operator()(int index) const;
@@ -69,12 +84,12 @@ struct numarray
     /** Iterators
      * Iterators on numarray are compatible with STL syntax
      * allows "forall" loops (for(auto& e : numarray) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
 
     /** Direct access to the value - doesn't check index bounds*/
     // Depreciated function - use at() instead
@@ -116,25 +131,14 @@ template <typename T> T sum(numarray<T> const& a);
 
 
 /** Math operators
- * Common mathematical operations between numarrays, and scalar or element values. */
-template <typename T> numarray<T>  operator-(numarray<T> const& a);
-
+ * Common mathematical operations between numarrays, and scalar or element values.
+ * The operators -a, a+b, a-b, a*b, a/b, a*s, s*a, a/s between numarrays (or expressions) are defined in numarray_expression.hpp */
 template <typename T> numarray<T>& operator+=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b);
-
 template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b);
-
 template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator*=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b);
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b);
-
 template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator/=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b);
 
 // Allow componentwise operations
 template <typename T> numarray<T>  sub(numarray<T> const& a, T const& b);
@@ -175,9 +179,37 @@ numarray<T>::numarray(std::initializer_list<T> arg)
 
 template <typename T>
 numarray<T>::numarray(const std::vector<T>& arg)
-    :data(arg)
+    :data(arg.begin(), arg.end())
+{}
+
+template <typename T>
+numarray<T>::numarray(memory_arena& arena)
+    :data(arena_allocator<T>(&arena))
 {}
 
+template <typename T>
+numarray<T>::numarray(int size, memory_arena& arena)
+    :data(size, T(), arena_allocator<T>(&arena))
+{}
+
+template <typename T> template <typename E>
+numarray<T>::numarray(numarray_expression<E> const& e)
+    :data()
+{
+    *this = e;
+}
+
+template <typename T> template <typename E>
+numarray<T>& numarray<T>::operator=(numarray_expression<E> const& e)
+{
+    E const& x = e.derived();
+    int const N = x.size();
+    data.resize(N);
+    for(int k=0; k<N; ++k)
+        data[k] = x[k];
+    return *this;
+}
+
 template <typename T>
 int numarray<T>::size() const
 {
@@ -192,6 +224,14 @@ numarray<T>& numarray<T>::resize(int size)
     return *this;
 }
 
+template <typename T>
+numarray<T>& numarray<T>::reserve(int capacity)
+{
+    assert_cgp_no_msg(capacity>=0);
+    data.reserve(capacity);
+    return *this;
+}
+
 template <typename T>
 numarray<T>& numarray<T>::resize_clear(int size)
 {
@@ -210,8 +250,7 @@ numarray<T>& numarray<T>::push_back(T const& value)
 template <typename T>
 numarray<T>& numarray<T>::push_back(numarray<T> const& value)
 {
-    for(T const& element : value)
-        data.push_back(element);
+    data.insert(data.end(), value.data.begin(), value.data.end());
     return *this;
 }
 
@@ -238,7 +277,7 @@ template <typename T> std::string type_str(numarray<T> const&)
 }
 
 
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
 template <typename T>
 void check_index_bounds(int index, numarray<T> const& data)
 {
@@ -294,6 +333,11 @@ void check_index_bounds(int index, numarray<T> const& data)
         error_cgp(msg);
     }
 }
+#elif CGP_BOUND_CHECK == 1
+template <typename T> void check_index_bounds(int index, numarray<T> const& data)
+{
+    check_index_bounds_cheap(index, data.size(), "numarray");
+}
 #else
 template <typename T> void check_index_bounds(int , numarray<T> const& ) {}
 #endif
@@ -346,37 +390,37 @@ T& numarray<T>::at_unsafe(int index)
 
 
 template <typename T>
-typename std::vector<T>::iterator numarray<T>::begin()
+typename numarray<T>::iterator numarray<T>::begin()
 {
     return data.begin();
 }
 
 template <typename T>
-typename std::vector<T>::iterator numarray<T>::end()
+typename numarray<T>::iterator numarray<T>::end()
 {
     return data.end();
 }
 
 template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::begin() const
+typename numarray<T>::const_iterator numarray<T>::begin() const
 {
     return data.begin();
 }
 
 template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::end() const
+typename numarray<T>::const_iterator numarray<T>::end() const
 {
     return data.end();
 }
 
 template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::cbegin() const
+typename numarray<T>::const_iterator numarray<T>::cbegin() const
 {
     return data.cbegin();
 }
 
 template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::cend() const
+typename numarray<T>::const_iterator numarray<T>::cend() const
 {
     return data.cend();
 }
@@ -469,15 +513,6 @@ numarray<T>& operator+=(numarray<T>& a, numarray<T> const& b)
 }
 
 
-
-template <typename T>
-numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res += b;
-    return res;
-}
-
 template <typename T>
 numarray<T>  operator+(numarray<T> const& a, T const& b)
 {
@@ -496,16 +531,6 @@ numarray<T>  operator+(T const& a, numarray<T> const& b)
     return res;
 }
 
-template <typename T> numarray<T>  operator-(numarray<T> const& a)
-{
-    int const N = a.size();
-    numarray<T> b(N);
-    for(int k=0; k<N; ++k)
-        b[k] = -a[k];
-    return b;
-}
-
-
 template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b)
 {
     assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
@@ -517,13 +542,6 @@ template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const&
     return a;
 }
 
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res -= b;
-    return res;
-}
-
 
 template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b)
 {
@@ -535,15 +553,6 @@ template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const&
         a[k] *= b[k];
     return a;
 }
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res *= b;
-    return res;
-}
-
-
-
 
 template <typename T> numarray<T>& operator*=(numarray<T>& a, float b)
 {
@@ -552,22 +561,6 @@ template <typename T> numarray<T>& operator*=(numarray<T>& a, float b)
         a[k] *= b;
     return a;
 }
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b)
-{
-    int const N = a.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a[k]*b;
-    return res;
-}
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a*b[k];
-    return res;
-}
 
 template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b)
 {
@@ -587,18 +580,6 @@ template <typename T> numarray<T>& operator/=(numarray<T>& a, float b)
         a[k] /= b;
     return a;
 }
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res /= b;
-    return res;
-}
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b)
-{
-    numarray<T> res = a;
-    res /= b;
-    return res;
-}
 
 
 
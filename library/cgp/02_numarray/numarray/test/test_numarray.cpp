@@ -114,5 +114,28 @@ namespace cgp_test
 			assert_cgp_no_msg(cgp::is_equal(sum(a),  4.5f+8.2f+6.1f-3.6));
 		}
 
+		// test expression templates
+		{
+			cgp::numarray<float> a = { 1.0f, 2.0f, 3.0f };
+			cgp::numarray<float> b = { 2.0f, 4.0f, 6.0f };
+			cgp::numarray<float> c = { -1.0f, 0.5f, 2.0f };
+
+			cgp::numarray<float> r = a + b * c;
+			assert_cgp_no_msg(cgp::is_equal(r, { -1.0f, 4.0f, 15.0f }));
+			r = -(a - b) / 2.0f + 2.0f * c;
+			assert_cgp_no_msg(cgp::is_equal(r, { -1.5f, 2.0f, 5.5f }));
+			r += a * 2.0f - b;
+			assert_cgp_no_msg(cgp::is_equal(r, { -1.5f, 2.0f, 5.5f }));
+			r *= b / a;
+			assert_cgp_no_msg(cgp::is_equal(r, { -3.0f, 4.0f, 11.0f }));
+			r = r * a; // the result can be an operand
+			assert_cgp_no_msg(cgp::is_equal(r, { -3.0f, 8.0f, 33.0f }));
+
+			cgp::numarray<float> d;
+			d = a + b; // resized
+			assert_cgp_no_msg(cgp::is_equal(d, { 3.0f, 6.0f, 9.0f }));
+			assert_cgp_no_msg(cgp::is_equal(sum(cgp::numarray<float>(a * b)), 28.0f));
+		}
+
 	}
 }
\ No newline at end of file
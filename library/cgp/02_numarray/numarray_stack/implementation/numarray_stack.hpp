@@ -27,7 +27,7 @@ namespace cgp
         // ******************************************************* //
 
         /** Size of the buffer (N - known at compile time) */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
         numarray_stack<T,N>& fill(T const& value);
@@ -40,7 +40,7 @@ namespace cgp
 
         /** Element access
          * Allows buffer[i], buffer(i), and buffer.at(i)
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         T const& operator[](int index) const;
         T& operator[](int index);
 
@@ -70,8 +70,8 @@ namespace cgp
     template <typename T, int N> std::ostream& operator<<(std::ostream& s, numarray_stack<T, N> const& v);
 
     /** Direct compiled-checked access to data */
-    template <int idx, typename T, int N> T const& get(numarray_stack<T,N> const& data);
-    template <int idx, typename T, int N> T& get(numarray_stack<T, N>& data);
+    template <int idx, typename T, int N> constexpr T const& get(numarray_stack<T,N> const& data);
+    template <int idx, typename T, int N> constexpr T& get(numarray_stack<T, N>& data);
 
 
     /** Convert all elements of the buffer to a string.
@@ -167,7 +167,7 @@ namespace cgp
 {
 
 
-    template <typename T, int N> int numarray_stack<T, N>::size() const
+    template <typename T, int N> constexpr int numarray_stack<T, N>::size() const
     {
         return N;
     }
@@ -180,7 +180,7 @@ namespace cgp
     }
 
 
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
     template <typename T, int N, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE index, numarray_stack<T, N> const& data)
     {
@@ -223,6 +223,12 @@ namespace cgp
         }
 
     }
+#elif CGP_BOUND_CHECK == 1
+    template <typename T, int N, typename INDEX_TYPE>
+    void check_index_bounds(INDEX_TYPE index, numarray_stack<T, N> const& )
+    {
+        check_index_bounds_cheap(int(index), N, "numarray_stack");
+    }
 #else
     template <typename T, int N, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE , numarray_stack<T, N> const& )
@@ -282,15 +288,15 @@ namespace cgp
     }
 
 
-    template <int idx, typename T, int N> T const& get(numarray_stack<T, N> const& data)
+    template <int idx, typename T, int N> constexpr T const& get(numarray_stack<T, N> const& data)
     {
         static_assert(idx>=0 && idx < N, "Incorrect element indexing");
-        return data.data[idx];
+        return std::get<idx>(data.data);
     }
-    template <int idx, typename T, int N> T& get(numarray_stack<T, N>& data)
+    template <int idx, typename T, int N> constexpr T& get(numarray_stack<T, N>& data)
     {
         static_assert(idx>=0 && idx < N, "Incorrect element indexing");
-        return data.data[idx];
+        return std::get<idx>(data.data);
     }
 
 
@@ -461,10 +467,9 @@ namespace cgp
 
     template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
         for (int k = 0; k < N; ++k)
-            res[k] = a[k] / b[k];
-        return res;
+            a[k] /= b[k];
+        return a;
     }
     template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, float b)
     {
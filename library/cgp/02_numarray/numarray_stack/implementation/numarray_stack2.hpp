@@ -13,24 +13,24 @@ namespace cgp
         T x, y;
 
 
-        numarray_stack<T, 2>();
-        numarray_stack<T, 2>(T const& x, T const& y);
+        constexpr numarray_stack<T, 2>();
+        constexpr numarray_stack<T, 2>(T const& x, T const& y);
         template<typename T1,typename T2>
-        numarray_stack<T, 2>(T1 const& x, T2 const& y);
-        numarray_stack<T, 2>(numarray_stack<T,3> const& v);
-        numarray_stack<T, 2>(numarray_stack<T,4> const& v);
+        constexpr numarray_stack<T, 2>(T1 const& x, T2 const& y);
+        constexpr numarray_stack<T, 2>(numarray_stack<T,3> const& v);
+        constexpr numarray_stack<T, 2>(numarray_stack<T,4> const& v);
 
 
     
         /** Size of the buffer = 2 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
-        numarray_stack<T, 2>& fill(T const& value);
+        constexpr numarray_stack<T, 2>& fill(T const& value);
 
         /** Element access
          * Allows buffer[i], buffer(i), and buffer.at(i)
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         T const& operator[](int index) const;
         T& operator[](int index);
 
@@ -61,48 +61,48 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T>  numarray_stack<T, 2>::numarray_stack()
+    template <typename T>  constexpr numarray_stack<T, 2>::numarray_stack()
         :x(T()),y(T())
     {}
 
-    template <typename T>  numarray_stack<T, 2>::numarray_stack(T const& x_arg, T const& y_arg)
+    template <typename T>  constexpr numarray_stack<T, 2>::numarray_stack(T const& x_arg, T const& y_arg)
         :x(x_arg),y(y_arg)
     {}
 
     template <typename T>
     template <typename T1,typename T2>
-    numarray_stack<T, 2>::numarray_stack(T1 const& x_arg, T2 const& y_arg)
+    constexpr numarray_stack<T, 2>::numarray_stack(T1 const& x_arg, T2 const& y_arg)
         :x(x_arg),y(y_arg)
     {}
 
     template <typename T>
-    numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 3> const& v)
+    constexpr numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 3> const& v)
         : x(v.x), y(v.y)
     {}
 
     template <typename T>
-    numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 4> const& v)
+    constexpr numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 4> const& v)
         : x(v.x), y(v.y)
     {}
     
-    template <typename T> int numarray_stack<T, 2>::size() const
+    template <typename T> constexpr int numarray_stack<T, 2>::size() const
     {
         return 2;
     }
 
 
 
-    template <typename T>  numarray_stack<T, 2>& numarray_stack<T, 2>::fill(T const& value)
+    template <typename T> constexpr numarray_stack<T, 2>& numarray_stack<T, 2>::fill(T const& value)
     {
         x = value;
         y = value;
         return *this;
     }
 
-    template <typename T, int N, typename INDEX_TYPE>
+    template <typename T, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE index, numarray_stack<T, 2> const& data)
     {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
         if (index < 0 || index>1)
         {
             std::string msg = "\n";
@@ -110,6 +110,8 @@ namespace cgp
             msg += " - Indexing is limited to 0 or 1";
             error_cgp(msg);
         }
+#elif CGP_BOUND_CHECK == 1
+        check_index_bounds_cheap(int(index), data.size(), "numarray_stack");
 #endif
     }
 
@@ -158,15 +160,15 @@ namespace cgp
     template <typename T> T const* numarray_stack<T, 2>::cend() const { return &y+1; }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 2> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 2> const& data)
     {
-        static_assert(idx < 2, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 2, "Incorrect element indexing");
+        return idx == 0 ? data.x : data.y;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 2>& data)
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 2>& data)
     {
-        static_assert(idx < 2, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 2, "Incorrect element indexing");
+        return idx == 0 ? data.x : data.y;
     }
 
 
@@ -175,4 +177,83 @@ namespace cgp
     {
         return "numarray_stack2<" + type_str(T()) + ">";
     }
+
+
+    // Unrolled operators for the size 2
+    //  More specialized than the generic loops of numarray_stack.hpp, and usable in constant expressions (constexpr)
+    template <typename T> constexpr numarray_stack<T, 2> operator-(numarray_stack<T, 2> const& a)
+    {
+        return numarray_stack<T, 2>(-a.x, -a.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator+=(numarray_stack<T, 2>& a, numarray_stack<T, 2> const& b)
+    {
+        a.x += b.x; a.y += b.y;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator+(numarray_stack<T, 2> const& a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a.x + b.x, a.y + b.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator-=(numarray_stack<T, 2>& a, numarray_stack<T, 2> const& b)
+    {
+        a.x -= b.x; a.y -= b.y;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator-(numarray_stack<T, 2> const& a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a.x - b.x, a.y - b.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator*=(numarray_stack<T, 2>& a, numarray_stack<T, 2> const& b)
+    {
+        a.x *= b.x; a.y *= b.y;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator*(numarray_stack<T, 2> const& a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a.x * b.x, a.y * b.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator/=(numarray_stack<T, 2>& a, numarray_stack<T, 2> const& b)
+    {
+        a.x /= b.x; a.y /= b.y;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator/(numarray_stack<T, 2> const& a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a.x / b.x, a.y / b.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator*=(numarray_stack<T, 2>& a, float b)
+    {
+        a.x *= b; a.y *= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator*(numarray_stack<T, 2> const& a, float b)
+    {
+        return numarray_stack<T, 2>(a.x * b, a.y * b);
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator*(float a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a * b.x, a * b.y);
+    }
+    template <typename T> constexpr numarray_stack<T, 2>& operator/=(numarray_stack<T, 2>& a, float b)
+    {
+        a.x /= b; a.y /= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator/(numarray_stack<T, 2> const& a, float b)
+    {
+        return numarray_stack<T, 2>(a.x / b, a.y / b);
+    }
+    template <typename T> constexpr numarray_stack<T, 2> operator/(float a, numarray_stack<T, 2> const& b)
+    {
+        return numarray_stack<T, 2>(a / b.x, a / b.y);
+    }
+    template <typename T> constexpr T dot(numarray_stack<T, 2> const& a, numarray_stack<T, 2> const& b)
+    {
+        return a.x * b.x + a.y * b.y;
+    }
+    template <typename T> constexpr T sum(numarray_stack<T, 2> const& a)
+    {
+        return a.x + a.y;
+    }
+
 }
\ No newline at end of file
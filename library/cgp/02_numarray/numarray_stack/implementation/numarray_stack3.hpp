@@ -16,24 +16,24 @@ namespace cgp
 
 
 
-        numarray_stack<T, 3>();
-        numarray_stack<T, 3>(T const& x, T const& y, T const& z);
-        numarray_stack<T, 3>(numarray_stack<T, 2> const& xy, T const& z);
-        numarray_stack<T, 3>(T const& x, numarray_stack<T, 2> const& yz);
+        constexpr numarray_stack<T, 3>();
+        constexpr numarray_stack<T, 3>(T const& x, T const& y, T const& z);
+        constexpr numarray_stack<T, 3>(numarray_stack<T, 2> const& xy, T const& z);
+        constexpr numarray_stack<T, 3>(T const& x, numarray_stack<T, 2> const& yz);
         template<typename T1,typename T2, typename T3>
-        numarray_stack<T,3>(T1 const& x, T2 const& y, T3 const& z);
+        constexpr numarray_stack<T,3>(T1 const& x, T2 const& y, T3 const& z);
 
 
 
         /** Size of the buffer = 3 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
-        numarray_stack<T, 3>& fill(T const& value);
+        constexpr numarray_stack<T, 3>& fill(T const& value);
 
         /** Element access
          * Allows buffer[i], buffer(i), and buffer.at(i)
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         T const& operator[](int index) const;
         T& operator[](int index);
 
@@ -57,9 +57,9 @@ namespace cgp
         T& at_unsafe(int index) { return (&x)[index]; }
 
         /** Sub-vector */
-        numarray_stack<T,2> xy() const;
-        numarray_stack<T,2> yz() const;
-        numarray_stack<T,2> xz() const;
+        constexpr numarray_stack<T,2> xy() const;
+        constexpr numarray_stack<T,2> yz() const;
+        constexpr numarray_stack<T,2> xz() const;
     };
 
 
@@ -70,34 +70,34 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T> numarray_stack<T, 3>::numarray_stack()
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack()
         :x(T()),y(T()),z(T())
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg)
         : x(x_arg), y(y_arg), z(z_arg)
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg)
         : x(get<0>(xy)), y(get<1>(xy)), z(z_arg)
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz)
         : x(x_arg), y(get<0>(yz)), z(get<1>(yz))
     {}
 
     template <typename T>
     template<typename T1,typename T2, typename T3>
-    numarray_stack<T, 3>::numarray_stack(T1 const& x_arg, T2 const& y_arg, T3 const& z_arg)
+    constexpr numarray_stack<T, 3>::numarray_stack(T1 const& x_arg, T2 const& y_arg, T3 const& z_arg)
         :x(T(x_arg)), y(T(y_arg)), z(T(z_arg))
     {}
 
 
-    template <typename T> int numarray_stack<T, 3>::size() const
+    template <typename T> constexpr int numarray_stack<T, 3>::size() const
     {
         return 3;
     }
 
 
 
-    template <typename T>  numarray_stack<T, 3>& numarray_stack<T, 3>::fill(T const& value)
+    template <typename T> constexpr numarray_stack<T, 3>& numarray_stack<T, 3>::fill(T const& value)
     {
         x = value;
         y = value;
@@ -105,8 +105,8 @@ namespace cgp
         return *this;
     }
 
-#ifndef cgp_NO_DEBUG
-    template <typename T, int N, typename INDEX_TYPE>
+#if CGP_BOUND_CHECK >= 2
+    template <typename T, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE index, numarray_stack<T, 3> const& data)
     {
 
@@ -118,8 +118,14 @@ namespace cgp
             error_cgp(msg);
         }
     }
+#elif CGP_BOUND_CHECK == 1
+    template <typename T, typename INDEX_TYPE>
+    void check_index_bounds(INDEX_TYPE index, numarray_stack<T, 3> const&)
+    {
+        check_index_bounds_cheap(int(index), 3, "numarray_stack");
+    }
 #else
-    template <typename T, int N, typename INDEX_TYPE>
+    template <typename T, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE, numarray_stack<T, 3> const&) {}
 #endif
 
@@ -170,29 +176,29 @@ namespace cgp
 
 
 
-    template <typename T> numarray_stack<T,2> numarray_stack<T, 3>::xy() const
+    template <typename T> constexpr numarray_stack<T,2> numarray_stack<T, 3>::xy() const
     {
         return numarray_stack<T, 2>{x, y};
     }
-    template <typename T> numarray_stack<T,2> numarray_stack<T, 3>::yz() const
+    template <typename T> constexpr numarray_stack<T,2> numarray_stack<T, 3>::yz() const
     {
         return numarray_stack<T, 2>{y, z};
     }
-    template <typename T> numarray_stack<T,2> numarray_stack<T, 3>::xz() const
+    template <typename T> constexpr numarray_stack<T,2> numarray_stack<T, 3>::xz() const
     {
         return numarray_stack<T, 2>{x, z};
     }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 3> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 3> const& data)
     {
-        static_assert(idx < 3, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 3, "Incorrect element indexing");
+        return idx == 0 ? data.x : idx == 1 ? data.y : data.z;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 3>& data)
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 3>& data)
     {
-        static_assert(idx < 3, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 3, "Incorrect element indexing");
+        return idx == 0 ? data.x : idx == 1 ? data.y : data.z;
     }
 
 
@@ -202,5 +208,81 @@ namespace cgp
     }
 
 
+    // Unrolled operators for the size 3
+    //  More specialized than the generic loops of numarray_stack.hpp, and usable in constant expressions (constexpr)
+    template <typename T> constexpr numarray_stack<T, 3> operator-(numarray_stack<T, 3> const& a)
+    {
+        return numarray_stack<T, 3>(-a.x, -a.y, -a.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator+=(numarray_stack<T, 3>& a, numarray_stack<T, 3> const& b)
+    {
+        a.x += b.x; a.y += b.y; a.z += b.z;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator+(numarray_stack<T, 3> const& a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a.x + b.x, a.y + b.y, a.z + b.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator-=(numarray_stack<T, 3>& a, numarray_stack<T, 3> const& b)
+    {
+        a.x -= b.x; a.y -= b.y; a.z -= b.z;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator-(numarray_stack<T, 3> const& a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator*=(numarray_stack<T, 3>& a, numarray_stack<T, 3> const& b)
+    {
+        a.x *= b.x; a.y *= b.y; a.z *= b.z;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator*(numarray_stack<T, 3> const& a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a.x * b.x, a.y * b.y, a.z * b.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator/=(numarray_stack<T, 3>& a, numarray_stack<T, 3> const& b)
+    {
+        a.x /= b.x; a.y /= b.y; a.z /= b.z;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator/(numarray_stack<T, 3> const& a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a.x / b.x, a.y / b.y, a.z / b.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator*=(numarray_stack<T, 3>& a, float b)
+    {
+        a.x *= b; a.y *= b; a.z *= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator*(numarray_stack<T, 3> const& a, float b)
+    {
+        return numarray_stack<T, 3>(a.x * b, a.y * b, a.z * b);
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator*(float a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a * b.x, a * b.y, a * b.z);
+    }
+    template <typename T> constexpr numarray_stack<T, 3>& operator/=(numarray_stack<T, 3>& a, float b)
+    {
+        a.x /= b; a.y /= b; a.z /= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator/(numarray_stack<T, 3> const& a, float b)
+    {
+        return numarray_stack<T, 3>(a.x / b, a.y / b, a.z / b);
+    }
+    template <typename T> constexpr numarray_stack<T, 3> operator/(float a, numarray_stack<T, 3> const& b)
+    {
+        return numarray_stack<T, 3>(a / b.x, a / b.y, a / b.z);
+    }
+    template <typename T> constexpr T dot(numarray_stack<T, 3> const& a, numarray_stack<T, 3> const& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+    template <typename T> constexpr T sum(numarray_stack<T, 3> const& a)
+    {
+        return a.x + a.y + a.z;
+    }
 
 }
\ No newline at end of file
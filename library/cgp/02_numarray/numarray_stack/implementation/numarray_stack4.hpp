@@ -13,26 +13,26 @@ namespace cgp
         T x, y, z, w;
 
 
-        numarray_stack<T, 4>();
-        numarray_stack<T, 4>(T const& x, T const& y, T const& z, T const& w);
-        numarray_stack<T, 4>(numarray_stack<T, 3> const& xyz, T const& w);
-        numarray_stack<T, 4>(T const& x, numarray_stack<T, 3> const& yzw);
+        constexpr numarray_stack<T, 4>();
+        constexpr numarray_stack<T, 4>(T const& x, T const& y, T const& z, T const& w);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 3> const& xyz, T const& w);
+        constexpr numarray_stack<T, 4>(T const& x, numarray_stack<T, 3> const& yzw);
 
-        numarray_stack<T, 4>(T const& x, T const& y, numarray_stack<T, 2> const& yz);
-        numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, T const& z, T const& w);
-        numarray_stack<T, 4>(T const& x, numarray_stack<T, 2> const& yz, T const& w);
-        numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw);
+        constexpr numarray_stack<T, 4>(T const& x, T const& y, numarray_stack<T, 2> const& yz);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, T const& z, T const& w);
+        constexpr numarray_stack<T, 4>(T const& x, numarray_stack<T, 2> const& yz, T const& w);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw);
 
 
         /** Size of the buffer = 4 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
-        numarray_stack<T, 4>& fill(T const& value);
+        constexpr numarray_stack<T, 4>& fill(T const& value);
 
         /** Element access
          * Allows buffer[i], buffer(i), and buffer.at(i)
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         T const& operator[](int index) const;
         T& operator[](int index);
 
@@ -56,10 +56,10 @@ namespace cgp
         T& at_unsafe(int index) { return (&x)[index]; }
 
         /** Sub-vector */
-        numarray_stack<T, 3> xyz() const;
-        numarray_stack<T, 2> xy() const;
-        numarray_stack<T, 2> yz() const;
-        numarray_stack<T, 2> xz() const;
+        constexpr numarray_stack<T, 3> xyz() const;
+        constexpr numarray_stack<T, 2> xy() const;
+        constexpr numarray_stack<T, 2> yz() const;
+        constexpr numarray_stack<T, 2> xz() const;
         
     };
 }
@@ -69,41 +69,41 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T> numarray_stack<T, 4>::numarray_stack()
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack()
         :x(T()), y(T()), z(T()), w(T())
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg, T const& w_arg)
         : x(x_arg), y(y_arg), z(z_arg), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 3> const& xyz, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 3> const& xyz, T const& w_arg)
         : x(get<0>(xyz)), y(get<1>(xyz)), z(get<2>(xyz)), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 3> const& yzw)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 3> const& yzw)
         : x(x_arg), y(get<0>(yzw)), z(get<1>(yzw)), w(get<2>(yzw))
     {}
 
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, numarray_stack<T, 2> const& yz)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, numarray_stack<T, 2> const& yz)
         : x(x_arg), y(y_arg), z(get<0>(yz)), w(get<1>(yz))
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg, T const& w_arg)
         : x(get<0>(xy)), y(get<1>(xy)), z(z_arg), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz, T const& w_arg)
         : x(x_arg), y(get<0>(yz)), z(get<1>(yz)), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw)
         : x(get<0>(xy)), y(get<1>(xy)), z(get<0>(zw)), w(get<1>(zw))
     {}
 
 
-    template <typename T> int numarray_stack<T, 4>::size() const
+    template <typename T> constexpr int numarray_stack<T, 4>::size() const
     {
         return 4;
     }
 
 
 
-    template <typename T>  numarray_stack<T, 4>& numarray_stack<T, 4>::fill(T const& value)
+    template <typename T> constexpr numarray_stack<T, 4>& numarray_stack<T, 4>::fill(T const& value)
     {
         x = value;
         y = value;
@@ -112,10 +112,10 @@ namespace cgp
         return *this;
     }
 
-    template <typename T, int N, typename INDEX_TYPE>
+    template <typename T, typename INDEX_TYPE>
     void check_index_bounds(INDEX_TYPE index, numarray_stack<T, 4> const& data)
     {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
         if (index < 0 || index>3)
         {
             std::string msg = "\n";
@@ -123,6 +123,8 @@ namespace cgp
             msg += " - Indexing is limited to 0, 1, 2, 3";
             error_cgp(msg);
         }
+#elif CGP_BOUND_CHECK == 1
+        check_index_bounds_cheap(int(index), data.size(), "numarray_stack");
 #endif
     }
 
@@ -172,37 +174,116 @@ namespace cgp
 
 
 
-    template <typename T> numarray_stack<T, 3> numarray_stack<T, 4>::xyz() const
+    template <typename T> constexpr numarray_stack<T, 3> numarray_stack<T, 4>::xyz() const
     {
         return numarray_stack<T, 3>{x, y, z};
     }
-    template <typename T> numarray_stack<T, 2> numarray_stack<T, 4>::xy() const
+    template <typename T> constexpr numarray_stack<T, 2> numarray_stack<T, 4>::xy() const
     {
         return numarray_stack<T, 2>{x, y};
     }
-    template <typename T> numarray_stack<T, 2> numarray_stack<T, 4>::yz() const
+    template <typename T> constexpr numarray_stack<T, 2> numarray_stack<T, 4>::yz() const
     {
         return numarray_stack<T, 2>{y, z};
     }
-    template <typename T> numarray_stack<T, 2> numarray_stack<T, 4>::xz() const
+    template <typename T> constexpr numarray_stack<T, 2> numarray_stack<T, 4>::xz() const
     {
         return numarray_stack<T, 2>{x, z};
     }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 4> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 4> const& data)
     {
-        static_assert(idx < 4, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 4, "Incorrect element indexing");
+        return idx == 0 ? data.x : idx == 1 ? data.y : idx == 2 ? data.z : data.w;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 4>& data)
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 4>& data)
     {
-        static_assert(idx < 4, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 4, "Incorrect element indexing");
+        return idx == 0 ? data.x : idx == 1 ? data.y : idx == 2 ? data.z : data.w;
     }
 
     template <typename T> std::string type_str(numarray_stack<T, 4> const&)
     {
         return "numarray_stack4<" + type_str(T()) + ">";
     }
+
+
+    // Unrolled operators for the size 4
+    //  More specialized than the generic loops of numarray_stack.hpp, and usable in constant expressions (constexpr)
+    template <typename T> constexpr numarray_stack<T, 4> operator-(numarray_stack<T, 4> const& a)
+    {
+        return numarray_stack<T, 4>(-a.x, -a.y, -a.z, -a.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator+=(numarray_stack<T, 4>& a, numarray_stack<T, 4> const& b)
+    {
+        a.x += b.x; a.y += b.y; a.z += b.z; a.w += b.w;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator+(numarray_stack<T, 4> const& a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator-=(numarray_stack<T, 4>& a, numarray_stack<T, 4> const& b)
+    {
+        a.x -= b.x; a.y -= b.y; a.z -= b.z; a.w -= b.w;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator-(numarray_stack<T, 4> const& a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator*=(numarray_stack<T, 4>& a, numarray_stack<T, 4> const& b)
+    {
+        a.x *= b.x; a.y *= b.y; a.z *= b.z; a.w *= b.w;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator*(numarray_stack<T, 4> const& a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator/=(numarray_stack<T, 4>& a, numarray_stack<T, 4> const& b)
+    {
+        a.x /= b.x; a.y /= b.y; a.z /= b.z; a.w /= b.w;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator/(numarray_stack<T, 4> const& a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator*=(numarray_stack<T, 4>& a, float b)
+    {
+        a.x *= b; a.y *= b; a.z *= b; a.w *= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator*(numarray_stack<T, 4> const& a, float b)
+    {
+        return numarray_stack<T, 4>(a.x * b, a.y * b, a.z * b, a.w * b);
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator*(float a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a * b.x, a * b.y, a * b.z, a * b.w);
+    }
+    template <typename T> constexpr numarray_stack<T, 4>& operator/=(numarray_stack<T, 4>& a, float b)
+    {
+        a.x /= b; a.y /= b; a.z /= b; a.w /= b;
+        return a;
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator/(numarray_stack<T, 4> const& a, float b)
+    {
+        return numarray_stack<T, 4>(a.x / b, a.y / b, a.z / b, a.w / b);
+    }
+    template <typename T> constexpr numarray_stack<T, 4> operator/(float a, numarray_stack<T, 4> const& b)
+    {
+        return numarray_stack<T, 4>(a / b.x, a / b.y, a / b.z, a / b.w);
+    }
+    template <typename T> constexpr T dot(numarray_stack<T, 4> const& a, numarray_stack<T, 4> const& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+    template <typename T> constexpr T sum(numarray_stack<T, 4> const& a)
+    {
+        return a.x + a.y + a.z + a.w;
+    }
+
 }
\ No newline at end of file
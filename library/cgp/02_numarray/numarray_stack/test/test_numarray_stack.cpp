@@ -195,7 +195,18 @@ namespace cgp_test
 			assert_cgp_no_msg(cgp::is_equal(sum(a),  8.2f+6.1f-3.6));
 		}
 
-		
+		// test compile time evaluation of the sizes 2, 3, 4
+		{
+			using namespace cgp;
+			constexpr vec2 a = vec2(1.0f, 2.0f) * 2.0f - vec2(0.5f, 0.5f);
+			static_assert(get<0>(a) == 1.5f && get<1>(a) == 3.5f, "constexpr vec2");
+			constexpr vec3 b = cross(vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f)) + vec3(1.0f, 2.0f, 3.0f) / 2.0f;
+			static_assert(b.x == 0.5f && b.y == 1.0f && b.z == 2.5f && dot(b, vec3(0, 0, 2)) == 5.0f, "constexpr vec3");
+			constexpr numarray_stack<int, 4> c = numarray_stack<int, 4>(1, 2, 3, 4) * numarray_stack<int, 4>(2, 2, 2, 2);
+			static_assert(get<3>(c) == 8 && sum(c) == 20 && c.size() == 4, "constexpr numarray_stack<int,4>");
+			assert_cgp_no_msg(is_equal(a, vec2(1.5f, 3.5f)));
+		}
+
 
 	}
 }
\ No newline at end of file
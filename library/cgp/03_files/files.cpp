@@ -6,6 +6,15 @@
 #include <iostream>
 #include <sys/stat.h>
 
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if defined(__linux__) || defined(__EMSCRIPTEN__)
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #endif
@@ -91,4 +100,127 @@ namespace cgp
 
         return buffer;
     }
+
+    bool file_is_newer(std::string const& file_a, std::string const& file_b)
+    {
+        // Nanosecond modification times: a file edited in the same second as the other one is still compared correctly
+        long long const time_b = file_get_modification_time(file_b);
+        if (time_b < 0)
+            return true;
+        long long const time_a = file_get_modification_time(file_a);
+        if (time_a < 0)
+            return false;
+        return time_a > time_b;
+    }
+
+    long long file_get_modification_time(std::string const& filename)
+    {
+        struct stat stat_buf;
+        if (stat(filename.c_str(), &stat_buf) != 0)
+            return -1;
+#if defined(__APPLE__)
+        return (long long)stat_buf.st_mtimespec.tv_sec * 1000000000LL + stat_buf.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+        return (long long)stat_buf.st_mtim.tv_sec * 1000000000LL + stat_buf.st_mtim.tv_nsec;
+#else
+        return (long long)stat_buf.st_mtime * 1000000000LL;
+#endif
+    }
+
+
+    file_mapping::file_mapping()
+        :address(nullptr), length(0), buffer()
+#ifdef _WIN32
+        , file_handle(nullptr), mapping_handle(nullptr)
+#endif
+    {}
+
+    file_mapping::file_mapping(std::string const& filename)
+        :file_mapping()
+    {
+        open(filename);
+    }
+
+    file_mapping::~file_mapping()
+    {
+        close();
+    }
+
+    bool file_mapping::open(std::string const& filename)
+    {
+        close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void const* view = (mapping != NULL) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (view == NULL) {
+            if (mapping != NULL) CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        file_handle = file;
+        mapping_handle = mapping;
+        address = static_cast<unsigned char const*>(view);
+        length = size_t(file_size.QuadPart);
+#elif !defined(__EMSCRIPTEN__)
+        int const fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat stat_buf;
+        if (fstat(fd, &stat_buf) != 0 || stat_buf.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, size_t(stat_buf.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping remains valid after closing the descriptor
+        if (view == MAP_FAILED)
+            return false;
+        address = static_cast<unsigned char const*>(view);
+        length = size_t(stat_buf.st_size);
+#else
+        if (!check_file_exist(filename))
+            return false;
+        buffer = read_from_file_binary(filename);
+        address = reinterpret_cast<unsigned char const*>(buffer.data());
+        length = buffer.size();
+#endif
+        return true;
+    }
+
+    void file_mapping::close()
+    {
+        if (address == nullptr)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(address);
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        mapping_handle = nullptr;
+        file_handle = nullptr;
+#elif !defined(__EMSCRIPTEN__)
+        munmap(const_cast<unsigned char*>(address), length);
+#else
+        buffer.clear();
+#endif
+        address = nullptr;
+        length = 0;
+    }
+
+    unsigned char const* file_mapping::data() const
+    {
+        return address;
+    }
+    size_t file_mapping::size() const
+    {
+        return length;
+    }
+    bool file_mapping::is_open() const
+    {
+        return address != nullptr;
+    }
 }
\ No newline at end of file
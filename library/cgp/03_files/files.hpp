@@ -25,6 +25,39 @@ namespace cgp
 	/** Read the entire content of a file as binary vector of octets*/
 	std::vector <char> read_from_file_binary(std::string const& filename);
 
+	/** Return true if file_a has been modified after file_b (or if file_b doesn't exist) */
+	bool file_is_newer(std::string const& file_a, std::string const& file_b);
+
+	/** Return the time of the last modification of a file in nanoseconds (with the resolution of the file system), or -1 if the file doesn't exist */
+	long long file_get_modification_time(std::string const& filename);
+
+	/** Read-only access to the content of a file mapped in memory (no copy: the pages are loaded on demand by the OS).
+	 * Falls back to reading the file in a buffer when memory mapping is not available (emscripten). */
+	struct file_mapping
+	{
+		file_mapping();
+		explicit file_mapping(std::string const& filename);
+		~file_mapping();
+		file_mapping(file_mapping const&) = delete;
+		file_mapping& operator=(file_mapping const&) = delete;
+
+		bool open(std::string const& filename); // Return false if the file cannot be opened
+		void close();
+
+		unsigned char const* data() const;
+		size_t size() const;
+		bool is_open() const;
+
+	private:
+		unsigned char const* address;
+		size_t length;
+		std::vector<char> buffer; // Used only when memory mapping is not available
+#ifdef _WIN32
+		void* file_handle;
+		void* mapping_handle;
+#endif
+	};
+
 	std::string read_text_file(std::string const& filename);
 	template <typename T> void read_from_file(std::string const& filename, T& data);
 	template <typename T> void read_from_file(std::string const& filename, numarray<numarray<T>>& data);
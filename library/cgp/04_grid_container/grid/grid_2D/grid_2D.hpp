@@ -3,6 +3,7 @@
 #include "cgp/01_base/base.hpp"
 #include "cgp/02_numarray/numarray.hpp"
 #include "../../offset_grid/offset_grid.hpp"
+#include "../grid_layout/grid_layout.hpp"
 
 
 
@@ -16,10 +17,11 @@ namespace cgp
 /** Container for 2D-grid like structure storing numerical element
  *
  * The grid_2D structure provide convenient access for 2D-grid organization where an element can be queried as grid_2D(i,j).
- * The indexing is obtained as grid_2D(k1,k2) = k1 + N1*k2
+ * The indexing is obtained as grid_2D(k1,k2) = k1 + N1*k2 with the default row-major layout.
+ * The LAYOUT parameter (grid_layout_tiled<TILE>, grid_layout_morton<TILE>) changes the order of the elements in memory (see grid_layout.hpp).
  * Elements of grid_2D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
  **/
-template <typename T>
+template <typename T, typename LAYOUT = grid_layout_row_major>
 struct grid_2D
 {
     /** 2D dimension (Nx,Ny) of the container */
@@ -34,8 +36,8 @@ struct grid_2D
     grid_2D(int size_1, int size_2);  // Build a grid_2D with specified dimension
 
     /** Direct build a grid_2D from a given 1D-buffer and its 2D-dimension
-    * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2 */
-    static grid_2D<T> from_buffer(numarray<T> const& arg, int size_1, int size_2);
+    * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2, and its elements are in the order of the LAYOUT */
+    static grid_2D<T, LAYOUT> from_buffer(numarray<T> const& arg, int size_1, int size_2);
 
 
     /** Remove all elements from the grid_2D */
@@ -51,7 +53,7 @@ struct grid_2D
     void resize(int size_1, int size_2);
 
     /** Element access
-     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+     * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
 
     T const& operator[](int2 const& index) const; // grid_2D[ {x,y} ]
     T & operator[](int2 const& index);            // grid_2D[ {x,y} ]
@@ -66,14 +68,14 @@ struct grid_2D
     int2 offset_to_index(int offset) const;
 
     /** Iterators
-     * 1D-type iterators on grid_2D are compatible with STL syntax
+     * 1D-type iterators on grid_2D are compatible with STL syntax (elements in memory order, see grid_for_each for the indices)
      * allows "forall" loops (for(auto& e : buffer) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename numarray<T>::iterator begin();
+    typename numarray<T>::iterator end();
+    typename numarray<T>::const_iterator begin() const;
+    typename numarray<T>::const_iterator end() const;
+    typename numarray<T>::const_iterator cbegin() const;
+    typename numarray<T>::const_iterator cend() const;
 
     /** Direct access to the value - doesn't check index bounds*/
     inline T const& at(int index) const { return data.at(index); }
@@ -83,46 +85,53 @@ struct grid_2D
 };
 
 
-template <typename T> std::string type_str(grid_2D<T> const&);
+template <typename T, typename LAYOUT> std::string type_str(grid_2D<T, LAYOUT> const&);
 
 /** Display all elements of the buffer.*/
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v);
+template <typename T, typename LAYOUT> std::ostream& operator<<(std::ostream& s, grid_2D<T, LAYOUT> const& v);
 
 /** Convert all elements of the buffer to a string.
  * \param buffer: the input buffer
  * \param separator: the separator between each element
  */
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
+template <typename T, typename LAYOUT> std::string str(grid_2D<T, LAYOUT> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
 
 
+/** Call f(k1, k2, element) for all the elements of the grid, in the memory order of the layout */
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_2D<T, LAYOUT>& grid, F&& f);
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_2D<T, LAYOUT> const& grid, F&& f);
+
+/** Copy a grid into a grid with another layout (same dimension and same elements) */
+template <typename T, typename LAYOUT_IN, typename LAYOUT_OUT> void convert(grid_2D<T, LAYOUT_IN> const& in, grid_2D<T, LAYOUT_OUT>& out);
+
 /** Equality test between grid_2D */
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b);
+template <typename T1, typename T2, typename LAYOUT> bool is_equal(grid_2D<T1, LAYOUT> const& a, grid_2D<T2, LAYOUT> const& b);
 
 /** Math operators
  * Common mathematical operations between buffers, and scalar or element values. */
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator+=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b);
 
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator+=(grid_2D<T, LAYOUT>& a, T const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(grid_2D<T, LAYOUT> const& a, T const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(T const& a, grid_2D<T, LAYOUT> const& b);
 
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator-=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator-=(grid_2D<T, LAYOUT>& a, T const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(grid_2D<T, LAYOUT> const& a, T const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(T const& a, grid_2D<T, LAYOUT> const& b);
 
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b);
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator*=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator*=(grid_2D<T, LAYOUT>& a, float b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(grid_2D<T, LAYOUT> const& a, float b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(float a, grid_2D<T, LAYOUT> const& b);
 
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator/=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator/=(grid_2D<T, LAYOUT>& a, float b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator/(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator/(grid_2D<T, LAYOUT> const& a, float b);
 
 
 
@@ -139,27 +148,27 @@ namespace cgp
 
 
 
-template <typename T>
-grid_2D<T>::grid_2D()
+template <typename T, typename LAYOUT>
+grid_2D<T, LAYOUT>::grid_2D()
     :dimension(int2{0,0}),data()
 {}
 
-template <typename T>
-grid_2D<T>::grid_2D(int size)
+template <typename T, typename LAYOUT>
+grid_2D<T, LAYOUT>::grid_2D(int size)
     :dimension({size,size}),data(size*size)
 {
     assert_cgp_no_msg(size>0);
 }
 
-template <typename T>
-grid_2D<T>::grid_2D(int2 const& size)
+template <typename T, typename LAYOUT>
+grid_2D<T, LAYOUT>::grid_2D(int2 const& size)
     :dimension(size),data(size[0]*size[1])
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0);
 }
 
-template <typename T>
-grid_2D<T>::grid_2D(int size_1, int size_2)
+template <typename T, typename LAYOUT>
+grid_2D<T, LAYOUT>::grid_2D(int size_1, int size_2)
     :dimension({size_1,size_2}),data(size_1*size_2)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0);
@@ -167,51 +176,51 @@ grid_2D<T>::grid_2D(int size_1, int size_2)
 
 
 
-template <typename T>
-int grid_2D<T>::size() const
+template <typename T, typename LAYOUT>
+int grid_2D<T, LAYOUT>::size() const
 {
     return dimension[0]*dimension[1];
 }
 
-template <typename T>
-void grid_2D<T>::clear()
+template <typename T, typename LAYOUT>
+void grid_2D<T, LAYOUT>::clear()
 {
     resize(0, 0);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int size)
+template <typename T, typename LAYOUT>
+void grid_2D<T, LAYOUT>::resize(int size)
 {
     assert_cgp_no_msg(size>=0);
     resize(size,size);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int2 const& size)
+template <typename T, typename LAYOUT>
+void grid_2D<T, LAYOUT>::resize(int2 const& size)
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0);
     dimension = size;
     data.resize(size[0]*size[1]);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int size_1, int size_2)
+template <typename T, typename LAYOUT>
+void grid_2D<T, LAYOUT>::resize(int size_1, int size_2)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0);
     dimension = {size_1,size_2};
     resize({size_1,size_2});
 }
 
-template <typename T>
-void grid_2D<T>::fill(T const& value)
+template <typename T, typename LAYOUT>
+void grid_2D<T, LAYOUT>::fill(T const& value)
 {
     data.fill(value);
 }
 
 
-#ifndef CGP_NO_DEBUG
-template <typename T>
-void check_index_bounds(int index1, int index2, grid_2D<T> const& data)
+#if CGP_BOUND_CHECK >= 2
+template <typename T, typename LAYOUT>
+void check_index_bounds(int index1, int index2, grid_2D<T, LAYOUT> const& data)
 {
     size_t const N1 = data.dimension.x;
     size_t const N2 = data.dimension.y;
@@ -248,96 +257,102 @@ void check_index_bounds(int index1, int index2, grid_2D<T> const& data)
         error_cgp(msg);
     }
 }
+#elif CGP_BOUND_CHECK == 1
+template <typename T, typename LAYOUT>
+void check_index_bounds(int index1, int index2, grid_2D<T, LAYOUT> const& data)
+{
+    check_index_bounds_cheap(LAYOUT::offset(index1, index2, data.dimension.x, data.dimension.y), data.data.size(), "grid_2D");
+}
 #else
-template <typename T>
-void check_index_bounds(int , int , grid_2D<T> const& ) {}
+template <typename T, typename LAYOUT>
+void check_index_bounds(int , int , grid_2D<T, LAYOUT> const& ) {}
 #endif
 
 
 
-template <typename T>
-T const& grid_2D<T>::operator[](int2 const& index) const
+template <typename T, typename LAYOUT>
+T const& grid_2D<T, LAYOUT>::operator[](int2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
-    int const idx = offset_grid(index.x, index.y, dimension.x);
-    return data[idx];
+    int const idx = LAYOUT::offset(index.x, index.y, dimension.x, dimension.y);
+    return data.at(idx);
 }
 
-template <typename T>
-T& grid_2D<T>::operator[](int2 const& index)
+template <typename T, typename LAYOUT>
+T& grid_2D<T, LAYOUT>::operator[](int2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
-    int const idx = offset_grid(index.x, index.y, dimension.x);
+    int const idx = LAYOUT::offset(index.x, index.y, dimension.x, dimension.y);
 
-    return data[idx];
+    return data.at(idx);
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(int2 const& index) const
+template <typename T, typename LAYOUT>
+T const& grid_2D<T, LAYOUT>::operator()(int2 const& index) const
 {
     return (*this)[index];
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int2 const& index)
+template <typename T, typename LAYOUT>
+T& grid_2D<T, LAYOUT>::operator()(int2 const& index)
 {
     return (*this)[index];
 }
 
 
-template <typename T>
-T const& grid_2D<T>::operator()(int k1, int k2) const
+template <typename T, typename LAYOUT>
+T const& grid_2D<T, LAYOUT>::operator()(int k1, int k2) const
 {
     check_index_bounds(k1, k2, *this);
-    int const idx = offset_grid(k1, k2, dimension.x);
+    int const idx = LAYOUT::offset(k1, k2, dimension.x, dimension.y);
 
-    return data[idx];
+    return data.at(idx);
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int k1, int k2)
+template <typename T, typename LAYOUT>
+T& grid_2D<T, LAYOUT>::operator()(int k1, int k2)
 {
     check_index_bounds(k1, k2, *this);
-    int const idx = offset_grid(k1, k2, dimension.x);
+    int const idx = LAYOUT::offset(k1, k2, dimension.x, dimension.y);
 
-    return data[idx];
+    return data.at(idx);
 }
 
 
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::begin()
+template <typename T, typename LAYOUT>
+typename numarray<T>::iterator grid_2D<T, LAYOUT>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::end()
+template <typename T, typename LAYOUT>
+typename numarray<T>::iterator grid_2D<T, LAYOUT>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::begin() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_2D<T, LAYOUT>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::end() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_2D<T, LAYOUT>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cbegin() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_2D<T, LAYOUT>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cend() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_2D<T, LAYOUT>::cend() const
 {
     return data.cend();
 }
@@ -351,13 +366,13 @@ typename std::vector<T>::const_iterator grid_2D<T>::cend() const
 
 
 
-template <typename T> std::string type_str(grid_2D<T> const&)
+template <typename T, typename LAYOUT> std::string type_str(grid_2D<T, LAYOUT> const&)
 {
-    return "grid_2D<" + type_str(T()) + ">";
+    return "grid_2D<" + type_str(T()) + LAYOUT::type_str() + ">";
 }
 
 
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b)
+template <typename T1, typename T2, typename LAYOUT> bool is_equal(grid_2D<T1, LAYOUT> const& a, grid_2D<T2, LAYOUT> const& b)
 {
     if (is_equal(a.dimension, b.dimension)==false)
         return false;
@@ -367,154 +382,177 @@ template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<
 
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v)
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_2D<T, LAYOUT>& grid, F&& f)
+{
+    T* const p = grid.data.data.data();
+    LAYOUT::for_each(grid.dimension.x, grid.dimension.y, [&](int k1, int k2, int offset) { f(k1, k2, p[offset]); });
+}
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_2D<T, LAYOUT> const& grid, F&& f)
+{
+    T const* const p = grid.data.data.data();
+    LAYOUT::for_each(grid.dimension.x, grid.dimension.y, [&](int k1, int k2, int offset) { f(k1, k2, p[offset]); });
+}
+
+template <typename T, typename LAYOUT_IN, typename LAYOUT_OUT> void convert(grid_2D<T, LAYOUT_IN> const& in, grid_2D<T, LAYOUT_OUT>& out)
+{
+    int const N1 = in.dimension.x;
+    int const N2 = in.dimension.y;
+    out.resize(N1, N2);
+    T const* const p = in.data.data.data();
+    grid_for_each(out, [&](int k1, int k2, T& value) { value = p[LAYOUT_IN::offset(k1, k2, N1, N2)]; });
+}
+
+
+template <typename T, typename LAYOUT> std::ostream& operator<<(std::ostream& s, grid_2D<T, LAYOUT> const& v)
 {
     return s << v.data;
 }
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename LAYOUT> std::string str(grid_2D<T, LAYOUT> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return to_string(v.data, separator, begin, end);
 }
 
 
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator+=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator+=(grid_2D<T, LAYOUT>& a, T const& b)
 {
     a.data += b;
     return a;
 }
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data+b.data;
     return res;
 
 }
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(grid_2D<T, LAYOUT> const& a, T const& b)
 {
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data+b;
     return res;
 }
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator+(T const& a, grid_2D<T, LAYOUT> const& b)
 {
-    grid_2D<T> res(b.dimension);
+    grid_2D<T, LAYOUT> res(b.dimension);
     res.data = a + b.data;
     return res;
 }
 
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator-=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator-=(grid_2D<T, LAYOUT>& a, T const& b)
 {
     a.data -= b;
     return a;
 }
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data-b.data;
     return res;
 }
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(grid_2D<T, LAYOUT> const& a, T const& b)
 {
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data-b;
     return res;
 }
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator-(T const& a, grid_2D<T, LAYOUT> const& b)
 {
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a-b.data;
     return res;
 }
 
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator*=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator*=(grid_2D<T, LAYOUT>& a, float b)
 {
     a.data *= b;
     return a;
 }
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data*b.data;
     return res;
 }
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(grid_2D<T, LAYOUT> const& a, float b)
 {
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data*b;
     return res;
 }
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator*(float a, grid_2D<T, LAYOUT> const& b)
 {
-    grid_2D<T> res(b.dimension);
+    grid_2D<T, LAYOUT> res(b.dimension);
     res.data = a*b.data;
     return res;
 }
 
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator/=(grid_2D<T, LAYOUT>& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
     return a;
 }
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>& operator/=(grid_2D<T, LAYOUT>& a, float b)
 {
     a.data /= b;
     return a;
 }
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator/(grid_2D<T, LAYOUT> const& a, grid_2D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data/b.data;
     return res;
 }
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b)
+template <typename T, typename LAYOUT> grid_2D<T, LAYOUT>  operator/(grid_2D<T, LAYOUT> const& a, float b)
 {
-    grid_2D<T> res(a.dimension);
+    grid_2D<T, LAYOUT> res(a.dimension);
     res.data = a.data/b;
     return res;
 }
 
 
-template <typename T>
-grid_2D<T> grid_2D<T>::from_buffer(numarray<T> const& arg, int size_1, int size_2)
+template <typename T, typename LAYOUT>
+grid_2D<T, LAYOUT> grid_2D<T, LAYOUT>::from_buffer(numarray<T> const& arg, int size_1, int size_2)
 {
     assert_cgp(arg.size()==size_1*size_2, "Incoherent size to generate grid_2D");
 
-    grid_2D<T> b(size_1, size_2);
+    grid_2D<T, LAYOUT> b(size_1, size_2);
     b.data = arg;
 
     return b;
 }
 
-template <typename T>
-int grid_2D<T>::index_to_offset(int k1, int k2) const
+template <typename T, typename LAYOUT>
+int grid_2D<T, LAYOUT>::index_to_offset(int k1, int k2) const
 {
-    return offset_grid(k1,k2,dimension.x);
+    return LAYOUT::offset(k1, k2, dimension.x, dimension.y);
 }
-template <typename T>
-int2 grid_2D<T>::offset_to_index(int offset) const
+template <typename T, typename LAYOUT>
+int2 grid_2D<T, LAYOUT>::offset_to_index(int offset) const
 {
-    int2 idx = index_grid_from_offset(offset,dimension.x);
-    return {idx.x, idx.y};
+    return LAYOUT::index(offset, dimension.x, dimension.y);
 }
 
 
@@ -3,6 +3,7 @@
 #include "cgp/01_base/base.hpp"
 #include "cgp/02_numarray/numarray.hpp"
 #include "../../offset_grid/offset_grid.hpp"
+#include "../grid_layout/grid_layout.hpp"
 
 
 /* ************************************************** */
@@ -15,9 +16,10 @@ namespace cgp
 /** Container for 3D-grid like structure storing numerical element
 *
 * The grid_3D structure provide convenient access for 3D-grid organization where an element can be queried as grid_3D(i,j).
+* The LAYOUT parameter changes the order of the elements in memory (row-major by default, see grid_layout.hpp).
 * Elements of grid_3D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
 **/
-template <typename T>
+template <typename T, typename LAYOUT = grid_layout_row_major>
 struct grid_3D
 {
     /** 3D dimension (Nx,Ny,Nz) of the container */
@@ -32,8 +34,8 @@ struct grid_3D
     grid_3D(int size_1, int size_2, int size_3); // Generate a grid of dimension size_1 x size_2 x size_3
 
     /** Direct build a grid_3D from a given 1D-buffer and its 3D-dimension
-    * \note: the size of the 3D-buffer must satisfy arg.size = size_1 * size_2 * size_3 */
-    static grid_3D<T> from_array(numarray<T> const& arg, int size_1, int size_2, int size_3);
+    * \note: the size of the 3D-buffer must satisfy arg.size = size_1 * size_2 * size_3, and its elements are in the order of the LAYOUT */
+    static grid_3D<T, LAYOUT> from_array(numarray<T> const& arg, int size_1, int size_2, int size_3);
 
     /** Remove all elements from the grid_2D */
     void clear();
@@ -48,7 +50,7 @@ struct grid_3D
     void resize(int size_1, int size_2, int size_3);
     
     /** Element access
-     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+     * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
     T const& operator[](int3 const& index) const;
     T& operator[](int3 const& index);
     T const& operator()(int3 const& index) const;
@@ -61,12 +63,12 @@ struct grid_3D
     int index_to_offset(int3 const& index) const;
     int3 offset_to_index(int offset) const;
 
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename numarray<T>::iterator begin();
+    typename numarray<T>::iterator end();
+    typename numarray<T>::const_iterator begin() const;
+    typename numarray<T>::const_iterator end() const;
+    typename numarray<T>::const_iterator cbegin() const;
+    typename numarray<T>::const_iterator cend() const;
 
     T const& at_unsafe(int index) const;
     T & at_unsafe(int index);           
@@ -75,35 +77,41 @@ struct grid_3D
 
 };
 
-template <typename T> std::string type_str(grid_3D<T> const&);
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b);
+template <typename T, typename LAYOUT> std::string type_str(grid_3D<T, LAYOUT> const&);
+template <typename T1, typename T2, typename LAYOUT> bool is_equal(grid_3D<T1, LAYOUT> const& a, grid_3D<T2, LAYOUT> const& b);
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v);
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+// Call f(k1, k2, k3, element) for all the elements of the grid, in the memory order of the layout
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_3D<T, LAYOUT>& grid, F&& f);
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_3D<T, LAYOUT> const& grid, F&& f);
+// Copy a grid into a grid with another layout (same dimension and same elements)
+template <typename T, typename LAYOUT_IN, typename LAYOUT_OUT> void convert(grid_3D<T, LAYOUT_IN> const& in, grid_3D<T, LAYOUT_OUT>& out);
 
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b);
+template <typename T, typename LAYOUT> std::ostream& operator<<(std::ostream& s, grid_3D<T, LAYOUT> const& v);
+template <typename T, typename LAYOUT> std::string str(grid_3D<T, LAYOUT> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
 
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator+=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator+=(grid_3D<T, LAYOUT>& a, T const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(grid_3D<T, LAYOUT> const& a, T const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(T const& a, grid_3D<T, LAYOUT> const& b);
 
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator-=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator-=(grid_3D<T, LAYOUT>& a, T const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(grid_3D<T, LAYOUT> const& a, T const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(T const& a, grid_3D<T, LAYOUT> const& b);
 
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator*=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator*=(grid_3D<T, LAYOUT>& a, float b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(grid_3D<T, LAYOUT> const& a, float b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(float a, grid_3D<T, LAYOUT> const& b);
+
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator/=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator/=(grid_3D<T, LAYOUT>& a, float b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(grid_3D<T, LAYOUT> const& a, float b);
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(float a, grid_3D<T, LAYOUT> const& b);
 
 }
 
@@ -117,90 +125,90 @@ namespace cgp
 {
 
 
-template <typename T>
-grid_3D<T>::grid_3D()
+template <typename T, typename LAYOUT>
+grid_3D<T, LAYOUT>::grid_3D()
     :dimension(int3{0,0,0}),data()
 {}
 
-template <typename T>
-grid_3D<T>::grid_3D(int size)
+template <typename T, typename LAYOUT>
+grid_3D<T, LAYOUT>::grid_3D(int size)
     :dimension({size,size,size}),data(size*size*size)
 {
     assert_cgp_no_msg(size>=0);
 }
 
-template <typename T>
-grid_3D<T>::grid_3D(int3 const& size)
+template <typename T, typename LAYOUT>
+grid_3D<T, LAYOUT>::grid_3D(int3 const& size)
     :dimension(size),data(size[0]*size[1]*size[2])
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0 && size[2]>=0);
 }
 
-template <typename T>
-grid_3D<T>::grid_3D(int size_1, int size_2, int size_3)
+template <typename T, typename LAYOUT>
+grid_3D<T, LAYOUT>::grid_3D(int size_1, int size_2, int size_3)
     :dimension({size_1,size_2, size_3}),data(size_1*size_2*size_3)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0 && size_3>=0);
 }
 
-template <typename T>
-int grid_3D<T>::size() const
+template <typename T, typename LAYOUT>
+int grid_3D<T, LAYOUT>::size() const
 {
     return dimension[0]*dimension[1]*dimension[2];
 }
 
-template <typename T>
-void grid_3D<T>::resize(int size)
+template <typename T, typename LAYOUT>
+void grid_3D<T, LAYOUT>::resize(int size)
 {
     assert_cgp_no_msg(size>=0);
     resize(size,size,size);
 }
 
-template <typename T>
-void grid_3D<T>::resize(int3 const& size)
+template <typename T, typename LAYOUT>
+void grid_3D<T, LAYOUT>::resize(int3 const& size)
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0 && size[2]>=0);
     dimension = size;
     data.resize(size[0]*size[1]*size[2]);
 }
 
-template <typename T>
-void grid_3D<T>::resize(int size_1, int size_2, int size_3)
+template <typename T, typename LAYOUT>
+void grid_3D<T, LAYOUT>::resize(int size_1, int size_2, int size_3)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0 && size_3>=0);
     dimension = {size_1, size_2, size_3};
     resize({size_1, size_2, size_3});
 }
 
-template <typename T>
-void grid_3D<T>::fill(T const& value)
+template <typename T, typename LAYOUT>
+void grid_3D<T, LAYOUT>::fill(T const& value)
 {
     data.fill(value);
 }
 
 
-template <typename T>
-grid_3D<T> grid_3D<T>::from_array(numarray<T> const& arg, int size_1, int size_2, int size_3)
+template <typename T, typename LAYOUT>
+grid_3D<T, LAYOUT> grid_3D<T, LAYOUT>::from_array(numarray<T> const& arg, int size_1, int size_2, int size_3)
 {
     assert_cgp(arg.size()==size_1*size_2*size_3, "Incoherent size to generate grid_2D");
 
-    grid_3D<T> b(size_1, size_2, size_3);
+    grid_3D<T, LAYOUT> b(size_1, size_2, size_3);
     b.data = arg;
 
     return b;
 }
 
-template <typename T>
-void grid_3D<T>::clear()
+template <typename T, typename LAYOUT>
+void grid_3D<T, LAYOUT>::clear()
 {
     data.clear();
 }
 
 
-template <typename T>
-static void check_index_bounds(int index1, int index2, int index3, grid_3D<T> const& data)
+template <typename T, typename LAYOUT>
+static void check_index_bounds(int index1, int index2, int index3, grid_3D<T, LAYOUT> const& data)
 {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
     int const N1 = data.dimension.x;
     int const N2 = data.dimension.y;
     int const N3 = data.dimension.z;
@@ -236,99 +244,101 @@ static void check_index_bounds(int index1, int index2, int index3, grid_3D<T> co
 
         error_cgp(msg);
     }
+#elif CGP_BOUND_CHECK == 1
+    check_index_bounds_cheap(LAYOUT::offset(index1, index2, index3, data.dimension.x, data.dimension.y, data.dimension.z), data.data.size(), "grid_3D");
 #endif
 }
 
 
-template <typename T> T const& grid_3D<T>::operator[](int3 const& index) const
+template <typename T, typename LAYOUT> T const& grid_3D<T, LAYOUT>::operator[](int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(index.x, index.y, index.z, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
-template <typename T> T& grid_3D<T>::operator[](int3 const& index)
+template <typename T, typename LAYOUT> T& grid_3D<T, LAYOUT>::operator[](int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(index.x, index.y, index.z, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
-template <typename T> T const& grid_3D<T>::operator()(int3 const& index) const
+template <typename T, typename LAYOUT> T const& grid_3D<T, LAYOUT>::operator()(int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(index.x, index.y, index.z, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
-template <typename T> T& grid_3D<T>::operator()(int3 const& index)
+template <typename T, typename LAYOUT> T& grid_3D<T, LAYOUT>::operator()(int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(index.x, index.y, index.z, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
-template <typename T> T const& grid_3D<T>::operator()(int k1, int k2, int k3) const
+template <typename T, typename LAYOUT> T const& grid_3D<T, LAYOUT>::operator()(int k1, int k2, int k3) const
 {
     check_index_bounds(k1, k2, k3, *this);
-    int const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(k1, k2, k3, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
-template <typename T> T& grid_3D<T>::operator()(int k1, int k2, int k3)
+template <typename T, typename LAYOUT> T& grid_3D<T, LAYOUT>::operator()(int k1, int k2, int k3)
 {
     check_index_bounds(k1, k2, k3, *this);
-    int const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    int const  idx = LAYOUT::offset(k1, k2, k3, dimension.x, dimension.y, dimension.z);
+    return data.at(idx);
 }
 
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::begin()
+template <typename T, typename LAYOUT>
+typename numarray<T>::iterator grid_3D<T, LAYOUT>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::end()
+template <typename T, typename LAYOUT>
+typename numarray<T>::iterator grid_3D<T, LAYOUT>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::begin() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_3D<T, LAYOUT>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::end() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_3D<T, LAYOUT>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cbegin() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_3D<T, LAYOUT>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cend() const
+template <typename T, typename LAYOUT>
+typename numarray<T>::const_iterator grid_3D<T, LAYOUT>::cend() const
 {
     return data.cend();
 }
 
-template <typename T>
-int grid_3D<T>::index_to_offset(int k1, int k2, int k3) const
+template <typename T, typename LAYOUT>
+int grid_3D<T, LAYOUT>::index_to_offset(int k1, int k2, int k3) const
 {
-    return offset_grid(k1, k2, k3, dimension.x, dimension.y);
+    return LAYOUT::offset(k1, k2, k3, dimension.x, dimension.y, dimension.z);
 }
-template <typename T>
-int grid_3D<T>::index_to_offset(int3 const& index) const
+template <typename T, typename LAYOUT>
+int grid_3D<T, LAYOUT>::index_to_offset(int3 const& index) const
 {
-    return offset_grid(index, dimension.x, dimension.y);
+    return LAYOUT::offset(index.x, index.y, index.z, dimension.x, dimension.y, dimension.z);
 }
-template <typename T>
-int3 grid_3D<T>::offset_to_index(int offset) const
+template <typename T, typename LAYOUT>
+int3 grid_3D<T, LAYOUT>::offset_to_index(int offset) const
 {
-    return index_grid_from_offset(offset, dimension.x, dimension.y);
+    return LAYOUT::index(offset, dimension.x, dimension.y, dimension.z);
 }
 
 
@@ -338,12 +348,12 @@ int3 grid_3D<T>::offset_to_index(int offset) const
 
 
 
-template <typename T> std::string type_str(grid_3D<T> const&)
+template <typename T, typename LAYOUT> std::string type_str(grid_3D<T, LAYOUT> const&)
 {
-    return "grid_3D<" + type_str(T()) + ">";
+    return "grid_3D<" + type_str(T()) + LAYOUT::type_str() + ">";
 }
 
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b)
+template <typename T1, typename T2, typename LAYOUT> bool is_equal(grid_3D<T1, LAYOUT> const& a, grid_3D<T2, LAYOUT> const& b)
 {
     if (is_equal(a.dimension, b.dimension) == false)
         return false;
@@ -351,136 +361,159 @@ template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<
 }
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v)
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_3D<T, LAYOUT>& grid, F&& f)
+{
+    T* const p = grid.data.data.data();
+    LAYOUT::for_each(grid.dimension.x, grid.dimension.y, grid.dimension.z, [&](int k1, int k2, int k3, int offset) { f(k1, k2, k3, p[offset]); });
+}
+template <typename T, typename LAYOUT, typename F> void grid_for_each(grid_3D<T, LAYOUT> const& grid, F&& f)
+{
+    T const* const p = grid.data.data.data();
+    LAYOUT::for_each(grid.dimension.x, grid.dimension.y, grid.dimension.z, [&](int k1, int k2, int k3, int offset) { f(k1, k2, k3, p[offset]); });
+}
+
+template <typename T, typename LAYOUT_IN, typename LAYOUT_OUT> void convert(grid_3D<T, LAYOUT_IN> const& in, grid_3D<T, LAYOUT_OUT>& out)
+{
+    int const N1 = in.dimension.x;
+    int const N2 = in.dimension.y;
+    int const N3 = in.dimension.z;
+    out.resize(N1, N2, N3);
+    T const* const p = in.data.data.data();
+    grid_for_each(out, [&](int k1, int k2, int k3, T& value) { value = p[LAYOUT_IN::offset(k1, k2, k3, N1, N2, N3)]; });
+}
+
+
+template <typename T, typename LAYOUT> std::ostream& operator<<(std::ostream& s, grid_3D<T, LAYOUT> const& v)
 {
     return s << v.data;
 }
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename LAYOUT> std::string str(grid_3D<T, LAYOUT> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return str(v.data, separator, begin, end);
 }
 
 
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator+=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator+=(grid_3D<T, LAYOUT>& a, T const& b)
 {
     a.data += b;
     return a;
 }
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data+b.data;
     return res;
 
 }
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(grid_3D<T, LAYOUT> const& a, T const& b)
 {
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data+b;
     return res;
 }
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator+(T const& a, grid_3D<T, LAYOUT> const& b)
 {
-    grid_3D<T> res(b.dimension);
+    grid_3D<T, LAYOUT> res(b.dimension);
     res.data = a + b.data;
     return res;
 }
 
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator-=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
     return a;
 }
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator-=(grid_3D<T, LAYOUT>& a, T const& b)
 {
     a.data -= b;
     return a;
 }
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data-b.data;
     return res;
 }
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(grid_3D<T, LAYOUT> const& a, T const& b)
 {
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data-b;
     return res;
 }
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator-(T const& a, grid_3D<T, LAYOUT> const& b)
 {
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a-b.data;
     return res;
 }
 
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator*=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
     return a;
 }
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator*=(grid_3D<T, LAYOUT>& a, float b)
 {
     a.data *= b;
     return a;
 }
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data*b.data;
     return res;
 }
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(grid_3D<T, LAYOUT> const& a, float b)
 {
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data*b;
     return res;
 }
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator*(float a, grid_3D<T, LAYOUT> const& b)
 {
-    grid_3D<T> res(b.dimension);
+    grid_3D<T, LAYOUT> res(b.dimension);
     res.data = a*b.data;
     return res;
 }
 
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator/=(grid_3D<T, LAYOUT>& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
     return a;
 }
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>& operator/=(grid_3D<T, LAYOUT>& a, float b)
 {
     a.data /= b;
     return a;
 }
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(grid_3D<T, LAYOUT> const& a, grid_3D<T, LAYOUT> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data/b.data;
     return res;
 }
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(grid_3D<T, LAYOUT> const& a, float b)
 {
-    grid_3D<T> res(a.dimension);
+    grid_3D<T, LAYOUT> res(a.dimension);
     res.data = a.data/b;
     return res;
 }
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b)
+template <typename T, typename LAYOUT> grid_3D<T, LAYOUT>  operator/(float a, grid_3D<T, LAYOUT> const& b)
 {
-    grid_3D<T> res(b.dimension);
+    grid_3D<T, LAYOUT> res(b.dimension);
     res.data = a/b.data;
     return res;
 }
@@ -489,29 +522,29 @@ template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b)
 
 
 
-template <typename T>
-T const& grid_3D<T>::at_unsafe(int index) const
+template <typename T, typename LAYOUT>
+T const& grid_3D<T, LAYOUT>::at_unsafe(int index) const
 {
     return data.at_unsafe(index);
 }
 
 
-template <typename T>
-T & grid_3D<T>::at_unsafe(int index)
+template <typename T, typename LAYOUT>
+T & grid_3D<T, LAYOUT>::at_unsafe(int index)
 {
     return data.at_unsafe(index);
 }
 
-template <typename T>
-T const& grid_3D<T>::at_unsafe(int index1, int index2, int index3) const
+template <typename T, typename LAYOUT>
+T const& grid_3D<T, LAYOUT>::at_unsafe(int index1, int index2, int index3) const
 {
-    return data.at_unsafe(offset_grid(index1, index2, index3, dimension.x, dimension.y));
+    return data.at_unsafe(LAYOUT::offset(index1, index2, index3, dimension.x, dimension.y, dimension.z));
 }
 
-template <typename T>
-T & grid_3D<T>::at_unsafe(int index1, int index2, int index3)
+template <typename T, typename LAYOUT>
+T & grid_3D<T, LAYOUT>::at_unsafe(int index1, int index2, int index3)
 {
-    return data.at_unsafe(offset_grid(index1, index2, index3, dimension.x, dimension.y));
+    return data.at_unsafe(LAYOUT::offset(index1, index2, index3, dimension.x, dimension.y, dimension.z));
 }
 
 }
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "cgp/02_numarray/numarray_stack/numarray_stack.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Memory layouts of the grid containers: grid_2D<T, LAYOUT> and grid_3D<T, LAYOUT>
+//  The layout only changes the position of the element (k1,k2[,k3]) in the 1D buffer grid.data: the element access grid(k1,k2),
+//  the size, and the iterators are the same for all the layouts. The buffer has exactly N1*N2[*N3] elements (no padding),
+//  and the iterators (begin/end, and grid_for_each that also gives the indices) walk the elements in the memory order.
+//  - grid_layout_row_major: offset = k1 + N1*(k2 + N2*k3). Default layout (buffers of the images, textures and marching cube).
+//  - grid_layout_tiled<TILE>: the grid is cut in square (cubic) tiles of TILE^2 (TILE^3) elements stored contiguously,
+//      row-major inside a tile and between the tiles.
+//  - grid_layout_morton<TILE>: same tiles, ordered along a Z-order (Morton) curve inside each tile.
+//  The tiles on the border of a grid whose dimension is not a multiple of TILE are smaller (and row-major inside).
+//  Each layout provides offset(index, dimension), index(offset, dimension), and for_each(dimension, f) calling f(k1,k2[,k3],offset)
+//  for all the elements in increasing offset.
+//  An indexed access in a tiled layout costs a few more integer operations than in the row-major one. In the grid layout cases of golf/bench
+//  (rotated bilinear sampling, 2D and 3D stencils) the row-major layout is the fastest: the tiled and Morton layouts are not a performance
+//  default, measure the actual access pattern before switching.
+
+namespace cgp
+{
+	namespace detail
+	{
+		constexpr int grid_layout_log2(int n) { return n <= 1 ? 0 : 1 + grid_layout_log2(n / 2); }
+
+		// Interleave the bits of x with 1 (resp. 2) zeros: ...x2 0 x1 0 x0 (x < 2^16, resp. x < 2^10)
+		inline std::uint32_t morton_part_1by1(std::uint32_t x)
+		{
+			x &= 0x0000ffff;
+			x = (x | (x << 8)) & 0x00ff00ff;
+			x = (x | (x << 4)) & 0x0f0f0f0f;
+			x = (x | (x << 2)) & 0x33333333;
+			x = (x | (x << 1)) & 0x55555555;
+			return x;
+		}
+		inline std::uint32_t morton_compact_1by1(std::uint32_t x)
+		{
+			x &= 0x55555555;
+			x = (x | (x >> 1)) & 0x33333333;
+			x = (x | (x >> 2)) & 0x0f0f0f0f;
+			x = (x | (x >> 4)) & 0x00ff00ff;
+			x = (x | (x >> 8)) & 0x0000ffff;
+			return x;
+		}
+		inline std::uint32_t morton_part_1by2(std::uint32_t x)
+		{
+			x &= 0x000003ff;
+			x = (x | (x << 16)) & 0xff0000ff;
+			x = (x | (x << 8)) & 0x0300f00f;
+			x = (x | (x << 4)) & 0x030c30c3;
+			x = (x | (x << 2)) & 0x09249249;
+			return x;
+		}
+		inline std::uint32_t morton_compact_1by2(std::uint32_t x)
+		{
+			x &= 0x09249249;
+			x = (x | (x >> 2)) & 0x030c30c3;
+			x = (x | (x >> 4)) & 0x0300f00f;
+			x = (x | (x >> 8)) & 0xff0000ff;
+			x = (x | (x >> 16)) & 0x000003ff;
+			return x;
+		}
+
+		// Order of the elements inside a full tile (the border tiles are always row-major)
+		struct grid_tile_row_major
+		{
+			static int local_offset(int l1, int l2, int T) { return l1 + T * l2; }
+			static int local_offset(int l1, int l2, int l3, int T) { return l1 + T * (l2 + T * l3); }
+			static int2 local_index_2(int l, int T) { return { l % T, l / T }; }
+			static int3 local_index_3(int l, int T) { return { l % T, (l / T) % T, l / (T * T) }; }
+		};
+		struct grid_tile_morton
+		{
+			static int local_offset(int l1, int l2, int) { return int(morton_part_1by1(l1) | (morton_part_1by1(l2) << 1)); }
+			static int local_offset(int l1, int l2, int l3, int) { return int(morton_part_1by2(l1) | (morton_part_1by2(l2) << 1) | (morton_part_1by2(l3) << 2)); }
+			static int2 local_index_2(int l, int) { return { int(morton_compact_1by1(l)), int(morton_compact_1by1(l >> 1)) }; }
+			static int3 local_index_3(int l, int) { return { int(morton_compact_1by2(l)), int(morton_compact_1by2(l >> 1)), int(morton_compact_1by2(l >> 2)) }; }
+		};
+
+		// Tiles of TILE^2 (TILE^3) elements, with the order ORDER inside the full tiles
+		template <int TILE, typename ORDER>
+		struct grid_layout_tiles
+		{
+			static_assert(TILE >= 2 && (TILE & (TILE - 1)) == 0, "The tile size of a grid layout must be a power of 2");
+			static constexpr int shift = grid_layout_log2(TILE);
+			static constexpr int mask = TILE - 1;
+
+			// 2D: tile rows of height h (TILE, or less on the border), tiles of width w in each row
+			static int offset(int k1, int k2, int N1, int N2)
+			{
+				int const t1 = k1 & ~mask;
+				int const t2 = k2 & ~mask;
+				if (t1 + TILE <= N1 && t2 + TILE <= N2) // Full tile (most of the accesses)
+					return t2 * N1 + (t1 << shift) + ORDER::local_offset(k1 & mask, k2 & mask, TILE);
+				int const w = std::min(TILE, N1 - t1);
+				int const h = std::min(TILE, N2 - t2);
+				int const l1 = k1 & mask;
+				int const l2 = k2 & mask;
+				return t2 * N1 + t1 * h + l1 + w * l2;
+			}
+			static int2 index(int offset, int N1, int N2)
+			{
+				int const t2 = (offset / (TILE * N1)) << shift;
+				int const h = std::min(TILE, N2 - t2);
+				int const r = offset - t2 * N1;
+				int const t1 = (r / (TILE * h)) << shift;
+				int const w = std::min(TILE, N1 - t1);
+				int const l = r - t1 * h;
+				int2 const local = (w == TILE && h == TILE) ? ORDER::local_index_2(l, TILE) : int2{ l % w, l / w };
+				return { t1 + local.x, t2 + local.y };
+			}
+			template <typename F> static void for_each(int N1, int N2, F&& f)
+			{
+				int offset = 0;
+				for (int t2 = 0; t2 < N2; t2 += TILE) {
+					int const h = std::min(TILE, N2 - t2);
+					for (int t1 = 0; t1 < N1; t1 += TILE) {
+						int const w = std::min(TILE, N1 - t1);
+						if (w == TILE && h == TILE) {
+							for (int l = 0; l < TILE * TILE; ++l, ++offset) {
+								int2 const local = ORDER::local_index_2(l, TILE);
+								f(t1 + local.x, t2 + local.y, offset);
+							}
+						}
+						else {
+							for (int l2 = 0; l2 < h; ++l2)
+								for (int l1 = 0; l1 < w; ++l1, ++offset)
+									f(t1 + l1, t2 + l2, offset);
+						}
+					}
+				}
+			}
+
+			// 3D: slabs of depth d, tile rows of height h in each slab, tiles of width w in each row
+			static int offset(int k1, int k2, int k3, int N1, int N2, int N3)
+			{
+				int const t1 = k1 & ~mask;
+				int const t2 = k2 & ~mask;
+				int const t3 = k3 & ~mask;
+				if (t1 + TILE <= N1 && t2 + TILE <= N2 && t3 + TILE <= N3)
+					return t3 * N1 * N2 + ((t2 * N1 + (t1 << shift)) << shift) + ORDER::local_offset(k1 & mask, k2 & mask, k3 & mask, TILE);
+				int const w = std::min(TILE, N1 - t1);
+				int const h = std::min(TILE, N2 - t2);
+				int const d = std::min(TILE, N3 - t3);
+				int const l1 = k1 & mask;
+				int const l2 = k2 & mask;
+				int const l3 = k3 & mask;
+				return t3 * N1 * N2 + t2 * N1 * d + t1 * h * d + l1 + w * (l2 + h * l3);
+			}
+			static int3 index(int offset, int N1, int N2, int N3)
+			{
+				int const t3 = (offset / (TILE * N1 * N2)) << shift;
+				int const d = std::min(TILE, N3 - t3);
+				int const r3 = offset - t3 * N1 * N2;
+				int const t2 = (r3 / (TILE * N1 * d)) << shift;
+				int const h = std::min(TILE, N2 - t2);
+				int const r2 = r3 - t2 * N1 * d;
+				int const t1 = (r2 / (TILE * h * d)) << shift;
+				int const w = std::min(TILE, N1 - t1);
+				int const l = r2 - t1 * h * d;
+				int3 const local = (w == TILE && h == TILE && d == TILE) ? ORDER::local_index_3(l, TILE) : int3{ l % w, (l / w) % h, l / (w * h) };
+				return { t1 + local.x, t2 + local.y, t3 + local.z };
+			}
+			template <typename F> static void for_each(int N1, int N2, int N3, F&& f)
+			{
+				int offset = 0;
+				for (int t3 = 0; t3 < N3; t3 += TILE) {
+					int const d = std::min(TILE, N3 - t3);
+					for (int t2 = 0; t2 < N2; t2 += TILE) {
+						int const h = std::min(TILE, N2 - t2);
+						for (int t1 = 0; t1 < N1; t1 += TILE) {
+							int const w = std::min(TILE, N1 - t1);
+							if (w == TILE && h == TILE && d == TILE) {
+								for (int l = 0; l < TILE * TILE * TILE; ++l, ++offset) {
+									int3 const local = ORDER::local_index_3(l, TILE);
+									f(t1 + local.x, t2 + local.y, t3 + local.z, offset);
+								}
+							}
+							else {
+								for (int l3 = 0; l3 < d; ++l3)
+									for (int l2 = 0; l2 < h; ++l2)
+										for (int l1 = 0; l1 < w; ++l1, ++offset)
+											f(t1 + l1, t2 + l2, t3 + l3, offset);
+							}
+						}
+					}
+				}
+			}
+		};
+	}
+
+
+	struct grid_layout_row_major
+	{
+		static int offset(int k1, int k2, int N1, int) { return k1 + N1 * k2; }
+		static int2 index(int offset, int N1, int) { return { offset % N1, offset / N1 }; }
+		template <typename F> static void for_each(int N1, int N2, F&& f)
+		{
+			int offset = 0;
+			for (int k2 = 0; k2 < N2; ++k2)
+				for (int k1 = 0; k1 < N1; ++k1, ++offset)
+					f(k1, k2, offset);
+		}
+
+		static int offset(int k1, int k2, int k3, int N1, int N2, int) { return k1 + N1 * (k2 + N2 * k3); }
+		static int3 index(int offset, int N1, int N2, int) { return { offset % N1, (offset / N1) % N2, offset / (N1 * N2) }; }
+		template <typename F> static void for_each(int N1, int N2, int N3, F&& f)
+		{
+			int offset = 0;
+			for (int k3 = 0; k3 < N3; ++k3)
+				for (int k2 = 0; k2 < N2; ++k2)
+					for (int k1 = 0; k1 < N1; ++k1, ++offset)
+						f(k1, k2, k3, offset);
+		}
+
+		static std::string type_str() { return ""; } // Default layout: not displayed in type_str(grid)
+	};
+
+	template <int TILE = 8>
+	struct grid_layout_tiled : detail::grid_layout_tiles<TILE, detail::grid_tile_row_major>
+	{
+		static std::string type_str() { return ", grid_layout_tiled<" + std::to_string(TILE) + ">"; }
+	};
+
+	template <int TILE = 16>
+	struct grid_layout_morton : detail::grid_layout_tiles<TILE, detail::grid_tile_morton>
+	{
+		static_assert(TILE <= 1024, "Morton tiles are limited to 1024 elements per axis");
+		static std::string type_str() { return ", grid_layout_morton<" + std::to_string(TILE) + ">"; }
+	};
+}
@@ -92,5 +92,64 @@ namespace cgp_test {
 
 	}
 
+	// The offsets of a layout are a bijection on [0,N[, and for_each walks them in increasing order
+	template <typename LAYOUT>
+	static void test_grid_layout_offsets(int N1, int N2, int N3)
+	{
+		int expected = 0;
+		LAYOUT::for_each(N1, N2, [&](int k1, int k2, int offset) {
+			assert_cgp_no_msg(offset == expected++);
+			assert_cgp_no_msg(LAYOUT::offset(k1, k2, N1, N2) == offset);
+			assert_cgp_no_msg(is_equal(LAYOUT::index(offset, N1, N2), cgp::int2{ k1,k2 }));
+		});
+		assert_cgp_no_msg(expected == N1 * N2);
+
+		expected = 0;
+		LAYOUT::for_each(N1, N2, N3, [&](int k1, int k2, int k3, int offset) {
+			assert_cgp_no_msg(offset == expected++);
+			assert_cgp_no_msg(LAYOUT::offset(k1, k2, k3, N1, N2, N3) == offset);
+			assert_cgp_no_msg(is_equal(LAYOUT::index(offset, N1, N2, N3), cgp::int3{ k1,k2,k3 }));
+		});
+		assert_cgp_no_msg(expected == N1 * N2 * N3);
+	}
+
+	void test_grid_layout()
+	{
+		// Dimensions multiple of the tile, and with partial tiles on the border
+		test_grid_layout_offsets<cgp::grid_layout_row_major>(7, 5, 3);
+		test_grid_layout_offsets<cgp::grid_layout_tiled<4> >(8, 16, 4);
+		test_grid_layout_offsets<cgp::grid_layout_tiled<4> >(7, 10, 5);
+		test_grid_layout_offsets<cgp::grid_layout_morton<4> >(8, 16, 4);
+		test_grid_layout_offsets<cgp::grid_layout_morton<4> >(13, 6, 9);
+
+		{
+			cgp::grid_2D<int> a(11, 9);
+			for (int k = 0; k < a.size(); ++k)
+				a.data[k] = k;
+			cgp::grid_2D<int, cgp::grid_layout_morton<4> > b;
+			convert(a, b);
+			assert_cgp_no_msg(type_str(b) == "grid_2D<int, grid_layout_morton<4>>");
+			assert_cgp_no_msg(b(0, 1) == a(0, 1) && b(10, 8) == a(10, 8) && b(5, 3) == a(5, 3));
+			assert_cgp_no_msg(b.data[1] == a(1, 0) && b.data[2] == a(0, 1));
+
+			int sum = 0;
+			grid_for_each(b, [&](int k1, int k2, int value) { assert_cgp_no_msg(value == a(k1, k2)); sum += value; });
+			assert_cgp_no_msg(sum == a.size() * (a.size() - 1) / 2);
+
+			cgp::grid_2D<int> c;
+			convert(b, c);
+			assert_cgp_no_msg(is_equal(a, c));
+		}
+
+		{
+			cgp::grid_3D<float, cgp::grid_layout_tiled<2> > a(3, 4, 5);
+			grid_for_each(a, [](int k1, int k2, int k3, float& value) { value = float(k1 + 10 * k2 + 100 * k3); });
+			assert_cgp_no_msg(a(2, 3, 4) == 432.0f && a(1, 0, 2) == 201.0f);
+			assert_cgp_no_msg(is_equal(a.offset_to_index(a.index_to_offset(2, 1, 3)), cgp::int3{ 2,1,3 }));
+			a += a;
+			assert_cgp_no_msg(a(2, 3, 4) == 864.0f);
+		}
+	}
+
 }
 
@@ -165,7 +165,7 @@ grid_stack_2D<T, N1, N2>& grid_stack_2D<T,N1,N2>::fill(T const& value)
 template <typename T, int N1, int N2>
 void check_index_bounds(int index1, int index2, grid_stack_2D<T,N1,N2> const& data)
 {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
     if (index1 < 0 || index2<0 || index1>=N1 || index2>=N2)
     {
         std::string msg = "\n";
@@ -197,6 +197,8 @@ void check_index_bounds(int index1, int index2, grid_stack_2D<T,N1,N2> const& da
 
         error_cgp(msg);
     }
+#elif CGP_BOUND_CHECK == 1
+    check_index_bounds_cheap(offset_grid_stack<N1>(index1, index2), N1 * N2, "grid_stack_2D");
 #endif
 }
 
@@ -207,7 +209,7 @@ T const& grid_stack_2D<T,N1,N2>::operator[](int2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
     int idx = offset_grid_stack<N1>(index.x, index.y);
-    return data[idx];
+    return data.at(idx);
 }
 
 template <typename T, int N1, int N2>
@@ -215,14 +217,14 @@ T& grid_stack_2D<T, N1, N2>::operator[](int2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
     int idx = offset_grid_stack<N1>(index.x, index.y);
-    return data[idx];
+    return data.at(idx);
 }
 template <typename T, int N1, int N2>
 T const& grid_stack_2D<T, N1, N2>::operator()(int2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
     int idx = offset_grid_stack<N1>(index.x, index.y);
-    return data[idx];
+    return data.at(idx);
 }
 
 template <typename T, int N1, int N2>
@@ -230,7 +232,7 @@ T& grid_stack_2D<T, N1, N2>::operator()(int2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
     int idx = offset_grid_stack<N1>(index.x, index.y);
-    return data[idx];
+    return data.at(idx);
 }
 
 
@@ -241,7 +243,7 @@ T const& grid_stack_2D<T, N1, N2>::operator()(int k1, int k2) const
 {
     check_index_bounds(k1, k2, *this);
     int idx = offset_grid_stack<N1>(k1, k2);
-    return data[idx];
+    return data.at(idx);
 }
 
 template <typename T, int N1, int N2>
@@ -249,7 +251,7 @@ T& grid_stack_2D<T, N1, N2>::operator()(int k1, int k2)
 {
     check_index_bounds(k1, k2, *this);
     int idx = offset_grid_stack<N1>(k1, k2);
-    return data[idx];
+    return data.at(idx);
 }
 
 
@@ -34,8 +34,8 @@ namespace cgp
         numarray_stack< numarray_stack<T, N2>, N1> data;
 
         /** Constructors */
-        matrix_stack();
-        matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements);
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements);
         matrix_stack(numarray_stack<T, N1* N2> const& elements);
 
         // Construct from a matrix with different size.
@@ -50,7 +50,7 @@ namespace cgp
         static matrix_stack<T, N1, N2> diagonal(numarray_stack<T, std::min(N1,N2)> const& arg);
 
         /** Total number of elements size = dimension[0] * dimension[1] */
-        int size() const;
+        constexpr int size() const;
         /** Return {N1,N2} */
         int2 dimension() const;
         /** Fill all elements of the grid_2D with the same element*/
@@ -58,7 +58,7 @@ namespace cgp
 
 
         /** Element access
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         numarray_stack<T, N2> const& operator[](int k1) const;
         numarray_stack<T, N2>& operator[](int k1);
 
@@ -137,10 +137,10 @@ namespace cgp
 
 
     /** Direct compiled-checked access to data */
-    template <int idx1, int idx2, typename T, int N1, int N2> T const& get(matrix_stack<T, N1, N2> const& data);
-    template <int idx1, int idx2, typename T, int N1, int N2> T& get(matrix_stack<T, N1, N2>& data);
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data);
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data);
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T const& get(matrix_stack<T, N1, N2> const& data);
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T& get(matrix_stack<T, N1, N2>& data);
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data);
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data);
     template <int offset, typename T, int N1, int N2> T const& get_offset(matrix_stack<T, N1, N2> const& data);
     template <int offset, typename T, int N1, int N2> T& get_offset(matrix_stack<T, N1, N2>& data);
 
@@ -229,12 +229,12 @@ namespace cgp
 
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2>::matrix_stack()
+    constexpr matrix_stack<T, N1, N2>::matrix_stack()
         : data()
     {}
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2>::matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements)
+    constexpr matrix_stack<T, N1, N2>::matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements)
         :data(elements)
     {}
 
@@ -292,7 +292,7 @@ namespace cgp
     }
 
 
-    template <typename T, int N1, int N2> int matrix_stack<T, N1, N2>::size() const { return N1 * N2; }
+    template <typename T, int N1, int N2> constexpr int matrix_stack<T, N1, N2>::size() const { return N1 * N2; }
     template <typename T, int N1, int N2> int2 matrix_stack<T, N1, N2>::dimension() const { return { N1,N2 }; }
     template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& matrix_stack<T, N1, N2>::fill(T const& value)
     {
@@ -308,7 +308,7 @@ namespace cgp
     template <typename T, int N1, int N2>
     void check_index_bounds(int index1, int index2, matrix_stack<T, N1, N2> const& data)
     {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
         if (index1 < 0 || index2 < 0 || index1 >= N1 || index2 >= N2)
         {
             std::string msg = "\n";
@@ -340,13 +340,15 @@ namespace cgp
 
             error_cgp(msg);
         }
+#elif CGP_BOUND_CHECK == 1
+        check_index_bounds_cheap(index1 * N2 + index2, data.size(), "matrix_stack");
 #endif
     }
 
     template <typename T, int N1, int N2>
     void check_index_bounds(int index2, matrix_stack<T, N1, N2> const& data)
     {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
         if (index2 < 0 || index2 >= N2)
         {
             std::string msg = "\n";
@@ -379,13 +381,15 @@ namespace cgp
 
             error_cgp(msg);
         }
+#elif CGP_BOUND_CHECK == 1
+        check_index_bounds_cheap(index2, data.data.size(), "matrix_stack");
 #endif
     }
 
     template <typename T, int N1, int N2>
     void check_offset_bounds(int offset, matrix_stack<T, N1, N2> const& data)
     {
-#ifndef cgp_NO_DEBUG
+#if CGP_BOUND_CHECK >= 2
         if (offset < 0 || offset >= N1*N2 )
         {
             std::string msg = "\n";
@@ -418,6 +422,8 @@ namespace cgp
 
             error_cgp(msg);
         }
+#elif CGP_BOUND_CHECK == 1
+        check_index_bounds_cheap(offset, data.size(), "matrix_stack");
 #endif
     }
 
@@ -522,22 +528,22 @@ namespace cgp
         return size_in_memory(T{})*N1*N2;
     }
 
-    template <int idx1, int idx2, typename T, int N1, int N2> T const& get(matrix_stack<T, N1, N2> const& data)
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T const& get(matrix_stack<T, N1, N2> const& data)
     {
         static_assert( (idx1 < N1) && (idx2 < N2), "Index too large for matrix_stack access");
-        return data.at(idx1, idx2);
+        return get<idx2>(get<idx1>(data.data));
     }
-    template <int idx1, int idx2, typename T, int N1, int N2> T& get(matrix_stack<T, N1, N2>& data)
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T& get(matrix_stack<T, N1, N2>& data)
     {
         static_assert((idx1 < N1) && (idx2 < N2), "Index too large for matrix_stack access");
-        return data.at(idx1, idx2);
+        return get<idx2>(get<idx1>(data.data));
     }
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data)
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data)
     {
         static_assert(idx1<N1, "Index too large for matrix_stack access");
         return get<idx1>(data.data);
     }
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data)
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data)
     {
         static_assert(idx1 < N1, "Index too large for matrix_stack access");
         return get<idx1>(data.data);
@@ -783,7 +789,7 @@ namespace cgp
         T s{};
         for(int k1=0; k1<N1; ++k1)
             for(int k2=0; k2<N2; ++k2)
-                s += m.at_unsafe(k1,k2);
+                s += m.at_unsafe(k1,k2) * m.at_unsafe(k1,k2);
 
         return sqrt(s);
     }
@@ -1,5 +1,6 @@
 #include "cgp/01_base/base.hpp"
 #include "mat_functions.hpp"
+#include "../mat4/simd/mat4_simd.hpp"
 
 namespace cgp
 {
@@ -104,23 +105,17 @@ namespace cgp
 
 	float det(mat4 const& m)
 	{
-		return -m(3,0)*det(m.remove_row_column(3,0)) + m(3,1)*det(m.remove_row_column(3,1)) - m(3,2)*det(m.remove_row_column(3,2)) + m(3,3)*det(m.remove_row_column(3,3));
+		return mat4_simd_determinant(m.begin());
 	}
 
 	mat4 inverse(mat4 const& m)
 	{
-		float const d = det(m);
+		// 2x2 minors shared between the cofactors (see mat4_simd.hpp) instead of the 16 determinants of 3x3 sub-matrices
+		mat4 inv;
+		float const d = mat4_simd_inverse(m.begin(), inv.begin());
 		assert_cgp( std::abs(d)>1e-5f , "Determinant is null");
 
-		mat4 inv = mat4{
-			 det(m.remove_row_column(0,0)), -det(m.remove_row_column(1,0)),  det(m.remove_row_column(2,0)), -det(m.remove_row_column(3,0)),
-			-det(m.remove_row_column(0,1)),  det(m.remove_row_column(1,1)), -det(m.remove_row_column(2,1)),  det(m.remove_row_column(3,1)),
-			 det(m.remove_row_column(0,2)), -det(m.remove_row_column(1,2)),  det(m.remove_row_column(2,2)), -det(m.remove_row_column(3,2)),
-			-det(m.remove_row_column(0,3)),  det(m.remove_row_column(1,3)), -det(m.remove_row_column(2,3)),  det(m.remove_row_column(3,3)),
-		}/d;
-
 		return inv;
-
 	}
 
 	mat2 tensor_product(vec2 const& a, vec2 const& b)
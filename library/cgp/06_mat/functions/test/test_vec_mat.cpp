@@ -2,6 +2,7 @@
 
 #include "cgp/01_base/base.hpp"
 #include "../mat_functions.hpp"
+#include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
 
 namespace cgp_test
 {
@@ -34,6 +35,28 @@ namespace cgp_test
 			assert_cgp_no_msg( norm(inverse(a)*a - mat4::build_identity())<1e-2f );
 		}
 
+		//product, transpose and transform mat4 (SIMD kernels)
+		{
+			mat4 a{1.0f,1.5f,2.5f,-2.4f, 3.1f,-1.5f,2.2f,4.0f, 3.1f,1.4f,-2.4f,-3.5f, 5.1f,0.2f,0.5f,-0.4f};
+			mat4 const aat{15.26f,-3.25f,7.6f,7.61f, -3.25f,32.7f,-11.77f,15.01f, 7.6f,-11.77f,29.58f,16.29f, 7.61f,15.01f,16.29f,26.46f};
+
+			assert_cgp_no_msg( is_equal(transpose(transpose(a)),a) );
+			assert_cgp_no_msg( is_equal(get<0,3>(transpose(a)),5.1f) );
+			assert_cgp_no_msg( is_equal(a*transpose(a),aat) );
+			mat4 b = a;
+			b *= transpose(a);
+			assert_cgp_no_msg( is_equal(b,aat) );
+			assert_cgp_no_msg( is_equal(a*vec4{1.0f,-2.0f,0.5f,1.0f},vec4{-3.15f,11.2f,-4.4f,4.55f}) );
+			assert_cgp_no_msg( is_equal(a.transform_position(vec3{1.0f,-2.0f,0.5f}),vec3{-0.692307f,2.461538f,-0.967033f}) );
+		}
+
+		//rotation matrix from quaternion
+		{
+			quaternion const q = normalize(quaternion{0.2f,-0.4f,0.5f,0.7f});
+			mat4 const R = mat4::build_identity().set_block_linear(rotation_transform::convert_quaternion_to_matrix(q));
+			assert_cgp_no_msg( is_equal(mat4::build_rotation_from_quaternion(q),R) );
+		}
+
 
 		// orthogonal vector vec2
 		{
@@ -62,5 +85,16 @@ namespace cgp_test
 			assert_cgp_no_msg( is_equal(norm(orthogonal_vector(vec3{5,3,-4})),1.0f) );
 		}
 
+		// test compile time construction of the matrices
+		{
+			constexpr mat3 M(1,0,0, 0,2,0, 0,0,3);
+			static_assert(get<1,1>(M) == 2.0f && get<2,2>(M) == 3.0f && get<0,1>(M) == 0.0f, "constexpr mat3");
+			constexpr mat4 D(2.0f);
+			static_assert(get<3,3>(D) == 2.0f && get<3,0>(D) == 0.0f, "constexpr mat4");
+			constexpr mat2 R(vec2(1,2), vec2(3,4));
+			static_assert(get<1,0>(R) == 3.0f, "constexpr mat2");
+			assert_cgp_no_msg( is_equal(M*vec3(1,1,1), vec3(1,2,3)) );
+		}
+
 	}
 }
\ No newline at end of file
@@ -29,11 +29,11 @@ namespace cgp
         // ******************************************************* //
         //  Constructors
         // ******************************************************* //
-        matrix_stack();
-        matrix_stack(numarray_stack<vec2, 2> const& elements);
-        matrix_stack(vec2 const& row_1, vec2 const& row_2);
-        matrix_stack(numarray_stack<float, 4> const& elements);
-        matrix_stack(
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack<vec2, 2> const& elements);
+        constexpr matrix_stack(vec2 const& row_1, vec2 const& row_2);
+        constexpr matrix_stack(numarray_stack<float, 4> const& elements);
+        constexpr matrix_stack(
             float xx, float xy, 
             float yx, float yy);
 
@@ -43,8 +43,8 @@ namespace cgp
         explicit matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M);
 
         // Build as a diagonal matrix (glm compatibility)
-        explicit matrix_stack(float value);
-        explicit matrix_stack(float xx, float yy);
+        explicit constexpr matrix_stack(float value);
+        explicit constexpr matrix_stack(float xx, float yy);
 
         matrix_stack(std::initializer_list<float> const& arg);
         matrix_stack(std::initializer_list<vec2> const& arg);
@@ -55,7 +55,7 @@ namespace cgp
         // ******************************************************* //
 
         // Return 4
-        int size() const;
+        constexpr int size() const;
         // Return {2,2}
         int2 dimension() const;
         // Fill all elements with a constant value
@@ -130,6 +130,37 @@ namespace cgp
 
 namespace cgp
 {
+    constexpr mat2::matrix_stack()
+        :data()
+    {}
+    constexpr mat2::matrix_stack(numarray_stack<vec2, 2> const& elements)
+        : data(elements)
+    {}
+    constexpr mat2::matrix_stack(vec2 const& row_1, vec2 const& row_2)
+        : data({ row_1,row_2 })
+    {}
+    constexpr mat2::matrix_stack(numarray_stack<float, 4> const& elements)
+        : data({
+            vec2{ get<0>(elements),get<1>(elements) },
+            vec2{ get<2>(elements),get<3>(elements) } })
+    {}
+    constexpr mat2::matrix_stack(
+        float xx, float xy,
+        float yx, float yy)
+        : data({ vec2{xx,xy},vec2{yx,yy} })
+    {}
+    constexpr mat2::matrix_stack(float value)
+        :data({
+        vec2(value,0),
+        vec2(0,value) })
+    {}
+    constexpr mat2::matrix_stack(float xx, float yy)
+        :data({
+        vec2(xx,0),
+        vec2(0,yy) })
+    {}
+    constexpr int mat2::size() const { return 4; }
+
     // Construct from a matrix with different size.
     //  Consider the min between (N1,N1_arg) and (N2,N2_arg)
     template <int N1_arg, int N2_arg>
@@ -6,40 +6,7 @@
 
 namespace cgp
 {
-    mat3::matrix_stack()
-        :data()
-    {}
-    mat3::matrix_stack(numarray_stack< vec3, 3> const& elements)
-        : data(elements)
-    {}
-    mat3::matrix_stack(vec3 const& row_1, vec3 const& row_2, vec3 const& row_3)
-        : data({ row_1,row_2, row_3 })
-    {}
-    mat3::matrix_stack(numarray_stack<float, 9> const& elements)
-        : data({
-            vec3{ get<0>(elements),get<1>(elements),get<2>(elements)},
-            vec3{ get<3>(elements),get<4>(elements),get<5>(elements)},
-            vec3{ get<6>(elements),get<7>(elements),get<8>(elements)} })
-    {}
-    mat3::matrix_stack(
-        float xx, float xy, float xz,
-        float yx, float yy, float yz,
-        float zx, float zy, float zz)
-        : data({ vec3{xx,xy,xz},vec3{yx,yy,yz},vec3{zx,zy,zz} })
-    {}
-
-    mat3::matrix_stack(float value)         
-        :data({
-        vec3(value,0,0),
-        vec3(0,value,0),
-        vec3(0,0,value) })
-    {}
-    mat3::matrix_stack(float xx, float yy, float zz) 
-        :data({
-        vec3(xx,0,0),
-        vec3(0,yy,0),
-        vec3(0,0,zz) })
-    {}
+
 
     mat3::matrix_stack(std::initializer_list<float> const& arg)
         :data()
@@ -113,7 +80,6 @@ namespace cgp
 
 
 
-    int mat3::size() const { return 9; }
     int2 mat3::dimension() const { return { 3,3 }; }
     mat3& mat3::fill(float value) {
         data.x.fill(value);
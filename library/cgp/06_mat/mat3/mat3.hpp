@@ -33,11 +33,11 @@ namespace cgp
         // ******************************************************* //
         //  Constructors
         // ******************************************************* //
-        matrix_stack();
-        matrix_stack(numarray_stack< vec3, 3> const& elements);
-        matrix_stack(vec3 const& row_1, vec3 const& row_2, vec3 const& row_3);
-        matrix_stack(numarray_stack<float, 9> const& elements);
-        matrix_stack(
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack< vec3, 3> const& elements);
+        constexpr matrix_stack(vec3 const& row_1, vec3 const& row_2, vec3 const& row_3);
+        constexpr matrix_stack(numarray_stack<float, 9> const& elements);
+        constexpr matrix_stack(
             float xx, float xy, float xz,
             float yx, float yy, float yz,
             float zx, float zy, float zz);
@@ -48,8 +48,8 @@ namespace cgp
         explicit matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M);
 
         // Build as a diagonal matrix (glm compatibility)
-        explicit matrix_stack(float value);
-        explicit matrix_stack(float xx, float yy, float zz);
+        explicit constexpr matrix_stack(float value);
+        explicit constexpr matrix_stack(float xx, float yy, float zz);
 
         matrix_stack(std::initializer_list<float> const& arg);
         matrix_stack(std::initializer_list<vec3> const& arg);
@@ -60,7 +60,7 @@ namespace cgp
         // ******************************************************* //
 
         // Return 9
-        int size() const;
+        constexpr int size() const;
         // Return {3,3}
         int2 dimension() const;
         // Fill all elements with a constant value
@@ -137,6 +137,41 @@ namespace cgp
 
 namespace cgp
 {
+    constexpr mat3::matrix_stack()
+        :data()
+    {}
+    constexpr mat3::matrix_stack(numarray_stack< vec3, 3> const& elements)
+        : data(elements)
+    {}
+    constexpr mat3::matrix_stack(vec3 const& row_1, vec3 const& row_2, vec3 const& row_3)
+        : data({ row_1,row_2, row_3 })
+    {}
+    constexpr mat3::matrix_stack(numarray_stack<float, 9> const& elements)
+        : data({
+            vec3{ get<0>(elements),get<1>(elements),get<2>(elements)},
+            vec3{ get<3>(elements),get<4>(elements),get<5>(elements)},
+            vec3{ get<6>(elements),get<7>(elements),get<8>(elements)} })
+    {}
+    constexpr mat3::matrix_stack(
+        float xx, float xy, float xz,
+        float yx, float yy, float yz,
+        float zx, float zy, float zz)
+        : data({ vec3{xx,xy,xz},vec3{yx,yy,yz},vec3{zx,zy,zz} })
+    {}
+    constexpr mat3::matrix_stack(float value)         
+        :data({
+        vec3(value,0,0),
+        vec3(0,value,0),
+        vec3(0,0,value) })
+    {}
+    constexpr mat3::matrix_stack(float xx, float yy, float zz) 
+        :data({
+        vec3(xx,0,0),
+        vec3(0,yy,0),
+        vec3(0,0,zz) })
+    {}
+    constexpr int mat3::size() const { return 9; }
+
     // Construct from a matrix with different size.
     //  Consider the min between (N1,N1_arg) and (N2,N2_arg)
     template <int N1_arg, int N2_arg>
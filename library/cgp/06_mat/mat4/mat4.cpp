@@ -1,43 +1,16 @@
 #include "cgp/01_base/base.hpp"
 
 #include "mat4.hpp"
+#include "simd/mat4_simd.hpp"
 #include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
 
 namespace cgp
 {
-    mat4::matrix_stack()
-        :data()
-    {}
 
-    mat4::matrix_stack(numarray_stack< vec4, 4> const& elements)
-        : data(elements)
-    {}
 
-    mat4::matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4)
-        :data({ row_1,row_2,row_3,row_4 })
-    {}
 
-    mat4::matrix_stack(numarray_stack<float, 16> const& elements)
-        : data({
-            vec4{ get<0>(elements),get<1>(elements),get<2>(elements),get<3>(elements)},
-            vec4{ get<4>(elements),get<5>(elements),get<6>(elements),get<7>(elements)},
-            vec4{ get<8>(elements),get<9>(elements),get<10>(elements),get<11>(elements)},
-            vec4{ get<12>(elements),get<13>(elements),get<14>(elements),get<15>(elements)} })
-    {}
 
 
-    mat4::matrix_stack(
-        float xx, float xy, float xz, float xw,
-        float yx, float yy, float yz, float yw,
-        float zx, float zy, float zz, float zw,
-        float wx, float wy, float wz, float ww)
-        : data(
-            vec4(xx, xy, xz, xw),
-            vec4(yx, yy, yz, yw),
-            vec4(zx, zy, zz, zw),
-            vec4(wx, wy, wz, ww)
-        )
-    {}
 
     mat4::matrix_stack(mat3 const& M)
         :data({
@@ -47,21 +20,7 @@ namespace cgp
         vec4(0, 0, 0, 1) })
     {}
 
-    mat4::matrix_stack(float value)
-        :data({
-        vec4(value,0,0,0),
-        vec4(0,value,0,0),
-        vec4(0,0,value,0),
-        vec4(0,0,0,value) })
-    {}
 
-    mat4::matrix_stack(float xx, float yy, float zz, float ww)
-        :data({
-        vec4(xx,0,0,0),
-        vec4(0,yy,0,0),
-        vec4(0,0,zz,0),
-        vec4(0,0,0,ww) })
-    {}
 
 
     mat4::matrix_stack(std::initializer_list<float> const& arg)
@@ -141,7 +100,6 @@ namespace cgp
             value, value, value, value};
     }
 
-    int matrix_stack<float, 4, 4>::size() const { return 16; }
     int2 matrix_stack<float, 4, 4>::dimension() const { return { 4,4 }; }
     matrix_stack<float, 4, 4>& matrix_stack<float, 4, 4>::fill(float value)
     {
@@ -339,7 +297,11 @@ namespace cgp
     mat4 mat4::build_rotation_from_quaternion(quaternion const& q)
     {
         assert_cgp(cgp::abs(norm(q) - 1.0f) < 5e-2f, "Quaternion should have unit norm to represent rotation");
-        return mat4(rotation_transform::from_quaternion(q).matrix());
+        float const s[3] = { 1.0f, 1.0f, 1.0f };
+        float const t[3] = { 0.0f, 0.0f, 0.0f };
+        mat4 M;
+        mat4_affine_from_quaternion(q.begin(), s, t, M.begin());
+        return M;
     }
     mat4& mat4::set_block_linear(mat3 const& L)
     {
@@ -401,6 +363,7 @@ namespace cgp
 
     vec3 mat4::transform_position(vec3 const& pos) const
     {
+        // Kept scalar: a single point does not amortize the transposition of the SIMD version (see mat4_simd_transform for vec4)
         float const x = data.x.x * pos.x + data.x.y * pos.y + data.x.z * pos.z + data.x.w;
         float const y = data.y.x * pos.x + data.y.y * pos.y + data.y.z * pos.z + data.y.w;
         float const z = data.z.x * pos.x + data.z.y * pos.y + data.z.z * pos.z + data.z.w;
@@ -474,22 +437,9 @@ namespace cgp
 
     mat4 operator*(mat4 const& a, mat4 const& b)
     {
-        float const axx=get<0,0>(a), axy=get<0,1>(a), axz=get<0,2>(a), axw=get<0,3>(a);
-        float const ayx=get<1,0>(a), ayy=get<1,1>(a), ayz=get<1,2>(a), ayw=get<1,3>(a);
-        float const azx=get<2,0>(a), azy=get<2,1>(a), azz=get<2,2>(a), azw=get<2,3>(a);
-        float const awx=get<3,0>(a), awy=get<3,1>(a), awz=get<3,2>(a), aww=get<3,3>(a);
-
-        float const bxx=get<0,0>(b), bxy=get<0,1>(b), bxz=get<0,2>(b), bxw=get<0,3>(b);
-        float const byx=get<1,0>(b), byy=get<1,1>(b), byz=get<1,2>(b), byw=get<1,3>(b);
-        float const bzx=get<2,0>(b), bzy=get<2,1>(b), bzz=get<2,2>(b), bzw=get<2,3>(b);
-        float const bwx=get<3,0>(b), bwy=get<3,1>(b), bwz=get<3,2>(b), bww=get<3,3>(b);
-
-        return mat4{
-            axx*bxx+axy*byx+axz*bzx+axw*bwx, axx*bxy+axy*byy+axz*bzy+axw*bwy, axx*bxz+axy*byz+axz*bzz+axw*bwz, axx*bxw+axy*byw+axz*bzw+axw*bww,
-            ayx*bxx+ayy*byx+ayz*bzx+ayw*bwx, ayx*bxy+ayy*byy+ayz*bzy+ayw*bwy, ayx*bxz+ayy*byz+ayz*bzz+ayw*bwz, ayx*bxw+ayy*byw+ayz*bzw+ayw*bww,
-            azx*bxx+azy*byx+azz*bzx+azw*bwx, azx*bxy+azy*byy+azz*bzy+azw*bwy, azx*bxz+azy*byz+azz*bzz+azw*bwz, azx*bxw+azy*byw+azz*bzw+azw*bww,
-            awx*bxx+awy*byx+awz*bzx+aww*bwx, awx*bxy+awy*byy+awz*bzy+aww*bwy, awx*bxz+awy*byz+awz*bzz+aww*bwz, awx*bxw+awy*byw+awz*bzw+aww*bww
-        };
+        mat4 result;
+        mat4_simd_multiply(a.begin(), b.begin(), result.begin());
+        return result;
     }
     mat4 operator*(float s, mat4 const& M)
     {
@@ -502,41 +452,21 @@ namespace cgp
     }
     mat4& operator*=(mat4& a, mat4 const& b)
     {
-        float* pa = a.begin();
-        float const* pb = b.begin();
-        float const axx = *(pa++); float const axy = *(pa++); float const axz = *(pa++); float const axw = *(pa++);
-        float const ayx = *(pa++); float const ayy = *(pa++); float const ayz = *(pa++); float const ayw = *(pa++);
-        float const azx = *(pa++); float const azy = *(pa++); float const azz = *(pa++); float const azw = *(pa++);
-        float const awx = *(pa++); float const awy = *(pa++); float const awz = *(pa++); float const aww = *(pa);
-
-        float const bxx = *(pb++); float const bxy = *(pb++); float const bxz = *(pb++); float const bxw = *(pb++);
-        float const byx = *(pb++); float const byy = *(pb++); float const byz = *(pb++); float const byw = *(pb++);
-        float const bzx = *(pb++); float const bzy = *(pb++); float const bzz = *(pb++); float const bzw = *(pb++);
-        float const bwx = *(pb++); float const bwy = *(pb++); float const bwz = *(pb++); float const bww = *(pb);
-
-        pa = a.begin();
-        *(pa++)=axx*bxx+axy*byx+axz*bzx+axw*bwx; 
-        *(pa++)=axx*bxy+axy*byy+axz*bzy+axw*bwy; 
-        *(pa++)=axx*bxz+axy*byz+axz*bzz+axw*bwz; 
-        *(pa++)=axx*bxw+axy*byw+axz*bzw+axw*bww;
-
-        *(pa++)=ayx*bxx+ayy*byx+ayz*bzx+ayw*bwx; 
-        *(pa++)=ayx*bxy+ayy*byy+ayz*bzy+ayw*bwy; 
-        *(pa++)=ayx*bxz+ayy*byz+ayz*bzz+ayw*bwz; 
-        *(pa++)=ayx*bxw+ayy*byw+ayz*bzw+ayw*bww;
-
-        *(pa++)=azx*bxx+azy*byx+azz*bzx+azw*bwx; 
-        *(pa++)=azx*bxy+azy*byy+azz*bzy+azw*bwy; 
-        *(pa++)=azx*bxz+azy*byz+azz*bzz+azw*bwz; 
-        *(pa++)=azx*bxw+azy*byw+azz*bzw+azw*bww;
-
-        *(pa++)=awx*bxx+awy*byx+awz*bzx+aww*bwx; 
-        *(pa++)=awx*bxy+awy*byy+awz*bzy+aww*bwy; 
-        *(pa++)=awx*bxz+awy*byz+awz*bzz+aww*bwz; 
-        *(pa)  =awx*bxw+awy*byw+awz*bzw+aww*bww;
-
+        mat4_simd_multiply(a.begin(), b.begin(), a.begin());
         return a;
     }
+    vec4 operator*(mat4 const& M, vec4 const& v)
+    {
+        vec4 result;
+        mat4_simd_transform(M.begin(), v.begin(), result.begin());
+        return result;
+    }
+    mat4 transpose(mat4 const& m)
+    {
+        mat4 result;
+        mat4_simd_transpose(m.begin(), result.begin());
+        return result;
+    }
     mat4& operator*=(mat4& M, float s)
     {
         float* pM = M.begin();
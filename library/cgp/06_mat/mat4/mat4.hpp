@@ -36,11 +36,11 @@ namespace cgp
         // ******************************************************* //
         //  Constructors
         // ******************************************************* //
-        matrix_stack();
-        matrix_stack(numarray_stack< numarray_stack<float, 4>, 4> const& elements);
-        matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4);
-        matrix_stack(numarray_stack<float, 16> const& elements);
-        matrix_stack(
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack< numarray_stack<float, 4>, 4> const& elements);
+        constexpr matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4);
+        constexpr matrix_stack(numarray_stack<float, 16> const& elements);
+        constexpr matrix_stack(
             float xx, float xy, float xz, float xw,
             float yx, float yy, float yz, float yw,
             float zx, float zy, float zz, float zw,
@@ -58,8 +58,8 @@ namespace cgp
         explicit matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M);
 
         // Build as a diagonal matrix (glm compatibility)
-        explicit matrix_stack(float value);
-        explicit matrix_stack(float xx, float yy, float zz, float ww=1.0f);
+        explicit constexpr matrix_stack(float value);
+        explicit constexpr matrix_stack(float xx, float yy, float zz, float ww=1.0f);
 
         matrix_stack(std::initializer_list<float> const& arg);
         matrix_stack(std::initializer_list<numarray_stack<float, 4> > const& arg);
@@ -161,7 +161,7 @@ namespace cgp
         // ******************************************************* //
 
         /** Return 16 */
-        int size() const;
+        constexpr int size() const;
         /** Return {4,4} */
         int2 dimension() const;
         /** Fill all elements of the grid_2D with the same element*/
@@ -196,7 +196,7 @@ namespace cgp
 
 
         /** Element access
-         * Bound checking is performed unless cgp_NO_DEBUG is defined. */
+         * Bound checking depends on CGP_BOUND_CHECK (see cgp_parameters.hpp). */
         vec4 const& operator[](int k2) const;
         vec4& operator[](int k2);
 
@@ -261,10 +261,13 @@ namespace cgp
         mat4 inverse_assuming_rigid_transform() const;
     };
 
+    // The products and the transpose use the SIMD kernels of mat4/simd/mat4_simd.hpp
     mat4 operator*(mat4 const& a, mat4 const& b);
     mat4 operator*(float s, mat4 const& M);
     mat4& operator*=(mat4& a, mat4 const& b); // a = a*b
     mat4& operator*=(mat4& M, float s);
+    vec4 operator*(mat4 const& M, vec4 const& v);
+    mat4 transpose(mat4 const& m);
     mat4& operator+=(mat4& a, mat4 const& b);
 
 }
@@ -272,6 +275,50 @@ namespace cgp
 
 namespace cgp
 {
+    constexpr mat4::matrix_stack()
+        :data()
+    {}
+    constexpr mat4::matrix_stack(numarray_stack< vec4, 4> const& elements)
+        : data(elements)
+    {}
+    constexpr mat4::matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4)
+        :data({ row_1,row_2,row_3,row_4 })
+    {}
+    constexpr mat4::matrix_stack(numarray_stack<float, 16> const& elements)
+        : data({
+            vec4{ get<0>(elements),get<1>(elements),get<2>(elements),get<3>(elements)},
+            vec4{ get<4>(elements),get<5>(elements),get<6>(elements),get<7>(elements)},
+            vec4{ get<8>(elements),get<9>(elements),get<10>(elements),get<11>(elements)},
+            vec4{ get<12>(elements),get<13>(elements),get<14>(elements),get<15>(elements)} })
+    {}
+    constexpr mat4::matrix_stack(
+        float xx, float xy, float xz, float xw,
+        float yx, float yy, float yz, float yw,
+        float zx, float zy, float zz, float zw,
+        float wx, float wy, float wz, float ww)
+        : data(
+            vec4(xx, xy, xz, xw),
+            vec4(yx, yy, yz, yw),
+            vec4(zx, zy, zz, zw),
+            vec4(wx, wy, wz, ww)
+        )
+    {}
+    constexpr mat4::matrix_stack(float value)
+        :data({
+        vec4(value,0,0,0),
+        vec4(0,value,0,0),
+        vec4(0,0,value,0),
+        vec4(0,0,0,value) })
+    {}
+    constexpr mat4::matrix_stack(float xx, float yy, float zz, float ww)
+        :data({
+        vec4(xx,0,0,0),
+        vec4(0,yy,0,0),
+        vec4(0,0,zz,0),
+        vec4(0,0,0,ww) })
+    {}
+    constexpr int mat4::size() const { return 16; }
+
     template <int N1_arg, int N2_arg>
     matrix_stack<float, 4, 4>::matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M)
         :data()
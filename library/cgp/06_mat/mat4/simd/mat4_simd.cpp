@@ -0,0 +1,279 @@
+#include "mat4_simd.hpp"
+
+#if defined(CGP_SIMD_SSE)
+	#include <xmmintrin.h>
+#elif defined(CGP_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace cgp
+{
+#if !defined(CGP_SIMD_SSE)
+	// Inverse with the 2x2 minors of the two first rows (s) and of the two last rows (c) - not used by the SSE version
+	//  The determinant is s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0, and each element of the adjugate is a combination of 3 minors.
+	static float mat4_inverse_scalar(float const* m, float* result)
+	{
+		float const a00 = m[0], a01 = m[1], a02 = m[2], a03 = m[3];
+		float const a10 = m[4], a11 = m[5], a12 = m[6], a13 = m[7];
+		float const a20 = m[8], a21 = m[9], a22 = m[10], a23 = m[11];
+		float const a30 = m[12], a31 = m[13], a32 = m[14], a33 = m[15];
+
+		float const s0 = a00 * a11 - a10 * a01;
+		float const s1 = a00 * a12 - a10 * a02;
+		float const s2 = a00 * a13 - a10 * a03;
+		float const s3 = a01 * a12 - a11 * a02;
+		float const s4 = a01 * a13 - a11 * a03;
+		float const s5 = a02 * a13 - a12 * a03;
+
+		float const c0 = a20 * a31 - a30 * a21;
+		float const c1 = a20 * a32 - a30 * a22;
+		float const c2 = a20 * a33 - a30 * a23;
+		float const c3 = a21 * a32 - a31 * a22;
+		float const c4 = a21 * a33 - a31 * a23;
+		float const c5 = a22 * a33 - a32 * a23;
+
+		float const det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		float const inv = 1.0f / det;
+
+		result[0] = ( a11 * c5 - a12 * c4 + a13 * c3) * inv;
+		result[1] = (-a01 * c5 + a02 * c4 - a03 * c3) * inv;
+		result[2] = ( a31 * s5 - a32 * s4 + a33 * s3) * inv;
+		result[3] = (-a21 * s5 + a22 * s4 - a23 * s3) * inv;
+
+		result[4] = (-a10 * c5 + a12 * c2 - a13 * c1) * inv;
+		result[5] = ( a00 * c5 - a02 * c2 + a03 * c1) * inv;
+		result[6] = (-a30 * s5 + a32 * s2 - a33 * s1) * inv;
+		result[7] = ( a20 * s5 - a22 * s2 + a23 * s1) * inv;
+
+		result[8] = ( a10 * c4 - a11 * c2 + a13 * c0) * inv;
+		result[9] = (-a00 * c4 + a01 * c2 - a03 * c0) * inv;
+		result[10] = ( a30 * s4 - a31 * s2 + a33 * s0) * inv;
+		result[11] = (-a20 * s4 + a21 * s2 - a23 * s0) * inv;
+
+		result[12] = (-a10 * c3 + a11 * c1 - a12 * c0) * inv;
+		result[13] = ( a00 * c3 - a01 * c1 + a02 * c0) * inv;
+		result[14] = (-a30 * s3 + a31 * s1 - a32 * s0) * inv;
+		result[15] = ( a20 * s3 - a21 * s1 + a22 * s0) * inv;
+
+		return det;
+	}
+#endif
+
+	float mat4_simd_determinant(float const* m)
+	{
+		float const s0 = m[0] * m[5] - m[4] * m[1];
+		float const s1 = m[0] * m[6] - m[4] * m[2];
+		float const s2 = m[0] * m[7] - m[4] * m[3];
+		float const s3 = m[1] * m[6] - m[5] * m[2];
+		float const s4 = m[1] * m[7] - m[5] * m[3];
+		float const s5 = m[2] * m[7] - m[6] * m[3];
+
+		float const c0 = m[8] * m[13] - m[12] * m[9];
+		float const c1 = m[8] * m[14] - m[12] * m[10];
+		float const c2 = m[8] * m[15] - m[12] * m[11];
+		float const c3 = m[9] * m[14] - m[13] * m[10];
+		float const c4 = m[9] * m[15] - m[13] * m[11];
+		float const c5 = m[10] * m[15] - m[14] * m[11];
+
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	}
+
+
+#if defined(CGP_SIMD_SSE)
+
+	void mat4_simd_multiply(float const* a, float const* b, float* result)
+	{
+		__m128 const b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4), b2 = _mm_loadu_ps(b + 8), b3 = _mm_loadu_ps(b + 12);
+		__m128 row[4];
+		for (int k = 0; k < 4; ++k) {
+			// Row k of the result: sum_j a(k,j) * row j of b
+			__m128 r = _mm_mul_ps(_mm_set1_ps(a[4 * k]), b0);
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[4 * k + 1]), b1));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[4 * k + 2]), b2));
+			row[k] = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[4 * k + 3]), b3));
+		}
+		for (int k = 0; k < 4; ++k)
+			_mm_storeu_ps(result + 4 * k, row[k]);
+	}
+
+	void mat4_simd_transpose(float const* m, float* result)
+	{
+		__m128 r0 = _mm_loadu_ps(m), r1 = _mm_loadu_ps(m + 4), r2 = _mm_loadu_ps(m + 8), r3 = _mm_loadu_ps(m + 12);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(result, r0);
+		_mm_storeu_ps(result + 4, r1);
+		_mm_storeu_ps(result + 8, r2);
+		_mm_storeu_ps(result + 12, r3);
+	}
+
+	float mat4_simd_inverse(float const* m, float* result)
+	{
+		__m128 const r0 = _mm_loadu_ps(m), r1 = _mm_loadu_ps(m + 4), r2 = _mm_loadu_ps(m + 8), r3 = _mm_loadu_ps(m + 12);
+
+		// Columns with the rows swapped by pairs: Xj = (a1j, a0j, a3j, a2j)
+		__m128 x0 = r0, x1 = r1, x2 = r2, x3 = r3;
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+		x0 = _mm_shuffle_ps(x0, x0, _MM_SHUFFLE(2, 3, 0, 1));
+		x1 = _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2, 3, 0, 1));
+		x2 = _mm_shuffle_ps(x2, x2, _MM_SHUFFLE(2, 3, 0, 1));
+		x3 = _mm_shuffle_ps(x3, x3, _MM_SHUFFLE(2, 3, 0, 1));
+
+		// Top_j = (a2j, a2j, a0j, a0j) and Bottom_j = (a3j, a3j, a1j, a1j)
+		__m128 const t0 = _mm_shuffle_ps(r2, r0, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 const t1 = _mm_shuffle_ps(r2, r0, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 const t2 = _mm_shuffle_ps(r2, r0, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 const t3 = _mm_shuffle_ps(r2, r0, _MM_SHUFFLE(3, 3, 3, 3));
+		__m128 const u0 = _mm_shuffle_ps(r3, r1, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 const u1 = _mm_shuffle_ps(r3, r1, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 const u2 = _mm_shuffle_ps(r3, r1, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 const u3 = _mm_shuffle_ps(r3, r1, _MM_SHUFFLE(3, 3, 3, 3));
+
+		// Minors of the pairs of columns: Kj = (cj, cj, sj, sj)
+		__m128 const k0 = _mm_sub_ps(_mm_mul_ps(t0, u1), _mm_mul_ps(u0, t1)); // columns (0,1)
+		__m128 const k1 = _mm_sub_ps(_mm_mul_ps(t0, u2), _mm_mul_ps(u0, t2)); // (0,2)
+		__m128 const k2 = _mm_sub_ps(_mm_mul_ps(t0, u3), _mm_mul_ps(u0, t3)); // (0,3)
+		__m128 const k3 = _mm_sub_ps(_mm_mul_ps(t1, u2), _mm_mul_ps(u1, t2)); // (1,2)
+		__m128 const k4 = _mm_sub_ps(_mm_mul_ps(t1, u3), _mm_mul_ps(u1, t3)); // (1,3)
+		__m128 const k5 = _mm_sub_ps(_mm_mul_ps(t2, u3), _mm_mul_ps(u2, t3)); // (2,3)
+
+		// Rows of the adjugate, with alternate signs
+		__m128 const sign_even = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f); // (+,-,+,-)
+		__m128 const sign_odd = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);  // (-,+,-,+)
+		__m128 b0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x1, k5), _mm_mul_ps(x2, k4)), _mm_mul_ps(x3, k3));
+		__m128 b1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, k5), _mm_mul_ps(x2, k2)), _mm_mul_ps(x3, k1));
+		__m128 b2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, k4), _mm_mul_ps(x1, k2)), _mm_mul_ps(x3, k0));
+		__m128 b3 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x0, k3), _mm_mul_ps(x1, k1)), _mm_mul_ps(x2, k0));
+		b0 = _mm_xor_ps(b0, sign_even);
+		b1 = _mm_xor_ps(b1, sign_odd);
+		b2 = _mm_xor_ps(b2, sign_even);
+		b3 = _mm_xor_ps(b3, sign_odd);
+
+		// Determinant: first row of the matrix times the first column of the adjugate
+		__m128 const column = _mm_movelh_ps(_mm_unpacklo_ps(b0, b1), _mm_unpacklo_ps(b2, b3));
+		__m128 d = _mm_mul_ps(r0, column);
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+		d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+		float const det = _mm_cvtss_f32(d);
+
+		__m128 const inv = _mm_div_ps(_mm_set1_ps(1.0f), d);
+		_mm_storeu_ps(result, _mm_mul_ps(b0, inv));
+		_mm_storeu_ps(result + 4, _mm_mul_ps(b1, inv));
+		_mm_storeu_ps(result + 8, _mm_mul_ps(b2, inv));
+		_mm_storeu_ps(result + 12, _mm_mul_ps(b3, inv));
+		return det;
+	}
+
+	void mat4_simd_transform(float const* m, float const* v, float* result)
+	{
+		// Products of the rows with v, transposed to sum the dot products in parallel
+		__m128 const x = _mm_loadu_ps(v);
+		__m128 p0 = _mm_mul_ps(_mm_loadu_ps(m), x);
+		__m128 p1 = _mm_mul_ps(_mm_loadu_ps(m + 4), x);
+		__m128 p2 = _mm_mul_ps(_mm_loadu_ps(m + 8), x);
+		__m128 p3 = _mm_mul_ps(_mm_loadu_ps(m + 12), x);
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		_mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+	}
+
+#elif defined(CGP_SIMD_NEON)
+
+	void mat4_simd_multiply(float const* a, float const* b, float* result)
+	{
+		float32x4_t const b0 = vld1q_f32(b), b1 = vld1q_f32(b + 4), b2 = vld1q_f32(b + 8), b3 = vld1q_f32(b + 12);
+		float32x4_t row[4];
+		for (int k = 0; k < 4; ++k) {
+			float32x4_t const ak = vld1q_f32(a + 4 * k);
+			float32x4_t r = vmulq_lane_f32(b0, vget_low_f32(ak), 0);
+			r = vmlaq_lane_f32(r, b1, vget_low_f32(ak), 1);
+			r = vmlaq_lane_f32(r, b2, vget_high_f32(ak), 0);
+			row[k] = vmlaq_lane_f32(r, b3, vget_high_f32(ak), 1);
+		}
+		for (int k = 0; k < 4; ++k)
+			vst1q_f32(result + 4 * k, row[k]);
+	}
+
+	void mat4_simd_transpose(float const* m, float* result)
+	{
+		// De-interleaved load: val[j] is the column j
+		float32x4x4_t const columns = vld4q_f32(m);
+		vst1q_f32(result, columns.val[0]);
+		vst1q_f32(result + 4, columns.val[1]);
+		vst1q_f32(result + 8, columns.val[2]);
+		vst1q_f32(result + 12, columns.val[3]);
+	}
+
+	float mat4_simd_inverse(float const* m, float* result)
+	{
+		float copy[16];
+		for (int k = 0; k < 16; ++k)
+			copy[k] = m[k];
+		return mat4_inverse_scalar(copy, result);
+	}
+
+	void mat4_simd_transform(float const* m, float const* v, float* result)
+	{
+		float32x4x4_t const columns = vld4q_f32(m);
+		float32x4_t r = vmulq_n_f32(columns.val[0], v[0]);
+		r = vmlaq_n_f32(r, columns.val[1], v[1]);
+		r = vmlaq_n_f32(r, columns.val[2], v[2]);
+		r = vmlaq_n_f32(r, columns.val[3], v[3]);
+		vst1q_f32(result, r);
+	}
+
+#else
+
+	void mat4_simd_multiply(float const* a, float const* b, float* result)
+	{
+		float r[16];
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				r[4 * i + j] = a[4 * i] * b[j] + a[4 * i + 1] * b[4 + j] + a[4 * i + 2] * b[8 + j] + a[4 * i + 3] * b[12 + j];
+		for (int k = 0; k < 16; ++k)
+			result[k] = r[k];
+	}
+
+	void mat4_simd_transpose(float const* m, float* result)
+	{
+		float r[16];
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				r[4 * j + i] = m[4 * i + j];
+		for (int k = 0; k < 16; ++k)
+			result[k] = r[k];
+	}
+
+	float mat4_simd_inverse(float const* m, float* result)
+	{
+		float copy[16];
+		for (int k = 0; k < 16; ++k)
+			copy[k] = m[k];
+		return mat4_inverse_scalar(copy, result);
+	}
+
+	void mat4_simd_transform(float const* m, float const* v, float* result)
+	{
+		float r[4];
+		for (int i = 0; i < 4; ++i)
+			r[i] = m[4 * i] * v[0] + m[4 * i + 1] * v[1] + m[4 * i + 2] * v[2] + m[4 * i + 3] * v[3];
+		for (int k = 0; k < 4; ++k)
+			result[k] = r[k];
+	}
+
+#endif
+
+	void mat4_affine_from_quaternion(float const* q, float const* scaling_row, float const* translation, float* result)
+	{
+		// Written directly in the matrix: no temporary 3x3 rotation matrix
+		float const x = q[0], y = q[1], z = q[2], w = q[3];
+		float const x2 = 2 * x, y2 = 2 * y, z2 = 2 * z;
+		float const xx = x * x2, yy = y * y2, zz = z * z2;
+		float const xy = x * y2, xz = x * z2, yz = y * z2;
+		float const wx = w * x2, wy = w * y2, wz = w * z2;
+
+		float const sx = scaling_row[0], sy = scaling_row[1], sz = scaling_row[2];
+		result[0] = sx * (1 - yy - zz); result[1] = sx * (xy - wz);     result[2] = sx * (xz + wy);      result[3] = translation[0];
+		result[4] = sy * (xy + wz);     result[5] = sy * (1 - xx - zz); result[6] = sy * (yz - wx);      result[7] = translation[1];
+		result[8] = sz * (xz - wy);     result[9] = sz * (yz + wx);     result[10] = sz * (1 - xx - yy); result[11] = translation[2];
+		result[12] = 0.0f;              result[13] = 0.0f;              result[14] = 0.0f;               result[15] = 1.0f;
+	}
+}
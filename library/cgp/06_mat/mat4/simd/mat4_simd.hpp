@@ -0,0 +1,29 @@
+#pragma once
+
+#include "cgp/cgp_parameters.hpp"
+
+// SIMD kernels of the mat4 operations (used by mat4.cpp and mat_functions.cpp)
+//  The matrices are 16 floats stored along rows, without alignment constraint. The result can be the same array as an argument.
+//  SSE is used on x86 (always available on x86-64), NEON on ARM, and a scalar version otherwise.
+//  Defining CGP_NO_SIMD forces the scalar version.
+#if !defined(CGP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define CGP_SIMD_SSE
+#elif !defined(CGP_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+	#define CGP_SIMD_NEON
+#endif
+
+namespace cgp
+{
+	// result = a * b
+	void mat4_simd_multiply(float const* a, float const* b, float* result);
+	void mat4_simd_transpose(float const* m, float* result);
+	// result = m^{-1} using the 2x2 minors (Laplace expansion). Returns the determinant (the result is not finite if it is 0).
+	float mat4_simd_inverse(float const* m, float* result);
+	float mat4_simd_determinant(float const* m);
+	// 4D vector: result = m * v
+	void mat4_simd_transform(float const* m, float const* v, float* result);
+
+	// Affine matrix | diag(scaling_row) * R(q)  translation |
+	//               |          0                    1       |  with R(q) the rotation of the unit quaternion q=(x,y,z,w)
+	void mat4_affine_from_quaternion(float const* q, float const* scaling_row, float const* translation, float* result);
+}
@@ -8,6 +8,8 @@
 
 #include "cgp/13_opengl/opengl.hpp"
 
+#include <cstdlib>
+
 #if defined(__linux__) || defined(__EMSCRIPTEN__)
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #endif
@@ -78,14 +80,20 @@ namespace cgp
         image_structure im;
         im.color_type = color_type;
 
+        // The C interface of lodepng gives its decoded buffer, copied once in the numarray
+        //  (lodepng::decode copies it in a std::vector, which would need a second copy as numarray uses arena_allocator)
         unsigned w=0, h = 0;
-        unsigned error = lodepng::decode(im.data.data, w, h, filename, lodepng_color_type);
+        unsigned char* pixels = nullptr;
+        unsigned error = lodepng_decode_file(&pixels, &w, &h, filename.c_str(), lodepng_color_type, 8);
         if ( error )
         {
+            std::free(pixels);
             std::cerr<<"Error Loading png file "<<filename<<std::endl;
             std::cerr<<"Decoder error " << error << ": " << lodepng_error_text(error) << std::endl;
             exit(1);
         }
+        im.data.data.assign(pixels, pixels + size_t(w) * size_t(h) * size_of_component(color_type));
+        std::free(pixels); // Allocated with malloc by lodepng
         im.width = w;
         im.height = h;
 
@@ -106,7 +114,7 @@ namespace cgp
         }
 
         //std::vector<unsigned char> output;
-        unsigned error = lodepng::encode(filename, im.data.data, im.width, im.height, lodepng_color_type);
+        unsigned error = lodepng::encode(filename, im.data.data.data(), im.width, im.height, lodepng_color_type);
         if ( error )
         {
             std::cerr<<"Error Loading png file "<<filename<<std::endl;
@@ -56,5 +56,9 @@ namespace cgp
 	//    0 3 6  9  
 	//    1 4 7 10
 	//    2 5 8 11
+	//  Note: use image_split_grid_view to avoid copying the sub-images
 	std::vector<image_structure> image_split_grid(image_structure const& image_in, int N_horizontal, int N_vertical);
-}
\ No newline at end of file
+}
+
+#include "image_view/image_view.hpp"
+#include "image_baked/image_baked.hpp"
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include "image_baked.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cgp
+{
+#ifdef __EMSCRIPTEN__
+    bool image_baked_cache::active = false;
+#else
+    bool image_baked_cache::active = true;
+#endif
+    std::string image_baked_cache::extension = ".cgptex";
+
+    namespace
+    {
+        struct image_baked_header {
+            char magic[4];
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t channels;
+            uint32_t face_count;
+            uint32_t level_count;
+            uint32_t reserved;
+        };
+        struct image_baked_level_entry {
+            uint64_t offset;
+            uint64_t size;
+        };
+        uint32_t const image_baked_version = 1;
+        size_t const image_baked_alignment = 16;
+
+        int channels_of(image_color_type type)
+        {
+            return type == image_color_type::rgba ? 4 : 3;
+        }
+
+        size_t align(size_t value)
+        {
+            return (value + image_baked_alignment - 1) / image_baked_alignment * image_baked_alignment;
+        }
+
+        // Allocate the storage and compute the offsets of all the levels
+        unsigned char* allocate(image_baked& im)
+        {
+            int const channels = channels_of(im.color_type);
+            im.offset.resize(size_t(im.face_count) * im.level_count + 1);
+            size_t total = 0;
+            for (int face = 0; face < im.face_count; ++face) {
+                for (int level = 0; level < im.level_count; ++level) {
+                    im.offset[size_t(face) * im.level_count + level] = total;
+                    total = align(total + size_t(im.level_width(level)) * im.level_height(level) * channels);
+                }
+            }
+            im.offset.back() = total;
+
+            auto buffer = std::make_shared<std::vector<unsigned char>>(total);
+            im.storage = buffer;
+            im.base = buffer->data();
+            return buffer->data();
+        }
+
+        // Downsample by a factor 2 using a box filter (the last row/column is repeated for odd dimensions)
+        void downsample(unsigned char const* in, int width_in, int height_in, unsigned char* out, int width_out, int height_out, int channels)
+        {
+            for (int y = 0; y < height_out; ++y) {
+                int const y0 = std::min(2 * y, height_in - 1);
+                int const y1 = std::min(2 * y + 1, height_in - 1);
+                for (int x = 0; x < width_out; ++x) {
+                    int const x0 = std::min(2 * x, width_in - 1);
+                    int const x1 = std::min(2 * x + 1, width_in - 1);
+                    for (int c = 0; c < channels; ++c) {
+                        int const sum = in[channels * (x0 + width_in * y0) + c] + in[channels * (x1 + width_in * y0) + c]
+                            + in[channels * (x0 + width_in * y1) + c] + in[channels * (x1 + width_in * y1) + c];
+                        out[channels * (x + width_out * y) + c] = static_cast<unsigned char>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+
+        void fill_face(image_baked& im, unsigned char* base, int face, image_view const& source)
+        {
+            assert_cgp(source.width == im.width && source.height == im.height && source.color_type == im.color_type, "All the faces of a baked image must have the same size and color type");
+            int const channels = channels_of(im.color_type);
+            unsigned char* level0 = base + im.offset[size_t(face) * im.level_count];
+            if (source.is_region()) {
+                for (int y = 0; y < im.height; ++y)
+                    std::memcpy(level0 + size_t(channels) * im.width * y, source.pixel(0, y), size_t(channels) * im.width);
+            }
+            else {
+                for (int y = 0; y < im.height; ++y)
+                    for (int x = 0; x < im.width; ++x)
+                        std::memcpy(level0 + size_t(channels) * (x + size_t(im.width) * y), source.pixel(x, y), channels);
+            }
+            for (int level = 1; level < im.level_count; ++level) {
+                unsigned char const* previous = base + im.offset[size_t(face) * im.level_count + level - 1];
+                unsigned char* current = base + im.offset[size_t(face) * im.level_count + level];
+                downsample(previous, im.level_width(level - 1), im.level_height(level - 1), current, im.level_width(level), im.level_height(level), channels);
+            }
+        }
+    }
+
+
+    int image_baked::level_width(int level) const
+    {
+        return std::max(width >> level, 1);
+    }
+    int image_baked::level_height(int level) const
+    {
+        return std::max(height >> level, 1);
+    }
+    unsigned char const* image_baked::level_data(int face, int level) const
+    {
+        assert_cgp_no_msg(face >= 0 && face < face_count && level >= 0 && level < level_count);
+        return base + offset[size_t(face) * level_count + level];
+    }
+    size_t image_baked::level_size(int, int level) const
+    {
+        return size_t(level_width(level)) * level_height(level) * channels_of(color_type);
+    }
+
+    int image_mipmap_level_count(int width, int height)
+    {
+        int N = 1;
+        while ((width >> N) > 0 || (height >> N) > 0)
+            N++;
+        return N;
+    }
+
+
+    image_baked image_bake(image_view const& im, bool mipmap)
+    {
+        image_baked baked;
+        baked.width = im.width;
+        baked.height = im.height;
+        baked.color_type = im.color_type;
+        baked.face_count = 1;
+        baked.level_count = mipmap ? image_mipmap_level_count(im.width, im.height) : 1;
+
+        unsigned char* base = allocate(baked);
+        fill_face(baked, base, 0, im);
+        return baked;
+    }
+
+    image_baked image_bake_cubemap(image_view const& x_neg, image_view const& x_pos, image_view const& y_neg, image_view const& y_pos, image_view const& z_neg, image_view const& z_pos, bool mipmap)
+    {
+        assert_cgp(x_neg.width == x_neg.height, "Cubemap faces should be squared images");
+
+        image_baked baked;
+        baked.width = x_neg.width;
+        baked.height = x_neg.height;
+        baked.color_type = x_neg.color_type;
+        baked.face_count = 6;
+        baked.level_count = mipmap ? image_mipmap_level_count(baked.width, baked.height) : 1;
+
+        unsigned char* base = allocate(baked);
+        image_view const* faces[6] = { &x_neg, &x_pos, &y_neg, &y_pos, &z_neg, &z_pos };
+        for (int face = 0; face < 6; ++face)
+            fill_face(baked, base, face, *faces[face]);
+        return baked;
+    }
+
+
+    void image_baked_save(std::string const& filename, image_baked const& im)
+    {
+        assert_cgp(im.face_count > 0, "Cannot save an empty baked image");
+
+        image_baked_header header;
+        std::memcpy(header.magic, "CGPT", 4);
+        header.version = image_baked_version;
+        header.width = uint32_t(im.width);
+        header.height = uint32_t(im.height);
+        header.channels = uint32_t(channels_of(im.color_type));
+        header.face_count = uint32_t(im.face_count);
+        header.level_count = uint32_t(im.level_count);
+        header.reserved = 0;
+
+        size_t const N_entry = size_t(im.face_count) * im.level_count;
+        std::vector<image_baked_level_entry> entries(N_entry);
+        for (int face = 0; face < im.face_count; ++face)
+            for (int level = 0; level < im.level_count; ++level)
+                entries[size_t(face) * im.level_count + level] = { uint64_t(im.offset[size_t(face) * im.level_count + level]), uint64_t(im.level_size(face, level)) };
+
+        // The pixel data starts on an aligned position
+        size_t const header_size = sizeof(header) + N_entry * sizeof(image_baked_level_entry);
+        std::vector<char> padding(align(header_size) - header_size, 0);
+
+        // Write in a temporary file first: a partially written cache is never used
+        std::string const temporary = filename + ".tmp";
+        std::ofstream stream(temporary, std::ios::binary);
+        if (!stream.is_open()) {
+            warning_cgp("Cannot write the baked image", filename);
+            return;
+        }
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<char const*>(entries.data()), N_entry * sizeof(image_baked_level_entry));
+        stream.write(padding.data(), padding.size());
+        stream.write(reinterpret_cast<char const*>(im.base), im.offset.back());
+        stream.close();
+
+        // rename replaces the previous cache atomically: there is always a complete cache file on disk
+        if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            warning_cgp("Cannot replace the baked image", filename);
+            std::remove(temporary.c_str());
+        }
+    }
+
+    image_baked image_baked_load(std::string const& filename)
+    {
+        image_baked im;
+
+        auto mapping = std::make_shared<file_mapping>();
+        if (!mapping->open(filename) || mapping->size() < sizeof(image_baked_header))
+            return im;
+
+        image_baked_header header;
+        std::memcpy(&header, mapping->data(), sizeof(header));
+        if (std::memcmp(header.magic, "CGPT", 4) != 0 || header.version != image_baked_version || (header.channels != 3 && header.channels != 4)
+            || (header.face_count != 1 && header.face_count != 6) || header.level_count == 0 || header.level_count > 32) {
+            warning_cgp("Invalid baked image file", filename);
+            return im;
+        }
+
+        size_t const N_entry = size_t(header.face_count) * header.level_count;
+        size_t const header_size = sizeof(header) + N_entry * sizeof(image_baked_level_entry);
+        size_t const data_start = align(header_size);
+        if (mapping->size() < data_start)
+            return im;
+
+        im.width = int(header.width);
+        im.height = int(header.height);
+        im.color_type = header.channels == 4 ? image_color_type::rgba : image_color_type::rgb;
+        im.face_count = int(header.face_count);
+        im.level_count = int(header.level_count);
+        im.offset.resize(N_entry + 1);
+        size_t const data_size = mapping->size() - data_start;
+        for (size_t k = 0; k < N_entry; ++k) {
+            image_baked_level_entry entry;
+            std::memcpy(&entry, mapping->data() + sizeof(header) + k * sizeof(entry), sizeof(entry));
+            int const level = int(k % header.level_count);
+            if (entry.size != im.level_size(0, level) || entry.offset + entry.size > data_size) {
+                warning_cgp("Truncated baked image file", filename);
+                return image_baked();
+            }
+            im.offset[k] = size_t(entry.offset);
+        }
+        im.offset.back() = data_size;
+
+        im.base = mapping->data() + data_start;
+        im.storage = mapping;
+        return im;
+    }
+
+
+    std::string image_baked_cache_filename(std::string const& filename)
+    {
+        return filename + image_baked_cache::extension;
+    }
+
+    bool image_baked_cache_is_valid(std::string const& filename)
+    {
+        std::string const baked_filename = image_baked_cache_filename(filename);
+        return image_baked_cache::active && check_path_exist(baked_filename) && !file_is_newer(filename, baked_filename);
+    }
+
+    image_baked image_load_file_baked(std::string const& filename, bool mipmap)
+    {
+        std::string const baked_filename = image_baked_cache_filename(filename);
+        if (image_baked_cache_is_valid(filename)) {
+            image_baked im = image_baked_load(baked_filename);
+            if (im.face_count == 1 && (im.level_count > 1 || !mipmap))
+                return im;
+        }
+
+        image_baked im = image_bake(image_load_file(filename), mipmap);
+        if (image_baked_cache::active)
+            image_baked_save(baked_filename, im);
+        return im;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../image.hpp"
+#include "../image_view/image_view.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cgp
+{
+	struct image_view; // Declared here as image_view.hpp includes this file through image.hpp
+
+	/** Image ready to be uploaded as a texture: raw RGB8/RGBA8 pixels with all the mipmap levels precomputed, and cubemap faces already split.
+	*  The pixels are either stored in memory (after image_bake) or read from a memory-mapped baked file (image_baked_load), in which case no copy is made.
+	*
+	* File layout (.cgptex, little endian):
+	*  - header: "CGPT", version, width, height, number of channels (3|4), number of faces (1|6), number of levels, 0
+	*  - for each face and each level (face major): offset (from the start of the pixel data) and size in bytes, as 64 bits integers
+	*  - pixel data: each level is tightly packed (no row padding) and starts on a 16 bytes boundary */
+	struct image_baked
+	{
+		int width = 0;
+		int height = 0;
+		image_color_type color_type = image_color_type::rgb;
+		int face_count = 0;  // 1 for a 2D texture, 6 for a cubemap (order: x_neg, x_pos, y_neg, y_pos, z_neg, z_pos)
+		int level_count = 0; // Number of mipmap levels (1 if no mipmap)
+
+		int level_width(int level) const;
+		int level_height(int level) const;
+		unsigned char const* level_data(int face, int level) const;
+		size_t level_size(int face, int level) const;
+
+		// Internal storage - the offsets are relative to base, which is kept valid by storage (buffer or file mapping)
+		std::shared_ptr<void> storage;
+		unsigned char const* base = nullptr;
+		std::vector<size_t> offset;
+	};
+
+	// Number of mipmap levels of a full chain down to 1x1
+	int image_mipmap_level_count(int width, int height);
+
+	// Compute the mipmap levels (box filter) of an image
+	image_baked image_bake(image_view const& im, bool mipmap = true);
+	// Gather the 6 faces of a cubemap (squared images of the same size). The faces can be views on a single atlas image.
+	image_baked image_bake_cubemap(image_view const& x_neg, image_view const& x_pos, image_view const& y_neg, image_view const& y_pos, image_view const& z_neg, image_view const& z_pos, bool mipmap = false);
+
+	void image_baked_save(std::string const& filename, image_baked const& im);
+	// Map the file in memory. Returns an image with face_count=0 if the file is missing or invalid.
+	image_baked image_baked_load(std::string const& filename);
+
+
+	// Cache of baked images stored next to the source files (filename + extension)
+	//  The cached file is used as long as it is more recent than the source file.
+	struct image_baked_cache {
+		static bool active;
+		static std::string extension;
+	};
+	std::string image_baked_cache_filename(std::string const& filename);
+	bool image_baked_cache_is_valid(std::string const& filename);
+
+	// Return the baked version of an image file. Uses the cache if valid, otherwise decodes, bakes and writes the cache.
+	image_baked image_load_file_baked(std::string const& filename, bool mipmap = true);
+}
@@ -0,0 +1,68 @@
+#include "cgp/01_base/base.hpp"
+#include "../image_baked.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_image_baked()
+	{
+		// Mipmap chain of a non power of two RGB image
+		{
+			int const w = 5, h = 3;
+			cgp::numarray<unsigned char> data;
+			data.resize(3 * w * h);
+			for (int k = 0; k < data.size(); ++k)
+				data[k] = static_cast<unsigned char>(10 * k);
+			cgp::image_structure const im(w, h, cgp::image_color_type::rgb, data);
+
+			cgp::image_baked const baked = cgp::image_bake(im);
+			assert_cgp_no_msg(baked.level_count == 3); // 5x3, 2x1, 1x1
+			assert_cgp_no_msg(baked.level_width(1) == 2 && baked.level_height(1) == 1);
+			assert_cgp_no_msg(baked.level_width(2) == 1 && baked.level_height(2) == 1);
+			assert_cgp_no_msg(std::memcmp(baked.level_data(0, 0), &data[0], data.size()) == 0);
+
+			// First pixel of level 1 is the average of the 2x2 block
+			int const expected = (data[0] + data[3] + data[3 * w] + data[3 * w + 3] + 2) / 4;
+			assert_cgp_no_msg(baked.level_data(0, 1)[0] == expected);
+
+			// Save and memory-map back
+			std::string const filename = "test_image_baked.cgptex";
+			cgp::image_baked_save(filename, baked);
+			cgp::image_baked const loaded = cgp::image_baked_load(filename);
+			assert_cgp_no_msg(loaded.face_count == 1);
+			assert_cgp_no_msg(loaded.width == w && loaded.height == h && loaded.color_type == cgp::image_color_type::rgb);
+			assert_cgp_no_msg(loaded.level_count == baked.level_count);
+			for (int level = 0; level < loaded.level_count; ++level)
+				assert_cgp_no_msg(std::memcmp(loaded.level_data(0, level), baked.level_data(0, level), baked.level_size(0, level)) == 0);
+			std::remove(filename.c_str());
+		}
+
+		// Cubemap faces
+		{
+			cgp::numarray<unsigned char> data;
+			data.resize(4 * 4 * 4);
+			cgp::image_structure faces[6];
+			for (int face = 0; face < 6; ++face) {
+				data.fill(static_cast<unsigned char>(face));
+				faces[face] = cgp::image_structure(4, 4, cgp::image_color_type::rgba, data);
+			}
+			cgp::image_baked const baked = cgp::image_bake_cubemap(faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]);
+			assert_cgp_no_msg(baked.face_count == 6 && baked.level_count == 1);
+			for (int face = 0; face < 6; ++face)
+				assert_cgp_no_msg(baked.level_data(face, 0)[0] == face);
+		}
+
+		// Invalid file
+		{
+			cgp::image_baked const missing = cgp::image_baked_load("file_that_does_not_exist.cgptex");
+			assert_cgp_no_msg(missing.face_count == 0);
+		}
+	}
+}
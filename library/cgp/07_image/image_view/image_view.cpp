@@ -0,0 +1,190 @@
+#include "image_view.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace cgp
+{
+    image_view::image_view()
+    {}
+
+    image_view::image_view(image_structure const& im)
+        :data(im.data.size() > 0 ? ptr(im.data) : nullptr), row_length(im.width), offset_x(0), offset_y(0), width(im.width), height(im.height), color_type(im.color_type)
+    {}
+
+    int image_view::channels() const
+    {
+        return color_type == image_color_type::rgba ? 4 : 3;
+    }
+
+    bool image_view::is_region() const
+    {
+        return !transposed && !mirror_horizontal && !mirror_vertical;
+    }
+
+    unsigned char const* image_view::pixel(int x, int y) const
+    {
+        assert_cgp_no_msg(x >= 0 && x < width && y >= 0 && y < height);
+        if (mirror_horizontal)
+            x = width - 1 - x;
+        if (mirror_vertical)
+            y = height - 1 - y;
+        if (transposed)
+            std::swap(x, y);
+        return data + size_t(channels()) * (size_t(offset_x + x) + size_t(row_length) * (offset_y + y));
+    }
+
+    image_view image_view::subview(int start_h, int start_v, int end_h, int end_v) const
+    {
+        // Sanity check
+        assert_cgp_no_msg(start_h < end_h);
+        assert_cgp_no_msg(start_v < end_v);
+        assert_cgp_no_msg(start_h >= 0);
+        assert_cgp_no_msg(start_v >= 0);
+        assert_cgp_no_msg(end_h <= width);
+        assert_cgp_no_msg(end_v <= height);
+
+        // Corners of the region in the view coordinates, mapped back to the source orientation
+        int x0 = start_h, x1 = end_h, y0 = start_v, y1 = end_v;
+        if (mirror_horizontal) {
+            x0 = width - end_h;
+            x1 = width - start_h;
+        }
+        if (mirror_vertical) {
+            y0 = height - end_v;
+            y1 = height - start_v;
+        }
+        if (transposed) {
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+
+        image_view sub = *this;
+        sub.offset_x = offset_x + x0;
+        sub.offset_y = offset_y + y0;
+        sub.width = end_h - start_h;
+        sub.height = end_v - start_v;
+        return sub;
+    }
+
+    image_view image_view::mirrored_horizontal() const
+    {
+        image_view v = *this;
+        v.mirror_horizontal = !mirror_horizontal;
+        return v;
+    }
+
+    image_view image_view::mirrored_vertical() const
+    {
+        image_view v = *this;
+        v.mirror_vertical = !mirror_vertical;
+        return v;
+    }
+
+    // A rotation is a transposition followed by a mirror: the transposition of the current orientation swaps the mirror flags
+    image_view image_view::rotated_90_degrees_counterclockwise() const
+    {
+        image_view v = *this;
+        v.transposed = !transposed;
+        v.mirror_horizontal = mirror_vertical;
+        v.mirror_vertical = !mirror_horizontal;
+        std::swap(v.width, v.height);
+        return v;
+    }
+
+    image_view image_view::rotated_90_degrees_clockwise() const
+    {
+        image_view v = *this;
+        v.transposed = !transposed;
+        v.mirror_horizontal = !mirror_vertical;
+        v.mirror_vertical = mirror_horizontal;
+        std::swap(v.width, v.height);
+        return v;
+    }
+
+    image_structure image_view::to_image() const
+    {
+        image_structure im;
+        im.width = width;
+        im.height = height;
+        im.color_type = color_type;
+
+        int const s = channels();
+        im.data.resize(size_t(s) * width * height);
+        if (is_region()) {
+            for (int ky = 0; ky < height; ++ky)
+                std::memcpy(&im.data[size_t(s) * width * ky], pixel(0, ky), size_t(s) * width);
+        }
+        else {
+            for (int ky = 0; ky < height; ++ky)
+                for (int kx = 0; kx < width; ++kx)
+                    std::memcpy(&im.data[size_t(s) * (kx + width * ky)], pixel(kx, ky), s);
+        }
+        return im;
+    }
+
+
+    std::vector<image_view> image_split_grid_view(image_structure const& image_in, int N_horizontal, int N_vertical)
+    {
+        // Sanity check
+        assert_cgp(N_horizontal > 0, "Split image should have N_horizontal>0");
+        assert_cgp(N_vertical > 0, "Split image should have N_vertical>0");
+
+        int const width = image_in.width / N_horizontal;
+        int const height = image_in.height / N_vertical;
+        assert_cgp(width * N_horizontal == image_in.width && height * N_vertical == image_in.height, "Cannot split image (" + str(image_in.width) + "x" + str(image_in.height) + ") into (" + str(N_horizontal) + "x" + str(N_vertical) + ") blocks");
+
+        image_view const full(image_in);
+        std::vector<image_view> subviews(N_horizontal * N_vertical);
+        for (int kh = 0; kh < N_horizontal; ++kh)
+            for (int kv = 0; kv < N_vertical; ++kv)
+                subviews[kv + N_vertical * kh] = full.subview(kh * width, kv * height, (kh + 1) * width, (kv + 1) * height);
+        return subviews;
+    }
+
+    image_structure image_resample(image_view const& im, int width, int height, image_color_type color_type)
+    {
+        assert_cgp(im.width > 0 && im.height > 0 && width > 0 && height > 0, "Cannot resample an empty image");
+        int const channels_in = im.channels();
+        int const channels_out = color_type == image_color_type::rgba ? 4 : 3;
+
+        image_structure out;
+        out.width = width;
+        out.height = height;
+        out.color_type = color_type;
+        out.data.resize(size_t(channels_out) * width * height);
+
+        float const scale_x = float(im.width) / float(width);
+        float const scale_y = float(im.height) / float(height);
+        for (int y = 0; y < height; ++y) {
+            float const v = std::min(std::max((y + 0.5f) * scale_y - 0.5f, 0.0f), float(im.height - 1));
+            int const y0 = int(v);
+            int const y1 = std::min(y0 + 1, im.height - 1);
+            float const ty = v - float(y0);
+            for (int x = 0; x < width; ++x) {
+                float const u = std::min(std::max((x + 0.5f) * scale_x - 0.5f, 0.0f), float(im.width - 1));
+                int const x0 = int(u);
+                int const x1 = std::min(x0 + 1, im.width - 1);
+                float const tx = u - float(x0);
+
+                unsigned char const* p00 = im.pixel(x0, y0);
+                unsigned char const* p10 = im.pixel(x1, y0);
+                unsigned char const* p01 = im.pixel(x0, y1);
+                unsigned char const* p11 = im.pixel(x1, y1);
+                unsigned char* q = &out.data[size_t(channels_out) * (x + size_t(width) * y)];
+                for (int c = 0; c < channels_out; ++c) {
+                    if (c >= channels_in) {
+                        q[c] = 255;
+                        continue;
+                    }
+                    float const value = (1 - ty) * ((1 - tx) * p00[c] + tx * p10[c]) + ty * ((1 - tx) * p01[c] + tx * p11[c]);
+                    q[c] = static_cast<unsigned char>(std::min(value + 0.5f, 255.0f));
+                }
+            }
+        }
+        return out;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../image.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	/** Non-owning view on a rectangular region of an image, with an optional orientation.
+	*  The view stores a pointer to the pixels of the source image (which must outlive the view), the position of the region and the row length of the source.
+	*  Sub-regions and mirrored/rotated views are obtained without copying any pixel.
+	*  The pixel (x,y) of the view is the pixel of the region at
+	*   - (y,x) if transposed (applied first)
+	*   - then mirrored horizontally (x -> width-1-x) and/or vertically (y -> height-1-y) */
+	struct image_view
+	{
+		unsigned char const* data = nullptr; // Pixels of the source image
+		int row_length = 0;                  // Width of the source image (number of pixels between two rows)
+		int offset_x = 0;                    // Position of the region in the source image
+		int offset_y = 0;
+		int width = 0;                       // Size of the view (after orientation)
+		int height = 0;
+		image_color_type color_type = image_color_type::rgb;
+
+		bool transposed = false;
+		bool mirror_horizontal = false;
+		bool mirror_vertical = false;
+
+		image_view();
+		image_view(image_structure const& im);
+
+		// Sub-region of the view from kh=[start_h..end_h[, and kv=[start_v..end_v[ (same convention as image_structure::subimage)
+		image_view subview(int start_h, int start_v, int end_h, int end_v) const;
+
+		image_view mirrored_horizontal() const;
+		image_view mirrored_vertical() const;
+		image_view rotated_90_degrees_counterclockwise() const;
+		image_view rotated_90_degrees_clockwise() const;
+
+		// True if the view is a region of the source in its initial orientation (rows can be read directly from the source)
+		bool is_region() const;
+
+		int channels() const;
+		unsigned char const* pixel(int x, int y) const;
+		// Copy the pixels of the view in a new image
+		image_structure to_image() const;
+	};
+
+	// Same as image_split_grid, but returns views on the input image (no copy)
+	std::vector<image_view> image_split_grid_view(image_structure const& image_in, int N_horizontal, int N_vertical);
+
+	// Resample a view to a new size (bilinear interpolation, pixel centers aligned) and color type (the alpha is set to 255 when converting rgb to rgba)
+	image_structure image_resample(image_view const& im, int width, int height, image_color_type color_type);
+}
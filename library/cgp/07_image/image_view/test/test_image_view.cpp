@@ -0,0 +1,57 @@
+#include "cgp/01_base/base.hpp"
+#include "../image_view.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bool is_equal(cgp::image_structure const& a, cgp::image_structure const& b)
+	{
+		if (a.width != b.width || a.height != b.height || a.color_type != b.color_type || a.data.size() != b.data.size())
+			return false;
+		for (int k = 0; k < a.data.size(); ++k)
+			if (a.data[k] != b.data[k])
+				return false;
+		return true;
+	}
+
+	void test_image_view()
+	{
+		// Views give the same pixels as the copying functions of image_structure
+		int const w = 6, h = 4;
+		cgp::numarray<unsigned char> data;
+		data.resize(3 * w * h);
+		for (int k = 0; k < data.size(); ++k)
+			data[k] = static_cast<unsigned char>(k);
+		cgp::image_structure const im(w, h, cgp::image_color_type::rgb, data);
+		cgp::image_view const view(im);
+
+		assert_cgp_no_msg(is_equal(view.to_image(), im));
+		assert_cgp_no_msg(is_equal(view.subview(1, 2, 5, 4).to_image(), im.subimage(1, 2, 5, 4)));
+		assert_cgp_no_msg(is_equal(view.mirrored_horizontal().to_image(), im.mirror_horizontal()));
+		assert_cgp_no_msg(is_equal(view.mirrored_vertical().to_image(), im.mirror_vertical()));
+		assert_cgp_no_msg(is_equal(view.rotated_90_degrees_clockwise().to_image(), im.rotate_90_degrees_clockwise()));
+		assert_cgp_no_msg(is_equal(view.rotated_90_degrees_counterclockwise().to_image(), im.rotate_90_degrees_counterclockwise()));
+
+		// Composition of orientations and sub-regions
+		cgp::image_view const rotated = view.rotated_90_degrees_clockwise().mirrored_horizontal();
+		cgp::image_structure const rotated_copy = im.rotate_90_degrees_clockwise().mirror_horizontal();
+		assert_cgp_no_msg(is_equal(rotated.to_image(), rotated_copy));
+		assert_cgp_no_msg(is_equal(rotated.subview(1, 1, 3, 5).to_image(), rotated_copy.subimage(1, 1, 3, 5)));
+		assert_cgp_no_msg(is_equal(view.rotated_90_degrees_clockwise().rotated_90_degrees_counterclockwise().to_image(), im));
+
+		// Split in a grid
+		std::vector<cgp::image_view> const views = cgp::image_split_grid_view(im, 3, 2);
+		std::vector<cgp::image_structure> const images = cgp::image_split_grid(im, 3, 2);
+		for (size_t k = 0; k < views.size(); ++k)
+			assert_cgp_no_msg(is_equal(views[k].to_image(), images[k]));
+
+		// Resampling to the same size is the identity, and rgb to rgba adds an opaque alpha
+		assert_cgp_no_msg(is_equal(cgp::image_resample(view, w, h, cgp::image_color_type::rgb), im));
+		cgp::image_structure const rgba = cgp::image_resample(view.subview(1, 1, 3, 3), 4, 4, cgp::image_color_type::rgba);
+		assert_cgp_no_msg(rgba.width == 4 && rgba.height == 4 && rgba.data[3] == 255);
+		assert_cgp_no_msg(rgba.data[0] == im.subimage(1, 1, 3, 3).data[0]); // corners are not interpolated
+	}
+}
@@ -25,4 +25,11 @@ void rand_initialize_generator()
     generator = std::default_random_engine(seed);
 }
 
+void rand_initialize_generator(unsigned int seed)
+{
+    generator = std::default_random_engine(seed);
+    distribution.reset();
+    distribution_normal.reset();
+}
+
 }
@@ -15,4 +15,7 @@ namespace cgp
 	 * Use this function if you want a different behavior of random at every new run */
 	void rand_initialize_generator();
 
+	/** Reset the generator to a given seed (the same sequence of numbers is generated after each call) */
+	void rand_initialize_generator(unsigned int seed);
+
 }
@@ -3,6 +3,7 @@
 
 #include "../affine_rt/affine_rt.hpp"
 #include "../affine_rts/affine_rts.hpp"
+#include "cgp/06_mat/mat4/simd/mat4_simd.hpp"
 
 namespace cgp
 {
@@ -21,17 +22,10 @@ namespace cgp
 
 	mat4 affine::matrix() const
 	{
-		mat3 const& R = rotation.matrix();
-		float const sx = scaling_xyz.x * scaling;
-		float const sy = scaling_xyz.y * scaling;
-		float const sz = scaling_xyz.z * scaling;
-		return mat4{ 
-			sx * get<0,0>(R), sx * get<0,1>(R)  , sx * get<0,2>(R), translation.x,
-			sy * get<1,0>(R), sy * get<1,1>(R)  , sy * get<1,2>(R), translation.y,
-			sz * get<2,0>(R), sz * get<2,1>(R)  , sz * get<2,2>(R), translation.z,
-			0.0f  ,  0.0f ,  0.0f ,    1.0f     
-		};
-		
+		float const s[3] = { scaling_xyz.x * scaling, scaling_xyz.y * scaling, scaling_xyz.z * scaling };
+		mat4 M;
+		mat4_affine_from_quaternion(rotation.data.begin(), s, translation.begin(), M.begin());
+		return M;
 	}
 
 	vec3 operator*(affine const& T, vec3 const& p)
@@ -1,5 +1,6 @@
 #include "cgp/01_base/base.hpp"
 #include "affine_rt.hpp"
+#include "cgp/06_mat/mat4/simd/mat4_simd.hpp"
 
 
 namespace cgp
@@ -17,7 +18,10 @@ namespace cgp
 
 	mat4 affine_rt::matrix() const
 	{
-		return mat4::build_affine(rotation.matrix(), translation);
+		float const s[3] = { 1.0f, 1.0f, 1.0f };
+		mat4 M;
+		mat4_affine_from_quaternion(rotation.data.begin(), s, translation.begin(), M.begin());
+		return M;
 	}
 
 	vec3 operator*(affine_rt const& T, vec3 const& p)
@@ -2,6 +2,7 @@
 #include "affine_rts.hpp"
 
 #include "../affine_rt/affine_rt.hpp"
+#include "cgp/06_mat/mat4/simd/mat4_simd.hpp"
 
 namespace cgp
 {
@@ -17,14 +18,10 @@ namespace cgp
 
 	mat4 affine_rts::matrix() const
 	{
-		mat3 const& R = rotation.matrix();
-		return mat4{ 
-			scaling * get<0,0>(R), scaling * get<0,1>(R)  , scaling * get<0,2>(R), translation.x,
-			scaling * get<1,0>(R), scaling * get<1,1>(R)  , scaling * get<1,2>(R), translation.y,
-			scaling * get<2,0>(R), scaling * get<2,1>(R)  , scaling * get<2,2>(R), translation.z,
-			0.0f  ,  0.0f ,  0.0f ,    1.0f     
-		};
-		
+		float const s[3] = { scaling, scaling, scaling };
+		mat4 M;
+		mat4_affine_from_quaternion(rotation.data.begin(), s, translation.begin(), M.begin());
+		return M;
 	}
 
 	vec3 operator*(affine_rts const& T, vec3 const& p)
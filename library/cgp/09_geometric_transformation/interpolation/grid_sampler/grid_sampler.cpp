@@ -0,0 +1,163 @@
+#include "grid_sampler.hpp"
+
+#include "cgp/06_mat/mat4/simd/mat4_simd.hpp" // CGP_SIMD_SSE, CGP_SIMD_NEON
+
+#if defined(CGP_SIMD_SSE)
+	#include <emmintrin.h>
+#elif defined(CGP_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace cgp
+{
+	// The taps are computed with the same code on packs of 4 coordinates (SSE/NEON) and on single coordinates (scalar, and end of the blocks)
+	struct grid_sampler_scalar
+	{
+		using type = float;
+		static int const lanes = 1;
+		static type set(float a) { return a; }
+		static type load(float const* p) { return *p; }
+		static void store(float* p, type a) { *p = a; }
+		static void store_int(int* p, type a) { *p = int(a); }
+		static type add(type a, type b) { return a + b; }
+		static type sub(type a, type b) { return a - b; }
+		static type mul(type a, type b) { return a * b; }
+		static type min(type a, type b) { return a < b ? a : b; }
+		static type max(type a, type b) { return a > b ? a : b; }
+		static type floor(type a) { float const t = float(int(a)); return t > a ? t - 1.0f : t; }
+		static type select_less(type a, type b, type x, type y) { return a < b ? x : y; }
+	};
+
+#if defined(CGP_SIMD_SSE)
+	struct grid_sampler_simd
+	{
+		using type = __m128;
+		static int const lanes = 4;
+		static type set(float a) { return _mm_set1_ps(a); }
+		static type load(float const* p) { return _mm_loadu_ps(p); }
+		static void store(float* p, type a) { _mm_storeu_ps(p, a); }
+		static void store_int(int* p, type a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(a)); }
+		static type add(type a, type b) { return _mm_add_ps(a, b); }
+		static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+		static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+		static type min(type a, type b) { return _mm_min_ps(a, b); }
+		static type max(type a, type b) { return _mm_max_ps(a, b); }
+		static type floor(type a)
+		{
+			__m128 const t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+			return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+		}
+		static type select_less(type a, type b, type x, type y)
+		{
+			__m128 const mask = _mm_cmplt_ps(a, b);
+			return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+		}
+	};
+#elif defined(CGP_SIMD_NEON)
+	struct grid_sampler_simd
+	{
+		using type = float32x4_t;
+		static int const lanes = 4;
+		static type set(float a) { return vdupq_n_f32(a); }
+		static type load(float const* p) { return vld1q_f32(p); }
+		static void store(float* p, type a) { vst1q_f32(p, a); }
+		static void store_int(int* p, type a) { vst1q_s32(p, vcvtq_s32_f32(a)); }
+		static type add(type a, type b) { return vaddq_f32(a, b); }
+		static type sub(type a, type b) { return vsubq_f32(a, b); }
+		static type mul(type a, type b) { return vmulq_f32(a, b); }
+		static type min(type a, type b) { return vminq_f32(a, b); }
+		static type max(type a, type b) { return vmaxq_f32(a, b); }
+		static type floor(type a)
+		{
+			float32x4_t const t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+			return vbslq_f32(vcgtq_f32(t, a), vsubq_f32(t, vdupq_n_f32(1.0f)), t);
+		}
+		static type select_less(type a, type b, type x, type y) { return vbslq_f32(vcltq_f32(a, b), x, y); }
+	};
+#else
+	using grid_sampler_simd = grid_sampler_scalar;
+#endif
+
+	// Taps of the coordinates u[i..i+lanes[
+	template <typename V>
+	static void grid_sampler_taps_pack(float const* u, int i, int N, grid_sampler_filter filter, grid_sampler_address address, int* index, float* weight, float* weight_derivative)
+	{
+		using type = typename V::type;
+		type const zero = V::set(0.0f);
+		type const one = V::set(1.0f);
+		type const n = V::set(float(N));
+		type const last = V::set(float(N - 1));
+		type const x = V::load(u + i);
+
+		// First tap (base), fractional part t in [0,1], and 0 for the coordinates clamped on the border (null gradient)
+		type base, t, inside;
+		if (address == grid_sampler_address::clamp) {
+			type const xc = V::min(V::max(x, zero), last);
+			base = V::min(V::floor(xc), V::set(float(N > 1 ? N - 2 : 0)));
+			t = V::sub(xc, base);
+			inside = V::select_less(x, zero, zero, V::select_less(last, x, zero, one));
+		}
+		else {
+			type xr = V::sub(x, V::mul(n, V::floor(V::mul(x, V::set(1.0f / N)))));
+			xr = V::select_less(xr, zero, zero, V::select_less(xr, n, xr, zero)); // Rounding of the modulo on the period
+			base = V::floor(xr);
+			t = V::sub(xr, base);
+			inside = one;
+		}
+
+		bool const bicubic = filter == grid_sampler_filter::bicubic;
+		int const K = bicubic ? 4 : 2;
+		for (int k = 0; k < K; ++k) {
+			type tap = V::add(base, V::set(float(bicubic ? k - 1 : k)));
+			if (N == 1)
+				tap = zero;
+			else if (address == grid_sampler_address::clamp)
+				tap = V::min(V::max(tap, zero), last);
+			else {
+				tap = V::select_less(tap, zero, V::add(tap, n), tap);
+				tap = V::select_less(tap, n, tap, V::sub(tap, n)); // Single wrap: |k-1| < N for N >= 2
+			}
+			V::store_int(index + k * grid_sampler_block + i, tap);
+		}
+
+		if (!bicubic) {
+			V::store(weight + i, V::sub(one, t));
+			V::store(weight + grid_sampler_block + i, t);
+			V::store(weight_derivative + i, V::sub(zero, inside));
+			V::store(weight_derivative + grid_sampler_block + i, inside);
+			return;
+		}
+
+		// Catmull-Rom weights (x2 to share the 1/2 factor) and their derivatives
+		type const half = V::set(0.5f);
+		type const t2 = V::mul(t, t);
+		type const t3 = V::mul(t2, t);
+		type const w0 = V::sub(V::sub(V::add(t2, t2), t), t3);                                               // -t + 2t^2 - t^3
+		type const w1 = V::add(V::sub(V::set(2.0f), V::mul(V::set(5.0f), t2)), V::mul(V::set(3.0f), t3)); // 2 - 5t^2 + 3t^3
+		type const w2 = V::sub(V::add(t, V::mul(V::set(4.0f), t2)), V::mul(V::set(3.0f), t3));            // t + 4t^2 - 3t^3
+		type const w3 = V::sub(t3, t2);                                                                      // -t^2 + t^3
+		type const d0 = V::sub(V::sub(V::mul(V::set(4.0f), t), V::mul(V::set(3.0f), t2)), one);          // -1 + 4t - 3t^2
+		type const d1 = V::sub(V::mul(V::set(9.0f), t2), V::mul(V::set(10.0f), t));                        // -10t + 9t^2
+		type const d2 = V::sub(V::add(one, V::mul(V::set(8.0f), t)), V::mul(V::set(9.0f), t2));           // 1 + 8t - 9t^2
+		type const d3 = V::sub(V::mul(V::set(3.0f), t2), V::add(t, t));                                     // -2t + 3t^2
+		type const half_inside = V::mul(half, inside);
+
+		V::store(weight + i, V::mul(half, w0));
+		V::store(weight + grid_sampler_block + i, V::mul(half, w1));
+		V::store(weight + 2 * grid_sampler_block + i, V::mul(half, w2));
+		V::store(weight + 3 * grid_sampler_block + i, V::mul(half, w3));
+		V::store(weight_derivative + i, V::mul(half_inside, d0));
+		V::store(weight_derivative + grid_sampler_block + i, V::mul(half_inside, d1));
+		V::store(weight_derivative + 2 * grid_sampler_block + i, V::mul(half_inside, d2));
+		V::store(weight_derivative + 3 * grid_sampler_block + i, V::mul(half_inside, d3));
+	}
+
+	void grid_sampler_taps(float const* u, int n, int N, grid_sampler_filter filter, grid_sampler_address address, int* index, float* weight, float* weight_derivative)
+	{
+		int i = 0;
+		for (; i + grid_sampler_simd::lanes <= n; i += grid_sampler_simd::lanes)
+			grid_sampler_taps_pack<grid_sampler_simd>(u, i, N, filter, address, index, weight, weight_derivative);
+		for (; i < n; ++i)
+			grid_sampler_taps_pack<grid_sampler_scalar>(u, i, N, filter, address, index, weight, weight_derivative);
+	}
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid_container.hpp"
+#include "cgp/05_vec/vec.hpp"
+
+// Sampler of a grid_2D at continuous positions, with bilinear or bicubic (Catmull-Rom) filtering and the gradient of the filtered value
+//  The sampler is bound to a grid (not copied: the grid must outlive the sampler) and to a world-space domain:
+//  the sample (k1,k2) is at the position corner_min + (k1,k2) * (corner_max-corner_min) / (dimension-1) (same convention as spatial_domain_grid_3D).
+//  - clamp: the positions outside the domain take the value of the border (the gradient is 0 along the clamped axis)
+//  - repeat: the grid is periodic with a period of dimension samples (the sample N is the sample 0)
+//  The batched versions sample thousands of positions at once: the taps and weights of the filter are computed by blocks with SSE/NEON
+//  (see grid_sampler_taps, the scalar version is used with CGP_NO_SIMD), and there is no assertion per query.
+//
+//  grid_sampler_2D<float> sampler(height, {-40,-15}, {40,15}, grid_sampler_filter::bicubic);
+//  float const h = sampler.sample({x,y});
+//  grid_sample<float> const s = sampler.sample_with_gradient({x,y}); // s.value, s.dx, s.dy
+//  sampler.sample(positions, heights); // numarray<vec2> -> numarray<float>
+
+namespace cgp
+{
+	enum class grid_sampler_filter { bilinear, bicubic };
+	enum class grid_sampler_address { clamp, repeat };
+
+	// Filtered value and its partial derivatives along the world x and y
+	template <typename T>
+	struct grid_sample {
+		T value;
+		T dx;
+		T dy;
+	};
+
+	// Number of queries processed together by the batched functions
+	constexpr int grid_sampler_block = 64;
+
+	// Taps of the filter along one axis of N samples, for n <= grid_sampler_block coordinates u given in sample units
+	//  index[k*grid_sampler_block+i], weight[...] and weight_derivative[...] (derivative along u) of the tap k of the coordinate i,
+	//  with k < 2 in bilinear and k < 4 in bicubic. The indices are in [0,N-1] after the addressing.
+	void grid_sampler_taps(float const* u, int n, int N, grid_sampler_filter filter, grid_sampler_address address, int* index, float* weight, float* weight_derivative);
+
+
+	template <typename T, typename LAYOUT = grid_layout_row_major>
+	struct grid_sampler_2D
+	{
+		grid_2D<T, LAYOUT> const* grid;
+		vec2 corner_min;
+		vec2 corner_max;
+		grid_sampler_filter filter;
+		grid_sampler_address address;
+
+		grid_sampler_2D();
+		// Domain in index coordinates: corner_min = (0,0), corner_max = dimension-1
+		explicit grid_sampler_2D(grid_2D<T, LAYOUT> const& grid, grid_sampler_filter filter = grid_sampler_filter::bilinear, grid_sampler_address address = grid_sampler_address::clamp);
+		grid_sampler_2D(grid_2D<T, LAYOUT> const& grid, vec2 const& corner_min, vec2 const& corner_max, grid_sampler_filter filter = grid_sampler_filter::bilinear, grid_sampler_address address = grid_sampler_address::clamp);
+
+		T sample(vec2 const& p) const;
+		grid_sample<T> sample_with_gradient(vec2 const& p) const;
+
+		// Batched queries (values are resized)
+		void sample(numarray<vec2> const& p, numarray<T>& values) const;
+		void sample_with_gradient(numarray<vec2> const& p, numarray<grid_sample<T>>& values) const;
+		void sample(vec2 const* p, int n, T* values) const;
+		void sample_with_gradient(vec2 const* p, int n, grid_sample<T>* values) const;
+
+	private:
+		void evaluate(vec2 const* p, int n, T* values, grid_sample<T>* samples) const;
+	};
+}
+
+
+namespace cgp
+{
+	template <typename T, typename LAYOUT>
+	grid_sampler_2D<T, LAYOUT>::grid_sampler_2D()
+		:grid(nullptr), corner_min(), corner_max(), filter(grid_sampler_filter::bilinear), address(grid_sampler_address::clamp)
+	{}
+
+	template <typename T, typename LAYOUT>
+	grid_sampler_2D<T, LAYOUT>::grid_sampler_2D(grid_2D<T, LAYOUT> const& grid_arg, grid_sampler_filter filter_arg, grid_sampler_address address_arg)
+		:grid(&grid_arg), corner_min(0, 0), corner_max(float(grid_arg.dimension.x - 1), float(grid_arg.dimension.y - 1)), filter(filter_arg), address(address_arg)
+	{}
+
+	template <typename T, typename LAYOUT>
+	grid_sampler_2D<T, LAYOUT>::grid_sampler_2D(grid_2D<T, LAYOUT> const& grid_arg, vec2 const& corner_min_arg, vec2 const& corner_max_arg, grid_sampler_filter filter_arg, grid_sampler_address address_arg)
+		:grid(&grid_arg), corner_min(corner_min_arg), corner_max(corner_max_arg), filter(filter_arg), address(address_arg)
+	{}
+
+	template <typename T, typename LAYOUT>
+	T grid_sampler_2D<T, LAYOUT>::sample(vec2 const& p) const
+	{
+		T value;
+		evaluate(&p, 1, &value, nullptr);
+		return value;
+	}
+
+	template <typename T, typename LAYOUT>
+	grid_sample<T> grid_sampler_2D<T, LAYOUT>::sample_with_gradient(vec2 const& p) const
+	{
+		grid_sample<T> s;
+		evaluate(&p, 1, nullptr, &s);
+		return s;
+	}
+
+	template <typename T, typename LAYOUT>
+	void grid_sampler_2D<T, LAYOUT>::sample(numarray<vec2> const& p, numarray<T>& values) const
+	{
+		values.resize(p.size());
+		evaluate(p.data.data(), int(p.size()), values.data.data(), nullptr);
+	}
+
+	template <typename T, typename LAYOUT>
+	void grid_sampler_2D<T, LAYOUT>::sample_with_gradient(numarray<vec2> const& p, numarray<grid_sample<T>>& values) const
+	{
+		values.resize(p.size());
+		evaluate(p.data.data(), int(p.size()), nullptr, values.data.data());
+	}
+
+	template <typename T, typename LAYOUT>
+	void grid_sampler_2D<T, LAYOUT>::sample(vec2 const* p, int n, T* values) const
+	{
+		evaluate(p, n, values, nullptr);
+	}
+
+	template <typename T, typename LAYOUT>
+	void grid_sampler_2D<T, LAYOUT>::sample_with_gradient(vec2 const* p, int n, grid_sample<T>* values) const
+	{
+		evaluate(p, n, nullptr, values);
+	}
+
+	template <typename T, typename LAYOUT>
+	void grid_sampler_2D<T, LAYOUT>::evaluate(vec2 const* p, int n, T* values, grid_sample<T>* samples) const
+	{
+		assert_cgp(grid != nullptr, "The grid_sampler_2D is not bound to a grid");
+		int const N1 = grid->dimension.x;
+		int const N2 = grid->dimension.y;
+		assert_cgp(N1 > 0 && N2 > 0, "Cannot sample an empty grid_2D (dimension " + str(grid->dimension) + ")");
+
+		// World position to sample units
+		vec2 const step = { N1 > 1 ? (corner_max.x - corner_min.x) / (N1 - 1) : 1.0f, N2 > 1 ? (corner_max.y - corner_min.y) / (N2 - 1) : 1.0f };
+		assert_cgp(step.x != 0 && step.y != 0, "Degenerated domain of grid_sampler_2D: corner_min=" + str(corner_min) + ", corner_max=" + str(corner_max));
+		vec2 const inv_step = { 1.0f / step.x, 1.0f / step.y };
+
+		int const K = filter == grid_sampler_filter::bicubic ? 4 : 2;
+		bool const gradient = samples != nullptr;
+		T const* const data = grid->data.data.data();
+
+		float u[grid_sampler_block], v[grid_sampler_block];
+		int index_u[4 * grid_sampler_block], index_v[4 * grid_sampler_block];
+		float weight_u[4 * grid_sampler_block], weight_v[4 * grid_sampler_block];
+		float derivative_u[4 * grid_sampler_block], derivative_v[4 * grid_sampler_block];
+
+		for (int start = 0; start < n; start += grid_sampler_block)
+		{
+			int const m = std::min(grid_sampler_block, n - start);
+			for (int i = 0; i < m; ++i) {
+				u[i] = (p[start + i].x - corner_min.x) * inv_step.x;
+				v[i] = (p[start + i].y - corner_min.y) * inv_step.y;
+			}
+			grid_sampler_taps(u, m, N1, filter, address, index_u, weight_u, derivative_u);
+			grid_sampler_taps(v, m, N2, filter, address, index_v, weight_v, derivative_v);
+
+			for (int i = 0; i < m; ++i)
+			{
+				// Filter along u for each row of taps, then along v
+				T value = T(), du = T(), dv = T();
+				for (int b = 0; b < K; ++b)
+				{
+					int const kv = index_v[b * grid_sampler_block + i];
+					T const& d0 = data[LAYOUT::offset(index_u[i], kv, N1, N2)];
+					T row = weight_u[i] * d0;
+					T row_du = gradient ? derivative_u[i] * d0 : T();
+					for (int a = 1; a < K; ++a) {
+						T const& d = data[LAYOUT::offset(index_u[a * grid_sampler_block + i], kv, N1, N2)];
+						row += weight_u[a * grid_sampler_block + i] * d;
+						if (gradient)
+							row_du += derivative_u[a * grid_sampler_block + i] * d;
+					}
+
+					float const w = weight_v[b * grid_sampler_block + i];
+					value += w * row;
+					if (gradient) {
+						du += w * row_du;
+						dv += derivative_v[b * grid_sampler_block + i] * row;
+					}
+				}
+
+				if (values != nullptr)
+					values[start + i] = value;
+				else
+					samples[start + i] = { value, inv_step.x * du, inv_step.y * dv };
+			}
+		}
+	}
+}
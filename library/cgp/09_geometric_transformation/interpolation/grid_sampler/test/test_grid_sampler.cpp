@@ -0,0 +1,93 @@
+#include "test_grid_sampler.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../../interpolation.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_grid_sampler()
+	{
+		// Smooth function sampled on a grid with dimensions that are not a multiple of the SIMD width
+		grid_2D<float> g(13, 9);
+		for (int k2 = 0; k2 < 9; ++k2)
+			for (int k1 = 0; k1 < 13; ++k1)
+				g(k1, k2) = std::sin(0.4f * k1) + 0.3f * k2 * k2;
+
+		// Positions inside the domain: 67 queries (blocks of 4 and remainder)
+		numarray<vec2> p;
+		for (int k = 0; k < 67; ++k)
+			p.push_back({ 0.17f * k, 0.113f * k });
+
+		// Bilinear in index coordinates: same as interpolation_bilinear, single and batched queries
+		{
+			grid_sampler_2D<float> sampler(g);
+			numarray<float> values;
+			sampler.sample(p, values);
+			assert_cgp_no_msg(values.size() == p.size());
+			for (int k = 0; k < int(p.size()); ++k) {
+				assert_cgp_no_msg(is_equal(values[k], interpolation_bilinear(g, p[k].x, p[k].y)));
+				assert_cgp_no_msg(is_equal(values[k], sampler.sample(p[k])));
+			}
+			assert_cgp_no_msg(is_equal(sampler.sample({ 12.0f, 8.0f }), g(12, 8)));
+			assert_cgp_no_msg(is_equal(sampler.sample({ 20.0f, -3.0f }), g(12, 0))); // Clamp
+		}
+
+		// Bicubic in a world domain: interpolates the samples, reproduces exactly a linear function, with its gradient
+		{
+			vec2 const corner_min = { -2.0f, 1.0f };
+			vec2 const corner_max = { 4.0f, 5.0f }; // step (0.5, 0.5)
+			grid_sampler_2D<float> sampler(g, corner_min, corner_max, grid_sampler_filter::bicubic);
+			assert_cgp_no_msg(is_equal(sampler.sample({ -2.0f + 0.5f * 3, 1.0f + 0.5f * 4 }), g(3, 4)));
+
+			grid_2D<float> linear(13, 9);
+			for (int k2 = 0; k2 < 9; ++k2)
+				for (int k1 = 0; k1 < 13; ++k1)
+					linear(k1, k2) = 2.0f * k1 - 3.0f * k2 + 1.0f;
+			grid_sampler_2D<float> sampler_linear(linear, corner_min, corner_max, grid_sampler_filter::bicubic);
+			grid_sample<float> const s = sampler_linear.sample_with_gradient({ 1.3f, 2.8f }); // Index (6.6, 3.6): no tap on the border
+			assert_cgp_no_msg(is_equal(s.value, 2.0f * 6.6f - 3.0f * 3.6f + 1.0f));
+			assert_cgp_no_msg(is_equal(s.dx, 4.0f) && is_equal(s.dy, -6.0f));
+
+			// Analytic gradient against finite differences, on the batched path
+			numarray<vec2> q;
+			for (int k = 0; k < 21; ++k)
+				q.push_back({ -1.5f + 0.23f * k, 1.6f + 0.13f * k });
+			numarray<grid_sample<float>> samples;
+			sampler.sample_with_gradient(q, samples);
+			float const h = 1e-2f;
+			for (int k = 0; k < int(q.size()); ++k) {
+				float const dx = (sampler.sample(q[k] + vec2(h, 0)) - sampler.sample(q[k] - vec2(h, 0))) / (2 * h);
+				float const dy = (sampler.sample(q[k] + vec2(0, h)) - sampler.sample(q[k] - vec2(0, h))) / (2 * h);
+				assert_cgp_no_msg(std::abs(samples[k].dx - dx) < 2e-2f && std::abs(samples[k].dy - dy) < 2e-2f);
+				assert_cgp_no_msg(is_equal(samples[k].value, sampler.sample(q[k])));
+			}
+		}
+
+		// Repeat: periodic of dimension samples, the gradient is continuous across the period
+		{
+			grid_sampler_2D<float> sampler(g, grid_sampler_filter::bicubic, grid_sampler_address::repeat);
+			for (int k = 0; k < int(p.size()); ++k) {
+				assert_cgp_no_msg(std::abs(sampler.sample(p[k]) - sampler.sample(p[k] + vec2(13.0f, -18.0f))) < 1e-4f);
+				grid_sample<float> const a = sampler.sample_with_gradient(p[k]);
+				grid_sample<float> const b = sampler.sample_with_gradient(p[k] - vec2(26.0f, 9.0f));
+				assert_cgp_no_msg(std::abs(a.dx - b.dx) < 1e-3f && std::abs(a.dy - b.dy) < 1e-3f);
+			}
+			assert_cgp_no_msg(is_equal(sampler.sample({ -1.0f, 0.0f }), g(12, 0)));
+		}
+
+		// Vector values and another memory layout give the same samples
+		{
+			grid_2D<vec3, grid_layout_morton<4> > c(13, 9);
+			grid_for_each(c, [&](int k1, int k2, vec3& value) { value = { g(k1, k2), float(k1), float(k2) }; });
+			grid_sampler_2D<vec3, grid_layout_morton<4> > sampler_c(c, grid_sampler_filter::bicubic);
+			grid_sampler_2D<float> sampler(g, grid_sampler_filter::bicubic);
+			for (int k = 0; k < int(p.size()); ++k) {
+				vec3 const v = sampler_c.sample(p[k]);
+				assert_cgp_no_msg(is_equal(v.x, sampler.sample(p[k])));
+			}
+			assert_cgp_no_msg(is_equal(sampler_c.sample({ 5.5f, 2.25f }), vec3(sampler.sample({ 5.5f, 2.25f }), 5.5f, 2.25f)));
+		}
+	}
+}
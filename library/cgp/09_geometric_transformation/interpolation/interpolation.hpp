@@ -1,15 +1,17 @@
 #pragma once
 
 #include "cgp/04_grid_container/grid_container.hpp"
+#include "grid_sampler/grid_sampler.hpp"
 
 namespace cgp
 {
     /** Interpolate value(x,y) using bilinear interpolation
-    * - value: grid_2D - coordinates assumed to be its indices
+    * - value: grid_2D - coordinates assumed to be its indices (any memory layout)
     * - (x,y): coordinates assumed to be \in [0,value.dimension.x-1] X [0,value.dimension.y]
+    * See grid_sampler_2D for bicubic filtering, gradients, border addressing and batched queries.
     */
-    template <typename T>
-    T interpolation_bilinear(grid_2D<T> const& value, float x, float y);
+    template <typename T, typename LAYOUT>
+    T interpolation_bilinear(grid_2D<T, LAYOUT> const& value, float x, float y);
 
 
     /** Compute basic linear interpolation 
@@ -21,8 +23,8 @@ namespace cgp
 
 namespace cgp
 {
-    template <typename T>
-    T interpolation_bilinear(grid_2D<T> const& value, float x, float y)
+    template <typename T, typename LAYOUT>
+    T interpolation_bilinear(grid_2D<T, LAYOUT> const& value, float x, float y)
     {
 	    int const x0 = int(std::floor(x));
         int const y0 = int(std::floor(y));
@@ -19,15 +19,29 @@ namespace cgp
 		assert_cgp(connectivity.size()>0, "Connectivity doesn't have any triangle");
 
 		if(normal.size()<N)
-			normal = normal_per_vertex(position, connectivity);
+			normal_per_vertex(position, connectivity, normal);
 		if(color.size()<N)
-			color.resize(N).fill(vec3{1.0f, 1.0f, 1.0f});
+			color.data.assign(N, vec3{1.0f, 1.0f, 1.0f});
 		if(uv.size()<N)
-			uv.resize(N).fill(vec2{0.0f, 0.0f});
+			uv.data.assign(N, vec2{0.0f, 0.0f});
 
 		return *this;
 	}
 
+	mesh::mesh(memory_arena& arena)
+		:position(arena), normal(arena), color(arena), uv(arena), connectivity(arena)
+	{}
+
+	mesh& mesh::reserve(int vertex_count, int triangle_count)
+	{
+		position.reserve(vertex_count);
+		normal.reserve(vertex_count);
+		color.reserve(vertex_count);
+		uv.reserve(vertex_count);
+		connectivity.reserve(triangle_count);
+		return *this;
+	}
+
 	mesh& mesh::push_back(mesh const& to_add)
 	{
 		unsigned int const N_vertex = static_cast<unsigned int>(position.size());
@@ -38,8 +52,12 @@ namespace cgp
 		uv.push_back(to_add.uv);
 
 
-		for(auto const& tri : to_add.connectivity)
-			connectivity.push_back( tri + uint3{N_vertex,N_vertex,N_vertex} );
+		// Single (geometric) growth of each buffer, then in place offset of the new triangles
+		int const N_triangle = connectivity.size();
+		int const N_add = to_add.connectivity.size();
+		connectivity.resize(N_triangle + N_add);
+		for(int k = 0; k < N_add; ++k)
+			connectivity[N_triangle + k] = to_add.connectivity[k] + uint3{N_vertex,N_vertex,N_vertex};
 
 		return *this;
 	}
@@ -48,10 +66,7 @@ namespace cgp
 	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, numarray<vec3>& normals, bool invert)
 	{
 		size_t const N = position.size();
-		if(normals.size()!=N)
-			normals.resize(N);
-		else
-			normals.fill(vec3{0,0,0});
+		normals.data.assign(N, vec3{0,0,0}); // no reallocation if the capacity is sufficient
 
 		size_t const N_tri = connectivity.size();
 		for (size_t k_tri = 0; k_tri < N_tri; ++k_tri)
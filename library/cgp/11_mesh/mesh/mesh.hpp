@@ -19,6 +19,13 @@ namespace cgp
 		numarray<vec2> uv;
 		numarray<uint3> connectivity;
 
+		mesh() = default;
+		/** Mesh storing all its buffers in the arena (temporary geometry, see memory_arena.hpp) */
+		explicit mesh(memory_arena& arena);
+
+		/** Reserve the per-vertex buffers and the connectivity (avoid the reallocations when the final size is known) */
+		mesh& reserve(int vertex_count, int triangle_count);
+
 		/** Fill all per-vertex attributes with default values if they are empty (ex. color to white, and 0 for texture-uv)
 		* This function should be called before creating a mesh_drawable if there is empty buffers */
 		mesh& fill_empty_field();
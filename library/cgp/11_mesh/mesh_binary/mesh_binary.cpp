@@ -0,0 +1,319 @@
+#include "mesh_binary.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cgp
+{
+#ifdef __EMSCRIPTEN__
+    bool mesh_binary_cache::active = false;
+#else
+    bool mesh_binary_cache::active = true;
+#endif
+    std::string mesh_binary_cache::extension = ".cgpmesh";
+
+    namespace
+    {
+        struct mesh_binary_header {
+            char magic[4];
+            uint32_t version;
+            uint32_t vertex_count;
+            uint32_t index_width;
+            uint32_t level_count;
+            uint32_t reserved;
+            float bounding_box_min[3];
+            float bounding_box_max[3];
+            uint64_t stream_offset[4]; // position, normal, color, uv
+        };
+        struct mesh_binary_level_entry {
+            uint64_t offset;
+            uint32_t triangle_count;
+            float error;
+        };
+        uint32_t const mesh_binary_version = 1;
+        size_t const mesh_binary_alignment = 16;
+        int const stream_dimension[4] = { 3, 3, 3, 2 };
+
+        size_t align(size_t value)
+        {
+            return (value + mesh_binary_alignment - 1) / mesh_binary_alignment * mesh_binary_alignment;
+        }
+        size_t stream_size(int k_stream, int vertex_count)
+        {
+            return sizeof(float) * stream_dimension[k_stream] * size_t(vertex_count);
+        }
+        size_t level_size(mesh_binary const& m, int level)
+        {
+            return size_t(3) * m.index_width * size_t(m.level_triangle_count[level]);
+        }
+        // Offsets of the 4 streams and of the levels, the last element is the total size
+        void compute_offsets(mesh_binary& m)
+        {
+            m.offset.resize(4 + m.level_count + 1);
+            size_t total = 0;
+            for (int k = 0; k < 4; ++k) {
+                m.offset[k] = total;
+                total = align(total + stream_size(k, m.vertex_count));
+            }
+            for (int level = 0; level < m.level_count; ++level) {
+                m.offset[4 + level] = total;
+                total = align(total + level_size(m, level));
+            }
+            m.offset.back() = total;
+        }
+        template <typename INDEX>
+        void write_indices(numarray<uint3> const& connectivity, unsigned char* out)
+        {
+            INDEX* index = reinterpret_cast<INDEX*>(out);
+            for (int k = 0; k < connectivity.size(); ++k)
+                for (int i = 0; i < 3; ++i)
+                    index[3 * k + i] = INDEX(connectivity[k][i]);
+        }
+        template <typename INDEX>
+        numarray<uint3> read_indices(void const* data, int triangle_count)
+        {
+            INDEX const* index = static_cast<INDEX const*>(data);
+            numarray<uint3> connectivity;
+            connectivity.resize(triangle_count);
+            for (int k = 0; k < triangle_count; ++k)
+                connectivity[k] = { unsigned(index[3 * k]), unsigned(index[3 * k + 1]), unsigned(index[3 * k + 2]) };
+            return connectivity;
+        }
+    }
+
+    float const* mesh_binary::position() const
+    {
+        return reinterpret_cast<float const*>(base + offset[0]);
+    }
+    float const* mesh_binary::normal() const
+    {
+        return reinterpret_cast<float const*>(base + offset[1]);
+    }
+    float const* mesh_binary::color() const
+    {
+        return reinterpret_cast<float const*>(base + offset[2]);
+    }
+    float const* mesh_binary::uv() const
+    {
+        return reinterpret_cast<float const*>(base + offset[3]);
+    }
+    void const* mesh_binary::index(int level) const
+    {
+        assert_cgp_no_msg(level >= 0 && level < level_count);
+        return base + offset[4 + level];
+    }
+    int mesh_binary::triangle_count(int level) const
+    {
+        assert_cgp_no_msg(level >= 0 && level < level_count);
+        return level_triangle_count[level];
+    }
+    float mesh_binary::error(int level) const
+    {
+        assert_cgp_no_msg(level >= 0 && level < level_count);
+        return level_error[level];
+    }
+
+    mesh mesh_binary::to_mesh() const
+    {
+        mesh m;
+        if (level_count == 0)
+            return m;
+        m.position.resize(vertex_count);
+        m.normal.resize(vertex_count);
+        m.color.resize(vertex_count);
+        m.uv.resize(vertex_count);
+        std::memcpy(static_cast<void*>(m.position.data.data()), position(), stream_size(0, vertex_count));
+        std::memcpy(static_cast<void*>(m.normal.data.data()), normal(), stream_size(1, vertex_count));
+        std::memcpy(static_cast<void*>(m.color.data.data()), color(), stream_size(2, vertex_count));
+        std::memcpy(static_cast<void*>(m.uv.data.data()), uv(), stream_size(3, vertex_count));
+        m.connectivity = to_lod().connectivity[0];
+        return m;
+    }
+    mesh_lod mesh_binary::to_lod() const
+    {
+        mesh_lod lod;
+        for (int level = 0; level < level_count; ++level) {
+            if (index_width == 2)
+                lod.connectivity.push_back(read_indices<uint16_t>(index(level), triangle_count(level)));
+            else
+                lod.connectivity.push_back(read_indices<uint32_t>(index(level), triangle_count(level)));
+            lod.error.push_back(error(level));
+        }
+        return lod;
+    }
+
+    mesh_binary mesh_binary_make(mesh const& m_arg, mesh_lod const& lod)
+    {
+        mesh m = m_arg;
+        m.fill_empty_field();
+        assert_cgp(mesh_check(m), "Cannot store an invalid mesh in binary format");
+
+        mesh_binary binary;
+        binary.vertex_count = m.position.size();
+        binary.index_width = binary.vertex_count <= 65536 ? 2 : 4;
+        binary.bounding_box_min = m.position.size() > 0 ? m.position[0] : vec3();
+        binary.bounding_box_max = binary.bounding_box_min;
+        for (vec3 const& p : m.position) {
+            binary.bounding_box_min = { std::min(binary.bounding_box_min.x, p.x), std::min(binary.bounding_box_min.y, p.y), std::min(binary.bounding_box_min.z, p.z) };
+            binary.bounding_box_max = { std::max(binary.bounding_box_max.x, p.x), std::max(binary.bounding_box_max.y, p.y), std::max(binary.bounding_box_max.z, p.z) };
+        }
+
+        // Level 0 is always the mesh connectivity
+        std::vector<numarray<uint3> const*> levels = { &m.connectivity };
+        binary.level_error = { 0.0f };
+        for (int k = 1; k < lod.size(); ++k) {
+            levels.push_back(&lod.connectivity[k]);
+            binary.level_error.push_back(lod.error[k]);
+        }
+        binary.level_count = int(levels.size());
+        for (numarray<uint3> const* level : levels)
+            binary.level_triangle_count.push_back(level->size());
+        compute_offsets(binary);
+
+        auto buffer = std::make_shared<std::vector<unsigned char>>(binary.offset.back(), 0);
+        unsigned char* base = buffer->data();
+        std::memcpy(base + binary.offset[0], ptr(m.position), stream_size(0, binary.vertex_count));
+        std::memcpy(base + binary.offset[1], ptr(m.normal), stream_size(1, binary.vertex_count));
+        std::memcpy(base + binary.offset[2], ptr(m.color), stream_size(2, binary.vertex_count));
+        std::memcpy(base + binary.offset[3], ptr(m.uv), stream_size(3, binary.vertex_count));
+        for (int level = 0; level < binary.level_count; ++level) {
+            if (binary.index_width == 2)
+                write_indices<uint16_t>(*levels[level], base + binary.offset[4 + level]);
+            else
+                write_indices<uint32_t>(*levels[level], base + binary.offset[4 + level]);
+        }
+
+        binary.storage = buffer;
+        binary.base = base;
+        return binary;
+    }
+
+    void mesh_binary_save(std::string const& filename, mesh_binary const& m)
+    {
+        assert_cgp(m.level_count > 0, "Cannot save an empty binary mesh");
+
+        mesh_binary_header header;
+        std::memcpy(header.magic, "CGPM", 4);
+        header.version = mesh_binary_version;
+        header.vertex_count = uint32_t(m.vertex_count);
+        header.index_width = uint32_t(m.index_width);
+        header.level_count = uint32_t(m.level_count);
+        header.reserved = 0;
+        for (int k = 0; k < 3; ++k) {
+            header.bounding_box_min[k] = m.bounding_box_min[k];
+            header.bounding_box_max[k] = m.bounding_box_max[k];
+        }
+        for (int k = 0; k < 4; ++k)
+            header.stream_offset[k] = uint64_t(m.offset[k]);
+
+        std::vector<mesh_binary_level_entry> entries(m.level_count);
+        for (int level = 0; level < m.level_count; ++level)
+            entries[level] = { uint64_t(m.offset[4 + level]), uint32_t(m.level_triangle_count[level]), m.level_error[level] };
+
+        // The data starts on an aligned position
+        size_t const header_size = sizeof(header) + entries.size() * sizeof(mesh_binary_level_entry);
+        std::vector<char> padding(align(header_size) - header_size, 0);
+
+        // Write in a temporary file first: a partially written cache is never used
+        std::string const temporary = filename + ".tmp";
+        std::ofstream stream(temporary, std::ios::binary);
+        if (!stream.is_open()) {
+            warning_cgp("Cannot write the binary mesh", filename);
+            return;
+        }
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<char const*>(entries.data()), entries.size() * sizeof(mesh_binary_level_entry));
+        stream.write(padding.data(), padding.size());
+        stream.write(reinterpret_cast<char const*>(m.base), m.offset.back());
+        stream.close();
+
+        // rename replaces the previous cache atomically: there is always a complete cache file on disk
+        if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            warning_cgp("Cannot replace the binary mesh", filename);
+            std::remove(temporary.c_str());
+        }
+    }
+
+    mesh_binary mesh_binary_load(std::string const& filename)
+    {
+        mesh_binary m;
+        auto mapping = std::make_shared<file_mapping>();
+        if (!mapping->open(filename) || mapping->size() < sizeof(mesh_binary_header))
+            return m;
+
+        mesh_binary_header header;
+        std::memcpy(&header, mapping->data(), sizeof(header));
+        if (std::memcmp(header.magic, "CGPM", 4) != 0 || header.version != mesh_binary_version || (header.index_width != 2 && header.index_width != 4)
+            || header.level_count == 0 || header.level_count > 64) {
+            warning_cgp("Invalid binary mesh file", filename);
+            return m;
+        }
+
+        size_t const header_size = sizeof(header) + header.level_count * sizeof(mesh_binary_level_entry);
+        size_t const data_start = align(header_size);
+        if (mapping->size() < data_start)
+            return m;
+        size_t const data_size = mapping->size() - data_start;
+
+        m.vertex_count = int(header.vertex_count);
+        m.index_width = int(header.index_width);
+        m.level_count = int(header.level_count);
+        m.bounding_box_min = { header.bounding_box_min[0], header.bounding_box_min[1], header.bounding_box_min[2] };
+        m.bounding_box_max = { header.bounding_box_max[0], header.bounding_box_max[1], header.bounding_box_max[2] };
+        m.offset.resize(4 + m.level_count + 1);
+        for (int k = 0; k < 4; ++k)
+            m.offset[k] = size_t(header.stream_offset[k]);
+        for (int level = 0; level < m.level_count; ++level) {
+            mesh_binary_level_entry entry;
+            std::memcpy(&entry, mapping->data() + sizeof(header) + level * sizeof(entry), sizeof(entry));
+            m.offset[4 + level] = size_t(entry.offset);
+            m.level_triangle_count.push_back(int(entry.triangle_count));
+            m.level_error.push_back(entry.error);
+        }
+        m.offset.back() = data_size;
+
+        // Check that all the streams are aligned and inside the file
+        bool valid = true;
+        for (int k = 0; k < 4; ++k)
+            valid = valid && m.offset[k] % mesh_binary_alignment == 0 && m.offset[k] + stream_size(k, m.vertex_count) <= data_size;
+        for (int level = 0; level < m.level_count; ++level)
+            valid = valid && m.offset[4 + level] % mesh_binary_alignment == 0 && m.offset[4 + level] + level_size(m, level) <= data_size;
+        if (!valid) {
+            warning_cgp("Truncated binary mesh file", filename);
+            return mesh_binary();
+        }
+
+        m.base = mapping->data() + data_start;
+        m.storage = mapping;
+        return m;
+    }
+
+    void mesh_save_file_binary(std::string const& filename, mesh const& m, mesh_lod const& lod)
+    {
+        mesh_binary_save(filename, mesh_binary_make(m, lod));
+    }
+
+    std::string mesh_binary_cache_filename(std::string const& filename)
+    {
+        return filename + mesh_binary_cache::extension;
+    }
+    bool mesh_binary_cache_is_valid(std::string const& filename)
+    {
+        std::string const binary_filename = mesh_binary_cache_filename(filename);
+        return mesh_binary_cache::active && check_path_exist(binary_filename) && !file_is_newer(filename, binary_filename);
+    }
+
+    std::string str(mesh_binary const& m)
+    {
+        std::string s = str(m.vertex_count) + " vertices, " + str(8 * m.index_width) + " bits indices, triangles per level [";
+        for (int level = 0; level < m.level_count; ++level)
+            s += (level > 0 ? " " : "") + str(m.triangle_count(level));
+        return s + "]";
+    }
+}
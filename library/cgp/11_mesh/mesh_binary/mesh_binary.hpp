@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../mesh/mesh.hpp"
+#include "../mesh_simplification/mesh_simplification.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cgp
+{
+	/** Mesh stored in the layout expected by the GPU: the attribute streams and the indices can be sent directly to the VBO/EBO without conversion.
+	*  The data is either stored in memory (after mesh_binary_make) or read from a memory-mapped file (mesh_binary_load), in which case no copy is made.
+	*  The connectivity can have several levels: level 0 is the full connectivity, the next ones are levels of details (see mesh_lod) indexing the same vertices.
+	*
+	* File layout (.cgpmesh, little endian):
+	*  - header: "CGPM", version, number of vertices, index width in bytes (2|4), number of levels, 0, bounding box (min and max)
+	*  - offsets of the position, normal, color and uv streams (64 bits integers)
+	*  - for each level: offset of the indices (64 bits integer), number of triangles, error
+	*  - data: vec3 position/normal/color, vec2 uv, and the indices of each level. Each stream starts on a 16 bytes boundary */
+	struct mesh_binary
+	{
+		int vertex_count = 0;
+		int index_width = 4;  // Size of an index in bytes: 2 when the mesh has at most 65536 vertices, 4 otherwise
+		int level_count = 0;  // 0 for an empty/invalid mesh
+		vec3 bounding_box_min;
+		vec3 bounding_box_max;
+
+		float const* position() const; // vertex_count x 3 floats
+		float const* normal() const;   // vertex_count x 3 floats
+		float const* color() const;    // vertex_count x 3 floats
+		float const* uv() const;       // vertex_count x 2 floats
+		void const* index(int level) const; // 3 x triangle_count(level) indices of index_width bytes
+		int triangle_count(int level) const;
+		float error(int level) const;       // Distance to the initial surface (0 for the level 0)
+
+		// Copy back to the generic structures
+		mesh to_mesh() const;
+		mesh_lod to_lod() const;
+
+		// Internal storage - the offsets (streams position, normal, color, uv, then the levels) are relative to base, which is kept valid by storage (buffer or file mapping)
+		std::shared_ptr<void> storage;
+		unsigned char const* base = nullptr;
+		std::vector<size_t> offset;
+		std::vector<int> level_triangle_count;
+		std::vector<float> level_error;
+	};
+
+	// Gather the mesh (the empty fields are filled with default values) and its optional levels of details (lod.connectivity[0] is expected to be the mesh connectivity)
+	mesh_binary mesh_binary_make(mesh const& m, mesh_lod const& lod = mesh_lod());
+
+	void mesh_binary_save(std::string const& filename, mesh_binary const& m);
+	// Map the file in memory. Returns a mesh with level_count=0 if the file is missing or invalid.
+	mesh_binary mesh_binary_load(std::string const& filename);
+
+	// Write a mesh (and its levels of details) in the binary format
+	void mesh_save_file_binary(std::string const& filename, mesh const& m, mesh_lod const& lod = mesh_lod());
+
+
+	// Cache of binary meshes stored next to the source files (filename + extension)
+	//  The cached file is used as long as it is more recent than the source file.
+	struct mesh_binary_cache {
+		static bool active;
+		static std::string extension;
+	};
+	std::string mesh_binary_cache_filename(std::string const& filename);
+	bool mesh_binary_cache_is_valid(std::string const& filename);
+
+	std::string str(mesh_binary const& m);
+}
@@ -0,0 +1,71 @@
+#include "cgp/01_base/base.hpp"
+#include "../mesh_binary.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <cstdio>
+#include <cstdint>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bool is_same_mesh(cgp::mesh const& a, cgp::mesh const& b)
+	{
+		return is_equal(a.position, b.position) && is_equal(a.normal, b.normal) && is_equal(a.color, b.color) && is_equal(a.uv, b.uv)
+			&& a.connectivity.size() == b.connectivity.size() && is_equal(a.connectivity, b.connectivity);
+	}
+
+	void test_mesh_binary()
+	{
+		std::string const filename = "test_mesh_binary.cgpmesh";
+
+		// Small mesh: 16 bits indices, round trip through a file
+		{
+			cgp::mesh m = cgp::mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 10, 10);
+			m.fill_empty_field();
+			cgp::mesh_lod const lod = cgp::mesh_lod_generate(m, 3, 0.5f, 1.0f);
+
+			cgp::mesh_save_file_binary(filename, m, lod);
+			cgp::mesh_binary const binary = cgp::mesh_binary_load(filename);
+			assert_cgp_no_msg(binary.level_count == lod.size());
+			assert_cgp_no_msg(binary.index_width == 2);
+			assert_cgp_no_msg(binary.vertex_count == m.position.size());
+			assert_cgp_no_msg(is_equal(binary.bounding_box_min, cgp::vec3{ 0,0,0 }) && is_equal(binary.bounding_box_max, cgp::vec3{ 1,1,0 }));
+			assert_cgp_no_msg(is_same_mesh(binary.to_mesh(), m));
+
+			// Streams are aligned, and can be read directly
+			assert_cgp_no_msg(reinterpret_cast<uintptr_t>(binary.position()) % 16 == 0);
+			assert_cgp_no_msg(reinterpret_cast<uintptr_t>(binary.index(1)) % 16 == 0);
+			assert_cgp_no_msg(binary.position()[3 * 5 + 1] == m.position[5].y);
+
+			cgp::mesh_lod const lod_loaded = binary.to_lod();
+			for (int k = 1; k < lod.size(); ++k) {
+				assert_cgp_no_msg(is_equal(lod_loaded.connectivity[k], lod.connectivity[k]));
+				assert_cgp_no_msg(lod_loaded.error[k] == lod.error[k]);
+			}
+		}
+
+		// Large mesh: 32 bits indices
+		{
+			cgp::mesh const m = cgp::mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 300, 300);
+			cgp::mesh_binary const binary = cgp::mesh_binary_make(m);
+			assert_cgp_no_msg(binary.index_width == 4);
+			assert_cgp_no_msg(binary.level_count == 1);
+
+			cgp::mesh_binary_save(filename, binary);
+			assert_cgp_no_msg(is_same_mesh(cgp::mesh_binary_load(filename).to_mesh(), m));
+		}
+
+		// Invalid file
+		{
+			std::FILE* file = std::fopen(filename.c_str(), "wb");
+			std::fputs("not a mesh", file);
+			std::fclose(file);
+			assert_cgp_no_msg(cgp::mesh_binary_load(filename).level_count == 0);
+		}
+
+		std::remove(filename.c_str());
+	}
+}
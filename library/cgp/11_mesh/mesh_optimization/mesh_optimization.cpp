@@ -0,0 +1,308 @@
+#include "mesh_optimization.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace cgp
+{
+	bool mesh_optimization::at_load = true;
+	bool mesh_optimization::verbose = false;
+	int mesh_optimization::cache_size = 32;
+
+
+	mesh_vertex_cache_statistics mesh_analyze_vertex_cache(numarray<uint3> const& connectivity, int N_vertex, int cache_size)
+	{
+		mesh_vertex_cache_statistics stats;
+		size_t const N_tri = connectivity.size();
+		if (N_tri == 0 || N_vertex == 0)
+			return stats;
+
+		// FIFO cache simulated with timestamps: a vertex is in the cache if less than cache_size misses happened since its insertion
+		std::vector<int> timestamp(N_vertex, -cache_size - 1);
+		std::vector<char> referenced(N_vertex, 0);
+		int misses = 0;
+		int N_referenced = 0;
+		for (size_t k_tri = 0; k_tri < N_tri; ++k_tri) {
+			for (unsigned int idx : connectivity.at(k_tri)) {
+				assert_cgp_no_msg(idx < unsigned(N_vertex));
+				if (misses - timestamp[idx] > cache_size) {
+					timestamp[idx] = misses;
+					misses++;
+				}
+				if (referenced[idx] == 0) {
+					referenced[idx] = 1;
+					N_referenced++;
+				}
+			}
+		}
+
+		stats.acmr = float(misses) / float(N_tri);
+		stats.atvr = float(misses) / float(N_referenced);
+		return stats;
+	}
+
+
+	// Next fanning vertex of the Tipsify algorithm
+	//  Prefer the candidate vertex that entered the cache the earliest, as long as all its remaining triangles can be emitted before it is evicted
+	static int tipsify_next_vertex(std::vector<unsigned int> const& candidates, std::vector<int> const& remaining, std::vector<int> const& timestamp, int time, int cache_size)
+	{
+		int best_vertex = -1;
+		int best_priority = -1;
+		for (unsigned int idx : candidates) {
+			if (remaining[idx] > 0) {
+				int priority = 0;
+				if (time - timestamp[idx] + 2 * remaining[idx] <= cache_size)
+					priority = time - timestamp[idx];
+				if (priority > best_priority) {
+					best_priority = priority;
+					best_vertex = int(idx);
+				}
+			}
+		}
+		return best_vertex;
+	}
+
+	void optimize_vertex_cache(numarray<uint3>& connectivity, int N_vertex, int cache_size)
+	{
+		int const N_tri = connectivity.size();
+		if (N_tri == 0 || N_vertex == 0)
+			return;
+		assert_cgp(cache_size > 3, "Vertex cache size should be larger than 3");
+
+		// Triangles adjacent to each vertex (compressed storage)
+		//  The triangles of vertex v are adjacency[offset[v] .. offset[v+1]]
+		std::vector<int> remaining(N_vertex, 0);
+		for (int k_tri = 0; k_tri < N_tri; ++k_tri)
+			for (unsigned int idx : connectivity.at(k_tri)) {
+				assert_cgp(idx < unsigned(N_vertex), "Triangle index exceeds the number of vertices");
+				remaining[idx]++;
+			}
+
+		std::vector<int> offset(N_vertex + 1, 0);
+		for (int k = 0; k < N_vertex; ++k)
+			offset[k + 1] = offset[k] + remaining[k];
+
+		std::vector<int> adjacency(offset[N_vertex]);
+		{
+			std::vector<int> fill(offset.begin(), offset.end() - 1);
+			for (int k_tri = 0; k_tri < N_tri; ++k_tri)
+				for (unsigned int idx : connectivity.at(k_tri))
+					adjacency[fill[idx]++] = k_tri;
+		}
+
+		// Tipsify - See Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007)
+		//  Triangles are emitted as fans around a vertex, the next fanning vertex being chosen among the vertices still in the FIFO cache.
+		std::vector<int> timestamp(N_vertex, 0);
+		std::vector<char> emitted(N_tri, 0);
+		std::vector<unsigned int> dead_end;       // stack of recently used vertices, used to restart when no candidate is found
+		std::vector<unsigned int> candidates;
+		dead_end.reserve(3 * N_tri);
+
+		numarray<uint3> result;
+		result.resize(N_tri);
+		int k_out = 0;
+		int time = cache_size + 1;
+		int cursor = 0;
+
+		int fanning_vertex = 0;
+		while (fanning_vertex >= 0)
+		{
+			candidates.clear();
+			for (int j = offset[fanning_vertex]; j < offset[fanning_vertex + 1]; ++j) {
+				int const k_tri = adjacency[j];
+				if (emitted[k_tri])
+					continue;
+
+				uint3 const& tri = connectivity.at(k_tri);
+				result.at(k_out++) = tri;
+				emitted[k_tri] = 1;
+				for (unsigned int idx : tri) {
+					dead_end.push_back(idx);
+					candidates.push_back(idx);
+					remaining[idx]--;
+					if (time - timestamp[idx] > cache_size) {
+						timestamp[idx] = time;
+						time++;
+					}
+				}
+			}
+
+			fanning_vertex = tipsify_next_vertex(candidates, remaining, timestamp, time, cache_size);
+
+			// Dead end: restart from a recently used vertex, or from the next vertex in input order
+			while (fanning_vertex < 0 && !dead_end.empty()) {
+				unsigned int const idx = dead_end.back();
+				dead_end.pop_back();
+				if (remaining[idx] > 0)
+					fanning_vertex = int(idx);
+			}
+			while (fanning_vertex < 0 && cursor < N_vertex) {
+				if (remaining[cursor] > 0)
+					fanning_vertex = cursor;
+				cursor++;
+			}
+		}
+		assert_cgp_no_msg(k_out == N_tri);
+
+		connectivity = result;
+	}
+
+
+	void optimize_overdraw(numarray<uint3>& connectivity, numarray<vec3> const& position, int cache_size)
+	{
+		int const N_tri = connectivity.size();
+		int const N_vertex = position.size();
+		if (N_tri == 0 || N_vertex == 0)
+			return;
+
+		// Split the triangle sequence into clusters at hard cache boundaries (all vertices of a triangle are cache misses)
+		std::vector<int> cluster_start;
+		{
+			std::vector<int> timestamp(N_vertex, -cache_size - 1);
+			int misses = 0;
+			for (int k_tri = 0; k_tri < N_tri; ++k_tri) {
+				int tri_misses = 0;
+				for (unsigned int idx : connectivity.at(k_tri)) {
+					assert_cgp_no_msg(idx < unsigned(N_vertex));
+					if (misses - timestamp[idx] > cache_size) {
+						timestamp[idx] = misses;
+						misses++;
+						tri_misses++;
+					}
+				}
+				if (k_tri == 0 || tri_misses == 3)
+					cluster_start.push_back(k_tri);
+			}
+		}
+		int const N_cluster = int(cluster_start.size());
+		cluster_start.push_back(N_tri);
+		if (N_cluster < 2)
+			return;
+
+		// Area weighted centroid and normal of each cluster, and of the entire mesh
+		std::vector<vec3> cluster_centroid(N_cluster);
+		std::vector<vec3> cluster_normal(N_cluster);
+		vec3 mesh_centroid = { 0,0,0 };
+		float mesh_area = 0.0f;
+		for (int k_cluster = 0; k_cluster < N_cluster; ++k_cluster) {
+			vec3 centroid = { 0,0,0 };
+			vec3 normal = { 0,0,0 };
+			float area = 0.0f;
+			for (int k_tri = cluster_start[k_cluster]; k_tri < cluster_start[k_cluster + 1]; ++k_tri) {
+				uint3 const& tri = connectivity.at(k_tri);
+				vec3 const& p0 = position.at(tri[0]);
+				vec3 const& p1 = position.at(tri[1]);
+				vec3 const& p2 = position.at(tri[2]);
+				vec3 const n = cross(p1 - p0, p2 - p0);
+				float const a = norm(n);
+				centroid += a * (p0 + p1 + p2) / 3.0f;
+				normal += n;
+				area += a;
+			}
+			mesh_centroid += centroid;
+			mesh_area += area;
+			cluster_centroid[k_cluster] = area > 1e-12f ? centroid / area : position.at(connectivity.at(cluster_start[k_cluster])[0]);
+			float const L = norm(normal);
+			cluster_normal[k_cluster] = L > 1e-12f ? normal / L : vec3{ 0,0,0 };
+		}
+		if (mesh_area > 1e-12f)
+			mesh_centroid /= mesh_area;
+
+		// Clusters facing outward, far from the center, are likely to occlude the other ones: draw them first
+		std::vector<float> sort_key(N_cluster);
+		std::vector<int> order(N_cluster);
+		for (int k_cluster = 0; k_cluster < N_cluster; ++k_cluster) {
+			sort_key[k_cluster] = dot(cluster_centroid[k_cluster] - mesh_centroid, cluster_normal[k_cluster]);
+			order[k_cluster] = k_cluster;
+		}
+		std::stable_sort(order.begin(), order.end(), [&sort_key](int a, int b) { return sort_key[a] > sort_key[b]; });
+
+		numarray<uint3> result;
+		result.resize(N_tri);
+		int k_out = 0;
+		for (int k_cluster : order)
+			for (int k_tri = cluster_start[k_cluster]; k_tri < cluster_start[k_cluster + 1]; ++k_tri)
+				result.at(k_out++) = connectivity.at(k_tri);
+
+		connectivity = result;
+	}
+
+
+	template <typename T>
+	static void remap_attribute(numarray<T>& attribute, std::vector<int> const& new_index, int N_vertex)
+	{
+		if (attribute.size() != N_vertex)
+			return;
+		numarray<T> remapped;
+		remapped.resize(N_vertex);
+		for (int k = 0; k < N_vertex; ++k)
+			remapped.at(new_index[k]) = attribute.at(k);
+		attribute = remapped;
+	}
+
+	void optimize_vertex_fetch(mesh& m)
+	{
+		int const N_vertex = m.position.size();
+		if (N_vertex == 0)
+			return;
+
+		// New index of each vertex in the order of first use
+		std::vector<int> new_index(N_vertex, -1);
+		int counter = 0;
+		for (uint3& tri : m.connectivity) {
+			for (unsigned int& idx : tri) {
+				assert_cgp_no_msg(idx < unsigned(N_vertex));
+				if (new_index[idx] < 0)
+					new_index[idx] = counter++;
+				idx = new_index[idx];
+			}
+		}
+		for (int k = 0; k < N_vertex; ++k)
+			if (new_index[k] < 0)
+				new_index[k] = counter++;
+
+		remap_attribute(m.position, new_index, N_vertex);
+		remap_attribute(m.normal, new_index, N_vertex);
+		remap_attribute(m.color, new_index, N_vertex);
+		remap_attribute(m.uv, new_index, N_vertex);
+	}
+
+
+	mesh_optimization_report mesh_optimize(mesh& m, bool overdraw)
+	{
+		int const N_vertex = m.position.size();
+
+		mesh_optimization_report report;
+		report.before = mesh_analyze_vertex_cache(m.connectivity, N_vertex);
+
+		// Keep the initial triangle order if it was already better (ex. meshes exported by an optimizing tool)
+		numarray<uint3> const initial_connectivity = m.connectivity;
+		optimize_vertex_cache(m.connectivity, N_vertex);
+		float const acmr_vertex_cache = mesh_analyze_vertex_cache(m.connectivity, N_vertex).acmr;
+		if (acmr_vertex_cache > report.before.acmr)
+			m.connectivity = initial_connectivity;
+
+		// The overdraw pass is only kept if it doesn't degrade the vertex cache order it starts from
+		else if (overdraw) {
+			numarray<uint3> const vertex_cache_connectivity = m.connectivity;
+			optimize_overdraw(m.connectivity, m.position);
+			if (mesh_analyze_vertex_cache(m.connectivity, N_vertex).acmr > acmr_vertex_cache)
+				m.connectivity = vertex_cache_connectivity;
+		}
+
+		optimize_vertex_fetch(m);
+
+		report.after = mesh_analyze_vertex_cache(m.connectivity, N_vertex);
+		return report;
+	}
+
+
+	std::string str(mesh_vertex_cache_statistics const& s)
+	{
+		return "ACMR=" + str(s.acmr) + " ATVR=" + str(s.atvr);
+	}
+	std::string str(mesh_optimization_report const& r)
+	{
+		return "[" + str(r.before) + "] -> [" + str(r.after) + "]";
+	}
+}
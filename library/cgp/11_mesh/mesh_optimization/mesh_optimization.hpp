@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../mesh/mesh.hpp"
+
+namespace cgp
+{
+	/** Global settings of the mesh optimization pass.
+	* - at_load: optimize automatically the meshes loaded from files (ex. mesh_load_file_obj)
+	* - verbose: display the ACMR/ATVR statistics before/after each automatic optimization
+	* - cache_size: size of the simulated post-transform vertex cache (FIFO) */
+	struct mesh_optimization {
+		static bool at_load;
+		static bool verbose;
+		static int cache_size;
+	};
+
+	/** Efficiency of a triangle ordering with respect to a FIFO post-transform vertex cache
+	* - acmr: Average Cache Miss Ratio = number of transformed vertices / number of triangles (in [0.5,3], lower is better)
+	* - atvr: Average Transformed Vertex Ratio = number of transformed vertices / number of referenced vertices (1 is optimal) */
+	struct mesh_vertex_cache_statistics {
+		float acmr = 0.0f;
+		float atvr = 0.0f;
+	};
+
+	/** Statistics before and after a call to mesh_optimize */
+	struct mesh_optimization_report {
+		mesh_vertex_cache_statistics before;
+		mesh_vertex_cache_statistics after;
+	};
+
+	/** Simulate a FIFO vertex cache of size cache_size while processing the triangles in order */
+	mesh_vertex_cache_statistics mesh_analyze_vertex_cache(numarray<uint3> const& connectivity, int N_vertex, int cache_size = mesh_optimization::cache_size);
+
+	/** Reorder the triangles to maximize the post-transform vertex cache hits (Tipsify algorithm, linear time)
+	* The vertices are not modified, only the order of the triangles in the connectivity. */
+	void optimize_vertex_cache(numarray<uint3>& connectivity, int N_vertex, int cache_size = mesh_optimization::cache_size);
+
+	/** Reorder clusters of triangles (as produced by optimize_vertex_cache) from the outside to the inside of the mesh to reduce overdraw (Tipsify-style sort).
+	* Clusters are split at hard cache boundaries, and then sorted by decreasing dot( centroid_cluster - centroid_mesh, normal_cluster ). */
+	void optimize_overdraw(numarray<uint3>& connectivity, numarray<vec3> const& position, int cache_size = mesh_optimization::cache_size);
+
+	/** Reorder the vertices (all per-vertex attributes) in the order of their first use in the connectivity to improve fetch locality.
+	* Vertices that are not referenced by any triangle are moved to the end of the buffers. */
+	void optimize_vertex_fetch(mesh& m);
+
+	/** Apply the full optimization pass on the mesh: vertex cache, [overdraw], and vertex fetch.
+	* Each triangle reordering is only kept if it doesn't increase the ACMR of the order it starts from.
+	* Returns the cache statistics before and after the optimization. */
+	mesh_optimization_report mesh_optimize(mesh& m, bool overdraw = true);
+
+	std::string str(mesh_vertex_cache_statistics const& s);
+	std::string str(mesh_optimization_report const& r);
+}
@@ -0,0 +1,70 @@
+#include "cgp/01_base/base.hpp"
+#include "../mesh_optimization.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_mesh_optimization()
+	{
+		// Cache statistics of trivial configurations
+		{
+			cgp::numarray<cgp::uint3> connectivity = { {0,1,2}, {2,1,3} };
+			cgp::mesh_vertex_cache_statistics stats = cgp::mesh_analyze_vertex_cache(connectivity, 4, 32);
+			assert_cgp_no_msg(std::abs(stats.acmr - 2.0f) < 1e-6f);
+			assert_cgp_no_msg(std::abs(stats.atvr - 1.0f) < 1e-6f);
+
+			// Cache of size 3 evicts vertex 0 before it is used again
+			connectivity = { {0,1,2}, {3,4,5}, {0,1,2} };
+			stats = cgp::mesh_analyze_vertex_cache(connectivity, 6, 3);
+			assert_cgp_no_msg(std::abs(stats.acmr - 3.0f) < 1e-6f);
+		}
+
+		// Optimization keeps the same set of triangles and improves ACMR on a grid
+		{
+			cgp::mesh m = cgp::mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 60, 60);
+			cgp::mesh const initial = m;
+			cgp::mesh_optimization_report const report = cgp::mesh_optimize(m);
+
+			assert_cgp_no_msg(m.position.size() == initial.position.size());
+			assert_cgp_no_msg(m.connectivity.size() == initial.connectivity.size());
+			assert_cgp_no_msg(report.after.acmr < report.before.acmr);
+			assert_cgp_no_msg(report.after.acmr < 0.8f);
+
+			// Compare the sets of triangles expressed with positions
+			auto triangle_key = [](cgp::mesh const& mesh, cgp::uint3 const& tri) {
+				std::array<std::array<float, 3>, 3> key;
+				for (int k = 0; k < 3; ++k)
+					key[k] = { mesh.position[tri[k]].x, mesh.position[tri[k]].y, mesh.position[tri[k]].z };
+				std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end()); // orientation is kept
+				return key;
+			};
+			std::vector<std::array<std::array<float, 3>, 3>> keys_initial, keys_optimized;
+			for (auto const& tri : initial.connectivity) keys_initial.push_back(triangle_key(initial, tri));
+			for (auto const& tri : m.connectivity) keys_optimized.push_back(triangle_key(m, tri));
+			std::sort(keys_initial.begin(), keys_initial.end());
+			std::sort(keys_optimized.begin(), keys_optimized.end());
+			assert_cgp_no_msg(keys_initial == keys_optimized);
+
+			// Vertices are stored in order of first use
+			unsigned int max_index = 0;
+			bool first_use_order = true;
+			for (auto const& tri : m.connectivity)
+				for (unsigned int idx : tri) {
+					if (idx > max_index + 1) first_use_order = false;
+					max_index = std::max(max_index, idx);
+				}
+			assert_cgp_no_msg(first_use_order);
+		}
+
+	}
+}
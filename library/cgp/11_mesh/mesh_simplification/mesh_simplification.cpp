@@ -0,0 +1,354 @@
+#include "mesh_simplification.hpp"
+#include "../mesh_optimization/mesh_optimization.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <thread>
+
+namespace cgp
+{
+	// Symmetric 4x4 matrix of the quadric error: Q(p) = sum_planes (n.p + d)^2
+	struct quadric {
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+
+		void add_plane(vec3 const& n, float d) {
+			double const a = n.x, b = n.y, c = n.z;
+			a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+			b2 += b * b; bc += b * c; bd += b * d;
+			c2 += c * c; cd += c * d;
+			d2 += double(d) * d;
+		}
+		quadric& operator+=(quadric const& q) {
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+			return *this;
+		}
+		double evaluate(vec3 const& p) const {
+			double const x = p.x, y = p.y, z = p.z;
+			double const e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+				+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+				+ c2 * z * z + 2 * cd * z
+				+ d2;
+			return std::max(e, 0.0);
+		}
+	};
+
+	// Candidate collapse of the vertex u onto the vertex v
+	struct collapse_candidate {
+		double cost;
+		unsigned int u, v;
+		int version_u, version_v;
+		bool operator>(collapse_candidate const& other) const { return cost > other.cost; }
+	};
+
+	static float bounding_box_diagonal(numarray<vec3> const& position)
+	{
+		if (position.size() == 0)
+			return 0.0f;
+		vec3 p_min = position[0], p_max = position[0];
+		for (vec3 const& p : position) {
+			p_min = { std::min(p_min.x, p.x), std::min(p_min.y, p.y), std::min(p_min.z, p.z) };
+			p_max = { std::max(p_max.x, p.x), std::max(p_max.y, p.y), std::max(p_max.z, p.z) };
+		}
+		return norm(p_max - p_min);
+	}
+
+	static vec3 triangle_normal(vec3 const& p0, vec3 const& p1, vec3 const& p2)
+	{
+		return cross(p1 - p0, p2 - p0);
+	}
+
+	numarray<uint3> mesh_simplify_connectivity(numarray<vec3> const& position, numarray<uint3> const& connectivity, mesh_simplification_parameters const& parameters, float* error_reached)
+	{
+		int const N_vertex = position.size();
+		int const N_tri = connectivity.size();
+		if (error_reached != nullptr)
+			*error_reached = 0.0f;
+		if (N_tri <= parameters.target_triangle_count || N_vertex == 0)
+			return connectivity;
+
+		float const diagonal = bounding_box_diagonal(position);
+		double const max_distance = double(parameters.max_error) * diagonal;
+		double const max_cost = max_distance * max_distance;
+
+		// Per-vertex adjacent triangles, and per-vertex quadrics
+		numarray<uint3> triangles = connectivity;
+		std::vector<char> triangle_removed(N_tri, 0);
+		std::vector<std::vector<int>> vertex_triangles(N_vertex);
+		std::vector<quadric> Q(N_vertex);
+		for (int k_tri = 0; k_tri < N_tri; ++k_tri) {
+			uint3 const& tri = triangles[k_tri];
+			for (unsigned int idx : tri) {
+				assert_cgp(idx < unsigned(N_vertex), "Triangle index exceeds the number of vertices");
+				vertex_triangles[idx].push_back(k_tri);
+			}
+
+			vec3 n = triangle_normal(position[tri[0]], position[tri[1]], position[tri[2]]);
+			float const L = norm(n);
+			if (L > 1e-12f) {
+				n /= L;
+				quadric q;
+				q.add_plane(n, -dot(n, position[tri[0]]));
+				for (unsigned int idx : tri)
+					Q[idx] += q;
+			}
+		}
+
+		// Lock vertices on the border and non-manifold edges of the connectivity
+		std::vector<char> locked(N_vertex, 0);
+		{
+			std::map<std::pair<unsigned int, unsigned int>, int> edge_count;
+			for (uint3 const& tri : triangles)
+				for (int k = 0; k < 3; ++k) {
+					unsigned int const a = tri[k], b = tri[(k + 1) % 3];
+					edge_count[{std::min(a, b), std::max(a, b)}]++;
+				}
+			for (auto const& it : edge_count) {
+				if (it.second != 2 && parameters.lock_border) {
+					locked[it.first.first] = 1;
+					locked[it.first.second] = 1;
+				}
+			}
+		}
+
+		std::vector<char> vertex_removed(N_vertex, 0);
+		std::vector<int> version(N_vertex, 0);
+		std::priority_queue<collapse_candidate, std::vector<collapse_candidate>, std::greater<collapse_candidate>> heap;
+
+		auto push_candidate = [&](unsigned int u, unsigned int v) {
+			if (locked[u] || u == v)
+				return;
+			quadric q = Q[u];
+			q += Q[v];
+			heap.push({ q.evaluate(position[v]), u, v, version[u], version[v] });
+		};
+
+		for (uint3 const& tri : triangles)
+			for (int k = 0; k < 3; ++k) {
+				push_candidate(tri[k], tri[(k + 1) % 3]);
+				push_candidate(tri[(k + 1) % 3], tri[k]);
+			}
+
+		std::vector<unsigned int> neighbors_u, neighbors_v;
+		auto collect_neighbors = [&](unsigned int idx, std::vector<unsigned int>& neighbors) {
+			neighbors.clear();
+			for (int k_tri : vertex_triangles[idx]) {
+				if (triangle_removed[k_tri]) continue;
+				for (unsigned int w : triangles[k_tri])
+					if (w != idx) neighbors.push_back(w);
+			}
+			std::sort(neighbors.begin(), neighbors.end());
+			neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		};
+
+		int N_tri_live = N_tri;
+		double cost_reached = 0.0;
+		while (!heap.empty() && N_tri_live > parameters.target_triangle_count)
+		{
+			collapse_candidate const c = heap.top();
+			heap.pop();
+
+			unsigned int const u = c.u, v = c.v;
+			if (vertex_removed[u] || vertex_removed[v] || c.version_u != version[u] || c.version_v != version[v])
+				continue;
+			if (c.cost > max_cost)
+				break;
+
+			// Link condition: u and v must share exactly the neighbors of the triangles adjacent to the edge (preserve the manifold topology)
+			collect_neighbors(u, neighbors_u);
+			collect_neighbors(v, neighbors_v);
+			if (std::find(neighbors_u.begin(), neighbors_u.end(), v) == neighbors_u.end())
+				continue;
+			int N_shared_triangle = 0;
+			for (int k_tri : vertex_triangles[u]) {
+				if (triangle_removed[k_tri]) continue;
+				uint3 const& tri = triangles[k_tri];
+				if (tri[0] == v || tri[1] == v || tri[2] == v)
+					N_shared_triangle++;
+			}
+			std::vector<unsigned int> common;
+			std::set_intersection(neighbors_u.begin(), neighbors_u.end(), neighbors_v.begin(), neighbors_v.end(), std::back_inserter(common));
+			if (int(common.size()) != N_shared_triangle)
+				continue;
+
+			// Reject the collapse if a remaining triangle flips or degenerates
+			bool valid = true;
+			for (int k_tri : vertex_triangles[u]) {
+				if (!valid) break;
+				if (triangle_removed[k_tri]) continue;
+				uint3 const& tri = triangles[k_tri];
+				if (tri[0] == v || tri[1] == v || tri[2] == v) continue;
+
+				vec3 p[3], p_new[3];
+				for (int k = 0; k < 3; ++k) {
+					p[k] = position[tri[k]];
+					p_new[k] = tri[k] == u ? position[v] : p[k];
+				}
+				vec3 const n_old = triangle_normal(p[0], p[1], p[2]);
+				vec3 const n_new = triangle_normal(p_new[0], p_new[1], p_new[2]);
+				float const L_old = norm(n_old), L_new = norm(n_new);
+				if (L_new < 1e-12f || (L_old > 1e-12f && dot(n_old, n_new) < 0.2f * L_old * L_new))
+					valid = false;
+			}
+			if (!valid)
+				continue;
+
+			// Apply the collapse u -> v
+			for (int k_tri : vertex_triangles[u]) {
+				if (triangle_removed[k_tri]) continue;
+				uint3& tri = triangles[k_tri];
+				if (tri[0] == v || tri[1] == v || tri[2] == v) {
+					triangle_removed[k_tri] = 1;
+					N_tri_live--;
+				}
+				else {
+					for (unsigned int& idx : tri)
+						if (idx == u) idx = v;
+					vertex_triangles[v].push_back(k_tri);
+				}
+			}
+			vertex_triangles[u].clear();
+			vertex_removed[u] = 1;
+			Q[v] += Q[u];
+			version[v]++;
+			cost_reached = std::max(cost_reached, c.cost);
+
+			// Update the candidates around v
+			collect_neighbors(v, neighbors_v);
+			for (unsigned int w : neighbors_v) {
+				push_candidate(v, w);
+				push_candidate(w, v);
+			}
+		}
+
+		if (error_reached != nullptr)
+			*error_reached = float(std::sqrt(cost_reached));
+
+		numarray<uint3> result;
+		for (int k_tri = 0; k_tri < N_tri; ++k_tri)
+			if (!triangle_removed[k_tri])
+				result.push_back(triangles[k_tri]);
+		return result;
+	}
+
+	template <typename T>
+	static numarray<T> compact_attribute(numarray<T> const& attribute, std::vector<int> const& new_index, int N_new)
+	{
+		numarray<T> compact;
+		if (attribute.size() != int(new_index.size()))
+			return compact;
+		compact.resize(N_new);
+		for (int k = 0; k < attribute.size(); ++k)
+			if (new_index[k] >= 0)
+				compact[new_index[k]] = attribute[k];
+		return compact;
+	}
+
+	mesh mesh_simplify(mesh const& m, mesh_simplification_parameters const& parameters)
+	{
+		numarray<uint3> const connectivity = mesh_simplify_connectivity(m.position, m.connectivity, parameters);
+
+		// Remove unused vertices
+		int const N_vertex = m.position.size();
+		std::vector<int> new_index(N_vertex, -1);
+		int N_new = 0;
+		for (uint3 const& tri : connectivity)
+			for (unsigned int idx : tri)
+				if (new_index[idx] < 0)
+					new_index[idx] = N_new++;
+
+		mesh simplified;
+		simplified.position = compact_attribute(m.position, new_index, N_new);
+		simplified.normal = compact_attribute(m.normal, new_index, N_new);
+		simplified.color = compact_attribute(m.color, new_index, N_new);
+		simplified.uv = compact_attribute(m.uv, new_index, N_new);
+		for (uint3 const& tri : connectivity)
+			simplified.connectivity.push_back({ unsigned(new_index[tri[0]]), unsigned(new_index[tri[1]]), unsigned(new_index[tri[2]]) });
+
+		return simplified;
+	}
+
+
+	int mesh_lod::size() const
+	{
+		return connectivity.size();
+	}
+
+	mesh_lod mesh_lod_generate(mesh const& m, int N_level, float reduction_ratio, float max_error)
+	{
+		assert_cgp(reduction_ratio > 0.0f && reduction_ratio < 1.0f, "The reduction ratio of the levels of details should be in ]0,1[");
+
+		mesh_lod lod;
+		lod.connectivity.push_back(m.connectivity);
+		lod.error.push_back(0.0f);
+
+		float const diagonal = bounding_box_diagonal(m.position);
+		for (int k_level = 1; k_level < N_level; ++k_level)
+		{
+			numarray<uint3> const& previous = lod.connectivity[k_level - 1];
+			float const previous_error = lod.error[k_level - 1];
+
+			// Each level is simplified from the previous one, the error budget being reduced by the already accumulated error
+			mesh_simplification_parameters parameters;
+			parameters.target_triangle_count = int(previous.size() * reduction_ratio);
+			parameters.max_error = diagonal > 0 ? max_error - previous_error / diagonal : 0.0f;
+			if (parameters.max_error <= 0.0f)
+				break;
+
+			float error = 0.0f;
+			numarray<uint3> level = mesh_simplify_connectivity(m.position, previous, parameters, &error);
+
+			// Stop if the simplification is blocked (ex. locked borders, or error threshold)
+			if (level.size() > 0.9f * previous.size() || level.size() == 0)
+				break;
+
+			optimize_vertex_cache(level, m.position.size());
+			lod.connectivity.push_back(level);
+			lod.error.push_back(previous_error + error);
+		}
+
+		return lod;
+	}
+
+	std::vector<mesh_lod> mesh_lod_generate(std::vector<mesh> const& meshes, int N_level, float reduction_ratio, float max_error)
+	{
+		int const N_mesh = int(meshes.size());
+		std::vector<mesh_lod> lods(N_mesh);
+
+		// Each thread takes the next mesh to process until all meshes are done
+		std::atomic<int> next_mesh(0);
+		auto worker = [&]() {
+			for (int k = next_mesh++; k < N_mesh; k = next_mesh++)
+				lods[k] = mesh_lod_generate(meshes[k], N_level, reduction_ratio, max_error);
+		};
+
+		int const N_thread = std::max(1, std::min(N_mesh, int(std::thread::hardware_concurrency())));
+		std::vector<std::thread> threads;
+		for (int k = 1; k < N_thread; ++k)
+			threads.push_back(std::thread(worker));
+		worker();
+		for (std::thread& t : threads)
+			t.join();
+
+		return lods;
+	}
+
+	std::string str(mesh_lod const& lod)
+	{
+		std::string s = "mesh_lod[";
+		for (int k = 0; k < lod.size(); ++k) {
+			s += str(lod.connectivity[k].size()) + " triangles (error " + str(lod.error[k]) + ")";
+			if (k < lod.size() - 1)
+				s += ", ";
+		}
+		return s + "]";
+	}
+}
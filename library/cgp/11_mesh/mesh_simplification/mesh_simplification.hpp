@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../mesh/mesh.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	/** Parameters of the mesh simplification
+	* - target_triangle_count: the simplification stops when the number of triangles is less or equal to this value
+	* - max_error: the simplification stops when the error of the next collapse exceeds this value.
+	*     The error is the distance to the initial surface (from the quadrics), expressed relatively to the diagonal of the bounding box.
+	* - lock_border: vertices on the borders of the connectivity are never moved.
+	*     This includes the UV/normal seams where the vertices are duplicated (ex. meshes loaded from OBJ). */
+	struct mesh_simplification_parameters {
+		int target_triangle_count = 0;
+		float max_error = 0.01f;
+		bool lock_border = true;
+	};
+
+	/** Simplify the connectivity using edge collapses ordered by Quadric Error Metrics (Garland-Heckbert).
+	* Collapses are half-edge collapses: the remaining vertices keep their initial position and attributes.
+	*  The returned connectivity therefore indexes the same per-vertex buffers as the input (unused vertices are not removed).
+	* The optional error_reached is filled with the largest collapse error in absolute distance. */
+	numarray<uint3> mesh_simplify_connectivity(numarray<vec3> const& position, numarray<uint3> const& connectivity, mesh_simplification_parameters const& parameters, float* error_reached = nullptr);
+
+	/** Simplify the mesh, and remove the vertices that are not used anymore */
+	mesh mesh_simplify(mesh const& m, mesh_simplification_parameters const& parameters);
+
+	/** Level of details of a mesh, sharing the per-vertex buffers of the initial mesh.
+	* - connectivity[0] is the initial connectivity, connectivity[k] the k-th simplified level
+	* - error[k] is the estimated distance (in the mesh coordinates) between the level k and the initial surface */
+	struct mesh_lod {
+		numarray<numarray<uint3>> connectivity;
+		numarray<float> error;
+
+		int size() const;
+	};
+
+	/** Generate a chain of levels of details of decreasing number of triangles (each level has reduction_ratio times the triangles of the previous one).
+	* The chain stops after N_level levels, when the error exceeds max_error (relative to the bounding box diagonal), or when the mesh cannot be simplified anymore. */
+	mesh_lod mesh_lod_generate(mesh const& m, int N_level = 4, float reduction_ratio = 0.5f, float max_error = 0.05f);
+
+	/** Generate the levels of details of independent meshes in parallel (one task per mesh, run on the available hardware threads) */
+	std::vector<mesh_lod> mesh_lod_generate(std::vector<mesh> const& meshes, int N_level = 4, float reduction_ratio = 0.5f, float max_error = 0.05f);
+
+	std::string str(mesh_lod const& lod);
+}
@@ -0,0 +1,69 @@
+#include "cgp/01_base/base.hpp"
+#include "../mesh_simplification.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <iostream>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_mesh_simplification()
+	{
+		// A flat grid can be simplified without error, its border being kept
+		{
+			cgp::mesh const grid = cgp::mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 20, 20);
+			cgp::mesh_simplification_parameters parameters;
+			parameters.target_triangle_count = 100;
+			parameters.max_error = 1e-4f;
+
+			cgp::mesh const simplified = cgp::mesh_simplify(grid, parameters);
+			assert_cgp_no_msg(simplified.connectivity.size() <= 100);
+			assert_cgp_no_msg(simplified.connectivity.size() > 0);
+			assert_cgp_no_msg(simplified.position.size() < grid.position.size());
+			assert_cgp_no_msg(simplified.uv.size() == simplified.position.size());
+
+			// All border vertices are still present, and triangles keep their orientation
+			int N_border = 0;
+			for (cgp::vec3 const& p : simplified.position)
+				if (p.x < 1e-6f || p.x > 1 - 1e-6f || p.y < 1e-6f || p.y > 1 - 1e-6f)
+					N_border++;
+			assert_cgp_no_msg(N_border == 4 * 19);
+			for (cgp::uint3 const& tri : simplified.connectivity) {
+				cgp::vec3 const n = cross(simplified.position[tri[1]] - simplified.position[tri[0]], simplified.position[tri[2]] - simplified.position[tri[0]]);
+				assert_cgp_no_msg(n.z > 0);
+			}
+		}
+
+		// The error threshold stops the simplification of a curved surface
+		{
+			cgp::mesh const sphere = cgp::mesh_primitive_sphere(1.0f, { 0,0,0 }, 40, 20);
+			cgp::mesh_simplification_parameters parameters;
+			parameters.max_error = 0.0f;
+			float error = -1.0f;
+			cgp::numarray<cgp::uint3> const connectivity = cgp::mesh_simplify_connectivity(sphere.position, sphere.connectivity, parameters, &error);
+			assert_cgp_no_msg(connectivity.size() == sphere.connectivity.size());
+			assert_cgp_no_msg(error == 0.0f);
+		}
+
+		// Levels of details have decreasing number of triangles and increasing error
+		{
+			cgp::mesh const sphere = cgp::mesh_primitive_sphere(1.0f, { 0,0,0 }, 40, 20);
+			cgp::mesh_lod const lod = cgp::mesh_lod_generate(sphere, 4, 0.5f, 0.05f);
+			assert_cgp_no_msg(lod.size() >= 2);
+			assert_cgp_no_msg(lod.connectivity[0].size() == sphere.connectivity.size());
+			for (int k = 1; k < lod.size(); ++k) {
+				assert_cgp_no_msg(lod.connectivity[k].size() < lod.connectivity[k - 1].size());
+				assert_cgp_no_msg(lod.error[k] >= lod.error[k - 1]);
+			}
+
+			std::vector<cgp::mesh_lod> const lods = cgp::mesh_lod_generate(std::vector<cgp::mesh>{ sphere, sphere, sphere }, 4, 0.5f, 0.05f);
+			assert_cgp_no_msg(lods.size() == 3);
+			for (cgp::mesh_lod const& l : lods)
+				assert_cgp_no_msg(l.size() == lod.size());
+		}
+	}
+}
@@ -4,9 +4,11 @@
 namespace cgp
 {
 
-	static numarray<uint3> connectivity_grid(size_t Nu, size_t Nv)
+	// extra_triangles: capacity reserved for the triangles added after the grid
+	static numarray<uint3> connectivity_grid(size_t Nu, size_t Nv, size_t extra_triangles = 0)
 	{
 		numarray<uint3> connectivity;
+		connectivity.reserve(int(2*(Nu-1)*(Nv-1) + extra_triangles));
 		for(size_t ku=0; ku<Nu-1; ++ku) {
 			for(size_t kv=0; kv<Nv-1; ++kv) {
 				unsigned int k00 = static_cast<unsigned int>(kv   + Nv* ku);
@@ -31,6 +33,7 @@ namespace cgp
 		rotation_transform const R = rotation_transform::from_vector_transform({0,0,1}, dir);
 
 		mesh shape;
+		shape.reserve(Nu*Nv, 0); // the connectivity is built by connectivity_grid
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -102,6 +105,7 @@ namespace cgp
 		assert_cgp(N>2, "Disc samples ("+str(N)+") must be >2");
 
 		mesh shape;
+		shape.reserve(N+1, N-1);
 
 		rotation_transform const r = rotation_transform::from_vector_transform({0,0,1}, normal);
 
@@ -131,6 +135,7 @@ namespace cgp
 		assert_cgp(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		shape.reserve(Nu*Nv + 2*(Nu-1), 0);
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -154,7 +159,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		shape.connectivity = connectivity_grid(Nu,Nv, 2*(Nu-1));
 
 		
 		// poles
@@ -189,6 +194,7 @@ namespace cgp
 		assert_cgp(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		shape.reserve(Nu*Nv + 2*(Nu-1), 0);
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -212,7 +218,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		shape.connectivity = connectivity_grid(Nu,Nv, 2*(Nu-1));
 
 		
 		// poles
@@ -249,6 +255,7 @@ namespace cgp
 		assert_cgp(Nv>1, "Grid sample must be >1");
 
 		mesh shape;
+		shape.reserve(Nu*Nv, 0);
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -283,6 +290,7 @@ namespace cgp
 		rotation_transform R = rotation_transform::from_vector_transform({0,0,1}, axis_orientation);
 
 		mesh shape;
+		shape.reserve(Nu*Nv, 0);
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -320,6 +328,7 @@ namespace cgp
 
 
 		mesh shape;
+		shape.reserve(Nu*Nv + (Nu-1) + (is_closed_base ? Nu+1 : 0), 0);
 		rotation_transform R = rotation_transform::from_vector_transform({0,0,1}, axis_direction);
 
 		//base
@@ -342,7 +351,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		shape.connectivity = connectivity_grid(Nu,Nv, (Nu-1) + (is_closed_base ? Nu-1 : 0));
 		shape.flip_connectivity();
 
 		//Extremity
@@ -384,6 +393,7 @@ namespace cgp
 		vec3 p011 = p000 + u*vec3{0,1,1};
 
 		mesh shape;
+		shape.reserve(6*4, 6*2);
 		shape.push_back(mesh_primitive_quadrangle(p000, p100, p101, p001));
 		shape.push_back(mesh_primitive_quadrangle(p100, p110, p111, p101));
 		shape.push_back(mesh_primitive_quadrangle(p110, p010, p011, p111));
@@ -401,6 +411,7 @@ namespace cgp
 
 
 		mesh shape;
+		shape.reserve(2*(Nx*Nz + Ny*Nz + Nx*Ny), 4*((Nx-1)*(Nz-1) + (Ny-1)*(Nz-1) + (Nx-1)*(Ny-1)));
 		shape.push_back(mesh_primitive_grid(p000, p100, p101, p001, Nx, Nz));
 		shape.push_back(mesh_primitive_grid(p100, p110, p111, p101, Ny, Nz));
 		shape.push_back(mesh_primitive_grid(p110, p010, p011, p111, Nx, Nz));
@@ -414,6 +425,7 @@ namespace cgp
 	mesh mesh_primitive_tetrahedron(vec3 const& p0, vec3 const& p1, vec3 const& p2, vec3 const& p3)
 	{
 		mesh shape;
+		shape.reserve(4*3, 4);
 		shape.push_back(mesh_primitive_triangle(p0,p2,p1));
 		shape.push_back(mesh_primitive_triangle(p0,p1,p3));
 		shape.push_back(mesh_primitive_triangle(p1,p2,p3));
@@ -437,6 +449,7 @@ namespace cgp
 		mesh const cylinder = mesh_primitive_cylinder(cylinder_radius, p0, p_extremity, 2, N, false);
 
 		mesh shape;
+		shape.reserve(cone_extremity.position.size() + cylinder.position.size(), cone_extremity.connectivity.size() + cylinder.connectivity.size());
 		shape.push_back(cone_extremity);
 		shape.push_back(cylinder);
 
@@ -462,6 +475,7 @@ namespace cgp
 		sphere.color.fill(color_sphere);
 
 		mesh shape;
+		shape.reserve(3*ux.position.size() + sphere.position.size(), 3*ux.connectivity.size() + sphere.connectivity.size());
 		shape.push_back(ux).push_back(uy).push_back(uz).push_back(sphere);
 		return shape;
 	}
@@ -27,7 +27,7 @@ namespace cgp
 		// Compute the marching cube
 		std::vector<vec3> position;
 		std::vector<marching_cube_relative_coordinates> relative;
-		int const N = marching_cube(position, field.data.data, domain, iso, &relative);
+		int const N = marching_cube(position, field.data.data.data(), domain, iso, &relative);
 
 
 		// Compute the mesh with non-duplicated vertices
@@ -103,6 +103,12 @@ namespace cgp
 
 
 	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative)
+	{
+		assert_cgp_no_msg(field.size() == size_t(domain.samples.x) * domain.samples.y * domain.samples.z);
+		return marching_cube(position, field.data(), domain, iso, relative);
+	}
+
+	size_t marching_cube(std::vector<vec3>& position, float const* field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative)
 	{
 		// Table of correspondance between the 256 type of cube and the edges on which new vertices are created
 		static std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
@@ -22,4 +22,6 @@ namespace cgp {
 	* - If the parameter relative is not null, it is filled with the indices of the indice grid corresponding to the edge on which the vertex lie. 
 	* - Note: the parameters are set using row std::vector to handle possibly large mesh with indices using size_t instead of int */
 	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative=nullptr);
+	/** Same with the field given as a contiguous array of domain.samples.x * samples.y * samples.z values (ex. grid_3D<float>::data.data.data()) */
+	size_t marching_cube(std::vector<vec3>& position, float const* field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative=nullptr);
 }
\ No newline at end of file
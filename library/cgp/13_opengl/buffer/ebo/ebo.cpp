@@ -1,12 +1,25 @@
 #include "ebo.hpp"
 #include "../../debug/debug.hpp"
+#include "../../memory/memory.hpp"
+#include "cgp/01_base/base.hpp"
 
 namespace cgp
 {
 
-	void opengl_ebo_structure::initialize_data_on_gpu(numarray<uint3> const& data)
+	// The previous buffer is lost if the EBO was not cleared
+	static void ebo_memory_register(opengl_ebo_structure const& ebo, GLuint previous_id, bool has_data)
 	{
+		if (previous_id != 0)
+			memory_mark_leaked(memory_category::buffer, previous_id);
+		std::string const format = "ebo " + str(ebo.size) + " triangles" + (ebo.details.type_element == GL_UNSIGNED_SHORT ? " ushort" : " uint");
+		memory_register(memory_category::buffer, ebo.id, ebo.details.size_byte, format, "opengl_ebo_structure::initialize_data_on_gpu");
+		if (has_data)
+			memory_count_upload(ebo.details.size_byte);
+	}
 
+	void opengl_ebo_structure::initialize_data_on_gpu(numarray<uint3> const& data)
+	{
+		GLuint const previous_id = id;
 		glGenBuffers(1, &id); opengl_check;
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id); opengl_check;
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(size_in_memory(data)), ptr(data), GL_DYNAMIC_DRAW); opengl_check;
@@ -18,7 +31,27 @@ namespace cgp
 		details.size_byte = size_in_memory(data);
 		details.size_element = 3;
 		details.type_element = GL_UNSIGNED_INT;
+		ebo_memory_register(*this, previous_id, true);
+	}
+
+	void opengl_ebo_structure::initialize_data_on_gpu(void const* data, int triangle_count, GLenum index_type)
+	{
+		assert_cgp(index_type == GL_UNSIGNED_SHORT || index_type == GL_UNSIGNED_INT, "EBO indices should be GL_UNSIGNED_SHORT or GL_UNSIGNED_INT");
+		size_t const size_byte = size_t(3) * triangle_count * (index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+		GLuint const previous_id = id;
 
+		glGenBuffers(1, &id); opengl_check;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id); opengl_check;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(size_byte), data, GL_DYNAMIC_DRAW); opengl_check;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); opengl_check;
+
+		size = triangle_count;
+		type = GL_ELEMENT_ARRAY_BUFFER;
+
+		details.size_byte = GLuint(size_byte);
+		details.size_element = 3;
+		details.type_element = index_type;
+		ebo_memory_register(*this, previous_id, data != nullptr);
 	}
 
 }
\ No newline at end of file
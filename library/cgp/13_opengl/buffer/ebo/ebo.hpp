@@ -10,6 +10,8 @@ namespace cgp
 	struct opengl_ebo_structure : opengl_gpu_buffer
 	{
 		void initialize_data_on_gpu(numarray<uint3> const& data);
+		// Send triangle_count triangles whose indices are stored contiguously as index_type (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT)
+		void initialize_data_on_gpu(void const* data, int triangle_count, GLenum index_type);
 	};
 
 
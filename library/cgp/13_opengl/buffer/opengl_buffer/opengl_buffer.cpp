@@ -1,5 +1,6 @@
 #include "opengl_buffer.hpp"
 #include "../../debug/debug.hpp"
+#include "../../memory/memory.hpp"
 
 
 namespace cgp
@@ -27,6 +28,7 @@ namespace cgp
 	}
 	void opengl_gpu_buffer::clear()
 	{
+		memory_unregister(memory_category::buffer, id);
 		glDeleteBuffers(1, &id);  opengl_check;
 
 		id = 0;
@@ -1,10 +1,12 @@
 #include "vbo.hpp"
 #include "../../debug/debug.hpp"
+#include "../../memory/memory.hpp"
 #include "cgp/01_base/base.hpp"
 
 namespace cgp
 {
-	static void warning_initialize_non_empty();
+	static void warning_initialize_non_empty(GLuint id);
+	static void vbo_memory_register(opengl_vbo_structure const& vbo, bool has_data);
 
 	template <int N>
 	static GLuint opengl_buffer_data_initialize_generic(numarray<numarray_stack<float,N> > const& data, GLuint buffer_type, GLenum draw_type)
@@ -21,7 +23,7 @@ namespace cgp
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec3> const& data, GLuint div)
 	{
 		if(id!=0){
-			warning_initialize_non_empty();
+			warning_initialize_non_empty(id);
 		}
 
 		divisor = div;
@@ -32,11 +34,12 @@ namespace cgp
 		details.size_byte = size_in_memory(data);
 		details.size_element = 3;
 		details.type_element = GL_FLOAT;
+		vbo_memory_register(*this, true);
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec2> const& data, GLuint div)
 	{
 		if(id!=0){
-			warning_initialize_non_empty();
+			warning_initialize_non_empty(id);
 		}
 
 		divisor = div;
@@ -47,11 +50,12 @@ namespace cgp
 		details.size_byte = size_in_memory(data);
 		details.size_element = 2;
 		details.type_element = GL_FLOAT;
+		vbo_memory_register(*this, true);
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec4> const& data, GLuint div)
 	{
 		if(id!=0){
-			warning_initialize_non_empty();
+			warning_initialize_non_empty(id);
 		}
 
 		divisor = div;
@@ -62,6 +66,31 @@ namespace cgp
 		details.size_byte = size_in_memory(data);
 		details.size_element = 4;
 		details.type_element = GL_FLOAT;
+		vbo_memory_register(*this, true);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(numarray<float> const& data, GLuint div)
+	{
+		initialize_data_on_gpu(ptr(data), data.size(), 1, div);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(float const* data, int element_count, int element_dimension, GLuint div)
+	{
+		if(id!=0){
+			warning_initialize_non_empty(id);
+		}
+		size_t const size_byte = sizeof(float) * size_t(element_count) * element_dimension;
+
+		divisor = div;
+		glGenBuffers(1, &id);                                                              opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, id);                                                 opengl_check;
+		glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(size_byte), data, GL_DYNAMIC_DRAW);       opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);                                                  opengl_check;
+		size = element_count;
+		type = GL_ARRAY_BUFFER;
+
+		details.size_byte = GLuint(size_byte);
+		details.size_element = element_dimension;
+		details.type_element = GL_FLOAT;
+		vbo_memory_register(*this, data != nullptr);
 	}
 	void opengl_vbo_structure::update(numarray<vec2> const& data, int size_elements_update)
 	{
@@ -69,9 +98,11 @@ namespace cgp
 		glBindBuffer(GL_ARRAY_BUFFER, id); opengl_check;
 		if (size_elements_update == -1) {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, size_in_memory(data), ptr(data));  opengl_check;
+			memory_count_upload(size_in_memory(data));
 		}
 		else {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, 2 * sizeof(float) * size_elements_update, ptr(data));  opengl_check;
+			memory_count_upload(2 * sizeof(float) * size_elements_update);
 		}
 	}
 	void opengl_vbo_structure::update(numarray<vec3> const& data, int size_elements_update)
@@ -80,9 +111,11 @@ namespace cgp
 		glBindBuffer(GL_ARRAY_BUFFER, id); opengl_check;
 		if (size_elements_update == -1) {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, size_in_memory(data), ptr(data));  opengl_check;
+			memory_count_upload(size_in_memory(data));
 		}
 		else {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, 3 * sizeof(float) * size_elements_update, ptr(data));  opengl_check;
+			memory_count_upload(3 * sizeof(float) * size_elements_update);
 		}
 	}
 	void opengl_vbo_structure::update(numarray<vec4> const& data, int size_elements_update)
@@ -91,9 +124,11 @@ namespace cgp
 		glBindBuffer(GL_ARRAY_BUFFER, id); opengl_check;
 		if (size_elements_update == -1) {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, size_in_memory(data), ptr(data));  opengl_check;
+			memory_count_upload(size_in_memory(data));
 		}
 		else {
 			glBufferSubData(GL_ARRAY_BUFFER, 0, 4 * sizeof(float) * size_elements_update, ptr(data));  opengl_check;
+			memory_count_upload(4 * sizeof(float) * size_elements_update);
 		}
 	}
 
@@ -108,8 +143,18 @@ namespace cgp
 	}
 
 
-	static void warning_initialize_non_empty()
+	static void vbo_memory_register(opengl_vbo_structure const& vbo, bool has_data)
 	{
+		std::string const format = "vbo " + str(vbo.size) + "x" + str(vbo.details.size_element) + " float" + (vbo.divisor > 0 ? " instanced" : "");
+		memory_register(memory_category::buffer, vbo.id, vbo.details.size_byte, format, "opengl_vbo_structure::initialize_data_on_gpu");
+		if (has_data)
+			memory_count_upload(vbo.details.size_byte);
+	}
+
+	static void warning_initialize_non_empty(GLuint id)
+	{
+		memory_mark_leaked(memory_category::buffer, id);
+
 		std::string warning = "\n";
 		warning += "  > You are calling initialize_data_on_gpu on an non-empty VBO (opengl_vbo_structure) \n";
 		warning += "In normal condition, you should avoid initializing a new Buffer on an existing one without clearing it - the previously allocated memory on the GPU is going to be lost.\n";
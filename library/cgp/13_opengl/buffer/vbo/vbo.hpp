@@ -14,6 +14,9 @@ namespace cgp
 		void initialize_data_on_gpu(numarray<vec3> const& data, GLuint divisor = 0);
 		void initialize_data_on_gpu(numarray<vec2> const& data, GLuint divisor = 0);
 		void initialize_data_on_gpu(numarray<vec4> const& data, GLuint divisor = 0);
+		void initialize_data_on_gpu(numarray<float> const& data, GLuint divisor = 0);
+		// Send element_count elements of element_dimension floats stored contiguously (ex. pointer on a memory-mapped file)
+		void initialize_data_on_gpu(float const* data, int element_count, int element_dimension, GLuint divisor = 0);
 
 		/** Re-write data on the VBO. (without re-allocation) in calling glBufferSubData
 		* - size_elements_update: 
@@ -0,0 +1,336 @@
+#include "capture.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+#include "cgp/07_image/image.hpp"
+#include "cgp/13_opengl/debug/debug.hpp"
+#include "cgp/13_opengl/memory/memory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace cgp
+{
+    // Convert the rgba rows read by OpenGL (bottom-up) into rgb rows (top-down)
+    static void capture_flip_to_rgb(unsigned char const* rgba, int width, int height, unsigned char* rgb)
+    {
+        for (int y = 0; y < height; ++y) {
+            unsigned char const* in = rgba + size_t(4) * width * (height - 1 - y);
+            unsigned char* out = rgb + size_t(3) * width * y;
+            for (int x = 0; x < width; ++x) {
+                out[3 * x + 0] = in[4 * x + 0];
+                out[3 * x + 1] = in[4 * x + 1];
+                out[3 * x + 2] = in[4 * x + 2];
+            }
+        }
+    }
+
+    static std::string capture_frame_filename(std::string const& directory, int index, frame_capture_format format)
+    {
+        std::string number = str(index);
+        while (number.size() < 5)
+            number = "0" + number;
+        return directory + "frame_" + number + (format == frame_capture_format::jpg ? ".jpg" : ".png");
+    }
+
+    static frame_capture_format capture_format_from_filename(std::string const& filename)
+    {
+        size_t const N = filename.size();
+        if (N > 4 && (filename.substr(N - 4) == ".jpg" || filename.substr(N - 4) == ".JPG"))
+            return frame_capture_format::jpg;
+        if (N > 5 && filename.substr(N - 5) == ".jpeg")
+            return frame_capture_format::jpg;
+        return frame_capture_format::png;
+    }
+
+
+    frame_capture::frame_capture()
+    {}
+
+    frame_capture::~frame_capture()
+    {
+        // No OpenGL call here (the context may already be destroyed): only the encoders are waited for
+        try {
+            if (encoder_image != nullptr)
+                encoder_image->wait_idle();
+            if (encoder_raw != nullptr)
+                encoder_raw->wait_idle();
+        }
+        catch (std::exception const& e) {
+            std::cerr << "[capture] " << e.what() << std::endl;
+        }
+    }
+
+    job_system& frame_capture::encoder(frame_capture_format format)
+    {
+        std::unique_ptr<job_system>& pool = (format == frame_capture_format::raw) ? encoder_raw : encoder_image;
+        if (pool == nullptr)
+            pool.reset(new job_system(format == frame_capture_format::raw ? 1 : 0));
+        return *pool;
+    }
+
+    void frame_capture::screenshot(std::string const& filename, int width, int height)
+    {
+        read_pixels(width, height, capture_format_from_filename(filename), filename);
+    }
+
+    void frame_capture::screenshot(std::string const& filename, opengl_fbo_structure const& fbo)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.id); opengl_check;
+        screenshot(filename, fbo.width, fbo.height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0); opengl_check;
+    }
+
+    void frame_capture::start_recording(std::string const& directory_arg, frame_capture_format format)
+    {
+        if (recording)
+            stop_recording();
+
+        std::string directory = directory_arg;
+        if (!directory.empty() && directory.back() != '/')
+            directory += '/';
+        if (!directory.empty() && !check_path_exist(directory))
+            error_cgp("Cannot record the frames in " + directory + " (the directory does not exist)");
+
+        recording = true;
+        recording_directory = directory;
+        recording_format = format;
+        recording_width = 0;
+        recording_height = 0;
+        N_frame = 0;
+        N_dropped = 0;
+        N_stall = 0;
+
+        if (format == frame_capture_format::raw) {
+            raw_stream = std::make_shared<std::ofstream>(directory + "frames.rgb", std::ios::binary);
+            if (!raw_stream->is_open())
+                error_cgp("Cannot open " + directory + "frames.rgb");
+        }
+    }
+
+    void frame_capture::record_frame(int width, int height)
+    {
+        if (!recording)
+            return;
+
+        // A raw recording keeps the size of its first frame
+        if (recording_format == frame_capture_format::raw) {
+            if (N_frame == 0) {
+                recording_width = width;
+                recording_height = height;
+            }
+            else if (width != recording_width || height != recording_height) {
+                N_dropped++;
+                return;
+            }
+        }
+
+        // Frames waiting for a PBO or for an encoder
+        job_system& pool = encoder(recording_format);
+        int busy = 0;
+        for (capture_slot const& slot : slots)
+            busy += slot.busy ? 1 : 0;
+        if (lossless) {
+            while (pool.pending() >= max_pending) {
+                pool.rethrow_error();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        else if (pool.pending() + busy >= max_pending + int(slots.size())) {
+            N_dropped++;
+            return;
+        }
+
+        std::string const filename = recording_format == frame_capture_format::raw ? "" : capture_frame_filename(recording_directory, N_frame, recording_format);
+        read_pixels(width, height, recording_format, filename);
+        N_frame++;
+    }
+
+    void frame_capture::record_frame(opengl_fbo_structure const& fbo)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.id); opengl_check;
+        record_frame(fbo.width, fbo.height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0); opengl_check;
+    }
+
+    void frame_capture::stop_recording()
+    {
+        if (!recording)
+            return;
+        finish();
+        recording = false;
+
+        std::cout << "[capture] " << N_frame << " frames recorded in " << recording_directory << " (" << N_dropped << " dropped, " << N_stall << " stalls)" << std::endl;
+        if (recording_format == frame_capture_format::raw) {
+            raw_stream.reset();
+            std::cout << "[capture] Encode with: ffmpeg -f rawvideo -pixel_format rgb24 -video_size " << recording_width << "x" << recording_height
+                << " -framerate " << framerate << " -i " << recording_directory << "frames.rgb -pix_fmt yuv420p " << recording_directory << "video.mp4" << std::endl;
+        }
+    }
+
+    bool frame_capture::is_recording() const
+    {
+        return recording;
+    }
+
+    void frame_capture::read_pixels(int width, int height, frame_capture_format format, std::string const& filename)
+    {
+#ifndef __EMSCRIPTEN__
+        if (width <= 0 || height <= 0)
+            return;
+
+        if (slots.empty()) {
+            slots.resize(std::max(ring_size, 1));
+            for (capture_slot& slot : slots) {
+                glGenBuffers(1, &slot.pbo); opengl_check;
+            }
+            next_slot = 0;
+        }
+
+        // The ring is full: wait for the oldest transfer
+        capture_slot& slot = slots[next_slot];
+        if (slot.busy) {
+            N_stall++;
+            retrieve(slot);
+        }
+
+        size_t const size = size_t(4) * width * height;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo); opengl_check;
+        if (slot.capacity < size) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ); opengl_check;
+            slot.capacity = size;
+            memory_register(memory_category::buffer, slot.pbo, size, "pbo " + str(width) + "x" + str(height) + " RGBA8", "frame_capture::read_pixels");
+        }
+        // RGBA8 rows are always 4-byte aligned: the rows are tightly packed whatever the GL_PACK_ALIGNMENT set by the window (1)
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); opengl_check; // Returns immediately: the destination is the PBO
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0); opengl_check;
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); opengl_check;
+        slot.busy = true;
+        slot.width = width;
+        slot.height = height;
+        slot.format = format;
+        slot.filename = filename;
+
+        next_slot = (next_slot + 1) % int(slots.size());
+#else
+        warning_cgp("Frame capture is not available with WebGL (no PBO mapping)", "");
+#endif
+    }
+
+    void frame_capture::retrieve(capture_slot& slot)
+    {
+#ifndef __EMSCRIPTEN__
+        // Usually already signaled when called from update()
+        while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(slot.fence); opengl_check;
+        slot.fence = nullptr;
+
+        int const width = slot.width;
+        int const height = slot.height;
+        size_t const size = size_t(4) * width * height;
+        auto pixels = std::make_shared<std::vector<unsigned char>>(size);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo); opengl_check;
+        void const* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(size), GL_MAP_READ_BIT); opengl_check;
+        if (mapped != nullptr) {
+            std::memcpy(pixels->data(), mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); opengl_check;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0); opengl_check;
+        slot.busy = false;
+        if (mapped == nullptr)
+            return;
+
+        // Encoding and writing on the worker threads
+        frame_capture_format const format = slot.format;
+        if (format == frame_capture_format::raw) {
+            std::shared_ptr<std::ofstream> stream = raw_stream;
+            if (stream == nullptr)
+                return;
+            encoder(format).submit([pixels, width, height, stream]() {
+                std::vector<unsigned char> rgb(size_t(3) * width * height);
+                capture_flip_to_rgb(pixels->data(), width, height, rgb.data());
+                stream->write(reinterpret_cast<char const*>(rgb.data()), std::streamsize(rgb.size()));
+            });
+        }
+        else {
+            std::string const filename = slot.filename;
+            encoder(format).submit([pixels, width, height, format, filename]() {
+                image_structure im;
+                im.width = width;
+                im.height = height;
+                im.color_type = image_color_type::rgb;
+                im.data.resize(size_t(3) * width * height);
+                capture_flip_to_rgb(pixels->data(), width, height, im.data.data.data());
+                if (format == frame_capture_format::jpg)
+                    image_save_jpg(filename, im);
+                else
+                    image_save_png(filename, im);
+            });
+        }
+#else
+        slot.busy = false;
+#endif
+    }
+
+    void frame_capture::update()
+    {
+#ifndef __EMSCRIPTEN__
+        // Slots are visited from the oldest capture, and stop at the first transfer not finished (keeps the order of the raw frames)
+        int const N = int(slots.size());
+        for (int k = 0; k < N; ++k) {
+            capture_slot& slot = slots[(next_slot + k) % N];
+            if (!slot.busy)
+                continue;
+            GLenum const status = glClientWaitSync(slot.fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+                break;
+            retrieve(slot);
+        }
+#endif
+        if (encoder_image != nullptr)
+            encoder_image->rethrow_error();
+        if (encoder_raw != nullptr)
+            encoder_raw->rethrow_error();
+    }
+
+    void frame_capture::finish()
+    {
+        int const N = int(slots.size());
+        for (int k = 0; k < N; ++k) {
+            capture_slot& slot = slots[(next_slot + k) % N];
+            if (slot.busy)
+                retrieve(slot);
+        }
+        for (capture_slot& slot : slots) {
+            memory_unregister(memory_category::buffer, slot.pbo);
+            glDeleteBuffers(1, &slot.pbo); opengl_check;
+        }
+        slots.clear();
+        next_slot = 0;
+
+        if (encoder_image != nullptr)
+            encoder_image->wait_idle();
+        if (encoder_raw != nullptr)
+            encoder_raw->wait_idle();
+        if (raw_stream != nullptr)
+            raw_stream->flush();
+    }
+
+    int frame_capture::frame_count() const
+    {
+        return N_frame;
+    }
+    int frame_capture::dropped_count() const
+    {
+        return N_dropped;
+    }
+    int frame_capture::stall_count() const
+    {
+        return N_stall;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "cgp/opengl_include.hpp"
+#include "cgp/13_opengl/fbo/fbo.hpp"
+#include "cgp/22_thread/job_system/job_system.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cgp
+{
+	// png/jpg: one image file per frame. raw: a single file of rgb24 frames (bottom-up rows already flipped), to be encoded with ffmpeg.
+	enum class frame_capture_format { png, jpg, raw };
+
+	/** Asynchronous screenshots and video recording of the rendered frames
+	*  glReadPixels writes in a ring of pixel buffer objects (PBO) and returns immediately: the transfer is done by the driver while the next frames are rendered.
+	*  A PBO is mapped only once its fence is signaled (usually ring_size-1 frames later), and the pixels are encoded and written by worker threads.
+	*
+	*  Usage:
+	*  | frame_capture capture;
+	*  | capture.start_recording("capture/", frame_capture_format::raw);
+	*  | // each frame, after the rendering and before swapping the buffers
+	*  | capture.record_frame(width, height);  // or record_frame(fbo)
+	*  | capture.update();
+	*  | ...
+	*  | capture.stop_recording(); // waits for the pending frames, prints the ffmpeg command for raw recordings
+	*
+	*  When the encoders cannot keep up (ex. png at high resolution), the frames are dropped and counted, so that the frame rate of the application is kept.
+	*  Set lossless=true to wait for the encoders instead (ex. offline rendering). */
+	class frame_capture
+	{
+	public:
+		int ring_size = 3;       // Number of PBO: a frame is read back ring_size-1 frames after its capture
+		int max_pending = 8;     // Number of frames waiting for the encoders above which frames are dropped (or waited for if lossless)
+		bool lossless = false;
+		float framerate = 60.0f; // Frame rate written in the ffmpeg command of raw recordings
+
+		frame_capture();
+		~frame_capture();
+
+		frame_capture(frame_capture const&) = delete;
+		frame_capture& operator=(frame_capture const&) = delete;
+
+		// Single image (.png or .jpg) written asynchronously
+		//  The version without fbo reads the framebuffer currently bound to GL_READ_FRAMEBUFFER (the default framebuffer if no fbo is bound)
+		void screenshot(std::string const& filename, int width, int height);
+		void screenshot(std::string const& filename, opengl_fbo_structure const& fbo);
+
+		// The directory must exist. Frames are named directory/frame_00000.png, or stored in directory/frames.rgb for raw
+		void start_recording(std::string const& directory, frame_capture_format format = frame_capture_format::png);
+		void record_frame(int width, int height);
+		void record_frame(opengl_fbo_structure const& fbo);
+		void stop_recording();
+		bool is_recording() const;
+
+		// Retrieve the frames whose transfer is finished (to be called once per frame)
+		void update();
+		// Block until all the captured frames are written, and release the PBO
+		void finish();
+
+		int frame_count() const;   // Number of frames recorded since start_recording
+		int dropped_count() const; // Number of frames dropped as the encoders were busy
+		int stall_count() const;   // Number of times the main thread waited for a PBO (the ring is too small)
+
+	private:
+		struct capture_slot {
+			GLuint pbo = 0;
+			size_t capacity = 0;
+			GLsync fence = nullptr;
+			bool busy = false;
+			int width = 0;
+			int height = 0;
+			frame_capture_format format = frame_capture_format::png;
+			std::string filename;
+		};
+
+		void read_pixels(int width, int height, frame_capture_format format, std::string const& filename);
+		void retrieve(capture_slot& slot);
+		job_system& encoder(frame_capture_format format);
+
+		std::vector<capture_slot> slots;
+		int next_slot = 0;
+
+		// Images are encoded in parallel, raw frames are written in order by a single thread
+		std::unique_ptr<job_system> encoder_image;
+		std::unique_ptr<job_system> encoder_raw;
+		std::shared_ptr<std::ofstream> raw_stream;
+
+		bool recording = false;
+		std::string recording_directory;
+		frame_capture_format recording_format = frame_capture_format::png;
+		int recording_width = 0;
+		int recording_height = 0;
+		int N_frame = 0;
+		int N_dropped = 0;
+		int N_stall = 0;
+	};
+}
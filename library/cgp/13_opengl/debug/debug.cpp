@@ -1,10 +1,51 @@
 #include "debug.hpp"
 
 #include "cgp/01_base/base.hpp"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <vector>
+
+// KHR_debug enums and function types (not part of the OpenGL 3.3 headers)
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#endif
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#endif
+#ifndef GL_DEBUG_TYPE_ERROR
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#endif
+#ifndef GL_DEBUG_SEVERITY_HIGH
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#endif
+#ifndef GL_DEBUG_SEVERITY_MEDIUM
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#endif
+#ifndef GL_DEBUG_SEVERITY_NOTIFICATION
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+#ifndef GL_DONT_CARE
+#define GL_DONT_CARE 0x1100
+#endif
 
 namespace cgp
 {
+	opengl_error_mode opengl_error_reporting::mode = opengl_error_mode::sampled;
+	int opengl_error_reporting::sample_period = 60;
+	bool opengl_error_reporting::debug_callback_available = false;
+	int opengl_error_reporting::error_count = 0;
+
+	// Messages received from the driver (possibly from another thread) and waiting to be reported
+	struct opengl_debug_message {
+		GLuint id;
+		GLenum type;
+		GLenum severity;
+		std::string text;
+	};
+	static std::mutex debug_message_mutex;
+	static std::vector<opengl_debug_message> debug_message_queue;
+
 	std::string opengl_info_display()
 	{
         using cgp::str;
@@ -49,6 +90,7 @@ namespace cgp
         GLenum error = glGetError();
         if( error !=GL_NO_ERROR )
         {
+            opengl_error_reporting::error_count++;
             std::string msg = "OpenGL ERROR detected\n"
                     "\tFile "+file+"\n"
                     "\tFunction "+function+"\n"
@@ -58,4 +100,126 @@ namespace cgp
             error_cgp(msg);
         }
 	}
+
+
+#ifndef __EMSCRIPTEN__
+    typedef void (APIENTRY *opengl_debug_proc)(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* user_param);
+    typedef void (APIENTRY *opengl_debug_message_callback_proc)(opengl_debug_proc callback, const void* user_param);
+    typedef void (APIENTRY *opengl_debug_message_control_proc)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+    // Only records the message: throwing from the driver callback is not allowed, the messages are reported by opengl_error_frame_check()
+    static void APIENTRY opengl_debug_callback(GLenum, GLenum type, GLuint id, GLenum severity, GLsizei, const GLchar* message, const void*)
+    {
+        if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+            return;
+
+        std::lock_guard<std::mutex> lock(debug_message_mutex);
+        debug_message_queue.push_back({ id, type, severity, str(message) });
+    }
+
+    static bool opengl_has_extension(std::string const& name)
+    {
+        GLint N_extension = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &N_extension);
+        for (GLint k = 0; k < N_extension; ++k) {
+            char const* extension = reinterpret_cast<char const*>(glGetStringi(GL_EXTENSIONS, GLuint(k)));
+            if (extension != nullptr && name == extension)
+                return true;
+        }
+        return false;
+    }
+
+    void opengl_error_initialize(GLADloadproc loader)
+    {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool const core_debug = major > 4 || (major == 4 && minor >= 3);
+
+        opengl_debug_message_callback_proc debug_message_callback = nullptr;
+        opengl_debug_message_control_proc debug_message_control = nullptr;
+        if (core_debug || opengl_has_extension("GL_KHR_debug")) {
+            debug_message_callback = reinterpret_cast<opengl_debug_message_callback_proc>(loader("glDebugMessageCallback"));
+            debug_message_control = reinterpret_cast<opengl_debug_message_control_proc>(loader("glDebugMessageControl"));
+        }
+        glGetError(); // Clear a possible error from the queries
+
+        opengl_error_reporting::debug_callback_available = (debug_message_callback != nullptr);
+        if (opengl_error_reporting::debug_callback_available) {
+            debug_message_callback(opengl_debug_callback, nullptr);
+            if (debug_message_control != nullptr)
+                debug_message_control(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+        }
+
+        opengl_error_set_mode(opengl_error_reporting::debug_callback_available ? opengl_error_mode::debug_callback : opengl_error_mode::sampled);
+    }
+#endif
+
+    void opengl_error_set_mode(opengl_error_mode mode)
+    {
+        opengl_error_reporting::mode = mode;
+
+#ifndef __EMSCRIPTEN__
+        if (opengl_error_reporting::debug_callback_available) {
+            bool const use_callback = (mode == opengl_error_mode::debug_callback || mode == opengl_error_mode::strict);
+            use_callback ? glEnable(GL_DEBUG_OUTPUT) : glDisable(GL_DEBUG_OUTPUT);
+            mode == opengl_error_mode::strict ? glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS) : glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        }
+#endif
+        glGetError(); // Do not report errors that happened before the change of mode
+    }
+
+    void opengl_error_frame_check()
+    {
+        static int frame_counter = 0;
+        frame_counter++;
+
+        opengl_error_mode const mode = opengl_error_reporting::mode;
+        if (mode == opengl_error_mode::sampled && frame_counter % std::max(opengl_error_reporting::sample_period, 1) == 0) {
+            GLenum const error = glGetError();
+            if (error != GL_NO_ERROR) {
+                opengl_error_reporting::error_count++;
+                warning_cgp("OpenGL error detected during the last frames: " + opengl_error_to_string(error), "(switch to strict mode to find the faulty call)");
+            }
+        }
+
+        std::vector<opengl_debug_message> messages;
+        {
+            std::lock_guard<std::mutex> lock(debug_message_mutex);
+            messages.swap(debug_message_queue);
+        }
+        // The warning id contains the message id and type: the limit of max_warning applies to each kind of message, not to the driver output as a whole
+        for (opengl_debug_message const& message : messages) {
+            std::string const message_id = " (id " + str(message.id) + ", type " + str(message.type) + "):";
+            if (message.type == GL_DEBUG_TYPE_ERROR) {
+                opengl_error_reporting::error_count++;
+                if (mode == opengl_error_mode::strict) {
+                    error_cgp("OpenGL ERROR detected by the debug output\n\t" + message.text);
+                }
+                else {
+                    warning_cgp("OpenGL error reported by the driver" + message_id, message.text);
+                }
+            }
+            else if (message.severity == GL_DEBUG_SEVERITY_HIGH || message.severity == GL_DEBUG_SEVERITY_MEDIUM) {
+                warning_cgp("OpenGL debug message" + message_id, message.text);
+            }
+        }
+    }
+
+    std::string str(opengl_error_mode mode)
+    {
+        switch (mode)
+        {
+        case opengl_error_mode::disabled:
+            return "disabled";
+        case opengl_error_mode::debug_callback:
+            return "debug callback";
+        case opengl_error_mode::sampled:
+            return "sampled";
+        case opengl_error_mode::strict:
+            return "strict";
+        default:
+            return "unknown";
+        }
+    }
 }
\ No newline at end of file
@@ -3,15 +3,45 @@
 #include "cgp/opengl_include.hpp"
 #include <string>
 
+// opengl_check is placed after OpenGL calls. It only calls glGetError (which stalls the driver) in strict mode.
+//  In the other modes, errors are reported asynchronously (KHR_debug) or sampled once per frame in opengl_error_frame_check().
 #ifndef CGP_NO_DEBUG
-#define opengl_check {cgp::check_opengl_error(__FILE__, __func__, __LINE__);}
+#define opengl_check {if(cgp::opengl_error_reporting::mode==cgp::opengl_error_mode::strict) {cgp::check_opengl_error(__FILE__, __func__, __LINE__);} }
 #else
 #define opengl_check {}
 #endif
 
 namespace cgp
 {
+	// How OpenGL errors are detected
+	//  - disabled: no check at all
+	//  - debug_callback: asynchronous messages from the driver (GL_KHR_debug), reported once per frame. Default when available.
+	//  - sampled: a single glGetError once every sample_period frames. Default when KHR_debug is not available.
+	//  - strict: glGetError after every opengl_check and synchronous debug messages. Errors abort the program (use for tests).
+	//      The driver messages are raised at the end of the frame by opengl_error_frame_check (not within the debug callback).
+	enum class opengl_error_mode { disabled, debug_callback, sampled, strict };
+
+	struct opengl_error_reporting {
+		static opengl_error_mode mode;
+		static int sample_period;              // Number of frames between two checks in sampled mode
+		static bool debug_callback_available;  // Set by opengl_error_initialize if the context supports GL_KHR_debug
+		static int error_count;                // Total number of errors detected since the start
+	};
+
 	std::string opengl_info_display();
 	void check_opengl_error(const std::string& file, const std::string& function, int line);
-}
 
+#ifndef __EMSCRIPTEN__
+	// Detect GL_KHR_debug and install the message callback (to be called once the context is current and GLAD is loaded)
+	//  The function pointers are retrieved using the loader (ex. glfwGetProcAddress) as they are not part of OpenGL 3.3
+	void opengl_error_initialize(GLADloadproc loader);
+#endif
+
+	// Change the error detection mode at runtime
+	void opengl_error_set_mode(opengl_error_mode mode);
+
+	// Report the errors collected during the frame (to be called once per frame, ex. before swapping the buffers)
+	void opengl_error_frame_check();
+
+	std::string str(opengl_error_mode mode);
+}
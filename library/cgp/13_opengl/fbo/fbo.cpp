@@ -1,6 +1,7 @@
 #include "fbo.hpp"
 
 #include "cgp/01_base/base.hpp"
+#include "../memory/memory.hpp"
 
 
 namespace cgp{
@@ -20,6 +21,7 @@ namespace cgp{
 			glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_id); opengl_check;
 			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height); opengl_check;
 			glBindRenderbuffer(GL_RENDERBUFFER, 0); opengl_check;
+			memory_register(memory_category::renderbuffer, depth_buffer_id, size_t(4) * width * height, "GL_DEPTH_COMPONENT32F " + str(width) + "x" + str(height), "opengl_fbo_structure::initialize");
 
 			// Create frame buffer
 			glGenFramebuffers(1, &id);
@@ -44,6 +46,7 @@ namespace cgp{
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); opengl_check;
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); opengl_check;
 			glBindTexture(GL_TEXTURE_2D, 0); opengl_check;
+			memory_register_texture(texture.id, GL_DEPTH_COMPONENT24, width, height, 1, false, 0, "opengl_fbo_structure::initialize");
 
 			
 
@@ -99,12 +102,17 @@ namespace cgp{
 				glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
 				glBindRenderbuffer(GL_RENDERBUFFER, 0);
 				opengl_check;
+
+				memory_register_texture(texture.id, GL_RGB8, width, height, 1, false, 0, "opengl_fbo_structure::update_screen_size");
+				memory_register(memory_category::renderbuffer, depth_buffer_id, size_t(4) * width * height, "GL_DEPTH_COMPONENT32F " + str(width) + "x" + str(height), "opengl_fbo_structure::update_screen_size");
 			}
 			else if(mode==opengl_fbo_mode::depth){
 				glBindTexture(GL_TEXTURE_2D, texture.id);
 				glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
 				glBindTexture(GL_TEXTURE_2D, 0);
 				opengl_check;
+
+				memory_register_texture(texture.id, GL_DEPTH_COMPONENT24, width, height, 1, false, 0, "opengl_fbo_structure::update_screen_size");
 			}
 
 			
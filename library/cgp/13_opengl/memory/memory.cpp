@@ -0,0 +1,325 @@
+#include "memory.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace cgp
+{
+	bool memory_registry::active = true;
+	size_t memory_registry::budget_gpu = 0;
+	size_t memory_registry::budget_cpu = 0;
+	size_t memory_registry::budget_upload = 0;
+	bool memory_registry::budget_strict = false;
+
+	namespace
+	{
+		struct owner_entry {
+			std::string name;
+			std::string location; // file:line of the scope
+		};
+
+		struct memory_registry_state {
+			std::mutex mutex;
+			std::map<std::pair<int, std::uintptr_t>, memory_allocation> allocations;
+			memory_upload_statistics upload;
+			bool over_budget[3] = {}; // gpu, cpu, upload: the warning is emitted once per crossing
+		};
+		memory_registry_state& registry()
+		{
+			static memory_registry_state s;
+			return s;
+		}
+
+		std::vector<owner_entry>& owner_stack()
+		{
+			thread_local std::vector<owner_entry> stack;
+			return stack;
+		}
+
+		std::string file_basename(char const* file)
+		{
+			std::string const f = file;
+			size_t const k = f.find_last_of("/\\");
+			return k == std::string::npos ? f : f.substr(k + 1);
+		}
+
+		void check_budget(memory_registry_state& s, int index, char const* name, size_t value, size_t budget)
+		{
+			bool const over = budget > 0 && value > budget;
+			if (over && !s.over_budget[index]) {
+				std::string const message = std::string(name) + " " + memory_size_str(value) + " exceeds the budget of " + memory_size_str(budget);
+				s.over_budget[index] = true;
+				if (memory_registry::budget_strict)
+					error_cgp("Memory budget exceeded: " + message);
+				warning_cgp("Memory budget exceeded", message);
+			}
+			if (!over)
+				s.over_budget[index] = false;
+		}
+	}
+
+	memory_owner_scope::memory_owner_scope(std::string const& name, char const* file, int line)
+	{
+		owner_stack().push_back({ name, file_basename(file) + ":" + str(line) });
+	}
+	memory_owner_scope::~memory_owner_scope()
+	{
+		owner_stack().pop_back();
+	}
+
+	size_t memory_totals::gpu() const
+	{
+		return category[int(memory_category::buffer)] + category[int(memory_category::texture)] + category[int(memory_category::renderbuffer)];
+	}
+	size_t memory_totals::cpu() const
+	{
+		return category[int(memory_category::cpu_mesh)];
+	}
+
+	void memory_register(memory_category category, std::uintptr_t key, size_t bytes, std::string const& format, char const* site)
+	{
+		if (!memory_registry::active || key == 0)
+			return;
+
+		memory_allocation a;
+		a.category = category;
+		a.key = key;
+		a.bytes = bytes;
+		a.format = format;
+		a.site = site;
+		std::vector<owner_entry> const& owners = owner_stack();
+		if (!owners.empty()) {
+			a.owner = owners.back().name;
+			a.site += " (" + owners.back().location + ")";
+		}
+
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		a.frame = s.upload.frame;
+		memory_allocation& entry = s.allocations[{ int(category), key }];
+		if (a.owner.empty() && !entry.owner.empty()) {
+			// Reallocation outside of any owner scope (ex. resize of a framebuffer): the owner of the creation is kept
+			a.owner = entry.owner;
+			a.site = entry.site;
+		}
+		entry = std::move(a);
+	}
+
+	void memory_unregister(memory_category category, std::uintptr_t key)
+	{
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.allocations.erase({ int(category), key });
+	}
+
+	void memory_mark_leaked(memory_category category, std::uintptr_t key)
+	{
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		auto it = s.allocations.find({ int(category), key });
+		if (it == s.allocations.end())
+			return;
+
+		// The entry is moved to a key that cannot be reused by OpenGL, so that a new object with the same id can be recorded
+		memory_allocation a = std::move(it->second);
+		s.allocations.erase(it);
+		a.leaked = true;
+		std::uintptr_t leaked_key = ~std::uintptr_t(0);
+		while (s.allocations.count({ int(category), leaked_key }) > 0)
+			--leaked_key;
+		s.allocations[{ int(category), leaked_key }] = std::move(a);
+	}
+
+	size_t memory_texel_size(GLint format)
+	{
+		switch (format)
+		{
+		case GL_RGB8:
+			return 3;
+		case GL_RGBA8:
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32F:
+			return 4;
+		case GL_RGB32F:
+			return 12;
+		case GL_RGBA32F:
+			return 16;
+		default:
+			return 4;
+		}
+	}
+
+	std::string memory_format_str(GLint format)
+	{
+		switch (format)
+		{
+		case GL_RGB8: return "GL_RGB8";
+		case GL_RGBA8: return "GL_RGBA8";
+		case GL_RGB32F: return "GL_RGB32F";
+		case GL_RGBA32F: return "GL_RGBA32F";
+		case GL_DEPTH_COMPONENT: return "GL_DEPTH_COMPONENT";
+		case GL_DEPTH_COMPONENT24: return "GL_DEPTH_COMPONENT24";
+		case GL_DEPTH_COMPONENT32F: return "GL_DEPTH_COMPONENT32F";
+		default: return "format " + str(format);
+		}
+	}
+
+	void memory_register_texture(GLuint id, GLint format, int width, int height, int layer_count, bool is_mipmap, size_t upload_bytes, char const* site)
+	{
+		// Sum of the levels of the mipmap chain
+		size_t texels = 0;
+		int w = width, h = height;
+		while (true) {
+			texels += size_t(w) * size_t(h);
+			if (!is_mipmap || (w <= 1 && h <= 1))
+				break;
+			w = std::max(w / 2, 1);
+			h = std::max(h / 2, 1);
+		}
+
+		std::string description = memory_format_str(format) + " " + str(width) + "x" + str(height);
+		if (layer_count > 1)
+			description += "x" + str(layer_count);
+		if (is_mipmap)
+			description += " mip";
+		memory_register(memory_category::texture, id, texels * layer_count * memory_texel_size(format), description, site);
+		memory_count_upload(upload_bytes);
+	}
+
+	void memory_count_upload(size_t bytes)
+	{
+		if (!memory_registry::active || bytes == 0)
+			return;
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.upload.current_frame += bytes;
+		s.upload.total += bytes;
+	}
+
+	void memory_frame_begin()
+	{
+		memory_totals const totals = memory_total();
+
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		memory_upload_statistics& upload = s.upload;
+		upload.last_frame = upload.current_frame;
+		upload.peak_frame = std::max(upload.peak_frame, upload.current_frame);
+		upload.current_frame = 0;
+		upload.frame++;
+
+		check_budget(s, 0, "GPU memory", totals.gpu(), memory_registry::budget_gpu);
+		check_budget(s, 1, "CPU mesh memory", totals.cpu(), memory_registry::budget_cpu);
+		check_budget(s, 2, "Upload of the frame", upload.last_frame, memory_registry::budget_upload);
+	}
+
+	std::vector<memory_allocation> memory_allocations()
+	{
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		std::vector<memory_allocation> allocations;
+		allocations.reserve(s.allocations.size());
+		for (auto const& entry : s.allocations)
+			allocations.push_back(entry.second);
+		return allocations;
+	}
+
+	memory_totals memory_total()
+	{
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		memory_totals totals;
+		for (auto const& entry : s.allocations) {
+			memory_allocation const& a = entry.second;
+			totals.category[int(a.category)] += a.bytes;
+			totals.count[int(a.category)]++;
+			if (a.leaked) {
+				totals.leaked_count++;
+				totals.leaked_bytes += a.bytes;
+			}
+		}
+		return totals;
+	}
+
+	memory_upload_statistics memory_upload()
+	{
+		memory_registry_state& s = registry();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.upload;
+	}
+
+	int memory_report_leaks()
+	{
+		std::vector<memory_allocation> const allocations = memory_allocations();
+		memory_totals const totals = memory_total();
+
+		int leaked = 0;
+		for (memory_allocation const& a : allocations) {
+			if (!a.leaked)
+				continue;
+			if (leaked == 0)
+				std::cout << "[memory] Leaked allocations (initialized again without clear):" << std::endl;
+			std::cout << "  " << str(a.category) << " " << memory_size_str(a.bytes) << " " << a.format << " - " << (a.owner.empty() ? "no owner" : a.owner) << " - " << a.site << std::endl;
+			leaked++;
+		}
+
+		// Allocations still alive, per owner
+		std::map<std::string, std::pair<int, size_t>> owners;
+		for (memory_allocation const& a : allocations) {
+			if (a.leaked)
+				continue;
+			std::pair<int, size_t>& owner = owners[a.owner.empty() ? "(no owner)" : a.owner];
+			owner.first++;
+			owner.second += a.bytes;
+		}
+		std::cout << "[memory] Alive at shutdown: GPU " << memory_size_str(totals.gpu()) << ", CPU meshes " << memory_size_str(totals.cpu()) << " (" << allocations.size() - leaked << " allocations)" << std::endl;
+		for (auto const& owner : owners)
+			std::cout << "  " << owner.first << ": " << owner.second.first << " allocations, " << memory_size_str(owner.second.second) << std::endl;
+		return leaked;
+	}
+
+	std::shared_ptr<mesh> memory_tracked_mesh(mesh&& m)
+	{
+		size_t const bytes = size_in_memory(m.position) + size_in_memory(m.normal) + size_in_memory(m.color) + size_in_memory(m.uv) + size_in_memory(m.connectivity);
+		std::string const format = str(m.position.size()) + " vertices, " + str(m.connectivity.size()) + " triangles";
+
+		mesh* const p = new mesh(std::move(m));
+		memory_register(memory_category::cpu_mesh, reinterpret_cast<std::uintptr_t>(p), bytes, format, "memory_tracked_mesh");
+		return std::shared_ptr<mesh>(p, [](mesh* q) {
+			memory_unregister(memory_category::cpu_mesh, reinterpret_cast<std::uintptr_t>(q));
+			delete q;
+		});
+	}
+
+	std::string memory_size_str(size_t bytes)
+	{
+		char buffer[32];
+		if (bytes < 1024)
+			std::snprintf(buffer, sizeof(buffer), "%d B", int(bytes));
+		else if (bytes < 1024 * 1024)
+			std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+		else if (bytes < size_t(1024) * 1024 * 1024)
+			std::snprintf(buffer, sizeof(buffer), "%.2f MB", bytes / (1024.0 * 1024.0));
+		else
+			std::snprintf(buffer, sizeof(buffer), "%.2f GB", bytes / (1024.0 * 1024.0 * 1024.0));
+		return buffer;
+	}
+
+	std::string str(memory_category category)
+	{
+		switch (category) {
+		case memory_category::buffer: return "buffer";
+		case memory_category::texture: return "texture";
+		case memory_category::renderbuffer: return "renderbuffer";
+		case memory_category::cpu_mesh: return "cpu_mesh";
+		}
+		return "";
+	}
+}
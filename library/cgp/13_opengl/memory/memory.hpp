@@ -0,0 +1,116 @@
+#pragma once
+
+#include "cgp/opengl_include.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Registry of the memory allocations
+//  The OpenGL buffers (VBO, EBO, PBO), textures and renderbuffers created by the library are recorded with their size, format and creation site,
+//  as well as the CPU meshes created with memory_tracked_mesh(). The bytes sent to the GPU are counted per frame.
+//  memory_owner_cgp("name") tags the allocations made until the end of the current scope (on the current thread) with an owner name (ex. an asset).
+//  memory_frame_begin() must be called once per frame: it closes the upload counter of the previous frame and checks the budgets.
+//  Defining CGP_NO_MEMORY_REGISTRY removes the owner scopes at compile time.
+#ifndef CGP_NO_MEMORY_REGISTRY
+	#define memory_owner_concatenate_detail(a, b) a##b
+	#define memory_owner_concatenate(a, b) memory_owner_concatenate_detail(a, b)
+	#define memory_owner_cgp(NAME) cgp::memory_owner_scope const memory_owner_concatenate(cgp_memory_owner_, __LINE__)(NAME, __FILE__, __LINE__)
+#else
+	#define memory_owner_cgp(NAME) {}
+#endif
+
+namespace cgp
+{
+	struct mesh;
+
+	enum class memory_category { buffer, texture, renderbuffer, cpu_mesh };
+	int const memory_category_count = 4;
+
+	struct memory_allocation {
+		memory_category category = memory_category::buffer;
+		std::uintptr_t key = 0;  // OpenGL id, or address of the CPU data
+		size_t bytes = 0;
+		std::string format;      // ex. "GL_RGBA8 1024x1024 mip", "vbo 3xGL_FLOAT"
+		std::string owner;       // Innermost memory_owner_cgp scope at the creation ("" if none)
+		std::string site;        // Library function, and location of the owner scope
+		long frame = 0;          // Frame of the creation
+		bool leaked = false;     // The id was overwritten by a new initialization without clear(): the memory cannot be released anymore
+	};
+
+	struct memory_registry {
+		static bool active;             // Allocations are recorded only when active (set before the first allocation)
+		static size_t budget_gpu;       // Budgets in bytes (0: no budget)
+		static size_t budget_cpu;
+		static size_t budget_upload;    // Bytes sent to the GPU in a single frame
+		static bool budget_strict;      // Exceeding a budget is an error (exception) instead of a warning
+	};
+
+	// Totals of the allocations alive (bytes)
+	struct memory_totals {
+		size_t category[memory_category_count] = {};
+		int count[memory_category_count] = {};
+		int leaked_count = 0;
+		size_t leaked_bytes = 0;
+
+		size_t gpu() const; // buffer + texture + renderbuffer
+		size_t cpu() const;
+	};
+
+	// Bytes sent to the GPU (glBufferData, glBufferSubData, glTexImage and glTexSubImage with data)
+	struct memory_upload_statistics {
+		size_t current_frame = 0;
+		size_t last_frame = 0;
+		size_t peak_frame = 0;
+		size_t total = 0;
+		long frame = 0;
+	};
+
+
+	// Record an allocation. A second allocation with the same category and key replaces the first one (ex. resize).
+	void memory_register(memory_category category, std::uintptr_t key, size_t bytes, std::string const& format, char const* site);
+	void memory_unregister(memory_category category, std::uintptr_t key);
+	// The allocation is still on the GPU but its id is lost (initialization of a non empty buffer)
+	void memory_mark_leaked(memory_category category, std::uintptr_t key);
+
+	// Record a texture from its OpenGL description. The size of the mipmap chain is added when is_mipmap is true.
+	//  upload_bytes is the size of the data sent with the creation (0 for an empty texture).
+	void memory_register_texture(GLuint id, GLint format, int width, int height, int layer_count, bool is_mipmap, size_t upload_bytes, char const* site);
+	// Size of a texel in bytes (estimation for the formats used by the library, 4 otherwise)
+	size_t memory_texel_size(GLint format);
+	std::string memory_format_str(GLint format);
+
+	void memory_count_upload(size_t bytes);
+	void memory_frame_begin();
+
+	std::vector<memory_allocation> memory_allocations();
+	memory_totals memory_total();
+	memory_upload_statistics memory_upload();
+
+	// Print the leaked allocations and the allocations still alive grouped by owner. Returns the number of leaked allocations.
+	//  To be called at shutdown, before the OpenGL context is destroyed.
+	int memory_report_leaks();
+
+	// Mesh held by a shared pointer whose CPU memory (all the numarrays) is recorded until the last copy of the pointer is released
+	//  The size is the one at the creation: later modifications of the mesh are not tracked.
+	std::shared_ptr<mesh> memory_tracked_mesh(mesh&& m);
+
+	// ImGui panel: totals and budgets, upload counter, allocations per owner and largest allocations
+	void memory_display_imgui();
+
+	// Size with a unit adapted to its magnitude (ex. "1.25 MB")
+	std::string memory_size_str(size_t bytes);
+	std::string str(memory_category category);
+
+
+	// RAII scope created by memory_owner_cgp
+	class memory_owner_scope {
+	public:
+		memory_owner_scope(std::string const& name, char const* file, int line);
+		~memory_owner_scope();
+		memory_owner_scope(memory_owner_scope const&) = delete;
+		memory_owner_scope& operator=(memory_owner_scope const&) = delete;
+	};
+}
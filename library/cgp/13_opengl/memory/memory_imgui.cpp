@@ -0,0 +1,86 @@
+#include "memory.hpp"
+#include "cgp/01_base/allocation/allocation_counter.hpp"
+#include "cgp/01_base/allocation/memory_arena.hpp"
+
+#include "third_party/src/imgui/imgui.h"
+
+#include <algorithm>
+#include <map>
+
+namespace cgp
+{
+	static void memory_budget_bar(char const* name, size_t value, size_t budget)
+	{
+		if (budget == 0) {
+			ImGui::Text("%s: %s", name, memory_size_str(value).c_str());
+			return;
+		}
+		std::string const overlay = memory_size_str(value) + " / " + memory_size_str(budget);
+		ImGui::ProgressBar(std::min(float(double(value) / budget), 1.0f), ImVec2(-1, 0), overlay.c_str());
+		ImGui::SameLine(); ImGui::Text("%s", name);
+	}
+
+	void memory_display_imgui()
+	{
+		ImGui::Checkbox("Budget strict", &memory_registry::budget_strict);
+
+		memory_totals const totals = memory_total();
+		memory_upload_statistics const upload = memory_upload();
+		memory_budget_bar("GPU", totals.gpu(), memory_registry::budget_gpu);
+		memory_budget_bar("CPU meshes", totals.cpu(), memory_registry::budget_cpu);
+		memory_budget_bar("Upload (last frame)", upload.last_frame, memory_registry::budget_upload);
+		ImGui::Text("Upload: peak %s per frame, total %s", memory_size_str(upload.peak_frame).c_str(), memory_size_str(upload.total).c_str());
+		for (int k = 0; k < memory_category_count; ++k)
+			ImGui::Text("  %s: %d, %s", str(memory_category(k)).c_str(), totals.count[k], memory_size_str(totals.category[k]).c_str());
+		if (totals.leaked_count > 0)
+			ImGui::TextColored(ImVec4(1, 0.4f, 0.4f, 1), "Leaked: %d allocations, %s", totals.leaked_count, memory_size_str(totals.leaked_bytes).c_str());
+		if (allocation_counter_active()) {
+			allocation_statistics const frame = allocation_last_frame();
+			ImGui::Text("Heap (last frame): %lld allocations, %s", frame.count, memory_size_str(size_t(frame.bytes)).c_str());
+		}
+		ImGui::Text("Frame arena: %s (peak %s, %d blocks)", memory_size_str(frame_arena().used()).c_str(), memory_size_str(frame_arena().peak()).c_str(), frame_arena().block_count());
+
+		std::vector<memory_allocation> allocations = memory_allocations();
+
+		// Per owner
+		struct owner_total { size_t gpu = 0; size_t cpu = 0; int count = 0; };
+		std::map<std::string, owner_total> owners;
+		for (memory_allocation const& a : allocations) {
+			owner_total& t = owners[a.owner.empty() ? "(no owner)" : a.owner];
+			(a.category == memory_category::cpu_mesh ? t.cpu : t.gpu) += a.bytes;
+			t.count++;
+		}
+		ImGui::Spacing();
+		ImGui::Columns(4, "memory_owners");
+		ImGui::Text("Owner"); ImGui::NextColumn();
+		ImGui::Text("GPU"); ImGui::NextColumn();
+		ImGui::Text("CPU"); ImGui::NextColumn();
+		ImGui::Text("Allocations"); ImGui::NextColumn();
+		for (auto const& owner : owners) {
+			ImGui::Text("%s", owner.first.c_str()); ImGui::NextColumn();
+			ImGui::Text("%s", memory_size_str(owner.second.gpu).c_str()); ImGui::NextColumn();
+			ImGui::Text("%s", memory_size_str(owner.second.cpu).c_str()); ImGui::NextColumn();
+			ImGui::Text("%d", owner.second.count); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+
+		// Largest allocations
+		if (ImGui::TreeNode("Largest allocations")) {
+			std::sort(allocations.begin(), allocations.end(), [](memory_allocation const& a, memory_allocation const& b) { return a.bytes > b.bytes; });
+			ImGui::Columns(4, "memory_allocations");
+			ImGui::Text("Size"); ImGui::NextColumn();
+			ImGui::Text("Format"); ImGui::NextColumn();
+			ImGui::Text("Owner"); ImGui::NextColumn();
+			ImGui::Text("Site"); ImGui::NextColumn();
+			for (size_t k = 0; k < allocations.size() && k < 20; ++k) {
+				memory_allocation const& a = allocations[k];
+				ImGui::Text("%s%s", memory_size_str(a.bytes).c_str(), a.leaked ? " (leaked)" : ""); ImGui::NextColumn();
+				ImGui::Text("%s %s", str(a.category).c_str(), a.format.c_str()); ImGui::NextColumn();
+				ImGui::Text("%s", a.owner.c_str()); ImGui::NextColumn();
+				ImGui::Text("%s", a.site.c_str()); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+			ImGui::TreePop();
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+#include "../memory.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_memory()
+	{
+		using namespace cgp;
+		memory_totals const before = memory_total();
+
+		// Registration with an owner, and replacement of an allocation with the same key (resize)
+		{
+			memory_owner_cgp("test owner");
+			memory_register(memory_category::buffer, 1000001, 400, "vbo test", "test_memory");
+		}
+		memory_register(memory_category::buffer, 1000001, 800, "vbo test", "test_memory");
+		memory_register_texture(1000002, GL_RGBA8, 16, 8, 1, true, 16 * 8 * 4, "test_memory");
+
+		memory_totals totals = memory_total();
+		assert_cgp_no_msg(totals.category[int(memory_category::buffer)] == before.category[int(memory_category::buffer)] + 800);
+		// Mipmap chain of a 16x8 texture: 16x8 + 8x4 + 4x2 + 2x1 + 1x1 texels
+		assert_cgp_no_msg(totals.category[int(memory_category::texture)] == before.category[int(memory_category::texture)] + 4 * (128 + 32 + 8 + 2 + 1));
+
+		bool found = false;
+		for (memory_allocation const& a : memory_allocations()) {
+			if (a.category == memory_category::buffer && a.key == 1000001) {
+				assert_cgp_no_msg(a.owner == "test owner"); // Kept from the creation
+				found = true;
+			}
+		}
+		assert_cgp_no_msg(found);
+
+		// A leaked buffer stays counted, and its id can be reused by a new allocation
+		memory_mark_leaked(memory_category::buffer, 1000001);
+		memory_register(memory_category::buffer, 1000001, 100, "vbo test", "test_memory");
+		totals = memory_total();
+		assert_cgp_no_msg(totals.leaked_count == before.leaked_count + 1);
+		assert_cgp_no_msg(totals.category[int(memory_category::buffer)] == before.category[int(memory_category::buffer)] + 900);
+
+		memory_unregister(memory_category::buffer, 1000001);
+		memory_unregister(memory_category::texture, 1000002);
+
+		// CPU mesh released with its last shared pointer
+		{
+			mesh m;
+			m.position.resize(10);
+			m.connectivity.resize(4);
+			std::shared_ptr<mesh> tracked = memory_tracked_mesh(std::move(m));
+			std::shared_ptr<mesh> copy = tracked;
+			assert_cgp_no_msg(memory_total().cpu() == before.cpu() + 10 * sizeof(vec3) + 4 * sizeof(uint3));
+		}
+		assert_cgp_no_msg(memory_total().cpu() == before.cpu());
+
+		// Upload counter of the frame
+		memory_frame_begin();
+		memory_count_upload(1234);
+		memory_frame_begin();
+		assert_cgp_no_msg(memory_upload().last_frame == 1234);
+		assert_cgp_no_msg(memory_upload().peak_frame >= 1234);
+	}
+}
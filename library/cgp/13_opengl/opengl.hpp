@@ -7,5 +7,8 @@
 #include "uniform/uniform.hpp"
 #include "shaders/shaders.hpp"
 #include "texture/texture.hpp"
+#include "texture/texture_atlas.hpp"
 #include "fbo/fbo.hpp"
+#include "capture/capture.hpp"
+#include "memory/memory.hpp"
 #include "emscripten/emscripten.hpp"
\ No newline at end of file
@@ -3,13 +3,46 @@
 #include "cgp/01_base/base.hpp"
 #include "cgp/03_files/files.hpp"
 #include "cgp/13_opengl/debug/debug.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Program binary enums and function types (not part of the OpenGL 3.3 headers)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
 
 namespace cgp
 {
     // Initialization of the static variable for the cache
     cache_uniform_location_structure opengl_shader_structure::cache_uniform_location;
 
+    bool opengl_shader_binary_cache::active = true;
+    bool opengl_shader_binary_cache::available = false;
+    std::string opengl_shader_binary_cache::extension = ".cgpprog";
+    int opengl_shader_binary_cache::hit_count = 0;
+    int opengl_shader_binary_cache::miss_count = 0;
+    float opengl_shader_binary_cache::load_time = 0.0f;
+
+    float opengl_shader_hot_reload::period = 0.25f;
+    int opengl_shader_hot_reload::reload_count = 0;
+    float opengl_shader_hot_reload::last_reload_time = 0.0f;
+    float opengl_shader_hot_reload::last_reload_latency = 0.0f;
+
+    static void opengl_shader_hot_reload_register(GLuint id, std::string const& vertex_shader_path, std::string const& fragment_shader_path, bool adapt_opengles);
+
 
     /** Load and compile shaders from glsl file sources
     * Display warnings and errors if the file cannot be accessed.
@@ -43,7 +76,11 @@ namespace cgp
 
     void opengl_shader_structure::load(std::string const& vertex_shader_path, std::string const& fragment_shader_path, bool adapt_opengles)
     {
+        auto const start = std::chrono::steady_clock::now();
         id = opengl_load_shader(vertex_shader_path, fragment_shader_path, adapt_opengles);
+        opengl_shader_binary_cache::load_time += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+        opengl_shader_hot_reload_register(id, vertex_shader_path, fragment_shader_path, adapt_opengles);
     }
 
     void opengl_shader_structure::load_from_inline_text(std::string const& vertex_shader_text, std::string const& fragment_shader_text, bool* load_shader_ok)
@@ -72,6 +109,10 @@ namespace cgp
     {
         cache_uniform_location.cache_data.clear();
     }
+    void opengl_shader_structure::invalidate_cache_uniform_location(GLuint shader_id)
+    {
+        cache_uniform_location.cache_data.erase(shader_id);
+    }
     std::string opengl_shader_structure::debug_dump_cache_uniform_location()
     {
         return str(cache_uniform_location);
@@ -150,7 +191,166 @@ namespace cgp
     }
 
 
-    
+
+    // ****************************************** //
+    // Program binary cache
+    // ****************************************** //
+
+#ifndef __EMSCRIPTEN__
+    typedef void (APIENTRY *opengl_get_program_binary_proc)(GLuint program, GLsizei buffer_size, GLsizei* length, GLenum* binary_format, void* binary);
+    typedef void (APIENTRY *opengl_program_binary_proc)(GLuint program, GLenum binary_format, const void* binary, GLsizei length);
+    typedef void (APIENTRY *opengl_program_parameteri_proc)(GLuint program, GLenum pname, GLint value);
+
+    static opengl_get_program_binary_proc opengl_get_program_binary = nullptr;
+    static opengl_program_binary_proc opengl_program_binary = nullptr;
+    static opengl_program_parameteri_proc opengl_program_parameteri = nullptr;
+
+    void opengl_shader_binary_cache_initialize(GLADloadproc loader)
+    {
+        opengl_get_program_binary = reinterpret_cast<opengl_get_program_binary_proc>(loader("glGetProgramBinary"));
+        opengl_program_binary = reinterpret_cast<opengl_program_binary_proc>(loader("glProgramBinary"));
+        opengl_program_parameteri = reinterpret_cast<opengl_program_parameteri_proc>(loader("glProgramParameteri"));
+
+        // Some drivers expose the functions but no binary format
+        GLint N_format = 0;
+        if (opengl_get_program_binary != nullptr)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &N_format);
+        glGetError(); // Clear a possible error from the query
+
+        opengl_shader_binary_cache::available = opengl_get_program_binary != nullptr && opengl_program_binary != nullptr && opengl_program_parameteri != nullptr && N_format > 0;
+    }
+#endif
+
+    static bool opengl_shader_binary_cache_usable()
+    {
+        return opengl_shader_binary_cache::active && opengl_shader_binary_cache::available;
+    }
+
+    // FNV-1a hash
+    static uint64_t opengl_shader_hash(std::string const& text, uint64_t hash = 14695981039346656037ULL)
+    {
+        for (char c : text) {
+            hash ^= uint64_t(static_cast<unsigned char>(c));
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static std::string opengl_gl_string(GLenum name)
+    {
+        char const* value = reinterpret_cast<char const*>(glGetString(name));
+        return value != nullptr ? std::string(value) : std::string();
+    }
+
+    static std::string opengl_shader_binary_cache_filename(std::string const& vertex_shader_path, std::string const& fragment_shader_path)
+    {
+        static char const hex[] = "0123456789abcdef";
+        uint64_t const hash = opengl_shader_hash(fragment_shader_path);
+        std::string hash_txt;
+        for (int k = 0; k < 8; ++k)
+            hash_txt += hex[(hash >> (60 - 4 * k)) & 0xF];
+        return vertex_shader_path + "." + hash_txt + opengl_shader_binary_cache::extension;
+    }
+
+    // The key identifies the sources and the driver that produced a binary
+    static uint64_t opengl_shader_binary_cache_key(std::string const& vertex_shader_text, std::string const& fragment_shader_text)
+    {
+        uint64_t hash = opengl_shader_hash(vertex_shader_text);
+        hash = opengl_shader_hash(std::string(1, '\0') + fragment_shader_text, hash);
+        hash = opengl_shader_hash(std::string(1, '\0') + opengl_gl_string(GL_VENDOR) + opengl_gl_string(GL_RENDERER) + opengl_gl_string(GL_VERSION), hash);
+        return hash;
+    }
+
+    // File layout: "CGPS", version (uint32), key (uint64), binary format (uint32), binary length (uint32), binary
+    struct opengl_shader_binary_header {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    // Returns 0 if the cached program is missing, outdated or rejected by the driver
+    static GLuint opengl_shader_binary_cache_load(std::string const& filename, uint64_t key)
+    {
+#ifndef __EMSCRIPTEN__
+        if (!opengl_shader_binary_cache_usable())
+            return 0;
+
+        std::ifstream stream(filename, std::ios::binary);
+        if (!stream.is_open())
+            return 0;
+        opengl_shader_binary_header header;
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return 0;
+        if (std::string(header.magic, 4) != "CGPS" || header.version != 1 || header.key != key || header.length == 0)
+            return 0;
+        std::vector<char> binary(header.length);
+        if (!stream.read(binary.data(), std::streamsize(binary.size())))
+            return 0;
+
+        GLuint const program_id = glCreateProgram();
+        opengl_program_binary(program_id, GLenum(header.format), binary.data(), GLsizei(binary.size()));
+        GLint is_linked = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &is_linked);
+        if (is_linked == GL_FALSE) {
+            // Ex. the driver was updated without changing its version string
+            glDeleteProgram(program_id);
+            glGetError();
+            return 0;
+        }
+        return program_id;
+#else
+        return 0;
+#endif
+    }
+
+    // To be called before linking a program that will be saved in the cache
+    static void opengl_shader_binary_cache_prepare(GLuint program_id)
+    {
+#ifndef __EMSCRIPTEN__
+        if (opengl_shader_binary_cache_usable())
+            opengl_program_parameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+    }
+
+    static void opengl_shader_binary_cache_save(std::string const& filename, uint64_t key, GLuint program_id)
+    {
+#ifndef __EMSCRIPTEN__
+        if (!opengl_shader_binary_cache_usable())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        opengl_get_program_binary(program_id, length, &written, &format, binary.data());
+        if (written <= 0)
+            return;
+
+        opengl_shader_binary_header const header = { {'C','G','P','S'}, 1, key, uint32_t(format), uint32_t(written) };
+        std::ofstream stream(filename, std::ios::binary);
+        if (!stream.is_open())
+            return; // Read-only directory: the shaders are compiled at each launch
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        stream.write(binary.data(), written);
+#endif
+    }
+
+    std::string opengl_shader_binary_cache_statistics()
+    {
+        int const N = opengl_shader_binary_cache::hit_count + opengl_shader_binary_cache::miss_count;
+        std::string s = str(N) + " programs loaded in " + str(int(1000 * opengl_shader_binary_cache::load_time)) + "ms";
+        s += " (" + str(opengl_shader_binary_cache::hit_count) + " from the binary cache, " + str(opengl_shader_binary_cache::miss_count) + " compiled)";
+        if (!opengl_shader_binary_cache::available)
+            s += " - program binaries not supported by the driver";
+        return s;
+    }
+
+
 	GLuint opengl_load_shader_from_text(std::string const& vertex_shader_txt, std::string const& fragment_shader_txt, bool* load_shader_ok)
 	{
         GLuint vertex_shader_id; 
@@ -237,6 +437,17 @@ namespace cgp
         
 
 
+        // Use the program stored in the binary cache if it was produced from the same sources by the same driver
+        std::string const cache_filename = opengl_shader_binary_cache_filename(vertex_shader_path, fragment_shader_path);
+        uint64_t const cache_key = opengl_shader_binary_cache_usable() ? opengl_shader_binary_cache_key(vertex_shader_text, fragment_shader_text) : 0;
+        GLuint const cached_program_id = opengl_shader_binary_cache_load(cache_filename, cache_key);
+        if (cached_program_id != 0) {
+            opengl_shader_binary_cache::hit_count++;
+            std::cout << "  [info] Shader loaded from the binary cache [ID=" + str(cached_program_id) + "]\n         (" + vertex_shader_path + ", " + fragment_shader_path + ")\n" << std::endl;
+            return cached_program_id;
+        }
+
+
         // Compile the programs
         GLuint vertex_shader_id   = 0; 
         bool const vertex_shader_valid   = compile_shader(GL_VERTEX_SHADER  , vertex_shader_text  , vertex_shader_id);
@@ -267,6 +478,7 @@ namespace cgp
         glAttachShader(program_id, fragment_shader_id);
 
         // Link Program
+        opengl_shader_binary_cache_prepare(program_id);
         glLinkProgram(program_id);
 
         bool const shader_program_valid = check_link(vertex_shader_id, fragment_shader_id, program_id);
@@ -280,6 +492,9 @@ namespace cgp
         glDetachShader(program_id, vertex_shader_id);
         glDetachShader(program_id, fragment_shader_id);
 
+        opengl_shader_binary_cache::miss_count++;
+        opengl_shader_binary_cache_save(cache_filename, cache_key, program_id);
+
 
         // Debug info
         std::string msg = "  [info] Shader compiled succesfully [ID=" + str(program_id) + "]\n";
@@ -290,4 +505,187 @@ namespace cgp
     }
 
 
+    // ****************************************** //
+    // Hot reload
+    // ****************************************** //
+
+    namespace
+    {
+        struct shader_source_record {
+            GLuint id = 0;
+            std::string vertex_shader_path;
+            std::string fragment_shader_path;
+            bool adapt_opengles = true;
+            long long vertex_time = 0;
+            long long fragment_time = 0;
+            bool changed = false;
+            std::chrono::steady_clock::time_point change_time;
+        };
+
+        // Shaders loaded from files, and the thread polling their modification time
+        struct shader_watcher {
+            std::vector<shader_source_record> records;
+            std::mutex mutex;
+            std::thread thread;
+            std::atomic<bool> running{ false };
+
+            ~shader_watcher() { stop(); }
+            void stop() {
+                running = false;
+                if (thread.joinable())
+                    thread.join();
+            }
+            void poll() {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (shader_source_record& record : records) {
+                    long long const vertex_time = file_get_modification_time(record.vertex_shader_path);
+                    long long const fragment_time = file_get_modification_time(record.fragment_shader_path);
+                    if (vertex_time != record.vertex_time || fragment_time != record.fragment_time) {
+                        record.vertex_time = vertex_time;
+                        record.fragment_time = fragment_time;
+                        if (!record.changed)
+                            record.change_time = std::chrono::steady_clock::now();
+                        record.changed = true;
+                    }
+                }
+            }
+        };
+
+        shader_watcher& shader_watcher_instance()
+        {
+            static shader_watcher watcher;
+            return watcher;
+        }
+    }
+
+    static void opengl_shader_hot_reload_register(GLuint id, std::string const& vertex_shader_path, std::string const& fragment_shader_path, bool adapt_opengles)
+    {
+        shader_source_record record;
+        record.id = id;
+        record.vertex_shader_path = vertex_shader_path;
+        record.fragment_shader_path = fragment_shader_path;
+        record.adapt_opengles = adapt_opengles;
+        record.vertex_time = file_get_modification_time(vertex_shader_path);
+        record.fragment_time = file_get_modification_time(fragment_shader_path);
+
+        shader_watcher& watcher = shader_watcher_instance();
+        std::lock_guard<std::mutex> lock(watcher.mutex);
+        watcher.records.push_back(record);
+    }
+
+    void opengl_shader_hot_reload_start()
+    {
+        shader_watcher& watcher = shader_watcher_instance();
+        if (watcher.running)
+            return;
+        watcher.stop();
+        watcher.running = true;
+        watcher.thread = std::thread([&watcher]() {
+            while (watcher.running) {
+                watcher.poll();
+                // Sleep by small steps to stop quickly
+                auto const wake_up = std::chrono::steady_clock::now() + std::chrono::microseconds(int(1e6f * opengl_shader_hot_reload::period));
+                while (watcher.running && std::chrono::steady_clock::now() < wake_up)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+    }
+
+    void opengl_shader_hot_reload_stop()
+    {
+        shader_watcher_instance().stop();
+    }
+
+    bool opengl_shader_hot_reload_is_running()
+    {
+        return shader_watcher_instance().running;
+    }
+
+    // Re-link the program in place with new sources. The sources are first validated on a temporary program, so that the current program is kept on error.
+    static bool opengl_relink_program(GLuint program_id, std::string const& vertex_shader_text, std::string const& fragment_shader_text)
+    {
+        GLuint vertex_shader_id = 0;
+        GLuint fragment_shader_id = 0;
+        bool const vertex_ok = compile_shader(GL_VERTEX_SHADER, vertex_shader_text, vertex_shader_id);
+        bool const fragment_ok = compile_shader(GL_FRAGMENT_SHADER, fragment_shader_text, fragment_shader_id);
+        if (!vertex_ok || !fragment_ok) {
+            if (vertex_ok) glDeleteShader(vertex_shader_id);
+            if (fragment_ok) glDeleteShader(fragment_shader_id);
+            return false;
+        }
+
+        GLuint const test_program_id = glCreateProgram();
+        glAttachShader(test_program_id, vertex_shader_id);
+        glAttachShader(test_program_id, fragment_shader_id);
+        glLinkProgram(test_program_id);
+        if (!check_link(vertex_shader_id, fragment_shader_id, test_program_id))
+            return false;
+        glDetachShader(test_program_id, vertex_shader_id);
+        glDetachShader(test_program_id, fragment_shader_id);
+        glDeleteProgram(test_program_id);
+
+        glAttachShader(program_id, vertex_shader_id);
+        glAttachShader(program_id, fragment_shader_id);
+        opengl_shader_binary_cache_prepare(program_id);
+        glLinkProgram(program_id);
+        glDetachShader(program_id, vertex_shader_id);
+        glDetachShader(program_id, fragment_shader_id);
+        glDeleteShader(vertex_shader_id);
+        glDeleteShader(fragment_shader_id);
+
+        GLint is_linked = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &is_linked);
+        return is_linked == GL_TRUE;
+    }
+
+    int opengl_shader_hot_reload_update()
+    {
+        std::vector<shader_source_record> modified;
+        {
+            shader_watcher& watcher = shader_watcher_instance();
+            std::lock_guard<std::mutex> lock(watcher.mutex);
+            for (shader_source_record& record : watcher.records) {
+                if (record.changed) {
+                    modified.push_back(record);
+                    record.changed = false;
+                }
+            }
+        }
+
+        int N_reload = 0;
+        for (shader_source_record const& record : modified) {
+            // The file may be missing while the editor saves it: it is reloaded at its next modification
+            if (!check_file_exist(record.vertex_shader_path) || !check_file_exist(record.fragment_shader_path))
+                continue;
+
+            auto const start = std::chrono::steady_clock::now();
+            std::string vertex_shader_text = read_text_file(record.vertex_shader_path);
+            std::string fragment_shader_text = read_text_file(record.fragment_shader_path);
+#ifdef __EMSCRIPTEN__
+            if (record.adapt_opengles) {
+                replace_header_for_opengles(vertex_shader_text);
+                replace_header_for_opengles(fragment_shader_text);
+            }
+#endif
+            if (!opengl_relink_program(record.id, vertex_shader_text, fragment_shader_text)) {
+                std::cout << "  [hot reload] Failed to reload (" << record.vertex_shader_path << ", " << record.fragment_shader_path << "), the previous version is kept\n" << std::endl;
+                continue;
+            }
+
+            // The uniform locations may have changed
+            opengl_shader_structure::invalidate_cache_uniform_location(record.id);
+            if (opengl_shader_binary_cache_usable())
+                opengl_shader_binary_cache_save(opengl_shader_binary_cache_filename(record.vertex_shader_path, record.fragment_shader_path), opengl_shader_binary_cache_key(vertex_shader_text, fragment_shader_text), record.id);
+
+            auto const end = std::chrono::steady_clock::now();
+            opengl_shader_hot_reload::last_reload_time = std::chrono::duration<float>(end - start).count();
+            opengl_shader_hot_reload::last_reload_latency = std::chrono::duration<float>(end - record.change_time).count();
+            opengl_shader_hot_reload::reload_count++;
+            N_reload++;
+            std::cout << "  [hot reload] Shader reloaded [ID=" << record.id << "] in " << int(1000 * opengl_shader_hot_reload::last_reload_time) << "ms (" << int(1000 * opengl_shader_hot_reload::last_reload_latency) << "ms after the modification)\n"
+                << "         (" << record.vertex_shader_path << ", " << record.fragment_shader_path << ")" << std::endl;
+        }
+        return N_reload;
+    }
+
 }
\ No newline at end of file
@@ -35,6 +35,8 @@ namespace cgp
 
 		// Clear the cache system
 		void clear_cache_uniform_location();
+		// Remove the locations of a single shader from the cache (ex. after the program is re-linked)
+		static void invalidate_cache_uniform_location(GLuint shader_id);
 
 		// Debug information of the current cache storage between uniform name and location
 		static std::string debug_dump_cache_uniform_location();
@@ -49,6 +51,43 @@ namespace cgp
 	};
 
 
+	// Cache of the linked programs loaded with opengl_shader_structure::load (glGetProgramBinary/glProgramBinary)
+	//  The binary is stored next to the vertex shader file (vertex_shader_path.<hash of the fragment path>.cgpprog).
+	//  It is used only if it was produced from the same sources by the same driver (GL_VENDOR, GL_RENDERER, GL_VERSION),
+	//  otherwise - or if the driver rejects it - the shaders are compiled and the cached file is rewritten.
+	struct opengl_shader_binary_cache {
+		static bool active;
+		static bool available;        // Set by opengl_shader_binary_cache_initialize if the driver supports program binaries
+		static std::string extension;
+		static int hit_count;         // Programs loaded from the cache
+		static int miss_count;        // Programs compiled from the sources
+		static float load_time;       // Total time spent in opengl_shader_structure::load (s)
+	};
+#ifndef __EMSCRIPTEN__
+	// Retrieve the program binary functions (OpenGL 4.1 or GL_ARB_get_program_binary) using the loader, once the context is current and GLAD is loaded
+	void opengl_shader_binary_cache_initialize(GLADloadproc loader);
+#endif
+	std::string opengl_shader_binary_cache_statistics();
+
+
+	// Hot reload of the shaders loaded with opengl_shader_structure::load
+	//  A watcher thread polls the modification time of the shader files. The modified programs are recompiled by opengl_shader_hot_reload_update,
+	//  to be called between two frames on the thread owning the OpenGL context.
+	//  The program is re-linked in place (same id), so that all the copies of the opengl_shader_structure (ex. in the mesh_drawable) use the new version.
+	//  If the new version fails to compile or link, the errors are displayed and the previous program is kept.
+	struct opengl_shader_hot_reload {
+		static float period;              // Polling period of the watcher (s)
+		static int reload_count;
+		static float last_reload_time;    // Time to recompile and swap the last reloaded program (s)
+		static float last_reload_latency; // Time between the detection of the modification and the swap (s)
+	};
+	void opengl_shader_hot_reload_start();
+	void opengl_shader_hot_reload_stop();
+	bool opengl_shader_hot_reload_is_running();
+	// Returns the number of reloaded programs
+	int opengl_shader_hot_reload_update();
+
+
 
 
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "cgp/01_base/base.hpp"
+#include "../texture_atlas.hpp"
+
+#include <vector>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_texture_atlas()
+	{
+		// Images of different sizes filled with a distinct color, with a marked pixel in the corner (0,0)
+		std::vector<cgp::image_structure> images(3);
+		int const size[3][2] = { {100,60}, {37,37}, {64,128} };
+		for (int k = 0; k < 3; ++k) {
+			images[k].width = size[k][0];
+			images[k].height = size[k][1];
+			images[k].color_type = cgp::image_color_type::rgb;
+			images[k].data.resize(3 * size[k][0] * size[k][1]);
+			for (int i = 0; i < size[k][0] * size[k][1]; ++i) {
+				images[k].data[3 * i + 0] = (unsigned char)(50 * (k + 1));
+				images[k].data[3 * i + 1] = 0;
+				images[k].data[3 * i + 2] = 0;
+			}
+			images[k].data[1] = 255;
+		}
+		std::vector<cgp::image_view> views(images.begin(), images.end());
+
+		int const padding = 8;
+		cgp::texture_atlas_image const atlas = cgp::texture_atlas_pack(views, padding);
+		int const S = atlas.image.width;
+		assert_cgp_no_msg(atlas.image.height == S);
+		assert_cgp_no_msg((S & (S - 1)) == 0);
+		assert_cgp_no_msg(atlas.max_level == 3);
+		assert_cgp_no_msg(atlas.region.size() == 3);
+
+		for (int k = 0; k < 3; ++k) {
+			cgp::texture_atlas_region const& r = atlas.region[k];
+			assert_cgp_no_msg(r.width == size[k][0] && r.height == size[k][1]);
+			assert_cgp_no_msg(r.x >= padding && r.y >= padding && r.x + r.width + padding <= S && r.y + r.height + padding <= S);
+
+			// Padded blocks are aligned on the padding, and do not overlap
+			assert_cgp_no_msg((r.x - padding) % padding == 0 && (r.y - padding) % padding == 0);
+			for (int j = 0; j < k; ++j) {
+				cgp::texture_atlas_region const& q = atlas.region[j];
+				bool const separated = r.x + r.width + padding <= q.x - padding || q.x + q.width + padding <= r.x - padding
+					|| r.y + r.height + padding <= q.y - padding || q.y + q.height + padding <= r.y - padding;
+				assert_cgp_no_msg(separated);
+			}
+
+			// uv rectangle
+			assert_cgp_no_msg(std::abs(r.uv_min.x * S - r.x) < 1e-3f && std::abs(r.uv_max.y * S - (r.y + r.height)) < 1e-3f);
+
+			// Content, and border replicated in the padding (rgb converted to rgba)
+			auto pixel = [&](int x, int y) { return &atlas.image.data[4 * (y * S + x)]; };
+			assert_cgp_no_msg(pixel(r.x + 1, r.y + 1)[0] == 50 * (k + 1) && pixel(r.x + 1, r.y + 1)[3] == 255);
+			assert_cgp_no_msg(pixel(r.x - padding, r.y - padding)[1] == 255);
+			assert_cgp_no_msg(pixel(r.x + r.width + padding - 1, r.y + r.height + padding - 1)[0] == 50 * (k + 1));
+		}
+
+		// Padding is rounded to a power of two
+		assert_cgp_no_msg(cgp::texture_atlas_pack(views, 5).max_level == 3);
+	}
+}
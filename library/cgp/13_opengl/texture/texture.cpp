@@ -1,6 +1,9 @@
 #include "texture.hpp"
 
 #include "cgp/01_base/base.hpp"
+#include "../memory/memory.hpp"
+
+#include <algorithm>
 
 namespace cgp
 {
@@ -69,6 +72,77 @@ namespace cgp
         return id;
     }
 
+    // Upload the level 0 of a texture target from an image view
+    static void opengl_tex_image_2d_view(GLenum target, GLint format, image_view const& im)
+    {
+        GLenum const gl_format = format_to_data_type(format);
+        GLenum const gl_component = format_to_component(format);
+
+        if (im.is_region()) {
+            // The region is read directly in the source image
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, im.row_length); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, im.offset_x); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, im.offset_y); opengl_check;
+            glTexImage2D(target, 0, format, im.width, im.height, 0, gl_format, gl_component, im.data); opengl_check;
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, 0); opengl_check;
+        }
+        else if (!im.transposed && !im.mirror_horizontal) {
+            // Vertical mirror: rows are uploaded one by one in reverse order
+            glTexImage2D(target, 0, format, im.width, im.height, 0, gl_format, gl_component, nullptr); opengl_check;
+            for (int y = 0; y < im.height; ++y) {
+                glTexSubImage2D(target, 0, 0, y, im.width, 1, gl_format, gl_component, im.pixel(0, y)); opengl_check;
+            }
+        }
+        else {
+            image_structure const copy = im.to_image();
+            glTexImage2D(target, 0, format, im.width, im.height, 0, gl_format, gl_component, ptr(copy.data)); opengl_check;
+        }
+    }
+
+    // Upload a layer of a GL_TEXTURE_2D_ARRAY from an image view (same strategy as opengl_tex_image_2d_view)
+    static void opengl_tex_sub_image_layer_view(int layer, GLint format, image_view const& im)
+    {
+        GLenum const gl_format = format_to_data_type(format);
+        GLenum const gl_component = format_to_component(format);
+
+        if (im.is_region()) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, im.row_length); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, im.offset_x); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, im.offset_y); opengl_check;
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, im.width, im.height, 1, gl_format, gl_component, im.data); opengl_check;
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0); opengl_check;
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, 0); opengl_check;
+        }
+        else if (!im.transposed && !im.mirror_horizontal) {
+            for (int y = 0; y < im.height; ++y) {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, y, layer, im.width, 1, 1, gl_format, gl_component, im.pixel(0, y)); opengl_check;
+            }
+        }
+        else {
+            image_structure const copy = im.to_image();
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, im.width, im.height, 1, gl_format, gl_component, ptr(copy.data)); opengl_check;
+        }
+    }
+
+    // Record the texture in the memory registry. The data sent is the level 0 of each layer (the mipmaps are generated on the GPU).
+    static void texture_memory_register(opengl_texture_image_structure const& texture, int layer_count, bool is_mipmap, bool has_data, char const* site)
+    {
+        size_t const upload_bytes = has_data ? memory_texel_size(texture.format) * size_t(texture.width) * size_t(texture.height) * layer_count : 0;
+        memory_register_texture(texture.id, texture.format, texture.width, texture.height, layer_count, is_mipmap, upload_bytes, site);
+    }
+
+    // Sum of the levels of a baked image uploaded to the GPU
+    static size_t baked_upload_bytes(image_baked const& im, GLint format, int level_count)
+    {
+        size_t bytes = 0;
+        for (int level = 0; level < level_count; ++level)
+            bytes += memory_texel_size(format) * size_t(im.level_width(level)) * size_t(im.level_height(level));
+        return bytes * im.face_count;
+    }
+
     void opengl_texture_image_structure::bind() const
     {
         assert_cgp(id!=0, "Incorrect texture id");
@@ -81,6 +155,7 @@ namespace cgp
     void opengl_texture_image_structure::clear()
     {
         assert_cgp(id != 0, "Cannot clear texture, ID=0");
+        memory_unregister(memory_category::texture, id);
         glDeleteTextures(1, &id);
         *this = opengl_texture_image_structure();
     }
@@ -88,8 +163,8 @@ namespace cgp
     void opengl_texture_image_structure::update_wrap(GLint wrap_s, GLint wrap_t) const
     {
         bind();
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
         unbind();
     }
 
@@ -103,14 +178,158 @@ namespace cgp
 
         // Initialize texture data on GPU
         id = opengl_initialize_texture_2d_on_gpu(width, height, ptr(im.data), wrap_s, wrap_t, texture_type, format, format_to_data_type(format), format_to_component(format), is_mipmap, texture_mag_filter, texture_min_filter);
+        texture_memory_register(*this, 1, is_mipmap, true, __func__);
+    }
+
+    void opengl_texture_image_structure::initialize_texture_2d_on_gpu(image_view const& im, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
+    {
+        // Store parameters
+        width = im.width;
+        height = im.height;
+        format = (im.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_2D;
+
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+
+        opengl_tex_image_2d_view(texture_type, format, im);
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        if (is_mipmap) {
+            glGenerateMipmap(texture_type); opengl_check;
+        }
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, texture_mag_filter); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+        texture_memory_register(*this, 1, is_mipmap, true, __func__);
     }
 
     void opengl_texture_image_structure::load_and_initialize_texture_2d_on_gpu(std::string const& filename, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
     {
+        if (image_baked_cache::active) {
+            image_baked const im = image_load_file_baked(filename, is_mipmap);
+            initialize_texture_2d_on_gpu(im, wrap_s, wrap_t, is_mipmap, texture_mag_filter, texture_min_filter);
+            return;
+        }
+
         image_structure const im = image_load_file(filename);
         initialize_texture_2d_on_gpu(im, wrap_s, wrap_t, is_mipmap, texture_mag_filter, texture_min_filter);
     }
 
+    void opengl_texture_image_structure::initialize_texture_2d_on_gpu(image_baked const& im, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
+    {
+        assert_cgp(im.face_count == 1, "Baked image should have a single face to be used as a 2D texture");
+
+        // Store parameters
+        width = im.width;
+        height = im.height;
+        format = (im.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_2D;
+
+        GLenum const gl_format = format_to_data_type(format);
+        GLenum const gl_component = format_to_component(format);
+
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+
+        int const N_level = is_mipmap ? im.level_count : 1;
+        for (int level = 0; level < N_level; ++level) {
+            glTexImage2D(texture_type, level, format, im.level_width(level), im.level_height(level), 0, gl_format, gl_component, im.level_data(0, level)); opengl_check;
+        }
+        glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, N_level - 1); opengl_check;
+        if (is_mipmap && N_level == 1) { // Baked without mipmap
+            glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, 1000); opengl_check;
+            glGenerateMipmap(texture_type); opengl_check;
+        }
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, texture_mag_filter); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+        memory_register_texture(id, format, width, height, 1, is_mipmap, baked_upload_bytes(im, format, N_level), __func__);
+    }
+
+    void opengl_texture_image_structure::initialize_texture_2d_array_on_gpu(std::vector<image_view> const& layers, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
+    {
+        assert_cgp(layers.size() > 0, "Texture array should have at least one layer");
+        image_view const& first = layers[0];
+        for (image_view const& layer : layers) {
+            assert_cgp(layer.width == first.width && layer.height == first.height && layer.color_type == first.color_type, "All the layers of a texture array should have the same size and color type");
+        }
+
+        width = first.width;
+        height = first.height;
+        layer_count = int(layers.size());
+        format = (first.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_2D_ARRAY;
+
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+
+        glTexImage3D(texture_type, 0, format, width, height, layer_count, 0, format_to_data_type(format), format_to_component(format), nullptr); opengl_check;
+        for (int layer = 0; layer < layer_count; ++layer)
+            opengl_tex_sub_image_layer_view(layer, format, layers[layer]);
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        if (is_mipmap) {
+            glGenerateMipmap(texture_type); opengl_check;
+        }
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, texture_mag_filter); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+        texture_memory_register(*this, layer_count, is_mipmap, true, __func__);
+    }
+
+    void opengl_texture_image_structure::initialize_texture_2d_array_on_gpu(std::vector<image_baked> const& layers, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
+    {
+        assert_cgp(layers.size() > 0, "Texture array should have at least one layer");
+        image_baked const& first = layers[0];
+        int N_level = is_mipmap ? first.level_count : 1;
+        for (image_baked const& layer : layers) {
+            assert_cgp(layer.face_count == 1, "Baked image should have a single face to be used as a layer of a texture array");
+            assert_cgp(layer.width == first.width && layer.height == first.height && layer.color_type == first.color_type, "All the layers of a texture array should have the same size and color type");
+            N_level = std::min(N_level, layer.level_count);
+        }
+
+        width = first.width;
+        height = first.height;
+        layer_count = int(layers.size());
+        format = (first.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_2D_ARRAY;
+
+        GLenum const gl_format = format_to_data_type(format);
+        GLenum const gl_component = format_to_component(format);
+
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+
+        for (int level = 0; level < N_level; ++level) {
+            glTexImage3D(texture_type, level, format, first.level_width(level), first.level_height(level), layer_count, 0, gl_format, gl_component, nullptr); opengl_check;
+            for (int layer = 0; layer < layer_count; ++layer) {
+                glTexSubImage3D(texture_type, level, 0, 0, layer, first.level_width(level), first.level_height(level), 1, gl_format, gl_component, layers[layer].level_data(0, level)); opengl_check;
+            }
+        }
+        glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, N_level - 1); opengl_check;
+        if (is_mipmap && N_level == 1) { // Baked without mipmap
+            glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, 1000); opengl_check;
+            glGenerateMipmap(texture_type); opengl_check;
+        }
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, texture_mag_filter); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+        memory_register_texture(id, format, width, height, layer_count, is_mipmap, baked_upload_bytes(first, format, N_level) * layer_count, __func__);
+    }
+
     void opengl_texture_image_structure::initialize_texture_2d_on_gpu(grid_2D<vec3> const& im, GLint wrap_s, GLint wrap_t, bool is_mippmap, GLint texture_mag_filter, GLint texture_min_filter)
     {
         // Store parameters
@@ -123,6 +342,7 @@ namespace cgp
         id = opengl_initialize_texture_2d_on_gpu(width, height, ptr(im.data),
             wrap_s, wrap_t, texture_type, format, format_to_data_type(format), format_to_component(format),
             is_mippmap, texture_mag_filter, texture_min_filter);
+        texture_memory_register(*this, 1, is_mippmap, true, __func__);
 
     }
 
@@ -138,6 +358,7 @@ namespace cgp
         id = opengl_initialize_texture_2d_on_gpu(width, height, (void*)NULL,
             wrap_s, wrap_t, texture_type, format, format_to_data_type(format), format_to_component(format),
             false, texture_mag_filter, texture_min_filter);
+        texture_memory_register(*this, 1, false, false, __func__);
 
     }
 
@@ -186,6 +407,73 @@ namespace cgp
 
 
         glBindTexture(texture_type, 0);
+        texture_memory_register(*this, 6, false, true, __func__);
+    }
+
+
+    void opengl_texture_image_structure::initialize_cubemap_on_gpu(image_view const& x_neg, image_view const& x_pos, image_view const& y_neg, image_view const& y_pos, image_view const& z_neg, image_view const& z_pos)
+    {
+        int const h = x_neg.width;
+        width = h;
+        height = h;
+        format = (x_neg.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_CUBE_MAP;
+
+        image_view const* faces[6] = { &x_neg, &x_pos, &y_neg, &y_pos, &z_neg, &z_pos };
+        for (image_view const* face : faces) {
+            assert_cgp(face->width == h && face->height == h && face->color_type == x_neg.color_type, "Cubemap faces should be squared images of the same size and color type");
+        }
+
+        glGenTextures(1, &id);
+        glBindTexture(texture_type, id);
+
+        GLenum const face_target[6] = { GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, GL_TEXTURE_CUBE_MAP_POSITIVE_Z };
+        for (int face = 0; face < 6; ++face)
+            opengl_tex_image_2d_view(face_target[face], format, *faces[face]);
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+        glBindTexture(texture_type, 0);
+        texture_memory_register(*this, 6, false, true, __func__);
+    }
+
+    void opengl_texture_image_structure::initialize_cubemap_on_gpu(image_baked const& im)
+    {
+        assert_cgp(im.face_count == 6, "Baked image should have 6 faces to be used as a cubemap");
+        assert_cgp_no_msg(im.width == im.height);
+
+        width = im.width;
+        height = im.height;
+        format = (im.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_CUBE_MAP;
+
+        GLenum const gl_format = format_to_data_type(format);
+        GLenum const gl_component = format_to_component(format);
+
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+
+        GLenum const face_target[6] = { GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, GL_TEXTURE_CUBE_MAP_POSITIVE_Z };
+        for (int face = 0; face < 6; ++face)
+            for (int level = 0; level < im.level_count; ++level) {
+                glTexImage2D(face_target[face], level, format, im.level_width(level), im.level_height(level), 0, gl_format, gl_component, im.level_data(face, level)); opengl_check;
+            }
+        glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, im.level_count - 1); opengl_check;
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE); opengl_check;
+
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, im.level_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+        memory_register_texture(id, format, width, height, 6, im.level_count > 1, baked_upload_bytes(im, format, im.level_count), __func__);
     }
 
 
@@ -195,6 +483,7 @@ namespace cgp
 
         glBindTexture(texture_type, id);
         glTexSubImage2D(texture_type, 0, 0, 0, GLsizei(im.dimension.x), GLsizei(im.dimension.y), format_to_data_type(format), format_to_component(format), ptr(im.data));
+        memory_count_upload(size_in_memory(im.data));
         glGenerateMipmap(texture_type);
         glBindTexture(texture_type, 0);
     }
@@ -205,6 +494,7 @@ namespace cgp
 
         glBindTexture(texture_type, id);
         glTexSubImage2D(texture_type, 0, 0, 0, GLsizei(im.width), GLsizei(im.height), format_to_data_type(format), format_to_component(format), ptr(im.data));
+        memory_count_upload(size_in_memory(im.data));
         glGenerateMipmap(texture_type);
         glBindTexture(texture_type, 0);
     }
@@ -243,6 +533,8 @@ namespace cgp
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, im.width, im.height, 0, GL_RGB, GL_UNSIGNED_BYTE, ptr(im.data)); opengl_check;
         }
         glGenerateMipmap(GL_TEXTURE_2D); opengl_check;
+        GLint const format = (im.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        memory_register_texture(id, format, im.width, im.height, 1, true, memory_texel_size(format) * size_t(im.width) * size_t(im.height), __func__);
 
         // Set default texture behavior
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
@@ -264,6 +556,7 @@ namespace cgp
         // Send texture on GPU
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, GLsizei(im.dimension.x), GLsizei(im.dimension.y), 0, GL_RGB, GL_FLOAT, ptr(im.data)); opengl_check;
         glGenerateMipmap(GL_TEXTURE_2D);
+        memory_register_texture(id, GL_RGB32F, int(im.dimension.x), int(im.dimension.y), 1, true, size_in_memory(im.data), __func__);
 
         // Set default texture behavior
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
@@ -282,6 +575,7 @@ namespace cgp
 
         glBindTexture(GL_TEXTURE_2D, texture_id);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0,0, GLsizei(im.dimension.x), GLsizei(im.dimension.y), GL_RGB, GL_FLOAT, ptr(im.data));
+        memory_count_upload(size_in_memory(im.data));
         glGenerateMipmap(GL_TEXTURE_2D);
         glBindTexture(GL_TEXTURE_2D,0);
     }
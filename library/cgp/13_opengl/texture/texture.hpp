@@ -20,7 +20,9 @@ namespace cgp
 
 		GLint format; // GL_RGB8, GL_RGBA8, GL_RGBF32
 
-		GLenum texture_type; // = GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+		GLenum texture_type; // = GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, or GL_TEXTURE_2D_ARRAY
+
+		int layer_count = 1; // Number of layers of a GL_TEXTURE_2D_ARRAY
 
 		void bind() const;
 		void unbind() const;
@@ -33,6 +35,7 @@ namespace cgp
 
 		// Shortcut to initialize a GL_TEXTURE_2D from an image described by its filename
 		//  Similar to: initialize_texture_2d_on_gpu( image_load_file(filename), ...)
+		//  If image_baked_cache::active, the image and its mipmaps are read from the baked cache (created at the first load)
 		void load_and_initialize_texture_2d_on_gpu(std::string const& filename, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
 
 
@@ -40,11 +43,28 @@ namespace cgp
 		// Initialize a GL_TEXTURE_2D from an image
 		void initialize_texture_2d_on_gpu(image_structure const& im, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
 
+		// Initialize a GL_TEXTURE_2D from a view on an image: regions of an image are uploaded without copy (GL_UNPACK_ROW_LENGTH/SKIP_PIXELS/SKIP_ROWS)
+		//  Only views with a horizontal mirror or a rotation need a temporary copy
+		void initialize_texture_2d_on_gpu(image_view const& im, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
+
 		// Initialize a GL_TEXTURE_2D from a float grid
 		void initialize_texture_2d_on_gpu(grid_2D<vec3> const& im, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
 
+		// Initialize a GL_TEXTURE_2D from a baked image: each precomputed mipmap level is uploaded directly (no glGenerateMipmap)
+		void initialize_texture_2d_on_gpu(image_baked const& im, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
+
 		// Initialize a CUBEMAP on GPU from 6 squared images
 		void initialize_cubemap_on_gpu(image_structure const& x_neg, image_structure const& x_pos, image_structure const& y_neg, image_structure const& y_pos, image_structure const& z_neg, image_structure const& z_pos);
+		// Initialize a CUBEMAP on GPU from 6 views (ex. regions of a single atlas image)
+		void initialize_cubemap_on_gpu(image_view const& x_neg, image_view const& x_pos, image_view const& y_neg, image_view const& y_pos, image_view const& z_neg, image_view const& z_pos);
+		// Initialize a CUBEMAP on GPU from a baked image with 6 faces
+		void initialize_cubemap_on_gpu(image_baked const& im);
+
+		// Initialize a GL_TEXTURE_2D_ARRAY with one layer per image (all the layers must have the same size and color type)
+		//  In the shader, the texture is a sampler2DArray read with texture(image_texture, vec3(u, v, layer))
+		void initialize_texture_2d_array_on_gpu(std::vector<image_view> const& layers, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
+		// Initialize a GL_TEXTURE_2D_ARRAY from baked images: the precomputed mipmap levels of each layer are uploaded directly
+		void initialize_texture_2d_array_on_gpu(std::vector<image_baked> const& layers, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, bool is_mipmap = true, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
 
 		// Initialize a generic GL_TEXTURE from empty data
 		void initialize_texture_2d_on_gpu(int width_arg, int height_arg, GLint format_arg=GL_RGB8, GLenum texture_type_arg= GL_TEXTURE_2D, GLint wrap_s= GL_CLAMP_TO_EDGE, GLint wrap_t= GL_CLAMP_TO_EDGE, GLint texture_mag_filter= GL_LINEAR, GLint texture_min_filter= GL_LINEAR);
@@ -0,0 +1,196 @@
+#include "texture_atlas.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// The static implementation of stb_rect_pack has unused functions
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "third_party/src/imgui/imstb_rectpack.h"
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace cgp
+{
+    static int next_power_of_two(int value)
+    {
+        int p = 1;
+        while (p < value)
+            p *= 2;
+        return p;
+    }
+
+    texture_atlas_image texture_atlas_pack(std::vector<image_view> const& images, int padding_arg, int max_size)
+    {
+        int const N = int(images.size());
+        assert_cgp(N > 0, "Cannot build an atlas without image");
+
+        // The blocks are packed on a grid of padding x padding pixels, so that they are aligned for the mipmap levels
+        int const padding = next_power_of_two(std::max(padding_arg, 1));
+        int const unit = padding;
+        int max_level = 0;
+        while ((1 << (max_level + 1)) <= padding)
+            max_level++;
+
+        std::vector<stbrp_rect> rects(N);
+        long area = 0;
+        for (int k = 0; k < N; ++k) {
+            rects[k].id = k;
+            rects[k].w = stbrp_coord((images[k].width + 2 * padding + unit - 1) / unit);
+            rects[k].h = stbrp_coord((images[k].height + 2 * padding + unit - 1) / unit);
+            area += long(rects[k].w) * rects[k].h * unit * unit;
+        }
+
+        // Smallest squared power of two atlas where all the blocks fit
+        int size = next_power_of_two(int(std::ceil(std::sqrt(double(area)))));
+        bool packed = false;
+        for (; size <= max_size && !packed; size *= 2) {
+            int const size_unit = size / unit;
+            std::vector<stbrp_node> nodes(size_unit);
+            stbrp_context context;
+            stbrp_init_target(&context, size_unit, size_unit, nodes.data(), size_unit);
+            packed = stbrp_pack_rects(&context, rects.data(), N) == 1;
+        }
+        size /= 2;
+        assert_cgp(packed, "Cannot pack the images in an atlas of maximal size " + str(max_size));
+
+        texture_atlas_image atlas;
+        atlas.max_level = max_level;
+        atlas.image.width = size;
+        atlas.image.height = size;
+        atlas.image.color_type = image_color_type::rgba;
+        atlas.image.data.resize(size_t(4) * size * size);
+        atlas.image.data.fill(0);
+        atlas.region.resize(N);
+
+        for (stbrp_rect const& rect : rects) {
+            image_view const& im = images[rect.id];
+            texture_atlas_region& region = atlas.region[rect.id];
+            region.x = rect.x * unit + padding;
+            region.y = rect.y * unit + padding;
+            region.width = im.width;
+            region.height = im.height;
+            region.uv_min = { region.x / float(size), region.y / float(size) };
+            region.uv_max = { (region.x + im.width) / float(size), (region.y + im.height) / float(size) };
+
+            // Copy the image and replicate its border in the padding
+            int const channels = im.channels();
+            for (int y = -padding; y < im.height + padding; ++y) {
+                int const y_source = std::min(std::max(y, 0), im.height - 1);
+                unsigned char* out = &atlas.image.data[size_t(4) * (size_t(region.y + y) * size + region.x - padding)];
+                for (int x = -padding; x < im.width + padding; ++x, out += 4) {
+                    unsigned char const* in = im.pixel(std::min(std::max(x, 0), im.width - 1), y_source);
+                    out[0] = in[0];
+                    out[1] = in[1];
+                    out[2] = in[2];
+                    out[3] = channels == 4 ? in[3] : 255;
+                }
+            }
+        }
+        return atlas;
+    }
+
+    void opengl_texture_atlas::initialize_atlas_on_gpu(texture_atlas_image const& atlas)
+    {
+        texture.initialize_texture_2d_on_gpu(atlas.image, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, true);
+        region = atlas.region;
+
+        // Deeper mipmap levels would mix neighboring sub-textures
+        texture.bind();
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, atlas.max_level); opengl_check;
+        texture.unbind();
+    }
+
+    void opengl_texture_atlas::initialize_atlas_on_gpu(std::vector<image_view> const& images, int padding, int max_size)
+    {
+        initialize_atlas_on_gpu(texture_atlas_pack(images, padding, max_size));
+    }
+
+    void opengl_texture_atlas::initialize_array_on_gpu(std::vector<image_view> const& images, GLint wrap_s, GLint wrap_t)
+    {
+        int const N = int(images.size());
+        assert_cgp(N > 0, "Cannot build a texture array without image");
+
+        int width = 0, height = 0;
+        bool same_format = true;
+        for (image_view const& im : images) {
+            width = std::max(width, im.width);
+            height = std::max(height, im.height);
+            same_format = same_format && im.color_type == images[0].color_type;
+        }
+
+        // Only the images that differ from the common format are resampled
+        std::vector<image_structure> resampled;
+        resampled.reserve(N);
+        std::vector<image_view> layers;
+        for (image_view const& im : images) {
+            if (im.width == width && im.height == height && same_format)
+                layers.push_back(im);
+            else {
+                resampled.push_back(image_resample(im, width, height, image_color_type::rgba));
+                layers.push_back(image_view(resampled.back()));
+            }
+        }
+        texture.initialize_texture_2d_array_on_gpu(layers, wrap_s, wrap_t);
+
+        region.resize(N);
+        for (int k = 0; k < N; ++k) {
+            region[k] = texture_atlas_region();
+            region[k].uv_min = { 0, 0 };
+            region[k].uv_max = { 1, 1 };
+            region[k].layer = k;
+            region[k].width = width;
+            region[k].height = height;
+        }
+    }
+
+    void opengl_texture_atlas::initialize_array_on_gpu(std::vector<image_baked> const& images, GLint wrap_s, GLint wrap_t)
+    {
+        int const N = int(images.size());
+        assert_cgp(N > 0, "Cannot build a texture array without image");
+
+        bool same_format = true;
+        for (image_baked const& im : images)
+            same_format = same_format && im.width == images[0].width && im.height == images[0].height && im.color_type == images[0].color_type;
+
+        // Different sizes: the level 0 of each image is resampled as for the non-baked images
+        if (!same_format) {
+            std::vector<image_view> views(N);
+            for (int k = 0; k < N; ++k) {
+                assert_cgp(images[k].face_count == 1, "Baked image should have a single face to be used as a layer of a texture array");
+                views[k].data = images[k].level_data(0, 0);
+                views[k].row_length = images[k].width;
+                views[k].width = images[k].width;
+                views[k].height = images[k].height;
+                views[k].color_type = images[k].color_type;
+            }
+            initialize_array_on_gpu(views, wrap_s, wrap_t);
+            return;
+        }
+
+        texture.initialize_texture_2d_array_on_gpu(images, wrap_s, wrap_t);
+        region.resize(N);
+        for (int k = 0; k < N; ++k) {
+            region[k] = texture_atlas_region();
+            region[k].uv_min = { 0, 0 };
+            region[k].uv_max = { 1, 1 };
+            region[k].layer = k;
+            region[k].width = images[0].width;
+            region[k].height = images[0].height;
+        }
+    }
+
+    void opengl_texture_atlas::clear()
+    {
+        if (texture.id != 0)
+            texture.clear();
+        region.clear();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "texture.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	// Location of a sub-texture in a texture atlas or in a texture array
+	struct texture_atlas_region
+	{
+		vec2 uv_min;   // uv coordinates of the corners of the sub-texture: uv = uv_min + (uv_max-uv_min) * uv_local
+		vec2 uv_max;
+		int layer = 0; // Layer in a texture array (0 in an atlas)
+
+		// Pixel position and size in the atlas (excluding the padding)
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	// Images packed in a single atlas image (CPU side, can be computed on a worker thread)
+	//  Each sub-image is surrounded by a padding replicating its border, and its padded block starts on a multiple of the padding:
+	//  the mipmap levels up to max_level=log2(padding) never mix two sub-images.
+	struct texture_atlas_image
+	{
+		image_structure image; // rgba
+		std::vector<texture_atlas_region> region;
+		int max_level = 0;
+	};
+
+	// Pack the images (imstb_rectpack) in the smallest squared power of two atlas, up to max_size. The padding is rounded to a power of two.
+	texture_atlas_image texture_atlas_pack(std::vector<image_view> const& images, int padding = 8, int max_size = 4096);
+
+
+	// Several images gathered in a single texture, so that objects using different images can be drawn with a single bind (and instanced draw call)
+	//  - atlas: GL_TEXTURE_2D, each sub-texture is a uv rectangle (uv outside [0,1] cannot repeat the sub-texture)
+	//  - array: GL_TEXTURE_2D_ARRAY, each sub-texture is a layer (sampler2DArray in the shader, full mipmap chain and wrap modes)
+	struct opengl_texture_atlas
+	{
+		opengl_texture_image_structure texture;
+		std::vector<texture_atlas_region> region; // One region per input image, in the same order
+
+		void initialize_atlas_on_gpu(texture_atlas_image const& atlas);
+		void initialize_atlas_on_gpu(std::vector<image_view> const& images, int padding = 8, int max_size = 4096);
+
+		// The images are resampled to the size of the largest one when their sizes differ
+		void initialize_array_on_gpu(std::vector<image_view> const& images, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE);
+		// Baked images (ex. image_load_file_baked): their mipmap levels are uploaded directly when they all have the same size and color type
+		void initialize_array_on_gpu(std::vector<image_baked> const& images, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE);
+
+		void clear();
+	};
+}
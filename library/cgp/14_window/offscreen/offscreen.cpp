@@ -0,0 +1,285 @@
+#include "cgp/13_opengl/opengl.hpp"
+#include "offscreen.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include <iostream>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <dlfcn.h>
+#define CGP_OFFSCREEN_EGL
+#endif
+
+namespace cgp
+{
+#ifdef CGP_OFFSCREEN_EGL
+    // Minimal EGL declarations (the EGL headers are not required to build the library)
+    typedef void* egl_handle;
+    typedef int egl_int;
+    typedef unsigned int egl_boolean;
+
+    static egl_int const egl_none = 0x3038;
+    static egl_int const egl_surface_type = 0x3033;
+    static egl_int const egl_pbuffer_bit = 0x0001;
+    static egl_int const egl_renderable_type = 0x3040;
+    static egl_int const egl_opengl_bit = 0x0008;
+    static egl_int const egl_red_size = 0x3024;
+    static egl_int const egl_green_size = 0x3023;
+    static egl_int const egl_blue_size = 0x3022;
+    static egl_int const egl_depth_size = 0x3025;
+    static egl_int const egl_width = 0x3057;
+    static egl_int const egl_height = 0x3056;
+    static unsigned int const egl_opengl_api = 0x30A2;
+    static egl_int const egl_context_major_version = 0x3098;
+    static egl_int const egl_context_minor_version = 0x30FB;
+    static egl_int const egl_context_opengl_profile_mask = 0x30FD;
+    static egl_int const egl_context_opengl_core_profile_bit = 0x0001;
+    static unsigned int const egl_platform_surfaceless_mesa = 0x31DD;
+
+    struct egl_functions {
+        void* library = nullptr;
+        void* (*get_proc_address)(char const*) = nullptr;
+        egl_handle (*get_display)(void*) = nullptr;
+        egl_handle (*get_platform_display)(unsigned int, void*, egl_int const*) = nullptr;
+        egl_boolean (*initialize)(egl_handle, egl_int*, egl_int*) = nullptr;
+        egl_boolean (*terminate)(egl_handle) = nullptr;
+        egl_boolean (*choose_config)(egl_handle, egl_int const*, egl_handle*, egl_int, egl_int*) = nullptr;
+        egl_boolean (*bind_api)(unsigned int) = nullptr;
+        egl_handle (*create_context)(egl_handle, egl_handle, egl_handle, egl_int const*) = nullptr;
+        egl_boolean (*destroy_context)(egl_handle, egl_handle) = nullptr;
+        egl_handle (*create_pbuffer_surface)(egl_handle, egl_handle, egl_int const*) = nullptr;
+        egl_boolean (*destroy_surface)(egl_handle, egl_handle) = nullptr;
+        egl_boolean (*make_current)(egl_handle, egl_handle, egl_handle, egl_handle) = nullptr;
+    };
+
+    template <typename T>
+    static void egl_load(egl_functions const& egl, T& function, char const* name)
+    {
+        function = reinterpret_cast<T>(dlsym(egl.library, name));
+    }
+
+    static egl_functions const& egl_library()
+    {
+        static egl_functions egl;
+        static bool loaded = false;
+        if (loaded)
+            return egl;
+        loaded = true;
+
+        egl.library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+        if (egl.library == nullptr)
+            egl.library = dlopen("libEGL.so", RTLD_NOW | RTLD_LOCAL);
+        if (egl.library == nullptr)
+            return egl;
+
+        egl_load(egl, egl.get_proc_address, "eglGetProcAddress");
+        egl_load(egl, egl.get_display, "eglGetDisplay");
+        egl_load(egl, egl.initialize, "eglInitialize");
+        egl_load(egl, egl.terminate, "eglTerminate");
+        egl_load(egl, egl.choose_config, "eglChooseConfig");
+        egl_load(egl, egl.bind_api, "eglBindAPI");
+        egl_load(egl, egl.create_context, "eglCreateContext");
+        egl_load(egl, egl.destroy_context, "eglDestroyContext");
+        egl_load(egl, egl.create_pbuffer_surface, "eglCreatePbufferSurface");
+        egl_load(egl, egl.destroy_surface, "eglDestroySurface");
+        egl_load(egl, egl.make_current, "eglMakeCurrent");
+        if (egl.get_proc_address != nullptr)
+            egl.get_platform_display = reinterpret_cast<egl_handle (*)(unsigned int, void*, egl_int const*)>(egl.get_proc_address("eglGetPlatformDisplayEXT"));
+        return egl;
+    }
+
+    static void* egl_get_proc_address(char const* name)
+    {
+        return egl_library().get_proc_address(name);
+    }
+#endif
+
+    bool offscreen_context::initialize_egl(bool surfaceless, int opengl_version_major, int opengl_version_minor)
+    {
+#ifdef CGP_OFFSCREEN_EGL
+        egl_functions const& egl = egl_library();
+        if (egl.get_proc_address == nullptr || egl.initialize == nullptr || egl.create_context == nullptr || egl.make_current == nullptr)
+            return false;
+        if (surfaceless && egl.get_platform_display == nullptr)
+            return false;
+
+        egl_handle const display = surfaceless ? egl.get_platform_display(egl_platform_surfaceless_mesa, nullptr, nullptr) : egl.get_display(nullptr);
+        egl_int major = 0, minor = 0;
+        if (display == nullptr || !egl.initialize(display, &major, &minor))
+            return false;
+
+        egl_int const config_attributes[] = {
+            egl_surface_type, surfaceless ? 0 : egl_pbuffer_bit,
+            egl_renderable_type, egl_opengl_bit,
+            egl_red_size, 8, egl_green_size, 8, egl_blue_size, 8, egl_depth_size, 24,
+            egl_none };
+        egl_handle config = nullptr;
+        egl_int N_config = 0;
+        egl.choose_config(display, config_attributes, &config, 1, &N_config);
+        if (N_config == 0 && !surfaceless) {
+            egl.terminate(display);
+            return false;
+        }
+
+        egl.bind_api(egl_opengl_api);
+        egl_int const context_attributes[] = {
+            egl_context_major_version, opengl_version_major,
+            egl_context_minor_version, opengl_version_minor,
+            egl_context_opengl_profile_mask, egl_context_opengl_core_profile_bit,
+            egl_none };
+        egl_handle const context = egl.create_context(display, N_config > 0 ? config : nullptr, nullptr, context_attributes);
+        if (context == nullptr) {
+            egl.terminate(display);
+            return false;
+        }
+
+        // The rendering is done in FBO: the pbuffer is only needed by the drivers without surfaceless contexts
+        egl_handle surface = nullptr;
+        if (!surfaceless) {
+            egl_int const surface_attributes[] = { egl_width, 16, egl_height, 16, egl_none };
+            surface = egl.create_pbuffer_surface(display, config, surface_attributes);
+        }
+        if (!egl.make_current(display, surface, surface, context)) {
+            if (surface != nullptr)
+                egl.destroy_surface(display, surface);
+            egl.destroy_context(display, context);
+            egl.terminate(display);
+            return false;
+        }
+
+        if (gladLoadGLLoader(egl_get_proc_address) == 0) {
+            egl.make_current(display, nullptr, nullptr, nullptr);
+            egl.destroy_context(display, context);
+            egl.terminate(display);
+            return false;
+        }
+
+        egl_display = display;
+        egl_context = context;
+        egl_surface = surface;
+        backend = surfaceless ? offscreen_backend::egl_surfaceless : offscreen_backend::egl_pbuffer;
+
+        opengl_error_initialize(egl_get_proc_address);
+        opengl_shader_binary_cache_initialize(egl_get_proc_address);
+        return true;
+#else
+        (void)surfaceless; (void)opengl_version_major; (void)opengl_version_minor;
+        return false;
+#endif
+    }
+
+    bool offscreen_context::initialize_glfw_hidden_window(int opengl_version_major, int opengl_version_minor)
+    {
+#ifndef __EMSCRIPTEN__
+        // No abort if there is no display server (unlike window_structure::initialize_glfw)
+        if (glfwInit() != GLFW_TRUE)
+            return false;
+
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, opengl_version_major);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, opengl_version_minor);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+        glfw_window = glfwCreateWindow(16, 16, "cgp offscreen", nullptr, nullptr);
+        if (glfw_window == nullptr)
+            return false;
+
+        glfwMakeContextCurrent(glfw_window);
+        if (gladLoadGL() == 0) {
+            glfwDestroyWindow(glfw_window);
+            glfw_window = nullptr;
+            return false;
+        }
+        backend = offscreen_backend::glfw_hidden_window;
+
+        opengl_error_initialize((GLADloadproc)glfwGetProcAddress);
+        opengl_shader_binary_cache_initialize((GLADloadproc)glfwGetProcAddress);
+        return true;
+#else
+        (void)opengl_version_major; (void)opengl_version_minor;
+        return false;
+#endif
+    }
+
+    bool offscreen_context::initialize(offscreen_backend requested, int opengl_version_major, int opengl_version_minor)
+    {
+        assert_cgp(!is_valid(), "The offscreen context is already initialized");
+
+        bool const any = requested == offscreen_backend::automatic;
+        bool ok = false;
+        if (!ok && (any || requested == offscreen_backend::egl_surfaceless))
+            ok = initialize_egl(true, opengl_version_major, opengl_version_minor);
+        if (!ok && (any || requested == offscreen_backend::egl_pbuffer))
+            ok = initialize_egl(false, opengl_version_major, opengl_version_minor);
+        if (!ok && (any || requested == offscreen_backend::glfw_hidden_window))
+            ok = initialize_glfw_hidden_window(opengl_version_major, opengl_version_minor);
+
+        if (!ok) {
+            std::cerr << "Failed to create an offscreen OpenGL " << opengl_version_major << "." << opengl_version_minor << " context with the backend " << str(requested) << std::endl;
+            return false;
+        }
+
+        // Same pixel storage as the windowed context
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        return true;
+    }
+
+    void offscreen_context::cleanup()
+    {
+#ifdef CGP_OFFSCREEN_EGL
+        if (egl_display != nullptr) {
+            egl_functions const& egl = egl_library();
+            egl.make_current(egl_display, nullptr, nullptr, nullptr);
+            if (egl_surface != nullptr)
+                egl.destroy_surface(egl_display, egl_surface);
+            egl.destroy_context(egl_display, egl_context);
+            egl.terminate(egl_display);
+        }
+#endif
+#ifndef __EMSCRIPTEN__
+        if (glfw_window != nullptr) {
+            glfwDestroyWindow(glfw_window);
+            glfwTerminate();
+        }
+#endif
+        egl_display = nullptr;
+        egl_context = nullptr;
+        egl_surface = nullptr;
+        glfw_window = nullptr;
+    }
+
+    bool offscreen_context::is_valid() const
+    {
+        return egl_context != nullptr || glfw_window != nullptr;
+    }
+
+    std::string offscreen_context::description() const
+    {
+        if (!is_valid())
+            return "no context";
+        char const* version = reinterpret_cast<char const*>(glGetString(GL_VERSION));
+        char const* renderer = reinterpret_cast<char const*>(glGetString(GL_RENDERER));
+        return str(backend) + " - OpenGL " + (version != nullptr ? version : "?") + " - " + (renderer != nullptr ? renderer : "?");
+    }
+
+    std::string str(offscreen_backend backend)
+    {
+        switch (backend) {
+        case offscreen_backend::automatic: return "automatic";
+        case offscreen_backend::egl_surfaceless: return "egl_surfaceless";
+        case offscreen_backend::egl_pbuffer: return "egl_pbuffer";
+        case offscreen_backend::glfw_hidden_window: return "glfw_hidden_window";
+        }
+        return "unknown";
+    }
+
+    offscreen_backend offscreen_backend_from_string(std::string const& name)
+    {
+        if (name == "egl_surfaceless") return offscreen_backend::egl_surfaceless;
+        if (name == "egl_pbuffer") return offscreen_backend::egl_pbuffer;
+        if (name == "glfw_hidden_window") return offscreen_backend::glfw_hidden_window;
+        return offscreen_backend::automatic;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <string>
+
+namespace cgp
+{
+	// How the OpenGL context of an offscreen_context is created
+	//  - egl_surfaceless: EGL on the Mesa surfaceless platform (GPU driver or llvmpipe), no display server needed (build machines, CI)
+	//  - egl_pbuffer: EGL on the default display with a small pbuffer surface
+	//  - glfw_hidden_window: invisible GLFW window (needs a display server, available on all the platforms)
+	//  - automatic: the first of the above that succeeds
+	enum class offscreen_backend { automatic, egl_surfaceless, egl_pbuffer, glfw_hidden_window };
+
+	/** OpenGL context without visible window, used to render into an opengl_fbo_structure (automated performance runs, visual regression tests).
+	* libEGL is loaded at runtime (dlopen): there is no link dependency, and the EGL backends are only available on Linux.
+	* With Mesa, the software rasterizer can be forced with the environment variable LIBGL_ALWAYS_SOFTWARE=1 (reproducible images across machines).
+	*
+	* Usage:
+	* | offscreen_context context;
+	* | context.initialize(offscreen_backend::automatic);
+	* | opengl_fbo_structure fbo; fbo.initialize(); fbo.update_screen_size(1280, 720);
+	* | ... render in the fbo ...
+	* | context.cleanup(); */
+	struct offscreen_context
+	{
+		offscreen_backend backend = offscreen_backend::automatic; // Backend in use after initialize()
+
+		// Create the context, make it current and load the OpenGL functions (GLAD). Returns false if the requested backend is not available.
+		bool initialize(offscreen_backend requested = offscreen_backend::automatic, int opengl_version_major = 3, int opengl_version_minor = 3);
+		void cleanup();
+		bool is_valid() const;
+
+		// Backend, OpenGL version and renderer
+		std::string description() const;
+
+		// Handles of the backend (void* to avoid exposing the EGL types)
+		void* egl_display = nullptr;
+		void* egl_context = nullptr;
+		void* egl_surface = nullptr;
+		GLFWwindow* glfw_window = nullptr;
+
+	private:
+		bool initialize_egl(bool surfaceless, int opengl_version_major, int opengl_version_minor);
+		bool initialize_glfw_hidden_window(int opengl_version_major, int opengl_version_minor);
+	};
+
+	std::string str(offscreen_backend backend);
+	// Parse "automatic", "egl_surfaceless", "egl_pbuffer" or "glfw_hidden_window" (automatic if the name is unknown)
+	offscreen_backend offscreen_backend_from_string(std::string const& name);
+}
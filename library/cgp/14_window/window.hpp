@@ -1,4 +1,5 @@
 #pragma once
 
 #include "window/window.hpp"
+#include "offscreen/offscreen.hpp"
 #include "imgui/imgui.hpp"
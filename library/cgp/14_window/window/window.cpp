@@ -101,6 +101,11 @@ namespace cgp
             std::cout<<"Failed to Init GLAD"<<std::endl;
             abort();
         }
+
+        // Use the asynchronous debug output for OpenGL errors when available (GL_KHR_debug)
+        opengl_error_initialize((GLADloadproc)glfwGetProcAddress);
+        // Program binaries to skip the compilation of the shaders at the next launches
+        opengl_shader_binary_cache_initialize((GLADloadproc)glfwGetProcAddress);
 #endif
 
 
@@ -2,6 +2,7 @@
 
 #include "material/material.hpp"
 #include "mesh_drawable/mesh_drawable.hpp"
+#include "mesh_drawable_lod/mesh_drawable_lod.hpp"
 #include "triangles_drawable/triangles_drawable.hpp"
 #include "curve_drawable/curve_drawable.hpp"
 #include "curve_drawable_dynamic_extend/curve_drawable_dynamic_extend.hpp"
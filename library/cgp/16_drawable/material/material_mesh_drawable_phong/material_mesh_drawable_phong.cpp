@@ -9,17 +9,28 @@ namespace cgp
 {
 	void material_mesh_drawable_phong::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 	{
-		opengl_uniform(shader, "material.color", color, expected);
-		opengl_uniform(shader, "material.alpha", alpha, expected);
+		// The names are built once: a long name converted to a temporary std::string is a heap allocation at every draw call
+		static std::string const name_color = "material.color";
+		static std::string const name_alpha = "material.alpha";
+		static std::string const name_ambient = "material.phong.ambient";
+		static std::string const name_diffuse = "material.phong.diffuse";
+		static std::string const name_specular = "material.phong.specular";
+		static std::string const name_specular_exponent = "material.phong.specular_exponent";
+		static std::string const name_use_texture = "material.texture_settings.use_texture";
+		static std::string const name_inverse_v = "material.texture_settings.texture_inverse_v";
+		static std::string const name_two_sided = "material.texture_settings.two_sided";
 
-		opengl_uniform(shader, "material.phong.ambient", phong.ambient, expected);
-		opengl_uniform(shader, "material.phong.diffuse", phong.diffuse, expected);
-		opengl_uniform(shader, "material.phong.specular", phong.specular, expected);
-		opengl_uniform(shader, "material.phong.specular_exponent", phong.specular_exponent, expected);
+		opengl_uniform(shader, name_color, color, expected);
+		opengl_uniform(shader, name_alpha, alpha, expected);
 
-		opengl_uniform(shader, "material.texture_settings.use_texture", texture_settings.active, expected);
-		opengl_uniform(shader, "material.texture_settings.texture_inverse_v", texture_settings.inverse_v, expected);
-		opengl_uniform(shader, "material.texture_settings.two_sided", texture_settings.two_sided, expected);
+		opengl_uniform(shader, name_ambient, phong.ambient, expected);
+		opengl_uniform(shader, name_diffuse, phong.diffuse, expected);
+		opengl_uniform(shader, name_specular, phong.specular, expected);
+		opengl_uniform(shader, name_specular_exponent, phong.specular_exponent, expected);
+
+		opengl_uniform(shader, name_use_texture, texture_settings.active, expected);
+		opengl_uniform(shader, name_inverse_v, texture_settings.inverse_v, expected);
+		opengl_uniform(shader, name_two_sided, texture_settings.two_sided, expected);
 	}
 
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "mesh_drawable.hpp"
 
 #include "cgp/01_base/base.hpp"
+#include "cgp/17_timer/profiler/profiler.hpp"
+#include "cgp/06_mat/mat4/simd/mat4_simd.hpp"
 
 #if defined(__linux__) || defined(__EMSCRIPTEN__)
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -12,6 +14,8 @@ namespace cgp
 	opengl_texture_image_structure mesh_drawable::default_texture;
 
 	static void warning_initialize_non_empty();
+	static void initialize_default_state(mesh_drawable& drawable, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg);
+	static void initialize_vao(mesh_drawable& drawable);
 
 	void mesh_drawable::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
 	{
@@ -35,13 +39,7 @@ namespace cgp
 
 		// Variable initialization
 		// *********************************************************************** //
-		if(!(shader_arg.id==default_shader.id && shader.id!=0))
-			shader = shader_arg;
-		if(!(texture_arg.id==default_texture.id && texture.id!=0))
-			texture = texture_arg;
-		model = affine();
-		material = material_mesh_drawable_phong();
-		supplementary_model_matrix = mat4::build_identity();
+		initialize_default_state(*this, shader_arg, texture_arg);
 
 
 		// Send the data to the GPU
@@ -54,15 +52,54 @@ namespace cgp
 
 		ebo_connectivity.initialize_data_on_gpu(data.connectivity);
 
+		initialize_vao(*this);
+	}
+
+	void mesh_drawable::initialize_data_on_gpu(mesh_binary const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		opengl_check;
+		if (vao != 0 || vbo_position.size != 0)
+			warning_initialize_non_empty();
+
+		if (data.level_count == 0 || data.vertex_count == 0) {
+			warning_cgp("Warning try to generate mesh_drawable with 0 vertex", "");
+			return;
+		}
+
+		initialize_default_state(*this, shader_arg, texture_arg);
+
+		// The streams are sent as they are stored (no conversion)
+		vbo_position.initialize_data_on_gpu(data.position(), data.vertex_count, 3);
+		vbo_normal.initialize_data_on_gpu(data.normal(), data.vertex_count, 3);
+		vbo_color.initialize_data_on_gpu(data.color(), data.vertex_count, 3);
+		vbo_uv.initialize_data_on_gpu(data.uv(), data.vertex_count, 2);
+
+		ebo_connectivity.initialize_data_on_gpu(data.index(0), data.triangle_count(0), data.index_width == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+
+		initialize_vao(*this);
+	}
 
+	static void initialize_default_state(mesh_drawable& drawable, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		if(!(shader_arg.id==mesh_drawable::default_shader.id && drawable.shader.id!=0))
+			drawable.shader = shader_arg;
+		if(!(texture_arg.id==mesh_drawable::default_texture.id && drawable.texture.id!=0))
+			drawable.texture = texture_arg;
+		drawable.model = affine();
+		drawable.material = material_mesh_drawable_phong();
+		drawable.supplementary_model_matrix = mat4::build_identity();
+	}
+
+	static void initialize_vao(mesh_drawable& drawable)
+	{
 		// Generate VAO 
 		//   - Preset shader location for default mesh shaders {position:0, normal:1, color:2, uv:3}
-		glGenVertexArrays(1, &vao); opengl_check;
-		glBindVertexArray(vao); opengl_check;
-		opengl_set_vao_location(vbo_position, 0);
-		opengl_set_vao_location(vbo_normal, 1);
-		opengl_set_vao_location(vbo_color, 2);
-		opengl_set_vao_location(vbo_uv, 3);
+		glGenVertexArrays(1, &drawable.vao); opengl_check;
+		glBindVertexArray(drawable.vao); opengl_check;
+		opengl_set_vao_location(drawable.vbo_position, 0);
+		opengl_set_vao_location(drawable.vbo_normal, 1);
+		opengl_set_vao_location(drawable.vbo_color, 2);
+		opengl_set_vao_location(drawable.vbo_uv, 3);
 		glBindVertexArray(0); opengl_check;
 	}
 
@@ -103,6 +140,7 @@ namespace cgp
 		glBindVertexArray(0); opengl_check;
 	}
 
+	template void mesh_drawable::initialize_supplementary_data_on_gpu(numarray<float> const& data, GLuint location_index, GLuint divisor);
 	template void mesh_drawable::initialize_supplementary_data_on_gpu(numarray<vec2> const& data, GLuint location_index, GLuint divisor);
 	template void mesh_drawable::initialize_supplementary_data_on_gpu(numarray<vec3> const& data, GLuint location_index, GLuint divisor);
 	template void mesh_drawable::initialize_supplementary_data_on_gpu(numarray<vec4> const& data, GLuint location_index, GLuint divisor);
@@ -147,14 +185,27 @@ namespace cgp
 	}
 
 
+	static void draw_with_material(mesh_drawable const& drawable, material_mesh_drawable_phong const& material, opengl_ebo_structure const& connectivity, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, GLenum draw_mode);
+
 	void draw(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, GLenum draw_mode)
 	{
+		draw_with_material(drawable, drawable.material, drawable.ebo_connectivity, environment, instance_count, expected_uniforms, additional_uniforms, draw_mode);
+	}
+
+	void draw(mesh_drawable const& drawable, opengl_ebo_structure const& connectivity, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, GLenum draw_mode)
+	{
+		draw_with_material(drawable, drawable.material, connectivity, environment, instance_count, expected_uniforms, additional_uniforms, draw_mode);
+	}
+
+	static void draw_with_material(mesh_drawable const& drawable, material_mesh_drawable_phong const& material, opengl_ebo_structure const& connectivity, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, GLenum draw_mode)
+	{
+		profile_zone_cgp("draw");
 		opengl_check;
 		// Initial clean check
 		// ********************************** //
 		// If there is not vertices or not triangles, returns
 		//  (no error + does not display anything)
-		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+		if (drawable.vbo_position.size == 0 || connectivity.size == 0)
 			return;
 
 		assert_cgp(drawable.shader.id != 0, "Try to draw mesh_drawable without shader ");
@@ -169,7 +220,7 @@ namespace cgp
 		// ********************************** //
 
 		// send the uniform values for the model and material of the mesh_drawable
-		drawable.send_opengl_uniform(expected_uniforms);
+		drawable.send_opengl_uniform(expected_uniforms, material);
 
 		// send the uniform values for the environment
 		environment.send_opengl_uniform(drawable.shader, expected_uniforms && environment.default_expected_uniform);
@@ -203,16 +254,16 @@ namespace cgp
 		// Prepare for draw call
 		// ********************************** //
 		glBindVertexArray(drawable.vao);                                     opengl_check;
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ebo_connectivity.id); opengl_check;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, connectivity.id); opengl_check;
 
 
 		// Draw call
 		// ********************************** //
 		if (instance_count <= 1) {
-			glDrawElements(draw_mode, GLsizei(drawable.ebo_connectivity.size * 3), GL_UNSIGNED_INT, nullptr); opengl_check;
+			glDrawElements(draw_mode, GLsizei(connectivity.size * 3), connectivity.details.type_element, nullptr); opengl_check;
 		}
 		else {
-			glDrawElementsInstanced(draw_mode, GLsizei(drawable.ebo_connectivity.size * 3), GL_UNSIGNED_INT, nullptr, instance_count); opengl_check;
+			glDrawElementsInstanced(draw_mode, GLsizei(connectivity.size * 3), connectivity.details.type_element, nullptr, instance_count); opengl_check;
 		}
 
 
@@ -226,15 +277,16 @@ namespace cgp
 	void draw_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
 	{
 #ifndef __EMSCRIPTEN__ 		// Polygon Mode not available in WebGL
-		mesh_drawable wireframe = drawable;
-		wireframe.material.phong = { 1.0f,0.0f,0.0f,64.0f };
-		wireframe.material.color = color;
-		wireframe.material.texture_settings.active = false;
+		// Only the material differs from the drawable: the mesh_drawable is not copied
+		material_mesh_drawable_phong wireframe = drawable.material;
+		wireframe.phong = { 1.0f,0.0f,0.0f,64.0f };
+		wireframe.color = color;
+		wireframe.texture_settings.active = false;
 	
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glEnable(GL_POLYGON_OFFSET_LINE);
 		glPolygonOffset(-1.0, 1.0);        opengl_check;
-		draw(wireframe, environment, instance_count, expected_uniforms, additional_uniforms);
+		draw_with_material(drawable, wireframe, drawable.ebo_connectivity, environment, instance_count, expected_uniforms, additional_uniforms, GL_TRIANGLES);
 		glDisable(GL_POLYGON_OFFSET_LINE); opengl_check;
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 #endif
@@ -243,14 +295,29 @@ namespace cgp
 
 
 	void mesh_drawable::send_opengl_uniform(bool expected) const
+	{
+		send_opengl_uniform(expected, material);
+	}
+
+	void mesh_drawable::send_opengl_uniform(bool expected, material_mesh_drawable_phong const& material_used) const
 	{
 		// Final model matrix in the shader is: hierarchy_transform_model * model
 		mat4 const model_shader = hierarchy_transform_model.matrix() * supplementary_model_matrix * model.matrix();
 
+		// The normal matrix transpose(model^{-1}) is computed once per draw call instead of once per vertex in the shader
+		//  (optional uniform: only the shaders declaring modelNormal use it). A degenerate model (ex. null scaling) keeps its own matrix.
+		mat4 model_normal_shader;
+		float const d = mat4_simd_inverse(model_shader.begin(), model_normal_shader.begin());
+		if (std::abs(d) > 1e-30f)
+			model_normal_shader = transpose(model_normal_shader);
+		else
+			model_normal_shader = model_shader;
+
 		// set the Model matrix
 		opengl_uniform(shader, "model", model_shader, expected);
+		opengl_uniform(shader, "modelNormal", model_normal_shader, false);
 
 		// set the material
-		material.send_opengl_uniform(shader, expected);
+		material_used.send_opengl_uniform(shader, expected);
 	}
 }
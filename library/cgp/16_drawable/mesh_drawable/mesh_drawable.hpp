@@ -2,6 +2,7 @@
 
 #include "cgp/09_geometric_transformation/affine/affine.hpp"
 #include "cgp/11_mesh/mesh/mesh.hpp"
+#include "cgp/11_mesh/mesh_binary/mesh_binary.hpp"
 #include "cgp/13_opengl/opengl.hpp"
 #include "cgp/16_drawable/material/material_mesh_drawable_phong/material_mesh_drawable_phong.hpp"
 #include "cgp/16_drawable/environment/environment.hpp"
@@ -67,12 +68,16 @@ namespace cgp
 
 		// Fill the VBO and VAO of the class using the data provided from the mesh
 		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
+		// Fill the VBO and VAO directly from the streams of a binary mesh (level 0 of the connectivity)
+		void initialize_data_on_gpu(mesh_binary const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
 
 		// Clear the GPU memory from the VBO and VAO data
 		void clear();
 
 		// Send the uniforms to the shader (called automatically during the draw stage)
 		void send_opengl_uniform(bool expected = true) const;
+		// Same with another material (ex. wireframe color), without modifying the mesh_drawable
+		void send_opengl_uniform(bool expected, material_mesh_drawable_phong const& material_used) const;
 
 		// Additional method allowing to fill an additional VBO
 		template<typename T>
@@ -88,6 +93,9 @@ namespace cgp
 	//  draw([mesh_drawable], environment);
 	void draw(mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), int instance_count=1, bool expected_uniforms=true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure(), GLenum draw_mode=GL_TRIANGLES);
 
+	// Draw the shape using another connectivity indexing the same VBOs (ex. a simplified level of detail)
+	void draw(mesh_drawable const& drawable, opengl_ebo_structure const& connectivity, environment_generic_structure const& environment = environment_generic_structure(), int instance_count=1, bool expected_uniforms=true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure(), GLenum draw_mode=GL_TRIANGLES);
+
 	// Draw the same shape while activating the GL_POLYGON_OFFSET_LINE mode from OpenGL
 	void draw_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = {0,0,1}, int instance_count = 1, bool expected_uniforms = true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
 
@@ -0,0 +1,72 @@
+#include "mesh_drawable_lod.hpp"
+
+namespace cgp
+{
+	void mesh_drawable_lod::initialize_data_on_gpu(mesh const& data, mesh_lod const& lod, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		mesh_drawable::initialize_data_on_gpu(data, shader_arg, texture_arg);
+
+		for (opengl_ebo_structure& ebo : ebo_lod)
+			ebo.clear();
+		ebo_lod.clear();
+		lod_error = { 0.0f };
+
+		for (int k = 1; k < lod.size(); ++k) {
+			opengl_ebo_structure ebo;
+			ebo.initialize_data_on_gpu(lod.connectivity[k]);
+			ebo_lod.push_back(ebo);
+			lod_error.push_back(lod.error[k]);
+		}
+	}
+
+	void mesh_drawable_lod::initialize_data_on_gpu(mesh_binary const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		mesh_drawable::initialize_data_on_gpu(data, shader_arg, texture_arg);
+
+		for (opengl_ebo_structure& ebo : ebo_lod)
+			ebo.clear();
+		ebo_lod.clear();
+		lod_error = { 0.0f };
+
+		GLenum const index_type = data.index_width == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		for (int k = 1; k < data.level_count; ++k) {
+			opengl_ebo_structure ebo;
+			ebo.initialize_data_on_gpu(data.index(k), data.triangle_count(k), index_type);
+			ebo_lod.push_back(ebo);
+			lod_error.push_back(data.error(k));
+		}
+	}
+
+	int mesh_drawable_lod::lod_level(vec3 const& camera_position) const
+	{
+		if (ebo_lod.size() == 0)
+			return 0;
+
+		mat4 const M = hierarchy_transform_model.matrix() * supplementary_model_matrix * model.matrix();
+		vec3 const center = M.transform_position({ 0,0,0 });
+		float const scaling = hierarchy_transform_model.scaling * model.scaling;
+		float const distance = norm(camera_position - center);
+
+		int level = 0;
+		for (int k = 1; k < lod_error.size(); ++k)
+			if (lod_error[k] * scaling <= lod_error_threshold * distance)
+				level = k;
+		return level;
+	}
+
+	void mesh_drawable_lod::clear()
+	{
+		for (opengl_ebo_structure& ebo : ebo_lod)
+			ebo.clear();
+		ebo_lod.clear();
+		lod_error.clear();
+		mesh_drawable::clear();
+	}
+
+	void draw(mesh_drawable_lod const& drawable, vec3 const& camera_position, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
+	{
+		int const level = drawable.lod_level(camera_position);
+		opengl_ebo_structure const& connectivity = level == 0 ? drawable.ebo_connectivity : drawable.ebo_lod[level - 1];
+		draw(drawable, connectivity, environment, instance_count, expected_uniforms, additional_uniforms);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cgp/16_drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/11_mesh/mesh_simplification/mesh_simplification.hpp"
+
+namespace cgp
+{
+	// A mesh_drawable with several levels of details sharing the same VBOs
+	//  The level is selected at each draw call from the distance to the camera.
+	struct mesh_drawable_lod : mesh_drawable
+	{
+		// Connectivity of the simplified levels: ebo_lod[k] is the level k+1 (level 0 is the full resolution ebo_connectivity)
+		std::vector<opengl_ebo_structure> ebo_lod;
+
+		// Distance between each level and the initial surface, in the mesh coordinates (lod_error[0]=0)
+		numarray<float> lod_error;
+
+		// The coarsest level whose error, seen from the camera, is below lod_error_threshold * distance_to_camera is drawn.
+		//  (The threshold is approximately the tolerated angular error in radians)
+		float lod_error_threshold = 0.002f;
+
+		// Fill the VBOs with the mesh data, and the EBOs with all the levels (lod.connectivity[0] is expected to be the mesh connectivity)
+		void initialize_data_on_gpu(mesh const& data, mesh_lod const& lod, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
+		// Fill the VBOs and all the EBOs from a binary mesh storing its levels of details
+		void initialize_data_on_gpu(mesh_binary const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
+
+		// Index of the level to draw when seen from the camera_position
+		int lod_level(vec3 const& camera_position) const;
+
+		// Clear the GPU memory from the VBO, EBO and VAO data
+		void clear();
+	};
+
+	// Draw the level of detail adapted to the camera position
+	void draw(mesh_drawable_lod const& drawable, vec3 const& camera_position, environment_generic_structure const& environment = environment_generic_structure(), int instance_count=1, bool expected_uniforms=true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+}
@@ -133,7 +133,14 @@ namespace cgp
 	}
 
 
+	static void draw_with_material(triangles_drawable const& drawable, material_mesh_drawable_phong const& material, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms);
+
 	void draw(triangles_drawable const& drawable, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		draw_with_material(drawable, drawable.material, environment, additional_uniforms);
+	}
+
+	static void draw_with_material(triangles_drawable const& drawable, material_mesh_drawable_phong const& material, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
 	{
 		// Initial clean check
 		// ********************************** //
@@ -154,7 +161,7 @@ namespace cgp
 		// ********************************** //
 
 		// send the uniform values for the model and material of the mesh_drawable
-		drawable.send_opengl_uniform();
+		drawable.send_opengl_uniform(true, material);
 
 		// send the uniform values for the environment
 		environment.send_opengl_uniform(drawable.shader);
@@ -204,14 +211,15 @@ namespace cgp
 	void draw_wireframe(triangles_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
 	{
 		#ifndef __EMSCRIPTEN__
-		triangles_drawable wireframe = drawable;
-		wireframe.material.phong = { 1.0f,0.0f,0.0f,64.0f };
-		wireframe.material.color = color;
-		wireframe.material.texture_settings.active = false;
+		// Only the material differs from the drawable: the triangles_drawable is not copied
+		material_mesh_drawable_phong wireframe = drawable.material;
+		wireframe.phong = { 1.0f,0.0f,0.0f,64.0f };
+		wireframe.color = color;
+		wireframe.texture_settings.active = false;
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glEnable(GL_POLYGON_OFFSET_LINE);
 		glPolygonOffset(-1.0, 1.0);        opengl_check;
-		draw(wireframe, environment, additional_uniforms);
+		draw_with_material(drawable, wireframe, environment, additional_uniforms);
 		glDisable(GL_POLYGON_OFFSET_LINE); opengl_check;
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 		#endif
@@ -219,6 +227,11 @@ namespace cgp
 
 
 	void triangles_drawable::send_opengl_uniform(bool expected) const
+	{
+		send_opengl_uniform(expected, material);
+	}
+
+	void triangles_drawable::send_opengl_uniform(bool expected, material_mesh_drawable_phong const& material_used) const
 	{
 		// Final model matrix in the shader is: hierarchy_transform_model * model
 		mat4 const model_shader = hierarchy_transform_model.matrix() * model.matrix();
@@ -232,6 +245,6 @@ namespace cgp
 		opengl_uniform(shader, "modelNormal", model_normal_shader, expected);
 
 		// set the material
-		material.send_opengl_uniform(shader);
+		material_used.send_opengl_uniform(shader);
 	}
 }
\ No newline at end of file
@@ -41,6 +41,8 @@ namespace cgp
 		void initialize_data_on_gpu(numarray<vec3> const& position, numarray<vec3> const& normal=numarray<vec3>(), numarray<vec3> const& color=numarray<vec3>(), numarray<vec3> const& uv= numarray<vec3>(), opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
 		void clear();
 		void send_opengl_uniform(bool expected = true) const;
+		// Same with another material (ex. wireframe color), without modifying the triangles_drawable
+		void send_opengl_uniform(bool expected, material_mesh_drawable_phong const& material_used) const;
 
 		std::map<std::string, opengl_texture_image_structure> supplementary_texture; // optional supplementary texture (can be used for multi-texturing)
 	};
@@ -0,0 +1,271 @@
+#include "benchmark.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace cgp
+{
+	static void const* volatile benchmark_sink = nullptr;
+
+	void benchmark_keep(void const* value)
+	{
+		benchmark_sink = value;
+	}
+
+	double benchmark_median(std::vector<double> values)
+	{
+		if (values.empty())
+			return 0.0;
+		size_t const N = values.size();
+		std::nth_element(values.begin(), values.begin() + N / 2, values.end());
+		double const upper = values[N / 2];
+		if (N % 2 == 1)
+			return upper;
+		double const lower = *std::max_element(values.begin(), values.begin() + N / 2);
+		return 0.5 * (lower + upper);
+	}
+
+	double benchmark_mad(std::vector<double> const& values)
+	{
+		double const median = benchmark_median(values);
+		std::vector<double> deviation;
+		for (double v : values)
+			deviation.push_back(std::abs(v - median));
+		return benchmark_median(deviation);
+	}
+
+	benchmark_result benchmark_run(std::string const& name, std::function<void()> const& function, benchmark_parameters const& parameters)
+	{
+		using clock = std::chrono::steady_clock;
+		auto const elapsed_ns = [](clock::time_point t0) { return std::chrono::duration<double, std::nano>(clock::now() - t0).count(); };
+
+		// The duration of the last warmup call gives the number of calls per sample
+		double call_ns = 0;
+		for (int k = 0; k < std::max(parameters.warmup, 1); ++k) {
+			clock::time_point const t0 = clock::now();
+			function();
+			call_ns = elapsed_ns(t0);
+		}
+		long long iterations = 1;
+		double const min_sample_ns = parameters.min_sample_time * 1e9;
+		if (call_ns < min_sample_ns)
+			iterations = static_cast<long long>(std::ceil(min_sample_ns / std::max(call_ns, 1.0)));
+
+		std::vector<double> samples;
+		for (int k = 0; k < std::max(parameters.repetitions, 1); ++k) {
+			clock::time_point const t0 = clock::now();
+			for (long long i = 0; i < iterations; ++i)
+				function();
+			samples.push_back(elapsed_ns(t0) / iterations);
+		}
+
+		benchmark_result result;
+		result.name = name;
+		result.repetitions = int(samples.size());
+		result.iterations = iterations;
+		result.median = benchmark_median(samples);
+		result.mad = benchmark_mad(samples);
+		result.min = *std::min_element(samples.begin(), samples.end());
+		double sum = 0;
+		for (double s : samples)
+			sum += s;
+		result.mean = sum / samples.size();
+		return result;
+	}
+
+
+	static std::string benchmark_json_escape(std::string const& s)
+	{
+		std::string escaped;
+		for (char c : s) {
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	bool benchmark_save_json(std::string const& filename, std::vector<benchmark_result> const& results)
+	{
+		std::ofstream stream(filename);
+		if (!stream.is_open()) {
+			warning_cgp("Cannot write the benchmark results", filename);
+			return false;
+		}
+
+#if defined(__clang__)
+		std::string const compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+		std::string const compiler = "gcc " __VERSION__;
+#elif defined(_MSC_FULL_VER)
+		std::string const compiler = "MSVC " + str(_MSC_FULL_VER);
+#else
+		std::string const compiler = "unknown";
+#endif
+		stream << "{\n";
+		stream << "  \"context\": {\"compiler\": \"" << benchmark_json_escape(compiler) << "\", \"hardware_threads\": " << std::thread::hardware_concurrency() << "},\n";
+		stream << "  \"benchmarks\": [\n";
+		char buffer[256];
+		for (size_t k = 0; k < results.size(); ++k) {
+			benchmark_result const& r = results[k];
+			std::snprintf(buffer, sizeof(buffer), "\"repetitions\": %d, \"iterations\": %lld, \"median_ns\": %.6g, \"mad_ns\": %.6g, \"min_ns\": %.6g, \"mean_ns\": %.6g",
+				r.repetitions, r.iterations, r.median, r.mad, r.min, r.mean);
+			stream << "    {\"name\": \"" << benchmark_json_escape(r.name) << "\", " << buffer << "}" << (k + 1 < results.size() ? "," : "") << "\n";
+		}
+		stream << "  ]\n}\n";
+		return stream.good();
+	}
+
+	// Value following "key": in an object of the file (only the flat objects written by benchmark_save_json are supported)
+	static bool benchmark_json_value(std::string const& object, std::string const& key, std::string& value)
+	{
+		size_t position = object.find("\"" + key + "\"");
+		if (position == std::string::npos)
+			return false;
+		position = object.find(':', position + key.size() + 2);
+		if (position == std::string::npos)
+			return false;
+		position = object.find_first_not_of(" \t\r\n", position + 1);
+		if (position == std::string::npos)
+			return false;
+
+		value.clear();
+		if (object[position] == '"') {
+			for (size_t k = position + 1; k < object.size() && object[k] != '"'; ++k) {
+				if (object[k] == '\\' && k + 1 < object.size())
+					++k;
+				value += object[k];
+			}
+			return true;
+		}
+		size_t const end = object.find_first_of(",}", position);
+		value = object.substr(position, end == std::string::npos ? std::string::npos : end - position);
+		return true;
+	}
+
+	std::vector<benchmark_result> benchmark_load_json(std::string const& filename)
+	{
+		std::vector<benchmark_result> results;
+		std::ifstream stream(filename);
+		if (!stream.is_open()) {
+			warning_cgp("Cannot read the benchmark results", filename);
+			return results;
+		}
+		std::string const content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		// Each object containing a median is a benchmark
+		size_t position = 0;
+		while ((position = content.find("\"median_ns\"", position)) != std::string::npos) {
+			size_t const begin = content.rfind('{', position);
+			size_t const end = content.find('}', position);
+			position = (end == std::string::npos) ? content.size() : end;
+			if (begin == std::string::npos || end == std::string::npos)
+				break;
+			std::string const object = content.substr(begin, end - begin + 1);
+
+			benchmark_result r;
+			std::string value;
+			if (!benchmark_json_value(object, "name", r.name))
+				continue;
+			if (benchmark_json_value(object, "repetitions", value)) r.repetitions = std::stoi(value);
+			if (benchmark_json_value(object, "iterations", value)) r.iterations = std::stoll(value);
+			if (benchmark_json_value(object, "median_ns", value)) r.median = std::stod(value);
+			if (benchmark_json_value(object, "mad_ns", value)) r.mad = std::stod(value);
+			if (benchmark_json_value(object, "min_ns", value)) r.min = std::stod(value);
+			if (benchmark_json_value(object, "mean_ns", value)) r.mean = std::stod(value);
+			results.push_back(r);
+		}
+		return results;
+	}
+
+	std::vector<benchmark_comparison> benchmark_compare(std::vector<benchmark_result> const& before, std::vector<benchmark_result> const& after, double threshold)
+	{
+		auto const find = [](std::vector<benchmark_result> const& results, std::string const& name) {
+			return std::find_if(results.begin(), results.end(), [&name](benchmark_result const& r) { return r.name == name; });
+		};
+
+		std::vector<benchmark_comparison> comparisons;
+		for (benchmark_result const& a : after) {
+			benchmark_comparison c;
+			c.name = a.name;
+			c.after = a.median;
+			auto const b = find(before, a.name);
+			if (b == before.end()) {
+				c.change = benchmark_change::added;
+				comparisons.push_back(c);
+				continue;
+			}
+			c.before = b->median;
+			c.ratio = c.before > 0 ? c.after / c.before : 0.0;
+
+			// 1.4826 MAD is an estimation of the standard deviation for a normal distribution
+			double const noise = 3 * 1.4826 * std::max(a.mad, b->mad);
+			double const difference = c.after - c.before;
+			if (std::abs(difference) > threshold * c.before && std::abs(difference) > noise)
+				c.change = difference > 0 ? benchmark_change::regression : benchmark_change::improvement;
+			comparisons.push_back(c);
+		}
+		for (benchmark_result const& b : before) {
+			if (find(after, b.name) == after.end()) {
+				benchmark_comparison c;
+				c.name = b.name;
+				c.before = b.median;
+				c.change = benchmark_change::removed;
+				comparisons.push_back(c);
+			}
+		}
+		return comparisons;
+	}
+
+
+	std::string benchmark_time_str(double ns)
+	{
+		char buffer[32];
+		if (ns < 1e3)
+			std::snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+		else if (ns < 1e6)
+			std::snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+		else if (ns < 1e9)
+			std::snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+		else
+			std::snprintf(buffer, sizeof(buffer), "%.3f s", ns / 1e9);
+		return buffer;
+	}
+
+	std::string str(benchmark_result const& result)
+	{
+		char buffer[64];
+		std::snprintf(buffer, sizeof(buffer), " (+/- %.1f%%)", result.median > 0 ? 100 * result.mad / result.median : 0.0);
+		return result.name + ": " + benchmark_time_str(result.median) + buffer + " [" + str(result.repetitions) + " x " + str(result.iterations) + " calls]";
+	}
+
+	std::string str(benchmark_change change)
+	{
+		switch (change) {
+		case benchmark_change::unchanged: return "unchanged";
+		case benchmark_change::regression: return "REGRESSION";
+		case benchmark_change::improvement: return "improvement";
+		case benchmark_change::added: return "added";
+		case benchmark_change::removed: return "removed";
+		}
+		return "";
+	}
+
+	std::string str(benchmark_comparison const& c)
+	{
+		if (c.change == benchmark_change::added)
+			return c.name + ": " + benchmark_time_str(c.after) + " (added)";
+		if (c.change == benchmark_change::removed)
+			return c.name + ": " + benchmark_time_str(c.before) + " (removed)";
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%+.1f%%", 100 * (c.ratio - 1));
+		return c.name + ": " + benchmark_time_str(c.before) + " -> " + benchmark_time_str(c.after) + " (" + buffer + ") " + str(c.change);
+	}
+}
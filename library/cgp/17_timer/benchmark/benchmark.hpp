@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Microbenchmark harness
+//  benchmark_run() calls the function a few times without measure (warmup), then measures a number of samples.
+//  A sample repeats the function enough times to last at least min_sample_time, so that fast functions are measured above the clock resolution.
+//  The results (median and median absolute deviation of the time per call) can be saved as JSON and compared between two runs.
+namespace cgp
+{
+	struct benchmark_parameters {
+		int warmup = 2;                // Calls before the measures (caches, allocations, thread pools)
+		int repetitions = 15;          // Number of measured samples
+		double min_sample_time = 0.01; // Minimal duration of a sample (s)
+	};
+
+	// Times per call in ns
+	struct benchmark_result {
+		std::string name;
+		int repetitions = 0;
+		long long iterations = 0;  // Calls per sample
+		double median = 0;
+		double mad = 0;            // Median absolute deviation
+		double min = 0;
+		double mean = 0;
+	};
+
+	benchmark_result benchmark_run(std::string const& name, std::function<void()> const& function, benchmark_parameters const& parameters = benchmark_parameters());
+
+	double benchmark_median(std::vector<double> values);
+	double benchmark_mad(std::vector<double> const& values);
+
+	// One object per benchmark in the array "benchmarks" (times in ns)
+	bool benchmark_save_json(std::string const& filename, std::vector<benchmark_result> const& results);
+	// Read a file written by benchmark_save_json (returns an empty vector if the file cannot be read)
+	std::vector<benchmark_result> benchmark_load_json(std::string const& filename);
+
+	enum class benchmark_change { unchanged, regression, improvement, added, removed };
+
+	struct benchmark_comparison {
+		std::string name;
+		double before = 0; // Median times (ns)
+		double after = 0;
+		double ratio = 0;  // after/before
+		benchmark_change change = benchmark_change::unchanged;
+	};
+
+	// A benchmark is a regression (resp. an improvement) when its median increases (resp. decreases) by more than the relative threshold,
+	//  and the difference is larger than the noise of the two runs (3 times the largest MAD, scaled to a standard deviation).
+	std::vector<benchmark_comparison> benchmark_compare(std::vector<benchmark_result> const& before, std::vector<benchmark_result> const& after, double threshold = 0.05);
+
+	// Prevent the compiler from removing the computation of a value that is not used
+	void benchmark_keep(void const* value);
+	template <typename T> void benchmark_keep(T const& value) { benchmark_keep(static_cast<void const*>(&value)); }
+
+	// Time with a unit adapted to its magnitude (ex. "12.3 us")
+	std::string benchmark_time_str(double ns);
+	std::string str(benchmark_result const& result);
+	std::string str(benchmark_comparison const& comparison);
+	std::string str(benchmark_change change);
+}
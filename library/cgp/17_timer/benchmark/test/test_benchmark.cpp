@@ -0,0 +1,74 @@
+#include "cgp/01_base/base.hpp"
+#include "../benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_benchmark()
+	{
+		// Median and median absolute deviation: the outlier does not change the result
+		{
+			assert_cgp_no_msg(cgp::benchmark_median({ 3, 1, 2 }) == 2);
+			assert_cgp_no_msg(cgp::benchmark_median({ 4, 1, 3, 2 }) == 2.5);
+			assert_cgp_no_msg(cgp::benchmark_median({ 1, 2, 3, 4, 1000 }) == 3);
+			assert_cgp_no_msg(cgp::benchmark_mad({ 1, 2, 3, 4, 1000 }) == 1);
+		}
+
+		// Run: fast functions are repeated within a sample
+		{
+			cgp::benchmark_parameters parameters;
+			parameters.repetitions = 5;
+			parameters.min_sample_time = 0.001;
+			int calls = 0;
+			cgp::benchmark_result const r = cgp::benchmark_run("test_increment", [&calls]() { calls++; cgp::benchmark_keep(calls); }, parameters);
+			assert_cgp_no_msg(r.repetitions == 5);
+			assert_cgp_no_msg(r.iterations > 1);
+			assert_cgp_no_msg(calls >= 5 * r.iterations);
+			assert_cgp_no_msg(r.min <= r.median && r.median > 0);
+		}
+
+		// JSON round trip
+		{
+			cgp::benchmark_result a;
+			a.name = "test \"quoted\"";
+			a.repetitions = 7; a.iterations = 1000; a.median = 12.5; a.mad = 0.25; a.min = 12; a.mean = 13;
+			cgp::benchmark_result b = a;
+			b.name = "test_b";
+			b.median = 3.5e6;
+
+			std::string const filename = "test_benchmark.json";
+			assert_cgp_no_msg(cgp::benchmark_save_json(filename, { a, b }));
+			std::vector<cgp::benchmark_result> const loaded = cgp::benchmark_load_json(filename);
+			std::remove(filename.c_str());
+			assert_cgp_no_msg(loaded.size() == 2);
+			assert_cgp_no_msg(loaded[0].name == a.name && loaded[0].iterations == 1000 && loaded[0].repetitions == 7);
+			assert_cgp_no_msg(loaded[0].median == 12.5 && loaded[0].mad == 0.25);
+			assert_cgp_no_msg(loaded[1].name == "test_b" && loaded[1].median == 3.5e6);
+		}
+
+		// Comparison: a change is reported only above the threshold and above the noise
+		{
+			auto const result = [](std::string const& name, double median, double mad) {
+				cgp::benchmark_result r;
+				r.name = name; r.median = median; r.mad = mad;
+				return r;
+			};
+			std::vector<cgp::benchmark_result> const before = { result("slower", 100, 1), result("faster", 100, 1), result("noisy", 100, 10), result("small", 100, 0.1), result("removed", 100, 1) };
+			std::vector<cgp::benchmark_result> const after = { result("slower", 120, 1), result("faster", 80, 1), result("noisy", 120, 10), result("small", 102, 0.1), result("added", 100, 1) };
+			std::vector<cgp::benchmark_comparison> const c = cgp::benchmark_compare(before, after, 0.05);
+			assert_cgp_no_msg(c.size() == 6);
+			assert_cgp_no_msg(c[0].change == cgp::benchmark_change::regression && std::abs(c[0].ratio - 1.2) < 1e-9);
+			assert_cgp_no_msg(c[1].change == cgp::benchmark_change::improvement);
+			assert_cgp_no_msg(c[2].change == cgp::benchmark_change::unchanged);
+			assert_cgp_no_msg(c[3].change == cgp::benchmark_change::unchanged);
+			assert_cgp_no_msg(c[4].change == cgp::benchmark_change::added);
+			assert_cgp_no_msg(c[5].change == cgp::benchmark_change::removed && c[5].name == "removed");
+		}
+	}
+}
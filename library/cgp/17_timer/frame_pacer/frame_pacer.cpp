@@ -0,0 +1,105 @@
+#include "frame_pacer.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace cgp
+{
+	frame_pacer::frame_pacer(float fps_target_arg, int history_size)
+		:fps_target(fps_target_arg), vsync(false), refresh_rate(0.0f), spin_margin(0.001f), oversleep(0.001f), fps_previous(fps_target_arg),
+		history(std::max(history_size, 1), 0.0f), history_missed(std::max(history_size, 1), 0), history_index(0), history_count(0)
+	{
+		reset();
+	}
+
+	void frame_pacer::reset()
+	{
+		frame_start = clock::now();
+		deadline = frame_start;
+		fps_previous = fps_target;
+	}
+
+	bool frame_pacer::is_limited_by_vsync() const
+	{
+		return vsync && refresh_rate > 0 && fps_target >= refresh_rate - 0.5f;
+	}
+
+	void frame_pacer::wait()
+	{
+		if (fps_target != fps_previous)
+			reset();
+
+		clock::time_point now = clock::now();
+		bool missed = false;
+
+		if (fps_target > 0 && !is_limited_by_vsync())
+		{
+			clock::duration const period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps_target));
+			deadline += period;
+
+			if (now > deadline) {
+				missed = true;
+				// More than a full period late: restart from now instead of trying to catch up with a burst of frames
+				if (now - deadline > period)
+					deadline = now;
+			}
+			else {
+				// Coarse sleep up to the margin before the deadline, then spin
+				float const margin = std::max(spin_margin, oversleep);
+				clock::time_point const wake_target = deadline - std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(margin));
+				if (now < wake_target) {
+					std::this_thread::sleep_until(wake_target);
+					float const overshoot = std::chrono::duration<float>(clock::now() - wake_target).count();
+					// Follow quickly an increase of the overshoot, and decrease slowly
+					oversleep = overshoot > oversleep ? overshoot : 0.99f * oversleep + 0.01f * overshoot;
+				}
+				while (clock::now() < deadline)
+					std::this_thread::yield();
+				now = clock::now();
+			}
+		}
+		else
+			deadline = now;
+
+		record(1000.0f * std::chrono::duration<float>(now - frame_start).count(), missed);
+		frame_start = now;
+	}
+
+	void frame_pacer::record(float frame_time, bool missed)
+	{
+		int const N = int(history.size());
+		history[history_index] = frame_time;
+		history_missed[history_index] = missed ? 1 : 0;
+		history_index = (history_index + 1) % N;
+		history_count = std::min(history_count + 1, N);
+	}
+
+	frame_pacing_statistics frame_pacer::statistics() const
+	{
+		frame_pacing_statistics s;
+		s.frame_count = history_count;
+		if (history_count == 0)
+			return s;
+
+		std::vector<float> times(history.begin(), history.begin() + history_count);
+		for (int k = 0; k < history_count; ++k) {
+			s.mean += times[k];
+			s.missed_deadlines += history_missed[k];
+		}
+		s.mean /= history_count;
+
+		int const k99 = std::min(history_count - 1, int(0.99f * history_count));
+		std::nth_element(times.begin(), times.begin() + k99, times.end());
+		s.p99 = times[k99];
+		s.max = *std::max_element(times.begin() + k99, times.end());
+
+		return s;
+	}
+
+	std::string str(frame_pacing_statistics const& s)
+	{
+		return "mean " + str(s.mean) + "ms, p99 " + str(s.p99) + "ms, max " + str(s.max) + "ms, missed " + str(s.missed_deadlines) + "/" + str(s.frame_count);
+	}
+}
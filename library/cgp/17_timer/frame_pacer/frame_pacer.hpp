@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace cgp
+{
+	// Frame time statistics over the last frames (times in ms)
+	struct frame_pacing_statistics {
+		float mean = 0.0f;
+		float p99 = 0.0f;
+		float max = 0.0f;
+		int missed_deadlines = 0; // Number of frames that ended after their deadline (among the recorded frames)
+		int frame_count = 0;      // Number of recorded frames
+	};
+
+	// Limits the frame rate without busy waiting the entire frame.
+	//  - The wait sleeps until shortly before the deadline, then spins for the remaining time (spin_margin) to compensate the OS sleep granularity.
+	//  - Deadlines are incremented by the frame period (and not resampled after the wait) to avoid any drift.
+	//  - When vsync is active and the monitor refresh rate is below the target, the buffer swap already blocks: no additional wait is added.
+	// Usage: call wait() once per frame, after the swap of the buffers.
+	class frame_pacer
+	{
+	public:
+		frame_pacer(float fps_target = 60.0f, int history_size = 240);
+
+		// Wait until the deadline of the current frame and record its duration
+		void wait();
+		// Restart the deadlines from the current time (ex. after a long loading, or a change of fps_target)
+		void reset();
+
+		frame_pacing_statistics statistics() const;
+
+		float fps_target;     // Target number of frames per second (a value <= 0 disables the limitation)
+		bool vsync;           // Is the buffer swap synchronized with the monitor
+		float refresh_rate;   // Refresh rate of the monitor (Hz) - 0 if unknown
+		float spin_margin;    // Minimal duration (s) spent spinning before the deadline
+
+	private:
+		using clock = std::chrono::steady_clock;
+
+		bool is_limited_by_vsync() const;
+		void record(float frame_time, bool missed);
+
+		clock::time_point deadline;
+		clock::time_point frame_start;
+		float oversleep;       // Running estimate of the OS sleep overshoot (s)
+		float fps_previous;
+
+		std::vector<float> history;
+		std::vector<char> history_missed;
+		int history_index;
+		int history_count;
+	};
+
+	std::string str(frame_pacing_statistics const& s);
+}
@@ -0,0 +1,333 @@
+#include "gpu_profiler.hpp"
+
+#include "cgp/opengl_include.hpp"
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+
+namespace cgp
+{
+	bool gpu_profiler::active = true;
+	int gpu_profiler::history_size = 300;
+	int gpu_profiler::frame_latency = 4;
+
+	namespace
+	{
+		struct zone_record {
+			char const* name;
+			int depth;
+			int query_begin;
+			int query_end; // -1 while the zone is open
+		};
+
+		// Queries of one frame. The slot is reused frame_latency frames later.
+		struct frame_slot {
+			std::vector<GLuint> queries; // Pool of query objects (grows with the number of zones)
+			int query_count = 0;
+			std::vector<zone_record> zones;
+			long long cpu_offset = 0;    // profiler_now() - GPU timestamp, measured at the start of the frame
+			long frame = 0;
+			bool pending = false;
+		};
+
+		struct zone_result {
+			char const* name;
+			int depth;
+			float ms;
+		};
+		struct frame_result {
+			long frame;
+			std::vector<zone_result> zones;
+		};
+
+		struct gpu_profiler_state {
+			std::vector<frame_slot> slots;
+			int current = -1; // Slot of the frame being recorded
+			long frame_count = 0;
+			int depth = 0;
+			int lane = -1;    // Lane "GPU" of the CPU profiler
+			int dropped = 0;
+			std::deque<frame_result> history;
+		};
+		gpu_profiler_state& state()
+		{
+			static gpu_profiler_state s;
+			return s;
+		}
+
+#ifndef __EMSCRIPTEN__
+		// Read the timestamps of the slot (all available) and store the durations
+		void resolve(gpu_profiler_state& s, frame_slot& slot)
+		{
+			if (s.lane < 0)
+				s.lane = profiler_add_lane("GPU");
+
+			frame_result result = { slot.frame, {} };
+			for (zone_record const& zone : slot.zones) {
+				if (zone.query_end < 0)
+					continue;
+				GLuint64 t0 = 0, t1 = 0;
+				glGetQueryObjectui64v(slot.queries[zone.query_begin], GL_QUERY_RESULT, &t0);
+				glGetQueryObjectui64v(slot.queries[zone.query_end], GL_QUERY_RESULT, &t1);
+				long long const start = static_cast<long long>(t0) + slot.cpu_offset;
+				long long const end = std::max(static_cast<long long>(t1) + slot.cpu_offset, start);
+				profiler_lane_record(s.lane, zone.name, start, end, zone.depth);
+				result.zones.push_back({ zone.name, zone.depth, (end - start) / 1e6f });
+			}
+			s.history.push_back(std::move(result));
+			while (s.history.size() > size_t(std::max(gpu_profiler::history_size, 1)))
+				s.history.pop_front();
+
+			// The CPU timeline waits for the GPU zones of the displayed frame
+			profiler::timeline_delay = int(s.frame_count - 1 - slot.frame);
+			slot.pending = false;
+		}
+
+		// Next query object of the slot (the pool grows when needed)
+		GLuint next_query(frame_slot& slot)
+		{
+			if (slot.query_count == int(slot.queries.size())) {
+				size_t const N_before = slot.queries.size();
+				slot.queries.resize(std::max(N_before * 2, size_t(32)));
+				glGenQueries(GLsizei(slot.queries.size() - N_before), slot.queries.data() + N_before);
+			}
+			return slot.queries[slot.query_count++];
+		}
+
+		void delete_queries(gpu_profiler_state& s)
+		{
+			for (frame_slot& slot : s.slots)
+				if (!slot.queries.empty())
+					glDeleteQueries(GLsizei(slot.queries.size()), slot.queries.data());
+			s.slots.clear();
+			s.current = -1;
+		}
+#endif
+	}
+
+	void gpu_profiler_frame_begin()
+	{
+#ifndef __EMSCRIPTEN__
+		gpu_profiler_state& s = state();
+		int const N_slot = std::max(gpu_profiler::frame_latency, 2);
+		if (int(s.slots.size()) != N_slot) {
+			delete_queries(s);
+			s.slots.resize(N_slot);
+		}
+
+		// Results of the previous frames, from the oldest. The queries of a frame complete in order: the last one is enough to test the whole frame.
+		//  Polling GL_QUERY_RESULT_AVAILABLE never waits for the GPU.
+		for (int k = 1; k <= N_slot; ++k) {
+			frame_slot& slot = s.slots[(s.current + k + N_slot) % N_slot];
+			if (!slot.pending)
+				continue;
+			if (slot.query_count == 0) {
+				slot.pending = false;
+				continue;
+			}
+			GLint available = 0;
+			glGetQueryObjectiv(slot.queries[slot.query_count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				break;
+			resolve(s, slot);
+		}
+
+		s.depth = 0;
+		if (!gpu_profiler::active) {
+			s.current = -1;
+			return;
+		}
+
+		// Start the new frame. A slot still pending is one whose results did not arrive after frame_latency frames: it is dropped.
+		s.current = (s.current + 1) % N_slot;
+		frame_slot& slot = s.slots[s.current];
+		if (slot.pending)
+			s.dropped++;
+		slot.query_count = 0;
+		slot.zones.clear();
+		slot.frame = s.frame_count++;
+		slot.pending = true;
+
+		// Offset between the GPU and the CPU clocks, to display the GPU zones on the CPU timeline
+		GLint64 gpu_now = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+		slot.cpu_offset = profiler_now() - static_cast<long long>(gpu_now);
+#endif
+	}
+
+	void gpu_profiler_finish()
+	{
+#ifndef __EMSCRIPTEN__
+		gpu_profiler_state& s = state();
+		int const N_slot = int(s.slots.size());
+		for (int k = 1; k <= N_slot; ++k) {
+			frame_slot& slot = s.slots[(s.current + k + N_slot) % N_slot];
+			if (slot.pending)
+				resolve(s, slot); // GL_QUERY_RESULT waits for the GPU
+		}
+		s.current = -1;
+		s.depth = 0;
+#endif
+	}
+
+	void gpu_profiler_cleanup()
+	{
+#ifndef __EMSCRIPTEN__
+		delete_queries(state());
+#endif
+	}
+
+	int gpu_profiler_zone_begin(char const* name)
+	{
+#ifndef __EMSCRIPTEN__
+		gpu_profiler_state& s = state();
+		if (s.current < 0)
+			return -1;
+		frame_slot& slot = s.slots[s.current];
+		glQueryCounter(next_query(slot), GL_TIMESTAMP);
+		slot.zones.push_back({ name, s.depth, slot.query_count - 1, -1 });
+		s.depth++;
+		return int(slot.zones.size()) - 1;
+#else
+		return -1;
+#endif
+	}
+
+	void gpu_profiler_zone_end(int zone)
+	{
+#ifndef __EMSCRIPTEN__
+		gpu_profiler_state& s = state();
+		if (s.current < 0 || zone >= int(s.slots[s.current].zones.size()))
+			return; // The frame changed during the zone
+		frame_slot& slot = s.slots[s.current];
+		s.depth--;
+		glQueryCounter(next_query(slot), GL_TIMESTAMP);
+		slot.zones[zone].query_end = slot.query_count - 1;
+#endif
+	}
+
+	static float percentile_sorted(std::vector<float> const& sorted, float p)
+	{
+		if (sorted.empty())
+			return 0.0f;
+		size_t const k = size_t(std::ceil(p * sorted.size()));
+		return sorted[std::min(std::max(k, size_t(1)) - 1, sorted.size() - 1)];
+	}
+
+	// Time per pass name for each frame of the history (the zones with the same name in a frame are summed)
+	static void gpu_profiler_table(std::vector<std::string>& names, std::vector<int>& depths, std::vector<std::vector<float>>& values)
+	{
+		gpu_profiler_state const& s = state();
+		names.clear();
+		depths.clear();
+		values.clear();
+		for (frame_result const& frame : s.history) {
+			std::vector<float> row(names.size(), -1.0f);
+			for (zone_result const& zone : frame.zones) {
+				size_t const k = size_t(std::find(names.begin(), names.end(), zone.name) - names.begin());
+				if (k == names.size()) {
+					names.push_back(zone.name);
+					depths.push_back(zone.depth);
+					for (std::vector<float>& previous : values)
+						previous.push_back(-1.0f);
+					row.push_back(-1.0f);
+				}
+				row[k] = std::max(row[k], 0.0f) + zone.ms;
+			}
+			values.push_back(row);
+		}
+	}
+
+	std::vector<gpu_pass_statistics> gpu_profiler_statistics()
+	{
+		std::vector<std::string> names;
+		std::vector<int> depths;
+		std::vector<std::vector<float>> values;
+		gpu_profiler_table(names, depths, values);
+
+		std::vector<gpu_pass_statistics> statistics;
+		for (size_t k = 0; k <= names.size(); ++k) {
+			bool const total = (k == names.size());
+			gpu_pass_statistics pass;
+			pass.name = total ? "total" : names[k];
+			pass.depth = total ? 0 : depths[k];
+
+			std::vector<float> samples;
+			for (std::vector<float> const& row : values) {
+				float v = -1.0f;
+				if (!total)
+					v = row[k];
+				else
+					for (size_t j = 0; j < names.size(); ++j)
+						if (depths[j] == 0 && row[j] >= 0)
+							v = std::max(v, 0.0f) + row[j];
+				if (v >= 0)
+					samples.push_back(v);
+			}
+			if (samples.empty() && !total)
+				continue;
+
+			pass.samples = int(samples.size());
+			if (!samples.empty()) {
+				pass.last = samples.back();
+				float sum = 0.0f;
+				for (float v : samples)
+					sum += v;
+				pass.average = sum / samples.size();
+				std::sort(samples.begin(), samples.end());
+				pass.p95 = percentile_sorted(samples, 0.95f);
+			}
+			statistics.push_back(pass);
+		}
+		return statistics;
+	}
+
+	int gpu_profiler_dropped_frames()
+	{
+		return state().dropped;
+	}
+
+	void gpu_profiler_clear()
+	{
+		gpu_profiler_state& s = state();
+		s.history.clear();
+		s.dropped = 0;
+	}
+
+	bool gpu_profiler_export_csv(std::string const& filename)
+	{
+		std::vector<std::string> names;
+		std::vector<int> depths;
+		std::vector<std::vector<float>> values;
+		gpu_profiler_table(names, depths, values);
+
+		std::ofstream stream(filename);
+		if (!stream.is_open()) {
+			warning_cgp("Cannot write the GPU profiler results", filename);
+			return false;
+		}
+
+		// Missing passes are left empty. Times in ms.
+		gpu_profiler_state const& s = state();
+		stream << "frame";
+		for (std::string const& name : names)
+			stream << "," << name;
+		stream << ",total\n";
+		for (size_t f = 0; f < values.size(); ++f) {
+			stream << s.history[f].frame;
+			float total = 0.0f;
+			for (size_t k = 0; k < names.size(); ++k) {
+				stream << ",";
+				if (values[f][k] >= 0)
+					stream << values[f][k];
+				if (depths[k] == 0 && values[f][k] >= 0)
+					total += values[f][k];
+			}
+			stream << "," << total << "\n";
+		}
+		return stream.good();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "profiler.hpp"
+
+#include <string>
+#include <vector>
+
+// GPU profiler of the render passes
+//  profile_gpu_zone_cgp("name") measures the GPU time of the OpenGL commands issued until the end of the current scope (zones can be nested).
+//  The time is measured with two GL_TIMESTAMP queries. The results are read back a few frames later (ring of frames) so that the CPU never waits for the GPU.
+//  The zones are added to the "GPU" lane of the CPU profiler (timeline and Chrome trace), and kept over the last frames for the averages, p95 and CSV export.
+//  gpu_profiler_frame_begin() must be called once per frame, when the OpenGL context is current.
+//  The names must be string literals (only the pointer is stored). Defining CGP_NO_PROFILER removes the zones at compile time.
+#ifndef CGP_NO_PROFILER
+	#define profile_gpu_zone_cgp(NAME) cgp::gpu_profiler_zone const cgp_profiler_concatenate(cgp_gpu_profiler_zone_, __LINE__)(NAME)
+#else
+	#define profile_gpu_zone_cgp(NAME) {}
+#endif
+
+namespace cgp
+{
+	struct gpu_profiler {
+		static bool active;       // Queries are issued only when active (can be changed at runtime)
+		static int history_size;  // Number of frames kept for the statistics and the CSV export
+		static int frame_latency; // Number of frames in the query ring: results older than this are discarded instead of waiting for the GPU
+	};
+
+	// GPU time of a pass over the frames kept in the history (ms)
+	struct gpu_pass_statistics {
+		std::string name;
+		int depth = 0;
+		int samples = 0;    // Number of frames containing the pass
+		float last = 0;
+		float average = 0;
+		float p95 = 0;
+	};
+
+	// Read back the queries of the previous frames that are available, and start a new frame
+	void gpu_profiler_frame_begin();
+	// Wait for the results of all the recorded frames (ex. at the end of a benchmark)
+	void gpu_profiler_finish();
+	// Delete the queries (to be called before the OpenGL context is destroyed)
+	void gpu_profiler_cleanup();
+
+	// Used by gpu_profiler_zone (returns the index of the zone in the current frame, or -1 if not recorded)
+	int gpu_profiler_zone_begin(char const* name);
+	void gpu_profiler_zone_end(int zone);
+
+	// Statistics of the passes in the order of their first appearance. The last element is the sum of the top level passes ("total").
+	std::vector<gpu_pass_statistics> gpu_profiler_statistics();
+	// Number of frames whose results were discarded because the GPU was too late (see frame_latency)
+	int gpu_profiler_dropped_frames();
+	void gpu_profiler_clear();
+
+	// One row per frame of the history and one column per pass (ms)
+	bool gpu_profiler_export_csv(std::string const& filename);
+
+	// ImGui table of the passes (last, average and p95), and export button (defined in profiler_imgui.cpp)
+	void gpu_profiler_display_imgui(std::string const& csv_filename = "gpu_passes.csv");
+
+
+	// RAII zone created by profile_gpu_zone_cgp
+	class gpu_profiler_zone {
+	public:
+		explicit gpu_profiler_zone(char const* name)
+			:zone(gpu_profiler::active ? gpu_profiler_zone_begin(name) : -1)
+		{}
+		~gpu_profiler_zone()
+		{
+			if (zone >= 0)
+				gpu_profiler_zone_end(zone);
+		}
+		gpu_profiler_zone(gpu_profiler_zone const&) = delete;
+		gpu_profiler_zone& operator=(gpu_profiler_zone const&) = delete;
+	private:
+		int zone;
+	};
+}
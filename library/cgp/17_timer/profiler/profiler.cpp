@@ -0,0 +1,305 @@
+#include "profiler.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CGP_PROFILER_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace cgp
+{
+	bool profiler::active = true;
+	int profiler::thread_capacity = 1 << 15;
+	int profiler::timeline_delay = 0;
+
+	// Ring buffer written by a single thread. The readers copy the events below count, and discard the ones that were overwritten during the copy.
+	struct profiler_thread_buffer {
+		std::unique_ptr<profiler_event[]> events;
+		unsigned long long capacity = 0;
+		std::atomic<unsigned long long> count;
+		int depth = 0;
+		int index = 0;
+		std::string name;
+	};
+
+	namespace
+	{
+		using thread_buffer = profiler_thread_buffer;
+		using clock = std::chrono::steady_clock;
+
+		// Timestamps of the zones: TSC ticks on x86-64 (about twice cheaper than steady_clock), ns since the epoch otherwise.
+		//  The ticks are converted into ns when the events are read, using the ratio measured since the epoch (invariant TSC).
+		inline long long ticks()
+		{
+#ifdef CGP_PROFILER_TSC
+			return static_cast<long long>(__rdtsc());
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+#endif
+		}
+		clock::time_point const profiler_epoch = clock::now();
+		long long const ticks_epoch = ticks();
+
+		struct ticks_converter {
+			double ns_per_tick;
+			long long operator()(long long t) const { return static_cast<long long>((t - ticks_epoch) * ns_per_tick); }
+			long long inverse(long long ns) const { return ticks_epoch + static_cast<long long>(ns / ns_per_tick); }
+		};
+		ticks_converter current_converter()
+		{
+#ifdef CGP_PROFILER_TSC
+			long long const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - profiler_epoch).count();
+			long long const elapsed = ticks() - ticks_epoch;
+			return { (ns > 0 && elapsed > 0) ? double(ns) / double(elapsed) : 1.0 };
+#else
+			return { 1.0 };
+#endif
+		}
+
+		struct registry_structure {
+			std::mutex mutex;
+			std::vector<std::shared_ptr<thread_buffer>> threads; // Kept after the end of the threads
+
+			std::vector<long long> frames;
+			size_t frame_index = 0;
+			int frame_thread = 0; // Thread calling profiler_frame_mark
+		};
+		registry_structure& registry()
+		{
+			static registry_structure r;
+			return r;
+		}
+
+		std::shared_ptr<thread_buffer> create_thread_buffer()
+		{
+			unsigned long long capacity = 1;
+			while (capacity < static_cast<unsigned long long>(std::max(profiler::thread_capacity, 16)))
+				capacity *= 2;
+
+			auto buffer = std::make_shared<thread_buffer>();
+			buffer->events.reset(new profiler_event[capacity]);
+			buffer->capacity = capacity;
+			buffer->count.store(0);
+
+			registry_structure& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			buffer->index = int(r.threads.size());
+			buffer->name = "thread " + str(buffer->index);
+			r.threads.push_back(buffer);
+			return buffer;
+		}
+
+		thread_buffer& current_thread_buffer()
+		{
+			thread_local thread_buffer* buffer = nullptr;
+			if (buffer == nullptr)
+				buffer = create_thread_buffer().get();
+			return *buffer;
+		}
+
+		void push_event(thread_buffer& buffer, profiler_event const& e)
+		{
+			unsigned long long const k = buffer.count.load(std::memory_order_relaxed);
+			buffer.events[k & (buffer.capacity - 1)] = e;
+			buffer.count.store(k + 1, std::memory_order_release);
+		}
+
+		size_t const frame_capacity = 256;
+	}
+
+	long long profiler_now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - profiler_epoch).count();
+	}
+
+	profiler_thread_buffer* profiler_zone_begin(long long& start)
+	{
+		thread_buffer& buffer = current_thread_buffer();
+		buffer.depth++;
+		start = ticks();
+		return &buffer;
+	}
+
+	void profiler_zone_end(profiler_thread_buffer* buffer, char const* name, long long start)
+	{
+		long long const end = ticks();
+		buffer->depth--;
+		push_event(*buffer, { name, start, end, buffer->depth, buffer->index });
+	}
+
+	void profiler_frame_mark()
+	{
+		if (!profiler::active)
+			return;
+		long long const t = ticks();
+		int const thread = current_thread_buffer().index;
+		registry_structure& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.frame_thread = thread;
+		if (r.frames.size() < frame_capacity)
+			r.frames.push_back(t);
+		else
+			r.frames[r.frame_index % frame_capacity] = t;
+		r.frame_index++;
+	}
+
+	std::vector<long long> profiler_frames()
+	{
+		registry_structure& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		ticks_converter const to_ns = current_converter();
+		std::vector<long long> frames;
+		size_t const N = r.frames.size();
+		for (size_t k = 0; k < N; ++k)
+			frames.push_back(to_ns(r.frames[(r.frame_index - N + k) % frame_capacity]));
+		return frames;
+	}
+
+	void profiler_set_thread_name(std::string const& name)
+	{
+		thread_buffer& buffer = current_thread_buffer();
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		buffer.name = name;
+	}
+
+	std::vector<profiler_thread_info> profiler_threads()
+	{
+		registry_structure& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::vector<profiler_thread_info> threads;
+		for (auto const& buffer : r.threads)
+			threads.push_back({ buffer->index, buffer->name });
+		return threads;
+	}
+
+	int profiler_add_lane(std::string const& name)
+	{
+		std::shared_ptr<thread_buffer> const buffer = create_thread_buffer();
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		buffer->name = name;
+		return buffer->index;
+	}
+
+	void profiler_lane_record(int lane, char const* name, long long start, long long end, int depth)
+	{
+		if (!profiler::active)
+			return;
+		std::shared_ptr<thread_buffer> buffer;
+		{
+			registry_structure& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			assert_cgp(lane >= 0 && lane < int(r.threads.size()), "Invalid profiler lane " + str(lane));
+			buffer = r.threads[lane];
+		}
+		ticks_converter const to_ns = current_converter();
+		push_event(*buffer, { name, to_ns.inverse(start), to_ns.inverse(end), depth, lane });
+	}
+
+	std::vector<profiler_event> profiler_collect(long long t_min, long long t_max)
+	{
+		std::vector<std::shared_ptr<thread_buffer>> threads;
+		{
+			registry_structure& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			threads = r.threads;
+		}
+
+		std::vector<profiler_event> events;
+		for (auto const& buffer : threads) {
+			unsigned long long const count = buffer->count.load(std::memory_order_acquire);
+			unsigned long long const first = count > buffer->capacity ? count - buffer->capacity : 0;
+			size_t const offset = events.size();
+			for (unsigned long long k = first; k < count; ++k)
+				events.push_back(buffer->events[k & (buffer->capacity - 1)]);
+
+			// Events overwritten by the thread during the copy are discarded.
+			//  The slot of the event count_after-capacity may be in the middle of being overwritten by the event count_after: it is discarded too.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			unsigned long long const count_after = buffer->count.load(std::memory_order_relaxed);
+			unsigned long long const first_valid = count_after + 1 > buffer->capacity ? count_after + 1 - buffer->capacity : 0;
+			if (first_valid > first)
+				events.erase(events.begin() + offset, events.begin() + offset + size_t(std::min(first_valid - first, count - first)));
+		}
+
+		ticks_converter const to_ns = current_converter();
+		for (profiler_event& e : events) {
+			e.start = to_ns(e.start);
+			e.end = to_ns(e.end);
+		}
+		events.erase(std::remove_if(events.begin(), events.end(), [t_min, t_max](profiler_event const& e) { return e.end < t_min || (t_max >= 0 && e.end > t_max); }), events.end());
+		std::stable_sort(events.begin(), events.end(), [](profiler_event const& a, profiler_event const& b) {
+			return a.thread != b.thread ? a.thread < b.thread : a.start < b.start;
+		});
+		return events;
+	}
+
+	void profiler_clear()
+	{
+		registry_structure& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for (auto& buffer : r.threads)
+			buffer->count.store(0); // Only safe when the other threads are not recording
+		r.frames.clear();
+		r.frame_index = 0;
+	}
+
+	static std::string json_escape(char const* s)
+	{
+		std::string escaped;
+		for (; s != nullptr && *s != '\0'; ++s) {
+			if (*s == '"' || *s == '\\')
+				escaped += '\\';
+			escaped += *s;
+		}
+		return escaped;
+	}
+
+	bool profiler_export_chrome_trace(std::string const& filename)
+	{
+		std::vector<profiler_event> const events = profiler_collect();
+		std::ofstream stream(filename);
+		if (!stream.is_open()) {
+			warning_cgp("Cannot write the profiler trace", filename);
+			return false;
+		}
+
+		// Complete events ("X") in microseconds, and one metadata event per thread for its name
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		for (profiler_thread_info const& thread : profiler_threads()) {
+			stream << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread.index << ",\"args\":{\"name\":\"" << json_escape(thread.name.c_str()) << "\"}}";
+			first = false;
+		}
+		char buffer[64];
+		for (profiler_event const& e : events) {
+			std::snprintf(buffer, sizeof(buffer), "\"ts\":%.3f,\"dur\":%.3f", e.start / 1000.0, (e.end - e.start) / 1000.0);
+			stream << (first ? "" : ",\n") << "{\"name\":\"" << json_escape(e.name) << "\",\"ph\":\"X\"," << buffer << ",\"pid\":0,\"tid\":" << e.thread << "}";
+			first = false;
+		}
+		int frame_thread = 0;
+		{
+			std::lock_guard<std::mutex> lock(registry().mutex);
+			frame_thread = registry().frame_thread;
+		}
+		for (long long const t : profiler_frames()) {
+			std::snprintf(buffer, sizeof(buffer), "\"ts\":%.3f", t / 1000.0);
+			stream << (first ? "" : ",\n") << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"t\"," << buffer << ",\"pid\":0,\"tid\":" << frame_thread << "}";
+			first = false;
+		}
+		stream << "\n]}\n";
+		return stream.good();
+	}
+}
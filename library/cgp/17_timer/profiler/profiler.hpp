@@ -0,0 +1,104 @@
+#pragma once
+
+#include "cgp/cgp_parameters.hpp"
+
+#include <string>
+#include <vector>
+
+// Scoped CPU profiler
+//  profile_zone_cgp("name") measures the time spent until the end of the current scope, profile_function_cgp() uses the name of the function.
+//  The zones are stored in a ring buffer per thread (no lock: two TSC reads and a store per zone) and can be displayed with profiler_display_imgui() or exported as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+//  The names must be string literals (only the pointer is stored).
+//  Defining CGP_NO_PROFILER removes all the zones at compile time.
+#ifndef CGP_NO_PROFILER
+	#define cgp_profiler_concatenate_impl(A, B) A##B
+	#define cgp_profiler_concatenate(A, B) cgp_profiler_concatenate_impl(A, B)
+	#define profile_zone_cgp(NAME) cgp::profiler_zone const cgp_profiler_concatenate(cgp_profiler_zone_, __LINE__)(NAME)
+	#define profile_function_cgp() profile_zone_cgp(__func__)
+	#define profile_thread_name_cgp(NAME) cgp::profiler_set_thread_name(NAME)
+	#define profile_frame_mark_cgp() cgp::profiler_frame_mark()
+#else
+	#define profile_zone_cgp(NAME) {}
+	#define profile_function_cgp() {}
+	#define profile_thread_name_cgp(NAME) {}
+	#define profile_frame_mark_cgp() {}
+#endif
+
+namespace cgp
+{
+	struct profiler {
+		static bool active;         // Zones are recorded only when active (can be changed at runtime)
+		static int thread_capacity; // Size of the ring buffer of each thread (power of 2, used when the buffer of a thread is created): the last thread_capacity-1 zones are kept
+		static int timeline_delay;  // Number of frames between the last frame and the one displayed by profiler_display_imgui (the GPU zones are received a few frames late)
+	};
+
+	// Zone recorded in the ring buffer of a thread (times in ns since the start of the profiler)
+	struct profiler_event {
+		char const* name;
+		long long start;
+		long long end;
+		int depth;  // Number of enclosing zones on the same thread
+		int thread; // Index of the thread in the order of their first zone
+	};
+
+	struct profiler_thread_info {
+		int index;
+		std::string name;
+	};
+
+	// Time since the start of the profiler (ns)
+	long long profiler_now();
+
+	// Ring buffer of the zones of a thread (defined in profiler.cpp)
+	struct profiler_thread_buffer;
+
+	// Used by profiler_zone: the buffer of the calling thread is looked up once per zone and given back at the end
+	//  (the start value is in internal ticks, converted in ns by profiler_collect)
+	profiler_thread_buffer* profiler_zone_begin(long long& start);
+	void profiler_zone_end(profiler_thread_buffer* buffer, char const* name, long long start);
+
+	// Mark the start of a new frame (to be called once per frame on the main thread)
+	void profiler_frame_mark();
+	// Start times of the last frames (in chronological order)
+	std::vector<long long> profiler_frames();
+
+	void profiler_set_thread_name(std::string const& name);
+	std::vector<profiler_thread_info> profiler_threads();
+
+	// Lanes are displayed and exported as threads, but their zones are given explicitly (ex. the GPU passes, measured afterward)
+	//  A lane is written by a single thread. The times are in ns, in the same time base as profiler_now().
+	int profiler_add_lane(std::string const& name);
+	void profiler_lane_record(int lane, char const* name, long long start, long long end, int depth);
+
+	// Zones ending in [t_min, t_max] that are still in the ring buffers, sorted by thread then start time
+	std::vector<profiler_event> profiler_collect(long long t_min = 0, long long t_max = -1);
+	// Remove all the recorded zones and frames
+	void profiler_clear();
+
+	// Write all the recorded zones in the Chrome trace event format (JSON)
+	bool profiler_export_chrome_trace(std::string const& filename);
+
+	// ImGui panel: timeline of the zones of the last frame for each thread, table of the most expensive zones, and export button
+	//  (defined in profiler_imgui.cpp, to be called between ImGui::Begin/End)
+	void profiler_display_imgui(std::string const& trace_filename = "profile.json");
+
+
+	// RAII zone created by profile_zone_cgp
+	class profiler_zone {
+	public:
+		explicit profiler_zone(char const* name_arg)
+			:name(name_arg), start(0), buffer(profiler::active ? profiler_zone_begin(start) : nullptr)
+		{}
+		~profiler_zone()
+		{
+			if (buffer != nullptr)
+				profiler_zone_end(buffer, name, start);
+		}
+		profiler_zone(profiler_zone const&) = delete;
+		profiler_zone& operator=(profiler_zone const&) = delete;
+	private:
+		char const* name;
+		long long start;
+		profiler_thread_buffer* buffer; // nullptr if the profiler was inactive at the start of the zone
+	};
+}
@@ -0,0 +1,148 @@
+#include "profiler.hpp"
+#include "gpu_profiler.hpp"
+
+#include "third_party/src/imgui/imgui.h"
+
+#include <algorithm>
+#include <map>
+
+namespace cgp
+{
+	static ImU32 profiler_zone_color(char const* name)
+	{
+		// Stable color per zone name
+		unsigned int h = 2166136261u;
+		for (char const* c = name; *c != '\0'; ++c)
+			h = (h ^ (unsigned char)(*c)) * 16777619u;
+		return IM_COL32(90 + (h & 0x7f), 90 + ((h >> 8) & 0x7f), 90 + ((h >> 16) & 0x7f), 255);
+	}
+
+	void profiler_display_imgui(std::string const& trace_filename)
+	{
+		static bool paused = false;
+		static long long frame_start = 0;
+		static long long frame_end = 0;
+		static std::vector<profiler_event> events;
+		static std::vector<profiler_thread_info> threads;
+
+		ImGui::Checkbox("Active", &profiler::active);
+		ImGui::SameLine();
+		ImGui::Checkbox("Pause", &paused);
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+			profiler_export_chrome_trace(trace_filename);
+
+		// Zones of the last complete frame (including the zones of the other threads overlapping the frame)
+		//  The displayed frame is delayed by profiler::timeline_delay frames when some zones are received late (GPU lane)
+		if (!paused) {
+			std::vector<long long> const frames = profiler_frames();
+			size_t const delay = size_t(std::max(profiler::timeline_delay, 0));
+			if (frames.size() >= 2 + delay) {
+				frame_start = frames[frames.size() - 2 - delay];
+				frame_end = frames[frames.size() - 1 - delay];
+				events = profiler_collect(frame_start);
+				events.erase(std::remove_if(events.begin(), events.end(), [](profiler_event const& e) { return e.start > frame_end; }), events.end());
+				threads = profiler_threads();
+			}
+		}
+		if (frame_end <= frame_start) {
+			ImGui::Text("No frame recorded (call profile_frame_mark_cgp() once per frame)");
+			return;
+		}
+		float const frame_ms = (frame_end - frame_start) / 1e6f;
+		ImGui::Text("Frame: %.3f ms", frame_ms);
+
+		// Timeline: one lane per thread, one row per depth of the zones
+		float const width = std::max(ImGui::GetContentRegionAvail().x, 300.0f);
+		float const row_height = ImGui::GetTextLineHeight() + 2.0f;
+		ImDrawList* draw_list = ImGui::GetWindowDrawList();
+		for (profiler_thread_info const& thread : threads) {
+			int max_depth = -1;
+			for (profiler_event const& e : events)
+				if (e.thread == thread.index)
+					max_depth = std::max(max_depth, e.depth);
+			if (max_depth < 0)
+				continue;
+
+			ImGui::Text("%s", thread.name.c_str());
+			ImVec2 const origin = ImGui::GetCursorScreenPos();
+			ImVec2 const size = ImVec2(width, row_height * (max_depth + 1));
+			ImGui::InvisibleButton(("##profiler_lane" + thread.name).c_str(), size);
+			bool const lane_hovered = ImGui::IsItemHovered();
+			ImVec2 const mouse = ImGui::GetMousePos();
+
+			draw_list->PushClipRect(origin, ImVec2(origin.x + size.x, origin.y + size.y), true);
+			for (profiler_event const& e : events) {
+				if (e.thread != thread.index)
+					continue;
+				float const x0 = origin.x + width * float(std::max(e.start, frame_start) - frame_start) / float(frame_end - frame_start);
+				float const x1 = origin.x + width * float(std::min(e.end, frame_end) - frame_start) / float(frame_end - frame_start);
+				float const y0 = origin.y + row_height * e.depth;
+				ImVec2 const p0 = ImVec2(x0, y0);
+				ImVec2 const p1 = ImVec2(std::max(x1, x0 + 1.0f), y0 + row_height - 1.0f);
+				draw_list->AddRectFilled(p0, p1, profiler_zone_color(e.name));
+				if (p1.x - p0.x > 30.0f) {
+					draw_list->PushClipRect(p0, p1, true);
+					draw_list->AddText(ImVec2(p0.x + 2.0f, p0.y + 1.0f), IM_COL32(0, 0, 0, 255), e.name);
+					draw_list->PopClipRect();
+				}
+				if (lane_hovered && mouse.x >= p0.x && mouse.x < p1.x && mouse.y >= p0.y && mouse.y < p1.y)
+					ImGui::SetTooltip("%s: %.3f ms", e.name, (e.end - e.start) / 1e6f);
+			}
+			draw_list->PopClipRect();
+		}
+
+		// Most expensive zones of the frame (inclusive time)
+		struct zone_total { float ms = 0.0f; int calls = 0; };
+		std::map<std::string, zone_total> totals;
+		for (profiler_event const& e : events) {
+			zone_total& t = totals[e.name];
+			t.ms += (std::min(e.end, frame_end) - std::max(e.start, frame_start)) / 1e6f;
+			t.calls++;
+		}
+		std::vector<std::pair<std::string, zone_total>> sorted(totals.begin(), totals.end());
+		std::sort(sorted.begin(), sorted.end(), [](auto const& a, auto const& b) { return a.second.ms > b.second.ms; });
+
+		ImGui::Columns(3, "profiler_zones");
+		ImGui::Text("Zone"); ImGui::NextColumn();
+		ImGui::Text("Time (ms)"); ImGui::NextColumn();
+		ImGui::Text("Calls"); ImGui::NextColumn();
+		for (size_t k = 0; k < sorted.size() && k < 12; ++k) {
+			ImGui::Text("%s", sorted[k].first.c_str()); ImGui::NextColumn();
+			ImGui::Text("%.3f", sorted[k].second.ms); ImGui::NextColumn();
+			ImGui::Text("%d", sorted[k].second.calls); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	void gpu_profiler_display_imgui(std::string const& csv_filename)
+	{
+		ImGui::Checkbox("GPU passes", &gpu_profiler::active);
+		ImGui::SameLine();
+		if (ImGui::Button("Export CSV"))
+			gpu_profiler_export_csv(csv_filename);
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			gpu_profiler_clear();
+
+		std::vector<gpu_pass_statistics> const statistics = gpu_profiler_statistics();
+		if (statistics.size() <= 1) {
+			ImGui::Text("No GPU pass recorded (call gpu_profiler_frame_begin() once per frame)");
+			return;
+		}
+		ImGui::Text("Over the last %d frames (%d dropped)", statistics.back().samples, gpu_profiler_dropped_frames());
+
+		ImGui::Columns(4, "gpu_profiler_passes");
+		ImGui::Text("Pass"); ImGui::NextColumn();
+		ImGui::Text("Last (ms)"); ImGui::NextColumn();
+		ImGui::Text("Average"); ImGui::NextColumn();
+		ImGui::Text("p95"); ImGui::NextColumn();
+		for (gpu_pass_statistics const& pass : statistics) {
+			ImGui::Text("%*s%s", 2 * pass.depth, "", pass.name.c_str()); ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.last); ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.average); ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.p95); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+}
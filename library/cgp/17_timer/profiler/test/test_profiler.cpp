@@ -0,0 +1,110 @@
+#include "cgp/01_base/base.hpp"
+#include "../profiler.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static int test_profiler_count(std::vector<cgp::profiler_event> const& events, std::string const& name)
+	{
+		int N = 0;
+		for (auto const& e : events)
+			if (name == e.name)
+				N++;
+		return N;
+	}
+
+	void test_profiler()
+	{
+		cgp::profiler::active = true;
+		long long const t0 = cgp::profiler_now();
+
+		// Nested zones: the inner zone is inside the outer one, with a larger depth
+		{
+			profile_zone_cgp("test_outer");
+			{
+				profile_zone_cgp("test_inner");
+			}
+		}
+		{
+			std::vector<cgp::profiler_event> const events = cgp::profiler_collect(t0);
+			cgp::profiler_event outer = {}, inner = {};
+			for (auto const& e : events) {
+				if (std::string(e.name) == "test_outer") outer = e;
+				if (std::string(e.name) == "test_inner") inner = e;
+			}
+			assert_cgp_no_msg(outer.name != nullptr && inner.name != nullptr);
+			assert_cgp_no_msg(inner.depth == outer.depth + 1);
+			assert_cgp_no_msg(outer.start <= inner.start && inner.end <= outer.end);
+			assert_cgp_no_msg(inner.thread == outer.thread);
+		}
+
+		// Inactive profiler: nothing is recorded
+		{
+			long long const t = cgp::profiler_now();
+			cgp::profiler::active = false;
+			{ profile_zone_cgp("test_inactive"); }
+			cgp::profiler::active = true;
+			assert_cgp_no_msg(test_profiler_count(cgp::profiler_collect(t), "test_inactive") == 0);
+		}
+
+		// Ring buffer of a new thread: only the last thread_capacity-1 zones are kept (the oldest slot may be in the middle of being overwritten)
+		{
+			int const capacity = cgp::profiler::thread_capacity;
+			cgp::profiler::thread_capacity = 64;
+			long long const t = cgp::profiler_now();
+			std::thread worker([]() {
+				profile_thread_name_cgp("test_worker");
+				for (int k = 0; k < 200; ++k) {
+					profile_zone_cgp("test_ring");
+				}
+			});
+			worker.join();
+			cgp::profiler::thread_capacity = capacity;
+
+			std::vector<cgp::profiler_event> const events = cgp::profiler_collect(t);
+			assert_cgp_no_msg(test_profiler_count(events, "test_ring") == 63);
+
+			bool named = false;
+			for (auto const& thread : cgp::profiler_threads())
+				named = named || thread.name == "test_worker";
+			assert_cgp_no_msg(named);
+		}
+
+		// Lane: zones given explicitly are returned at their time, on the thread index of the lane
+		{
+			int const lane = cgp::profiler_add_lane("test_lane");
+			long long const t = cgp::profiler_now();
+			cgp::profiler_lane_record(lane, "test_lane_zone", t + 1000000, t + 3000000, 0);
+			cgp::profiler_event zone = {};
+			for (auto const& e : cgp::profiler_collect(t))
+				if (std::string(e.name) == "test_lane_zone")
+					zone = e;
+			assert_cgp_no_msg(zone.name != nullptr && zone.thread == lane);
+			assert_cgp_no_msg(std::abs(zone.start - (t + 1000000)) < 1000 && std::abs(zone.end - (t + 3000000)) < 1000);
+		}
+
+		// Chrome trace export
+		{
+			cgp::profiler_frame_mark();
+			std::string const filename = "test_profiler_trace.json";
+			assert_cgp_no_msg(cgp::profiler_export_chrome_trace(filename));
+			std::ifstream stream(filename);
+			std::stringstream content;
+			content << stream.rdbuf();
+			std::string const json = content.str();
+			assert_cgp_no_msg(json.find("\"traceEvents\"") != std::string::npos);
+			assert_cgp_no_msg(json.find("\"name\":\"test_outer\",\"ph\":\"X\"") != std::string::npos);
+			assert_cgp_no_msg(json.find("\"args\":{\"name\":\"test_worker\"}") != std::string::npos);
+			std::remove(filename.c_str());
+		}
+	}
+}
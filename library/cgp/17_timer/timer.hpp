@@ -1,5 +1,9 @@
 #pragma once
 
+#include "benchmark/benchmark.hpp"
+#include "frame_pacer/frame_pacer.hpp"
+#include "profiler/profiler.hpp"
+#include "profiler/gpu_profiler.hpp"
 #include "timer_basic/timer_basic.hpp"
 #include "timer_event_periodic/timer_event_periodic.hpp"
 #include "timer_fps/timer_fps.hpp"
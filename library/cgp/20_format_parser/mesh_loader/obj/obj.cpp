@@ -10,7 +10,13 @@
 #include "cgp/01_base/base.hpp"
 #include "cgp/03_files/files.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <map>
+#include <thread>
 
 #include <fstream>
 #include <sstream>
@@ -18,7 +24,7 @@
 namespace cgp
 {
 
-    void mesh_save_file_obj(std::string const& filename, mesh const& m)
+    void save_file_obj(std::string const& filename, mesh const& m)
     {
         std::ofstream stream(filename, std::ofstream::out);
         assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
@@ -101,9 +107,450 @@ mesh mesh_load_file_obj(const std::string& filename)
     numarray<numarray<int>> vertex_correspondance;
      mesh m = mesh_load_file_obj(filename, vertex_correspondance);
      m.fill_empty_field();
+
+     // Reorder triangles and vertices for the GPU caches (the correspondance is not valid anymore after this step)
+     if(mesh_optimization::at_load) {
+        mesh_optimization_report const report = mesh_optimize(m);
+        if(mesh_optimization::verbose)
+            std::cout<<"[mesh_optimize] "<<filename<<" "<<str(report)<<std::endl;
+     }
      return m;
 }
+// Fast loader: the file is memory mapped, and split into chunks of lines parsed in parallel.
+//  The chunks are then concatenated in order, and the (position, uv, normal) triplets are deduplicated with an open addressing hash table.
+//  The output is the same as the stream based loader (loader::obj_load_reference).
+namespace {
+
+// Vertex of a face as written in the file (1-based indices, 0 when the field is absent)
+//  double_slash is set for the form "v//vn", as it changes the interpretation depending on the obj_type (see extract_face_index)
+struct obj_corner {
+    int3 index;
+    bool double_slash;
+};
+
+struct obj_chunk {
+    std::vector<vec3> position;
+    std::vector<vec2> uv;
+    std::vector<vec3> normal;
+    std::vector<obj_corner> corner; // triangulated faces: 3 consecutive corners per triangle
+};
+
+inline bool obj_is_space(char c)
+{
+    return c==' ' || c=='\t' || c=='\r' || c=='\v' || c=='\f';
+}
+inline bool obj_is_digit(char c)
+{
+    return c>='0' && c<='9';
+}
+inline char const* obj_skip_space(char const* it, char const* end)
+{
+    while(it<end && obj_is_space(*it))
+        ++it;
+    return it;
+}
+
+// Parse a float in [it,end[ and advance it. Return false (it unchanged) if no number can be read.
+//  The value is exact (same as strtof): decimal mantissas of up to 15 digits with small exponents are converted with a single correctly rounded double operation,
+//  the other cases, as well as the rare doubles that fall exactly on the middle of two floats, are handed to strtof.
+bool obj_parse_float(char const*& it, char const* end, float& value)
+{
+    static double const power_of_ten[] = { 1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22 };
+
+    char const* p = it;
+    bool negative = false;
+    if(p<end && (*p=='-' || *p=='+')) {
+        negative = (*p=='-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;        // significant digits stored in the mantissa
+    int exponent = 0;
+    bool truncated = false;
+    bool has_digit = false;
+    for(; p<end && obj_is_digit(*p); ++p) {
+        has_digit = true;
+        if(digits<19) {
+            mantissa = 10*mantissa + uint64_t(*p-'0');
+            if(mantissa>0) digits++;
+        }
+        else {
+            exponent++;
+            truncated = truncated || *p!='0';
+        }
+    }
+    if(p<end && *p=='.') {
+        ++p;
+        for(; p<end && obj_is_digit(*p); ++p) {
+            has_digit = true;
+            if(digits<19) {
+                mantissa = 10*mantissa + uint64_t(*p-'0');
+                if(mantissa>0) digits++;
+                exponent--;
+            }
+            else
+                truncated = truncated || *p!='0';
+        }
+    }
+    if(!has_digit)
+        return false;
+
+    if(p<end && (*p=='e' || *p=='E')) {
+        char const* q = p+1;
+        bool negative_exponent = false;
+        if(q<end && (*q=='-' || *q=='+')) {
+            negative_exponent = (*q=='-');
+            ++q;
+        }
+        if(q<end && obj_is_digit(*q)) {
+            int e = 0;
+            for(; q<end && obj_is_digit(*q); ++q)
+                if(e<100000) e = 10*e + (*q-'0');
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+
+    bool exact = false;
+    if(!truncated && mantissa<=(uint64_t(1)<<53) && exponent>=-22 && exponent<=22) {
+        double d = double(mantissa);
+        d = exponent<0 ? d/power_of_ten[-exponent] : d*power_of_ten[exponent];
+        if(d==0.0) {
+            value = negative ? -0.0f : 0.0f;
+            exact = true;
+        }
+        else if(d>=double(std::numeric_limits<float>::min()) && d<=double(std::numeric_limits<float>::max())) {
+            // Rounding the double to float is exact unless the double is exactly on the middle of two floats
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            if((bits & ((uint64_t(1)<<29)-1)) != (uint64_t(1)<<28)) {
+                value = negative ? -float(d) : float(d);
+                exact = true;
+            }
+        }
+    }
+    if(!exact) {
+        char buffer[128];
+        size_t const length = std::min(size_t(p-it), sizeof(buffer)-1);
+        std::memcpy(buffer, it, length);
+        buffer[length] = '\0';
+        value = std::strtof(buffer, nullptr);
+    }
+
+    it = p;
+    return true;
+}
+
+// Parse an integer in [it,end[ and advance it. Return false (it unchanged) if no integer can be read.
+bool obj_parse_int(char const*& it, char const* end, int& value)
+{
+    char const* p = it;
+    bool negative = false;
+    if(p<end && (*p=='-' || *p=='+')) {
+        negative = (*p=='-');
+        ++p;
+    }
+    if(p>=end || !obj_is_digit(*p))
+        return false;
+    long v = 0;
+    for(; p<end && obj_is_digit(*p); ++p)
+        v = 10*v + (*p-'0');
+    value = int(negative ? -v : v);
+    it = p;
+    return true;
+}
+
+// Read up to N floats separated by spaces (the missing ones are set to 0)
+template <int N>
+void obj_parse_floats(char const* it, char const* end, float* values)
+{
+    for(int k=0; k<N; ++k)
+        values[k] = 0.0f;
+    for(int k=0; k<N; ++k) {
+        it = obj_skip_space(it, end);
+        if(!obj_parse_float(it, end, values[k]))
+            return;
+    }
+}
+
+// Parse a face vertex "v", "v/vt", "v/vt/vn", or "v//vn" (same behavior as sscanf in extract_face_index: the reading stops at the first unexpected character)
+obj_corner obj_parse_corner(char const* it, char const* end)
+{
+    obj_corner corner = { {0,0,0}, false };
+    if(!obj_parse_int(it, end, corner.index[0]) || it>=end || *it!='/')
+        return corner;
+    ++it;
+    if(it<end && *it=='/') {
+        corner.double_slash = true;
+        ++it;
+        obj_parse_int(it, end, corner.index[2]);
+        return corner;
+    }
+    if(!obj_parse_int(it, end, corner.index[1]) || it>=end || *it!='/')
+        return corner;
+    ++it;
+    obj_parse_int(it, end, corner.index[2]);
+    return corner;
+}
+
+void obj_parse_chunk(char const* begin, char const* end, obj_chunk& chunk)
+{
+    std::vector<obj_corner> polygon;
+    char const* line = begin;
+    while(line<end)
+    {
+        char const* line_end = static_cast<char const*>(std::memchr(line, '\n', size_t(end-line)));
+        if(line_end==nullptr)
+            line_end = end;
+
+        char const* it = obj_skip_space(line, line_end);
+        char const* word = it;
+        while(it<line_end && !obj_is_space(*it))
+            ++it;
+        size_t const word_length = size_t(it-word);
+
+        if(word_length==1 && word[0]=='v') {
+            vec3 p;
+            obj_parse_floats<3>(it, line_end, &p.x);
+            chunk.position.push_back(p);
+        }
+        else if(word_length==2 && word[0]=='v' && word[1]=='t') {
+            vec2 uv;
+            obj_parse_floats<2>(it, line_end, &uv.x);
+            chunk.uv.push_back(uv);
+        }
+        else if(word_length==2 && word[0]=='v' && word[1]=='n') {
+            vec3 n;
+            obj_parse_floats<3>(it, line_end, &n.x);
+            chunk.normal.push_back(n);
+        }
+        else if(word_length==1 && word[0]=='f') {
+            polygon.clear();
+            while(true) {
+                it = obj_skip_space(it, line_end);
+                if(it>=line_end)
+                    break;
+                char const* token = it;
+                while(it<line_end && !obj_is_space(*it))
+                    ++it;
+                polygon.push_back(obj_parse_corner(token, it));
+            }
+            // Fan triangulation (as triangulate_faces)
+            for(size_t k=0; k+2<polygon.size(); ++k) {
+                chunk.corner.push_back(polygon[0]);
+                chunk.corner.push_back(polygon[k+1]);
+                chunk.corner.push_back(polygon[k+2]);
+            }
+        }
+
+        line = line_end+1;
+    }
+}
+
+// Keep the fields that extract_face_index would have read for this type of file, and switch to 0-based indices
+int3 obj_corner_index(obj_corner const& corner, loader::obj_type const type)
+{
+    int3 index = corner.index;
+    if(type==loader::obj_type::vertex)
+        index[1] = index[2] = 0;
+    else if(type==loader::obj_type::vertex_texture)
+        index[2] = 0;
+    else if(type==loader::obj_type::vertex_normal) {
+        index[1] = 0;
+        if(!corner.double_slash)
+            index[2] = 0;
+    }
+    else if(type==loader::obj_type::vertex_texture_normal && corner.double_slash)
+        index[2] = 0;
+
+    return { index[0]-1, index[1]-1, index[2]-1 };
+}
+
+// Open addressing (linear probing) table associating an index triplet to its vertex in the output mesh
+struct obj_vertex_table {
+    struct slot {
+        int3 key;
+        int value; // -1 for an empty slot
+    };
+    std::vector<slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+    explicit obj_vertex_table(size_t expected_size)
+    {
+        size_t capacity = 1024;
+        while(capacity < 2*expected_size)
+            capacity *= 2;
+        slots.assign(capacity, slot{ {0,0,0}, -1 });
+        mask = capacity-1;
+    }
+
+    static size_t hash(int3 const& key)
+    {
+        uint32_t h = uint32_t(key[0])*0x9E3779B1u ^ uint32_t(key[1])*0x85EBCA77u ^ uint32_t(key[2])*0xC2B2AE3Du;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        return size_t(h);
+    }
+
+    // Return the value associated to the key, or insert new_value and return -1 if the key is not in the table
+    int find_or_insert(int3 const& key, int new_value)
+    {
+        if(2*(count+1) > slots.size())
+            grow();
+        size_t k = hash(key) & mask;
+        while(slots[k].value>=0) {
+            if(slots[k].key[0]==key[0] && slots[k].key[1]==key[1] && slots[k].key[2]==key[2])
+                return slots[k].value;
+            k = (k+1) & mask;
+        }
+        slots[k].key = key;
+        slots[k].value = new_value;
+        count++;
+        return -1;
+    }
+
+    void grow()
+    {
+        std::vector<slot> previous(2*slots.size(), slot{ {0,0,0}, -1 });
+        previous.swap(slots);
+        mask = slots.size()-1;
+        for(slot const& s : previous) {
+            if(s.value<0) continue;
+            size_t k = hash(s.key) & mask;
+            while(slots[k].value>=0)
+                k = (k+1) & mask;
+            slots[k] = s;
+        }
+    }
+};
+
+}
+
 mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
+{
+    assert_file_exist(filename);
+    file_mapping file(filename);
+    assert_cgp(file.is_open(), "Cannot open file "+str(filename));
+    char const* const data = reinterpret_cast<char const*>(file.data());
+    size_t const size = file.size();
+
+    // Split the file in chunks of complete lines (at least 1MB per chunk to amortize the thread creation)
+    size_t const min_chunk_size = size_t(1) << 20;
+    int const N_thread = int(std::max(size_t(1), std::min(size_t(std::max(1u, std::thread::hardware_concurrency())), size/min_chunk_size)));
+    std::vector<size_t> chunk_start(N_thread+1, size);
+    chunk_start[0] = 0;
+    for(int k=1; k<N_thread; ++k) {
+        size_t offset = std::max(chunk_start[k-1], k*(size/N_thread));
+        char const* line_end = offset<size ? static_cast<char const*>(std::memchr(data+offset, '\n', size-offset)) : nullptr;
+        chunk_start[k] = line_end==nullptr ? size : size_t(line_end-data)+1;
+    }
+
+    std::vector<obj_chunk> chunks(N_thread);
+    std::vector<std::thread> threads;
+    for(int k=1; k<N_thread; ++k)
+        threads.push_back(std::thread(obj_parse_chunk, data+chunk_start[k], data+chunk_start[k+1], std::ref(chunks[k])));
+    obj_parse_chunk(data, data+chunk_start[1], chunks[0]);
+    for(std::thread& t : threads)
+        t.join();
+
+    // Concatenate the chunks
+    numarray<vec3> positions;
+    numarray<vec2> texture_uv;
+    numarray<vec3> normals;
+    size_t N_corner = 0;
+    for(obj_chunk const& chunk : chunks) {
+        positions.data.insert(positions.data.end(), chunk.position.begin(), chunk.position.end());
+        texture_uv.data.insert(texture_uv.data.end(), chunk.uv.begin(), chunk.uv.end());
+        normals.data.insert(normals.data.end(), chunk.normal.begin(), chunk.normal.end());
+        N_corner += chunk.corner.size();
+    }
+    assert_cgp(positions.size()>0, str("File ")+filename+" has 0 vertices");
+
+    loader::obj_type type = loader::obj_type::vertex;
+    if(texture_uv.size()>0 && normals.size()>0)
+        type = loader::obj_type::vertex_texture_normal;
+    else if( texture_uv.size()>0 )
+        type = loader::obj_type::vertex_texture;
+    else if( normals.size()>0 )
+        type = loader::obj_type::vertex_normal;
+    bool const has_uv = type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_texture;
+    bool const has_normal = type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_normal;
+
+    // Set unique per-vertex value for texture and normals (duplicate vertices if necessary)
+    mesh m;
+    m.connectivity.resize(N_corner/3);
+    m.position.data.reserve(positions.size());
+    std::vector<int3> vertex_key; // index triplet of each output vertex
+    obj_vertex_table table(positions.size());
+    size_t k_corner = 0;
+    for(obj_chunk const& chunk : chunks) {
+        for(obj_corner const& corner : chunk.corner) {
+            int3 const index = obj_corner_index(corner, type);
+            int const offset = int(m.position.size());
+            int const existing = table.find_or_insert(index, offset);
+            if(existing>=0) {
+                m.connectivity[k_corner/3][k_corner%3] = existing;
+            }
+            else {
+                m.connectivity[k_corner/3][k_corner%3] = offset;
+                vertex_key.push_back(index);
+
+                assert_cgp_no_msg( index[0]<int(positions.size()) );
+                m.position.push_back( positions[index[0]] );
+                if(has_uv) {
+                    assert_cgp_no_msg( index[1]<int(texture_uv.size()) );
+                    m.uv.push_back( texture_uv[index[1]] );
+                }
+                if(has_normal) {
+                    assert_cgp_no_msg( index[2]<int(normals.size()) );
+                    m.normal.push_back( normals[index[2]] );
+                }
+            }
+            k_corner++;
+        }
+    }
+
+    // Retrieve correspondance between initial vertices in files and new ones
+    //  The vertices duplicated from the same position are ordered as with the std::map of the reference loader
+    long const N = long(positions.size());
+    vertex_correspondance.clear();
+    vertex_correspondance.resize(positions.size());
+    for(size_t k=0; k<vertex_key.size(); ++k) {
+        int const vertex_in = vertex_key[k][0];
+        if(vertex_in>=0 && vertex_in<int(positions.size()))
+            vertex_correspondance[vertex_in].push_back(int(k));
+    }
+    for(numarray<int>& duplicates : vertex_correspondance) {
+        if(duplicates.size()<2) continue;
+        std::sort(duplicates.begin(), duplicates.end(), [&vertex_key, N](int a, int b) {
+            return long(vertex_key[a][1]) + N*long(vertex_key[a][2]) < long(vertex_key[b][1]) + N*long(vertex_key[b][2]);
+        });
+    }
+
+    return m;
+}
+
+
+mesh_binary mesh_load_file_obj_binary(std::string const& filename, int lod_level_count)
+{
+    std::string const binary_filename = mesh_binary_cache_filename(filename);
+    if(mesh_binary_cache_is_valid(filename)) {
+        mesh_binary m = mesh_binary_load(binary_filename);
+        if(m.level_count>1 || (m.level_count==1 && lod_level_count<=1))
+            return m;
+    }
+
+    mesh const m = mesh_load_file_obj(filename);
+    mesh_binary const binary = lod_level_count>1 ? mesh_binary_make(m, mesh_lod_generate(m, lod_level_count)) : mesh_binary_make(m);
+    if(mesh_binary_cache::active)
+        mesh_binary_save(binary_filename, binary);
+    return binary;
+}
+
+mesh loader::obj_load_reference(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
 {
     assert_file_exist(filename);
 
@@ -18,6 +18,8 @@ namespace cgp
     *  - .mtl files are not read with this loader (cannot read shading and color)
     *  - Only one mesh is loaded - this parser cannot be used when multiple textures are associated to different objects
     *  - The mesh is triangulated if higher degree polygons are in the file
+    *  - Triangles and vertices are reordered for GPU cache efficiency if mesh_optimization::at_load is true
+    *  - The file is memory mapped and large files are parsed in parallel (chunks of lines on the hardware threads)
     */
     mesh mesh_load_file_obj(std::string const& filename);
 
@@ -25,6 +27,13 @@ namespace cgp
     * Outputs the correspondance between the vertex index in the file, and the loaded one */
     mesh mesh_load_file_obj(std::string const& filename, numarray<numarray<int>>& vertex_correspondance);
 
+    /** Load a mesh stored as .obj in the binary format ready to be sent to the GPU (see mesh_binary).
+    * The binary version is cached next to the file (filename + mesh_binary_cache::extension):
+    *  the OBJ is parsed and converted only when the cache is missing or older than the OBJ file, otherwise the cache is memory mapped.
+    * If lod_level_count>1, the levels of details computed by mesh_lod_generate are stored in the same file.
+    *  (A cache without levels of details is regenerated when they are requested, other changes of parameters require to delete the cache) */
+    mesh_binary mesh_load_file_obj_binary(std::string const& filename, int lod_level_count = 1);
+
 
 
 namespace loader{
@@ -55,6 +64,10 @@ namespace loader{
     */
 
     numarray<numarray<int3>> obj_read_faces(const std::string& filename, obj_type const type);
+
+    /** Stream based implementation of mesh_load_file_obj (multiple passes on the file read line by line, std::map to merge the vertices).
+     * Much slower than mesh_load_file_obj which gives the same result - kept as a reference to validate the fast loader. */
+    mesh obj_load_reference(std::string const& filename, numarray<numarray<int>>& vertex_correspondance);
 }
 
 
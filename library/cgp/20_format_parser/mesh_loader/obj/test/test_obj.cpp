@@ -0,0 +1,88 @@
+#include "cgp/01_base/base.hpp"
+#include "../obj.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bool same_bits(float a, float b)
+	{
+		return std::memcmp(&a, &b, sizeof(float)) == 0;
+	}
+
+	void test_obj_same_as_reference(std::string const& filename)
+	{
+		cgp::numarray<cgp::numarray<int>> correspondance, correspondance_reference;
+		cgp::mesh const m = cgp::mesh_load_file_obj(filename, correspondance);
+		cgp::mesh const reference = cgp::loader::obj_load_reference(filename, correspondance_reference);
+
+		assert_cgp_no_msg(m.position.size() == reference.position.size());
+		assert_cgp_no_msg(m.uv.size() == reference.uv.size());
+		assert_cgp_no_msg(m.normal.size() == reference.normal.size());
+		assert_cgp_no_msg(m.connectivity.size() == reference.connectivity.size());
+		for (int k = 0; k < m.position.size(); ++k)
+			for (int i = 0; i < 3; ++i)
+				assert_cgp_no_msg(same_bits(m.position[k][i], reference.position[k][i]));
+		for (int k = 0; k < m.normal.size(); ++k)
+			for (int i = 0; i < 3; ++i)
+				assert_cgp_no_msg(same_bits(m.normal[k][i], reference.normal[k][i]));
+		for (int k = 0; k < m.uv.size(); ++k)
+			for (int i = 0; i < 2; ++i)
+				assert_cgp_no_msg(same_bits(m.uv[k][i], reference.uv[k][i]));
+		for (int k = 0; k < m.connectivity.size(); ++k)
+			assert_cgp_no_msg(is_equal(m.connectivity[k], reference.connectivity[k]));
+
+		assert_cgp_no_msg(correspondance.size() == correspondance_reference.size());
+		for (int k = 0; k < correspondance.size(); ++k)
+			assert_cgp_no_msg(is_equal(correspondance[k], correspondance_reference[k]));
+	}
+
+	void test_obj()
+	{
+		// Polygons, comments, CRLF, mixed spacing, and numbers that need exact rounding
+		std::string const filename = "test_obj_loader.obj";
+		{
+			std::ofstream stream(filename);
+			stream << "# comment\n"
+				<< "o object\n"
+				<< "v 0 0 0\n"
+				<< "v 1.0 0.0 -0.0\r\n"
+				<< "  v\t1.0e0  1 .5\n"
+				<< "v -1.5E-3 +2.25 0.1\n"
+				<< "v 0.30000001192092896 1.00000005960464477539 123456789012345678901234\n"
+				<< "v 3.4028235e38 1e-40 7\n"
+				<< "vt 0 0\nvt 1 0\nvt 1 1 0\nvt 0 1\n"
+				<< "vn 0 0 1\nvn 0 1 0\n"
+				<< "f 1/1/1 2/2/1 3/3/1 4/4/1\n"   // quad: triangulated as a fan
+				<< "f 2/2/2 5/3/2 6/4/2\r\n"
+				<< "#f 1/1/1 2/2/1 3/3/1\n"
+				<< "f 1/1/1 3/3/1 5/1/2";            // last line without line break
+		}
+		test_obj_same_as_reference(filename);
+
+		cgp::numarray<cgp::numarray<int>> correspondance;
+		cgp::mesh const m = cgp::mesh_load_file_obj(filename, correspondance);
+		assert_cgp_no_msg(m.connectivity.size() == 4);
+		assert_cgp_no_msg(m.position.size() == 8);
+		assert_cgp_no_msg(cgp::is_equal(m.position[2], cgp::vec3{ 1.0f, 1.0f, 0.5f }));
+		assert_cgp_no_msg(m.position[3].x == -1.5e-3f);
+		assert_cgp_no_msg(correspondance[4].size() == 2); // vertex 5 is used with two different normals
+
+		// Faces without uv or normals
+		{
+			std::ofstream stream(filename);
+			stream << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nvn 0 0 1\n"
+				<< "f 1//1 2//1 3//1\nf 2//1 4//1 3//1\n";
+		}
+		test_obj_same_as_reference(filename);
+
+		std::remove(filename.c_str());
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+namespace cgp_test
+{
+	void test_obj();
+
+	// Compare the fast loader with the reference stream based one on an existing file
+	void test_obj_same_as_reference(std::string const& filename);
+}
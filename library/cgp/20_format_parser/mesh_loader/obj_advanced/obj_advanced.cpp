@@ -1,5 +1,7 @@
 #include "obj_advanced.hpp"
 
+#include <algorithm>
+
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "third_party/src/tinyobj/tiny_obj_loader.hpp"
 
@@ -21,15 +23,33 @@ namespace cgp
 			}
 			return drawables;
 		}
+
+		cgp::mesh_drawable convert_to_mesh_drawable(merged_element const& element, opengl_shader_structure const& shader, GLint wrap)
+		{
+			mesh m = element.mesh_element;
+			m.fill_empty_field();
+
+			mesh_drawable drawable;
+			drawable.initialize_data_on_gpu(m, shader);
+			drawable.initialize_supplementary_data_on_gpu(element.texture_layer, 4);
+
+			std::vector<image_view> layers;
+			for (image_structure const& im : element.texture_layers)
+				layers.push_back(image_view(im));
+			drawable.texture.initialize_texture_2d_array_on_gpu(layers, wrap, wrap);
+
+			return drawable;
+		}
+
+		std::string str(merged_element const& element)
+		{
+			return cgp::str(element.mesh_element.connectivity.size()) + " triangles, " + cgp::str(element.texture_layers.size()) + " texture layers, draw calls: " + cgp::str(element.element_count) + " -> 1";
+		}
 	}
 
-	std::vector<mesh_obj_advanced_loader::shape_element_node> mesh_load_file_obj_advanced(std::string const& directory, std::string const& filename)
+	static void obj_advanced_parse(std::string const& inputfile, tinyobj::ObjReader& reader)
 	{
-		std::vector<mesh_obj_advanced_loader::shape_element_node> data;
-
-		std::string inputfile = directory + filename; // project::path + "assets/StMaria/StMaria.obj";
 		tinyobj::ObjReaderConfig reader_config;
-		tinyobj::ObjReader reader;
 
 		if (!reader.ParseFromFile(inputfile, reader_config)) {
 			if (!reader.Error().empty()) {
@@ -41,6 +61,15 @@ namespace cgp
 		if (!reader.Warning().empty()) {
 			std::cout << "TinyObjReader: " << reader.Warning();
 		}
+	}
+
+	std::vector<mesh_obj_advanced_loader::shape_element_node> mesh_load_file_obj_advanced(std::string const& directory, std::string const& filename)
+	{
+		std::vector<mesh_obj_advanced_loader::shape_element_node> data;
+
+		std::string inputfile = directory + filename; // project::path + "assets/StMaria/StMaria.obj";
+		tinyobj::ObjReader reader;
+		obj_advanced_parse(inputfile, reader);
 
 		auto& attrib = reader.GetAttrib();
 		auto& shapes = reader.GetShapes();
@@ -140,4 +169,100 @@ namespace cgp
 
 		return data;
 	}
-}
\ No newline at end of file
+
+	mesh_obj_advanced_loader::merged_element mesh_load_file_obj_advanced_merged(std::string const& directory, std::string const& filename)
+	{
+		mesh_obj_advanced_loader::merged_element merged;
+
+		tinyobj::ObjReader reader;
+		obj_advanced_parse(directory + filename, reader);
+
+		auto& attrib = reader.GetAttrib();
+		auto& shapes = reader.GetShapes();
+		auto& materials = reader.GetMaterials();
+
+		// One layer per distinct texture file, the layer 0 being used by the materials without texture
+		std::vector<std::string> layer_filename = { "" };
+		std::vector<int> material_layer(materials.size(), 0);
+		for (size_t k = 0; k < materials.size(); ++k) {
+			std::string const& texture_filename = materials[k].diffuse_texname;
+			if (texture_filename == "")
+				continue;
+			auto const it = std::find(layer_filename.begin(), layer_filename.end(), texture_filename);
+			material_layer[k] = int(it - layer_filename.begin());
+			if (it == layer_filename.end())
+				layer_filename.push_back(texture_filename);
+		}
+
+		std::vector<image_structure> images(layer_filename.size());
+		int width = 1, height = 1;
+		for (size_t k = 1; k < layer_filename.size(); ++k) {
+			images[k] = image_load_file(directory + layer_filename[k]);
+			width = std::max(width, images[k].width);
+			height = std::max(height, images[k].height);
+		}
+		images[0] = image_structure(width, height, image_color_type::rgba, numarray<unsigned char>(size_t(4) * width * height).fill(255));
+		for (image_structure& im : images) {
+			if (im.width != width || im.height != height || im.color_type != image_color_type::rgba)
+				im = image_resample(image_view(im), width, height, image_color_type::rgba);
+		}
+		merged.texture_layers = images;
+
+		// Gather the faces of all the shapes (the vertices are duplicated per face, as in mesh_load_file_obj_advanced)
+		mesh& m = merged.mesh_element;
+		bool has_normal = false;
+		bool has_uv = false;
+		for (size_t shape_idx = 0; shape_idx < shapes.size(); shape_idx++)
+		{
+			tinyobj::mesh_t const& shape = shapes[shape_idx].mesh;
+			size_t index_offset = 0;
+			int idx_material_previous = -2;
+			for (size_t f = 0; f < shape.num_face_vertices.size(); f++)
+			{
+				int const idx_material = shape.material_ids[f];
+				if (idx_material != idx_material_previous) {
+					merged.element_count++;
+					idx_material_previous = idx_material;
+				}
+				float const layer = float(idx_material >= 0 ? material_layer[idx_material] : 0);
+
+				size_t const fv = size_t(shape.num_face_vertices[f]);
+				unsigned int const first_vertex = m.position.size();
+				for (size_t v = 0; v < fv; v++) {
+					tinyobj::index_t const idx = shape.indices[index_offset + v];
+					m.position.push_back({ attrib.vertices[3 * size_t(idx.vertex_index) + 0], attrib.vertices[3 * size_t(idx.vertex_index) + 1], attrib.vertices[3 * size_t(idx.vertex_index) + 2] });
+
+					// Missing normals/uv are set to 0 to keep one value per vertex
+					vec3 normal = { 0,0,0 };
+					if (idx.normal_index >= 0) {
+						normal = { attrib.normals[3 * size_t(idx.normal_index) + 0], attrib.normals[3 * size_t(idx.normal_index) + 1], attrib.normals[3 * size_t(idx.normal_index) + 2] };
+						has_normal = true;
+					}
+					m.normal.push_back(normal);
+
+					vec2 uv = { 0,0 };
+					if (idx.texcoord_index >= 0) {
+						uv = { attrib.texcoords[2 * size_t(idx.texcoord_index) + 0], attrib.texcoords[2 * size_t(idx.texcoord_index) + 1] };
+						has_uv = true;
+					}
+					m.uv.push_back(uv);
+					merged.texture_layer.push_back(layer);
+				}
+				index_offset += fv;
+
+				for (size_t k = 1; k + 1 < fv; ++k) {
+					m.connectivity.push_back({ first_vertex, first_vertex + unsigned(k), first_vertex + unsigned(k + 1) });
+					merged.triangle_material.push_back(idx_material);
+				}
+			}
+		}
+
+		// Let fill_empty_field compute the normals if the file has none
+		if (!has_normal)
+			m.normal.clear();
+		if (!has_uv)
+			m.uv.clear();
+
+		return merged;
+	}
+}
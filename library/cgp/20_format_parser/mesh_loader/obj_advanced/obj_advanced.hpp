@@ -13,9 +13,32 @@ namespace cgp
 		};
 
 		std::vector<cgp::mesh_drawable> convert_to_mesh_drawable(std::vector<shape_element_node> const& elements);
+
+		// All the shapes of a file merged in a single mesh. The textures of the materials are gathered in the layers of a texture array.
+		//  Only CPU data is stored: the GPU structures are created by convert_to_mesh_drawable (the loading can run on a worker thread)
+		struct merged_element {
+			mesh mesh_element;
+			numarray<float> texture_layer;   // Per-vertex layer in the texture array (constant on each triangle)
+			numarray<int> triangle_material; // Per-triangle index of the material in the file (-1 if none)
+
+			// Images of the layers, resampled to the size of the largest texture (rgba). Layer 0 is white (materials without texture).
+			std::vector<image_structure> texture_layers;
+
+			// Number of elements returned by mesh_load_file_obj_advanced for the same file (i.e. number of draw calls and texture binds without merging)
+			int element_count = 0;
+		};
+
+		// Single mesh_drawable for all the materials: the layer is sent as a supplementary VBO (location 4) and the texture is a GL_TEXTURE_2D_ARRAY
+		//  The shader is expected to read the layer at location 4 and to sample a sampler2DArray (ex. shaders/mesh_texture_array)
+		cgp::mesh_drawable convert_to_mesh_drawable(merged_element const& element, opengl_shader_structure const& shader, GLint wrap = GL_REPEAT);
+
+		std::string str(merged_element const& element);
 	}
 
 	std::vector<mesh_obj_advanced_loader::shape_element_node> mesh_load_file_obj_advanced(std::string const& directory, std::string const& filename);
 
+	// Load all the shapes and materials of a file in a single mesh (see merged_element)
+	mesh_obj_advanced_loader::merged_element mesh_load_file_obj_advanced_merged(std::string const& directory, std::string const& filename);
+
 
 }
\ No newline at end of file
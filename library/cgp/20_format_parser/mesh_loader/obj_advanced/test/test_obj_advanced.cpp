@@ -0,0 +1,71 @@
+#include "cgp/01_base/base.hpp"
+#include "../obj_advanced.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_obj_advanced_merged()
+	{
+		// Asset with 3 materials: two textures of different sizes, and a material without texture
+		{
+			cgp::numarray<unsigned char> red(4 * 4 * 4), blue(3 * 8 * 8);
+			for (int k = 0; k < 16; ++k) { red[4 * k] = 255; red[4 * k + 1] = 0; red[4 * k + 2] = 0; red[4 * k + 3] = 255; }
+			for (int k = 0; k < 64; ++k) { blue[3 * k] = 0; blue[3 * k + 1] = 0; blue[3 * k + 2] = 255; }
+			cgp::image_save_png("test_obj_advanced_red.png", cgp::image_structure(4, 4, cgp::image_color_type::rgba, red));
+			cgp::image_save_png("test_obj_advanced_blue.png", cgp::image_structure(8, 8, cgp::image_color_type::rgb, blue));
+
+			std::ofstream mtl("test_obj_advanced.mtl");
+			mtl << "newmtl red\nmap_Kd test_obj_advanced_red.png\n"
+				<< "newmtl blue\nmap_Kd test_obj_advanced_blue.png\n"
+				<< "newmtl plain\nKd 0.5 0.5 0.5\n";
+			mtl.close();
+
+			std::ofstream obj("test_obj_advanced.obj");
+			obj << "mtllib test_obj_advanced.mtl\n"
+				<< "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 2 0 0\nv 2 1 0\n"
+				<< "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+				<< "o first\nusemtl red\nf 1/1 2/2 3/3\nf 1/1 3/3 4/4\n"
+				<< "usemtl blue\nf 2/1 5/2 6/3\n"
+				<< "o second\nusemtl plain\nf 2/1 6/3 3/4\n"
+				<< "usemtl red\nf 4/1 3/2 6/3\n";
+			obj.close();
+		}
+
+		cgp::mesh_obj_advanced_loader::merged_element const merged = cgp::mesh_load_file_obj_advanced_merged("", "test_obj_advanced.obj");
+		std::cout << cgp::mesh_obj_advanced_loader::str(merged) << std::endl;
+
+		// 4 runs of materials would be 4 draw calls with mesh_load_file_obj_advanced
+		assert_cgp_no_msg(merged.element_count == 4);
+		assert_cgp_no_msg(merged.mesh_element.connectivity.size() == 5);
+		assert_cgp_no_msg(merged.mesh_element.position.size() == 15);
+		assert_cgp_no_msg(merged.texture_layer.size() == 15);
+		assert_cgp_no_msg(merged.mesh_element.uv.size() == 15);
+		assert_cgp_no_msg(merged.mesh_element.normal.size() == 0); // computed by fill_empty_field
+
+		// White layer + 2 textures, all resampled to the largest size
+		assert_cgp_no_msg(merged.texture_layers.size() == 3);
+		for (cgp::image_structure const& im : merged.texture_layers)
+			assert_cgp_no_msg(im.width == 8 && im.height == 8 && im.color_type == cgp::image_color_type::rgba);
+		assert_cgp_no_msg(merged.texture_layers[0].data[0] == 255 && merged.texture_layers[0].data[2] == 255);
+		assert_cgp_no_msg(merged.texture_layers[1].data[0] == 255 && merged.texture_layers[1].data[2] == 0);
+		assert_cgp_no_msg(merged.texture_layers[2].data[0] == 0 && merged.texture_layers[2].data[2] == 255);
+
+		// The layer follows the material of each triangle
+		float const expected_layer[5] = { 1, 1, 2, 0, 1 };
+		for (int k = 0; k < 5; ++k)
+			for (unsigned int idx : merged.mesh_element.connectivity[k])
+				assert_cgp_no_msg(merged.texture_layer[idx] == expected_layer[k]);
+
+		std::remove("test_obj_advanced.obj");
+		std::remove("test_obj_advanced.mtl");
+		std::remove("test_obj_advanced_red.png");
+		std::remove("test_obj_advanced_blue.png");
+	}
+}
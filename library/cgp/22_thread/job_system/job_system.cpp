@@ -0,0 +1,105 @@
+#include "job_system.hpp"
+
+#include "cgp/17_timer/profiler/profiler.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	job_system::job_system(int N_thread)
+		:N_pending(0), stopping(false)
+	{
+		if (N_thread <= 0)
+			N_thread = std::max(int(std::thread::hardware_concurrency()) - 1, 1);
+
+		workers.reserve(N_thread);
+		for (int k = 0; k < N_thread; ++k)
+			workers.emplace_back(&job_system::worker_loop, this);
+	}
+
+	job_system::~job_system()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		job_available.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	void job_system::submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(job));
+			N_pending++;
+		}
+		job_available.notify_one();
+	}
+
+	void job_system::worker_loop()
+	{
+		profile_thread_name_cgp("job worker");
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				job_available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+				if (jobs.empty()) // stopping once the remaining jobs are done
+					return;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			std::exception_ptr job_error;
+			try {
+				profile_zone_cgp("job");
+				job();
+			}
+			catch (...) {
+				job_error = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (job_error && !error)
+					error = job_error;
+				N_pending--;
+			}
+			job_finished.notify_all();
+		}
+	}
+
+	void job_system::wait_idle()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			job_finished.wait(lock, [this]() { return N_pending == 0; });
+		}
+		rethrow_error();
+	}
+
+	void job_system::rethrow_error()
+	{
+		std::exception_ptr e;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::swap(e, error);
+		}
+		if (e)
+			std::rethrow_exception(e);
+	}
+
+	int job_system::size() const
+	{
+		return int(workers.size());
+	}
+
+	int job_system::pending() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return N_pending;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgp
+{
+	/** Pool of worker threads executing independent jobs (ex. image decoding, mesh parsing).
+	* Jobs are executed in submission order by the first available worker. They must not call OpenGL (use a task_queue to send the result back to the main thread).
+	* An exception thrown by a job is stored and re-thrown on the owner thread by rethrow_error() or wait_idle(). */
+	class job_system
+	{
+	public:
+		// N_thread=0: one worker per hardware thread, minus the main thread (at least one worker)
+		explicit job_system(int N_thread = 0);
+		~job_system();
+
+		job_system(job_system const&) = delete;
+		job_system& operator=(job_system const&) = delete;
+
+		void submit(std::function<void()> job);
+
+		// Block until all the submitted jobs are finished
+		void wait_idle();
+		// Re-throw the first exception raised by a job since the last call (if any)
+		void rethrow_error();
+
+		int size() const;    // Number of worker threads
+		int pending() const; // Number of jobs submitted and not finished
+
+	private:
+		void worker_loop();
+
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> jobs;
+		mutable std::mutex mutex;
+		std::condition_variable job_available;
+		std::condition_variable job_finished;
+		int N_pending;
+		bool stopping;
+		std::exception_ptr error;
+	};
+}
@@ -0,0 +1,50 @@
+#include "task_queue.hpp"
+
+#include <chrono>
+
+namespace cgp
+{
+	void task_queue::push(std::function<void()> task)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+
+	int task_queue::run(float budget)
+	{
+		using clock = std::chrono::steady_clock;
+		clock::time_point const start = clock::now();
+
+		int counter = 0;
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (tasks.empty())
+					break;
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+
+			// The task is executed outside of the lock: it may post other tasks
+			task();
+			counter++;
+
+			if (std::chrono::duration<float>(clock::now() - start).count() > budget)
+				break;
+		}
+		return counter;
+	}
+
+	int task_queue::size() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return int(tasks.size());
+	}
+
+	bool task_queue::empty() const
+	{
+		return size() == 0;
+	}
+}
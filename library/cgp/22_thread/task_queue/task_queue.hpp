@@ -0,0 +1,27 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace cgp
+{
+	/** Tasks posted from any thread, and executed on the thread that calls run() (typically OpenGL uploads on the main thread).
+	* run() executes the tasks in posting order until the time budget of the call is spent, so that a long list of uploads is spread over several frames. */
+	class task_queue
+	{
+	public:
+		void push(std::function<void()> task);
+
+		// Execute tasks until the queue is empty or budget (in seconds) is exceeded. At least one task is executed if the queue is not empty.
+		//  Returns the number of executed tasks.
+		int run(float budget = 0.008f);
+
+		int size() const;
+		bool empty() const;
+
+	private:
+		std::deque<std::function<void()>> tasks;
+		mutable std::mutex mutex;
+	};
+}
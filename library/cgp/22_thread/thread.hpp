@@ -0,0 +1,5 @@
+#pragma once
+
+#include "job_system/job_system.hpp"
+#include "task_queue/task_queue.hpp"
+#include "triple_buffer/triple_buffer.hpp"
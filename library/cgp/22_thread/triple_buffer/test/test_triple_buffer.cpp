@@ -0,0 +1,68 @@
+#include "cgp/01_base/base.hpp"
+#include "../triple_buffer.hpp"
+
+#include <thread>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	// Value made of two fields written separately: a torn read would be detected as a mismatch
+	struct test_triple_buffer_value {
+		int a = 0;
+		int b = 0;
+	};
+
+	void test_triple_buffer()
+	{
+		// Single thread
+		{
+			cgp::triple_buffer<int> buffer(5);
+			assert_cgp_no_msg(buffer.update() == false);
+			assert_cgp_no_msg(buffer.read_buffer() == 5);
+
+			buffer.write_buffer() = 1;
+			buffer.publish();
+			buffer.write_buffer() = 2;
+			buffer.publish();
+			assert_cgp_no_msg(buffer.update() == true);
+			assert_cgp_no_msg(buffer.read_buffer() == 2); // intermediate value skipped
+			assert_cgp_no_msg(buffer.update() == false);
+			assert_cgp_no_msg(buffer.read_buffer() == 2);
+
+			buffer.write_buffer() = 3;
+			buffer.publish();
+			assert_cgp_no_msg(buffer.update() == true);
+			assert_cgp_no_msg(buffer.read_buffer() == 3);
+		}
+
+		// Producer and consumer threads: values are read complete and in increasing order
+		{
+			int const N = 200000;
+			cgp::triple_buffer<test_triple_buffer_value> buffer;
+			std::thread producer([&buffer]() {
+				for (int k = 1; k <= N; ++k) {
+					test_triple_buffer_value& value = buffer.write_buffer();
+					value.a = k;
+					value.b = -k;
+					buffer.publish();
+				}
+			});
+
+			int last = 0;
+			bool valid = true;
+			while (last < N) {
+				if (buffer.update()) {
+					test_triple_buffer_value const& value = buffer.read_buffer();
+					if (value.a != -value.b || value.a <= last)
+						valid = false;
+					last = value.a;
+				}
+			}
+			producer.join();
+			assert_cgp_no_msg(valid);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+
+namespace cgp
+{
+	/** Lock-free single producer / single consumer exchange of the latest value (ex. simulation snapshots).
+	* The producer writes in write_buffer() and calls publish(), the consumer calls update() and reads read_buffer().
+	*  Neither side ever waits: the producer always has a free buffer, and the consumer always reads the most recent published value (intermediate values may be skipped).
+	*  The three buffers are allocated once, the exchange only swaps indices. */
+	template <typename T>
+	class triple_buffer
+	{
+	public:
+		triple_buffer();
+		explicit triple_buffer(T const& initial_value);
+
+		// Producer side
+		T& write_buffer();
+		void publish();
+
+		// Consumer side - Returns true if a new value has been published since the last call
+		bool update();
+		T const& read_buffer() const;
+
+	private:
+		// The middle index stores the buffer exchanged between the two threads, and a flag (bit 2) indicating that it holds an unread value
+		static constexpr int fresh_bit = 4;
+
+		T buffer[3];
+		std::atomic<int> middle;
+		int back;   // Owned by the producer
+		int front;  // Owned by the consumer
+	};
+}
+
+
+namespace cgp
+{
+	template <typename T>
+	triple_buffer<T>::triple_buffer()
+		:buffer(), middle(1), back(0), front(2)
+	{}
+
+	template <typename T>
+	triple_buffer<T>::triple_buffer(T const& initial_value)
+		:buffer{ initial_value, initial_value, initial_value }, middle(1), back(0), front(2)
+	{}
+
+	template <typename T>
+	T& triple_buffer<T>::write_buffer()
+	{
+		return buffer[back];
+	}
+
+	template <typename T>
+	void triple_buffer<T>::publish()
+	{
+		// release: the writes to the back buffer are visible to the consumer acquiring the middle index
+		int const previous = middle.exchange(back | fresh_bit, std::memory_order_acq_rel);
+		back = previous & ~fresh_bit;
+	}
+
+	template <typename T>
+	bool triple_buffer<T>::update()
+	{
+		if ((middle.load(std::memory_order_relaxed) & fresh_bit) == 0)
+			return false;
+
+		int const previous = middle.exchange(front, std::memory_order_acq_rel);
+		front = previous & ~fresh_bit;
+		return true;
+	}
+
+	template <typename T>
+	T const& triple_buffer<T>::read_buffer() const
+	{
+		return buffer[front];
+	}
+}
@@ -37,4 +37,5 @@
 #include "19_camera_controller/camera_controller.hpp"
 #include "20_format_parser/format_parser.hpp"
 #include "21_scene_project_helper/scene_project_helper.hpp"
+#include "22_thread/thread.hpp"
 
@@ -13,6 +13,56 @@
 
 
 
+// *************************************************************** //
+// CGP BOUND CHECKING
+//
+// Level of the index checks in the element access of the containers (numarray, numarray_stack, matrix_stack, grid_2D, grid_3D, grid_stack_2D)
+//   2: Full check of every index, with a detailed error message (default)
+//   1: Cheap check only - a single unsigned comparison per access (on the linear offset for the grids), the message is only built on error
+//   0: No check (default when CGP_NO_DEBUG is defined)
+// The golf Makefile selects the level with CHECKS=debug|cheap|release
+// *************************************************************** //
+// #define CGP_BOUND_CHECK 1
+
+#ifndef CGP_BOUND_CHECK
+    #if defined(CGP_NO_DEBUG) || defined(cgp_NO_DEBUG)
+        #define CGP_BOUND_CHECK 0
+    #else
+        #define CGP_BOUND_CHECK 2
+    #endif
+#endif
+
+
+
+// *************************************************************** //
+// CGP PROFILER
+//
+// Uncomment the following definition to remove the profiler zones (profile_zone_cgp) at compile time
+// *************************************************************** //
+// #define CGP_NO_PROFILER
+
+
+
+// *************************************************************** //
+// CGP SIMD
+//
+// Uncomment the following definition to use the scalar version of the mat4 kernels (product, inverse, transpose) and of the grid_sampler_2D taps instead of SSE/NEON
+// *************************************************************** //
+// #define CGP_NO_SIMD
+
+
+
+// *************************************************************** //
+// CGP ALLOCATION COUNTER
+//
+// Uncomment the following definition to replace the global operator new/delete and count the heap allocations (allocation_counter.hpp)
+//   Not defined by default: the replacement changes the allocator of the whole program (clashes with sanitizers and custom allocators)
+// The golf Makefile defines it unless ALLOCATION_COUNTER=off
+// *************************************************************** //
+// #define CGP_ALLOCATION_COUNTER
+
+
+
 // *************************************************************** //
 // OpenGL Version
 // *************************************************************** //